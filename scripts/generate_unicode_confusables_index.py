@@ -0,0 +1,74 @@
+# Generates src/base/unicode/confusables_index.h from confusables_data.h.
+#
+# The code points are split into pages of 256. Every page that contains a
+# decomposition gets a bitmap of the code points that have one and the
+# index of the first decomposition of every 32 code points, so a lookup
+# is a table read and a popcount instead of a search.
+#
+# usage: python scripts/generate_unicode_confusables_index.py > src/base/unicode/confusables_index.h
+from __future__ import print_function
+
+import os
+import re
+
+PAGE_SHIFT = 8
+PAGE_SIZE = 1 << PAGE_SHIFT
+WORDS = PAGE_SIZE // 32
+MAX_CODE_POINT = 0x10ffff
+
+def main():
+	path = os.path.join(os.path.dirname(__file__), "..", "src", "base", "unicode", "confusables_data.h")
+	data = open(path).read()
+	table = re.search(r"decomp_chars\[NUM_DECOMPS\] = \{(.*?)\};", data, re.S).group(1)
+	chars = [int(c, 16) for c in re.findall(r"0x[0-9a-f]+", table)]
+	assert chars == sorted(chars)
+	assert len(chars) < 0x10000
+
+	num_blocks = (MAX_CODE_POINT >> PAGE_SHIFT) + 1
+	# page 0 stays empty, for the blocks without decompositions
+	pages = [(0, [0] * WORDS)]
+	blocks = [0] * num_blocks
+	for index, c in enumerate(chars):
+		block = c >> PAGE_SHIFT
+		if not blocks[block]:
+			blocks[block] = len(pages)
+			pages.append((index, [0] * WORDS))
+		pages[blocks[block]][1][(c & (PAGE_SIZE - 1)) // 32] |= 1 << (c & 31)
+	assert len(pages) < 0x100
+
+	print("#include <stdint.h>")
+	print("")
+	print("// generated by scripts/generate_unicode_confusables_index.py")
+	print("")
+	print("enum")
+	print("{")
+	print("\tCONFUSABLE_PAGE_SHIFT={},".format(PAGE_SHIFT))
+	print("\tNUM_CONFUSABLE_BLOCKS={},".format(num_blocks))
+	print("\tNUM_CONFUSABLE_PAGES={},".format(len(pages)))
+	print("\tNUM_CONFUSABLE_WORDS={},".format(WORDS))
+	print("};")
+	print("")
+
+	print("static const uint8_t confusable_blocks[NUM_CONFUSABLE_BLOCKS] = {")
+	for i in range(0, num_blocks, 16):
+		print("\t" + " ".join("{},".format(b) for b in blocks[i:i + 16]))
+	print("};")
+	print("")
+
+	print("static const uint32_t confusable_bits[NUM_CONFUSABLE_PAGES][NUM_CONFUSABLE_WORDS] = {")
+	for _, words in pages:
+		print("\t{" + ", ".join("0x{:08x}".format(w) for w in words) + "},")
+	print("};")
+	print("")
+
+	print("static const uint16_t confusable_base[NUM_CONFUSABLE_PAGES][NUM_CONFUSABLE_WORDS] = {")
+	for first, words in pages:
+		bases = []
+		for w in words:
+			bases.append(first)
+			first += bin(w).count("1")
+		print("\t{" + ", ".join(str(b) for b in bases) + "},")
+	print("};")
+
+if __name__ == "__main__":
+	main()
@@ -35,6 +35,37 @@ void sha256_str(SHA256_DIGEST digest, char *str, size_t max_len)
 	}
 }
 
+static int hex_digit(char c)
+{
+	if(c >= '0' && c <= '9')
+		return c - '0';
+	if(c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+int sha256_from_str(SHA256_DIGEST *out, const char *str)
+{
+	unsigned i;
+	if(str_length(str) != SHA256_MAXSTRSIZE - 1)
+	{
+		return 2;
+	}
+	for(i = 0; i < sizeof(out->data); i++)
+	{
+		int high = hex_digit(str[2 * i]);
+		int low = hex_digit(str[2 * i + 1]);
+		if(high < 0 || low < 0)
+		{
+			return 1;
+		}
+		out->data[i] = (high << 4) | low;
+	}
+	return 0;
+}
+
 int sha256_comp(SHA256_DIGEST digest1, SHA256_DIGEST digest2)
 {
 	return mem_comp(digest1.data, digest2.data, sizeof(digest1.data));
@@ -1,5 +1,9 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE /* recvmmsg and sendmmsg */
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -79,7 +83,8 @@ void dbg_assert_imp(const char *filename, int line, int test, const char *msg)
 {
 	if(!test)
 	{
-		dbg_msg("assert", "%s(%d): %s", filename, line, msg);
+		dbg_msg_level(LOG_LEVEL_ERROR, "assert", "%s(%d): %s", filename, line, msg);
+		dbg_logger_flush();
 		dbg_break();
 	}
 }
@@ -89,31 +94,525 @@ void dbg_break()
 	*((volatile unsigned*)0) = 0x0;
 }
 
-void dbg_msg(const char *sys, const char *fmt, ...)
+#if defined(__GNUC__)
+static unsigned log_atomic_inc(volatile unsigned *value)
 {
-	va_list args;
-	char str[1024*4];
-	char *msg;
-	int i, len;
+	return __sync_add_and_fetch(value, 1);
+}
+
+static unsigned log_atomic_compswap(volatile unsigned *value, unsigned comperand, unsigned newvalue)
+{
+	return __sync_val_compare_and_swap(value, comperand, newvalue);
+}
+
+static void log_barrier()
+{
+	__sync_synchronize();
+}
+#elif defined(_MSC_VER)
+static unsigned log_atomic_inc(volatile unsigned *value)
+{
+	return InterlockedIncrement((volatile LONG *)value);
+}
+
+static unsigned log_atomic_compswap(volatile unsigned *value, unsigned comperand, unsigned newvalue)
+{
+	return InterlockedCompareExchange((volatile LONG *)value, (LONG)newvalue, (LONG)comperand);
+}
+
+static void log_barrier()
+{
+	MemoryBarrier();
+}
+#else
+	#error missing atomic implementation for this compiler
+#endif
+
+static unsigned log_atomic_exchange(volatile unsigned *value, unsigned newvalue)
+{
+	unsigned old;
+	do
+		old = *value;
+	while(log_atomic_compswap(value, old, newvalue) != old);
+	return old;
+}
+
+/*
+	Every system that logged something gets a filter, the filters are
+	only ever appended so they can be read without a lock.
+*/
+enum
+{
+	LOG_MAX_FILTERS=64,
+	LOG_MAX_LINE=1024*4,
+};
+
+typedef struct
+{
+	char sys[32];
+	volatile int level; // -1 for the default level
+	volatile unsigned second;
+	volatile unsigned count;
+	volatile unsigned suppressed;
+} LOG_FILTER;
+
+static LOG_FILTER log_filters[LOG_MAX_FILTERS];
+static volatile unsigned num_log_filters = 0;
+static volatile unsigned log_filters_busy = 0;
+static volatile int log_default_level = LOG_LEVEL_INFO;
+static volatile int log_rate_limit = 0;
+
+static LOG_FILTER *log_filter_find(const char *sys)
+{
+	LOG_FILTER *filter = 0;
+	unsigned i, num = num_log_filters;
+	for(i = 0; i < num; i++)
+	{
+		if(str_comp(log_filters[i].sys, sys) == 0)
+			return &log_filters[i];
+	}
+	if(str_length(sys) >= (int)sizeof(log_filters[0].sys))
+		return 0;
+
+	while(log_atomic_compswap(&log_filters_busy, 0, 1) != 0)
+		thread_yield();
+	// another thread might have added it in the meantime
+	for(; i < num_log_filters; i++)
+	{
+		if(str_comp(log_filters[i].sys, sys) == 0)
+		{
+			filter = &log_filters[i];
+			break;
+		}
+	}
+	if(!filter && num_log_filters < LOG_MAX_FILTERS)
+	{
+		filter = &log_filters[num_log_filters];
+		str_copy(filter->sys, sys, sizeof(filter->sys));
+		filter->level = -1;
+		filter->second = 0;
+		filter->count = 0;
+		filter->suppressed = 0;
+		log_barrier();
+		num_log_filters++;
+	}
+	log_barrier();
+	log_filters_busy = 0;
+	return filter;
+}
+
+static int log_filter_pass(int level, const char *sys, unsigned *suppressed)
+{
+	LOG_FILTER *filter = log_filter_find(sys);
+	int max_level = log_default_level;
+	unsigned limit = (unsigned)log_rate_limit;
+	unsigned second, old_second;
+
+	*suppressed = 0;
+	if(filter && filter->level >= 0)
+		max_level = filter->level;
+	if(level > max_level)
+		return 0;
+	// errors are never dropped
+	if(!filter || limit == 0 || level == LOG_LEVEL_ERROR)
+		return 1;
+
+	second = (unsigned)(time_get()/time_freq());
+	old_second = filter->second;
+	if(old_second != second && log_atomic_compswap(&filter->second, old_second, second) == old_second)
+	{
+		filter->count = 0;
+		*suppressed = log_atomic_exchange(&filter->suppressed, 0);
+	}
+	if(log_atomic_inc(&filter->count) > limit)
+	{
+		log_atomic_inc(&filter->suppressed);
+		return 0;
+	}
+	return 1;
+}
+
+void dbg_logger_level(const char *sys, int level)
+{
+	LOG_FILTER *filter;
+	if(!sys)
+	{
+		if(level >= 0)
+			log_default_level = level;
+		return;
+	}
+	filter = log_filter_find(sys);
+	if(filter)
+		filter->level = level;
+}
+
+void dbg_logger_rate_limit(int lines_per_second)
+{
+	log_rate_limit = lines_per_second;
+}
+
+/*
+	The asynchronous log queue is a bounded multi producer ring. A line
+	takes one or more consecutive slots, a producer claims them by moving
+	the head and publishes each slot through its sequence number. The
+	single writer thread hands the lines to the loggers in order.
+*/
+enum
+{
+	LOG_QUEUE_SIZE=1024, // a power of two
+	LOG_SLOT_SIZE=256,
+};
+
+typedef struct
+{
+	volatile unsigned sequence;
+	unsigned num_slots;
+	char data[LOG_SLOT_SIZE];
+} LOG_SLOT;
+
+static LOG_SLOT log_slots[LOG_QUEUE_SIZE];
+static volatile unsigned log_head = 0;
+static volatile unsigned log_tail = 0;
+static volatile unsigned log_written = 0;
+static volatile unsigned log_dropped = 0;
+static volatile unsigned log_wake_pending = 0;
+static volatile int log_running = 0;
+static volatile int log_stop = 0;
+static void *log_thread = 0;
+#if !defined(CONF_PLATFORM_MACOSX)
+static SEMAPHORE log_semaphore;
+#endif
+
+static void log_wake()
+{
+	if(log_wake_pending || log_atomic_compswap(&log_wake_pending, 0, 1) != 0)
+		return;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_signal(&log_semaphore);
+#endif
+}
+
+static int log_queue_push(const char *line, int len)
+{
+	unsigned num = len/LOG_SLOT_SIZE + 1;
+	unsigned pos = log_head;
+	unsigned i;
+
+	while(1)
+	{
+		// the slots are freed in order, so if the last one is free all of them are
+		LOG_SLOT *last = &log_slots[(pos+num-1)%LOG_QUEUE_SIZE];
+		int diff = (int)(last->sequence - (pos+num-1));
+		if(diff == 0)
+		{
+			unsigned old = log_atomic_compswap(&log_head, pos, pos+num);
+			if(old == pos)
+				break;
+			pos = old;
+		}
+		else if(diff < 0)
+			return 0;
+		else
+			pos = log_head;
+	}
+
+	for(i = 0; i < num; i++)
+	{
+		LOG_SLOT *slot = &log_slots[(pos+i)%LOG_QUEUE_SIZE];
+		int size = len+1 - i*LOG_SLOT_SIZE;
+		mem_copy(slot->data, line + i*LOG_SLOT_SIZE, size < LOG_SLOT_SIZE ? size : LOG_SLOT_SIZE);
+		slot->num_slots = num;
+	}
+	// publish the first slot last, the writer never waits inside a line
+	for(i = num; i > 0; i--)
+	{
+		log_barrier();
+		log_slots[(pos+i-1)%LOG_QUEUE_SIZE].sequence = pos+i;
+	}
+
+	log_wake();
+	return 1;
+}
+
+// claims the oldest line, the writer thread and dbg_logger_write_queued may race for it
+static int log_queue_claim(unsigned *pos, unsigned *num)
+{
+	while(1)
+	{
+		unsigned tail = log_tail;
+		LOG_SLOT *first = &log_slots[tail%LOG_QUEUE_SIZE];
+		if(first->sequence != tail+1)
+			return 0;
+		log_barrier();
+		*num = first->num_slots;
+		if(log_atomic_compswap(&log_tail, tail, tail+*num) == tail)
+		{
+			*pos = tail;
+			return 1;
+		}
+	}
+}
+
+static int log_queue_pop(char *line)
+{
+	unsigned pos, num, i;
+
+	if(!log_queue_claim(&pos, &num))
+		return 0;
+
+	for(i = 0; i < num; i++)
+	{
+		LOG_SLOT *slot = &log_slots[(pos+i)%LOG_QUEUE_SIZE];
+		mem_copy(line + i*LOG_SLOT_SIZE, slot->data, LOG_SLOT_SIZE);
+		log_barrier();
+		slot->sequence = pos+i+LOG_QUEUE_SIZE;
+	}
+	return 1;
+}
+
+static void log_to_loggers(const char *line)
+{
+	int i;
+	for(i = 0; i < num_loggers; i++)
+		loggers[i](line);
+}
+
+static void log_thread_func(void *user)
+{
+	char line[LOG_MAX_LINE];
+	while(1)
+	{
+		unsigned dropped;
+
+		if(log_queue_pop(line))
+		{
+			log_to_loggers(line);
+			log_barrier();
+			log_written = log_tail;
+			continue;
+		}
+
+		// report it after the lines that made it into the queue
+		dropped = log_atomic_exchange(&log_dropped, 0);
+		if(dropped)
+		{
+			char timestr[80];
+			str_timestamp_format(timestr, sizeof(timestr), FORMAT_SPACE);
+			str_format(line, sizeof(line), "[%s][logger]: the log queue was full, dropped %u lines", timestr, dropped);
+			log_to_loggers(line);
+			continue;
+		}
+		if(log_stop)
+			break;
+
+#if defined(CONF_PLATFORM_MACOSX)
+		thread_sleep(10);
+#else
+		semaphore_wait(&log_semaphore);
+#endif
+		log_wake_pending = 0;
+		log_barrier();
+	}
+}
+
+// raw descriptors of the loggers for dbg_logger_write_queued
+static int log_fds[2];
+static int num_log_fds = 0;
+
+static void log_add_fd(int fd)
+{
+	if(num_log_fds < (int)(sizeof(log_fds)/sizeof(log_fds[0])))
+		log_fds[num_log_fds++] = fd;
+}
+
+void dbg_logger_write_queued()
+{
+#if defined(CONF_FAMILY_UNIX)
+	char line[LOG_MAX_LINE+1];
+	unsigned pos, num, i;
+	int len, f;
+
+	if(!log_running)
+		return;
 
+	while(log_queue_claim(&pos, &num))
+	{
+		len = 0;
+		for(i = 0; i < num; i++)
+		{
+			const char *data = log_slots[(pos+i)%LOG_QUEUE_SIZE].data;
+			int k;
+			for(k = 0; k < LOG_SLOT_SIZE && data[k] && len < LOG_MAX_LINE; k++)
+				line[len++] = data[k];
+		}
+		line[len++] = '\n';
+		for(f = 0; f < num_log_fds; f++)
+		{
+			// nothing can be done about errors while crashing
+			if(write(log_fds[f], line, len) != len)
+				continue;
+		}
+	}
+#endif
+}
+
+void dbg_logger_async_start()
+{
+	static int installed = 0;
+	unsigned i;
+
+	if(log_running)
+		return;
+
+	for(i = 0; i < LOG_QUEUE_SIZE; i++)
+		log_slots[i].sequence = i;
+	log_head = 0;
+	log_tail = 0;
+	log_written = 0;
+	log_stop = 0;
+	log_wake_pending = 0;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_init(&log_semaphore);
+#endif
+	log_barrier();
+
+	log_thread = thread_init(log_thread_func, 0);
+	if(!log_thread)
+	{
+#if !defined(CONF_PLATFORM_MACOSX)
+		semaphore_destroy(&log_semaphore);
+#endif
+		dbg_msg("dbg/logger", "failed to start the log thread, logging synchronously");
+		return;
+	}
+	log_running = 1;
+
+	if(!installed)
+	{
+		// write out what is queued when leaving main
+		atexit(dbg_logger_async_stop);
+		installed = 1;
+	}
+}
+
+void dbg_logger_async_stop()
+{
+	char line[LOG_MAX_LINE];
+
+	if(!log_running)
+		return;
+
+	log_stop = 1;
+	log_barrier();
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_signal(&log_semaphore);
+#endif
+	thread_wait(log_thread);
+	log_thread = 0;
+	log_running = 0;
+	log_barrier();
+
+	// lines that came in while the thread was stopping
+	while(log_queue_pop(line))
+		log_to_loggers(line);
+	log_written = log_tail;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_destroy(&log_semaphore);
+#endif
+}
+
+void dbg_logger_flush()
+{
+	unsigned target, written;
+	int64 last_progress;
+
+	if(!log_running)
+		return;
+
+	target = log_head;
+	written = log_written;
+	last_progress = time_get();
+	log_wake();
+	while((int)(log_written - target) < 0)
+	{
+		// give up if the writer is stuck, or if it is the caller
+		if(log_written != written)
+		{
+			written = log_written;
+			last_progress = time_get();
+		}
+		else if(time_get() - last_progress > time_freq())
+			break;
+		thread_sleep(1);
+	}
+}
+
+static void log_line(int level, const char *line)
+{
+	if(log_running)
+	{
+		int len = str_length(line);
+		if(log_queue_push(line, len))
+			return;
+		if(level != LOG_LEVEL_ERROR)
+		{
+			log_atomic_inc(&log_dropped);
+			return;
+		}
+		// errors wait for room to stay in order
+		dbg_logger_flush();
+		if(log_queue_push(line, len))
+			return;
+	}
+	log_to_loggers(line);
+}
+
+static void log_msg_va(int level, const char *sys, const char *fmt, va_list args)
+{
+	char str[LOG_MAX_LINE];
+	char *msg;
+	int len;
+	unsigned suppressed;
 	char timestr[80];
+
+	if(!log_filter_pass(level, sys, &suppressed))
+		return;
+
 	str_timestamp_format(timestr, sizeof(timestr), FORMAT_SPACE);
+	if(suppressed)
+	{
+		str_format(str, sizeof(str), "[%s][%s]: suppressed %u messages", timestr, sys, suppressed);
+		log_line(LOG_LEVEL_WARN, str);
+	}
 
 	str_format(str, sizeof(str), "[%s][%s]: ", timestr, sys);
 
 	len = strlen(str);
 	msg = (char *)str + len;
 
-	va_start(args, fmt);
 #if defined(CONF_FAMILY_WINDOWS) && !defined(__GNUC__)
 	_vsprintf_p(msg, sizeof(str)-len, fmt, args);
 #else
 	vsnprintf(msg, sizeof(str)-len, fmt, args);
 #endif
+
+	log_line(level, str);
+}
+
+void dbg_msg(const char *sys, const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	log_msg_va(LOG_LEVEL_INFO, sys, fmt, args);
 	va_end(args);
+}
 
-	for(i = 0; i < num_loggers; i++)
-		loggers[i](str);
+void dbg_msg_level(int level, const char *sys, const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	log_msg_va(level, sys, fmt, args);
+	va_end(args);
 }
 
 #if defined(CONF_FAMILY_WINDOWS)
@@ -237,6 +736,9 @@ void dbg_logger_stdout()
 	}
 #endif
 	dbg_logger(logger_stdout);
+#if defined(CONF_FAMILY_UNIX)
+	log_add_fd(STDOUT_FILENO);
+#endif
 }
 
 void dbg_logger_debugger() { dbg_logger(logger_debugger); }
@@ -244,7 +746,12 @@ void dbg_logger_file(const char *filename)
 {
 	logfile = io_open(filename, IOFLAG_WRITE);
 	if(logfile)
+	{
 		dbg_logger(logger_file);
+#if defined(CONF_FAMILY_UNIX)
+		log_add_fd(fileno((FILE *)logfile));
+#endif
+	}
 	else
 		dbg_msg("dbg/logger", "failed to open '%s' for logging", filename);
 
@@ -1200,6 +1707,163 @@ int net_udp_recv(NETSOCKET sock, NETADDR *addr, void *data, int maxsize)
 	return -1; /* error */
 }
 
+#if defined(CONF_PLATFORM_LINUX)
+enum
+{
+	NET_MMSG_MAX = 64
+};
+
+static int priv_net_udp_send_mmsg(int sock, int type, const NETDATAGRAM *packets, int num)
+{
+	struct mmsghdr msgs[NET_MMSG_MAX];
+	struct iovec iovecs[NET_MMSG_MAX];
+	union
+	{
+		struct sockaddr_in in;
+		struct sockaddr_in6 in6;
+	} addrs[NET_MMSG_MAX];
+	int i, sent = 0, next = 0;
+
+	mem_zero(msgs, sizeof(struct mmsghdr)*num);
+	for(i = 0; i < num; i++)
+	{
+		if(type == NETTYPE_IPV4)
+		{
+			netaddr_to_sockaddr_in(&packets[i].addr, &addrs[i].in);
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i].in);
+		}
+		else
+		{
+			netaddr_to_sockaddr_in6(&packets[i].addr, &addrs[i].in6);
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i].in6);
+		}
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		iovecs[i].iov_base = packets[i].data;
+		iovecs[i].iov_len = packets[i].size;
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while(next < num)
+	{
+		int d = sendmmsg(sock, msgs+next, num-next, 0);
+		if(d <= 0)
+		{
+			/* the first datagram failed, skip it and keep sending the rest */
+			next++;
+			continue;
+		}
+		for(i = next; i < next+d; i++)
+			network_stats.sent_bytes += msgs[i].msg_len;
+		network_stats.sent_packets += d;
+		sent += d;
+		next += d;
+	}
+	return sent;
+}
+#endif
+
+int net_udp_send_batch(NETSOCKET sock, const NETDATAGRAM *packets, int num)
+{
+	int sent = 0;
+#if defined(CONF_PLATFORM_LINUX)
+	int next = 0;
+	while(next < num)
+	{
+		/* collect a run of unicast packets going out over the same socket */
+		unsigned type = packets[next].addr.type;
+		int s = type == NETTYPE_IPV4 ? sock.ipv4sock : type == NETTYPE_IPV6 ? sock.ipv6sock : -1;
+		int run = 0;
+		while(s >= 0 && next+run < num && run < NET_MMSG_MAX && packets[next+run].addr.type == type)
+			run++;
+
+		if(run == 0)
+		{
+			/* broadcasts and the like take the regular path */
+			if(net_udp_send(sock, &packets[next].addr, packets[next].data, packets[next].size) >= 0)
+				sent++;
+			next++;
+			continue;
+		}
+
+		sent += priv_net_udp_send_mmsg(s, type, packets+next, run);
+		next += run;
+	}
+#else
+	int i;
+	for(i = 0; i < num; i++)
+	{
+		if(net_udp_send(sock, &packets[i].addr, packets[i].data, packets[i].size) >= 0)
+			sent++;
+	}
+#endif
+	return sent;
+}
+
+#if defined(CONF_PLATFORM_LINUX)
+static int priv_net_udp_recv_mmsg(int sock, NETDATAGRAM *packets, int num, int maxsize)
+{
+	struct mmsghdr msgs[NET_MMSG_MAX];
+	struct iovec iovecs[NET_MMSG_MAX];
+	struct sockaddr_storage addrs[NET_MMSG_MAX];
+	int i, d;
+
+	if(num > NET_MMSG_MAX)
+		num = NET_MMSG_MAX;
+
+	mem_zero(msgs, sizeof(struct mmsghdr)*num);
+	for(i = 0; i < num; i++)
+	{
+		iovecs[i].iov_base = packets[i].data;
+		iovecs[i].iov_len = maxsize;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	d = recvmmsg(sock, msgs, num, MSG_DONTWAIT, 0);
+	for(i = 0; i < d; i++)
+	{
+		sockaddr_to_netaddr((struct sockaddr *)&addrs[i], &packets[i].addr);
+		packets[i].size = msgs[i].msg_len;
+		network_stats.recv_bytes += msgs[i].msg_len;
+	}
+	if(d > 0)
+		network_stats.recv_packets += d;
+	return d;
+}
+#endif
+
+int net_udp_recv_batch(NETSOCKET sock, NETDATAGRAM *packets, int num, int maxsize)
+{
+	int received = 0;
+#if defined(CONF_PLATFORM_LINUX)
+	if(sock.ipv4sock >= 0)
+	{
+		int d = priv_net_udp_recv_mmsg(sock.ipv4sock, packets, num, maxsize);
+		if(d > 0)
+			received += d;
+	}
+	if(received < num && sock.ipv6sock >= 0)
+	{
+		int d = priv_net_udp_recv_mmsg(sock.ipv6sock, packets+received, num-received, maxsize);
+		if(d > 0)
+			received += d;
+	}
+#else
+	while(received < num)
+	{
+		int bytes = net_udp_recv(sock, &packets[received].addr, packets[received].data, maxsize);
+		if(bytes <= 0)
+			break;
+		packets[received].size = bytes;
+		received++;
+	}
+#endif
+	return received;
+}
+
 int net_udp_close(NETSOCKET sock)
 {
 	return priv_net_close_all_sockets(sock);
@@ -78,6 +78,31 @@ void dbg_break();
 void dbg_msg(const char *sys, const char *fmt, ...)
 GNUC_ATTRIBUTE((format(printf, 2, 3)));
 
+enum
+{
+	LOG_LEVEL_ERROR=0,
+	LOG_LEVEL_WARN,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_DEBUG,
+	NUM_LOG_LEVELS,
+};
+
+/*
+	Function: dbg_msg_level
+		Prints a debug message with a log level, <dbg_msg> uses
+		LOG_LEVEL_INFO.
+
+	Parameters:
+		level - One of the LOG_LEVEL_* values.
+		sys - A string that describes what system the message belongs to
+		fmt - A printf styled format string.
+
+	See Also:
+		<dbg_logger_level>
+*/
+void dbg_msg_level(int level, const char *sys, const char *fmt, ...)
+GNUC_ATTRIBUTE((format(printf, 3, 4)));
+
 /* Group: Memory */
 
 /*
@@ -556,6 +581,13 @@ typedef struct
 	unsigned short port;
 } NETADDR;
 
+typedef struct
+{
+	NETADDR addr;
+	void *data;
+	int size;
+} NETDATAGRAM;
+
 /*
 	Function: net_init
 		Initiates network functionallity.
@@ -686,6 +718,40 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 */
 int net_udp_recv(NETSOCKET sock, NETADDR *addr, void *data, int maxsize);
 
+/*
+	Function: net_udp_send_batch
+		Sends several packets over an UDP socket, using as few
+		syscalls as the platform allows.
+
+	Parameters:
+		sock - Socket to use.
+		packets - Packets to send, addr, data and size have to be set.
+		num - Number of packets.
+
+	Returns:
+		The number of packets that were handed to the socket. A packet
+		that can't be sent is skipped, the ones after it are still sent.
+*/
+int net_udp_send_batch(NETSOCKET sock, const NETDATAGRAM *packets, int num);
+
+/*
+	Function: net_udp_recv_batch
+		Recives several packets over an UDP socket, using as few
+		syscalls as the platform allows.
+
+	Parameters:
+		sock - Socket to use.
+		packets - Packets to fill, data has to point to a buffer of
+			maxsize bytes. addr and size will be set.
+		num - Maximum number of packets to recive.
+		maxsize - Size of each buffer.
+
+	Returns:
+		The number of packets recived, 0 if there was nothing to
+		recive.
+*/
+int net_udp_recv_batch(NETSOCKET sock, NETDATAGRAM *packets, int num, int maxsize);
+
 /*
 	Function: net_udp_close
 		Closes an UDP socket.
@@ -1398,6 +1464,63 @@ void dbg_logger_stdout();
 void dbg_logger_debugger();
 void dbg_logger_file(const char *filename);
 
+/*
+	Function: dbg_logger_level
+		Sets the most verbose level that is logged for a system.
+
+	Parameters:
+		sys - The system, 0 sets the default of all systems.
+		level - One of the LOG_LEVEL_* values, -1 makes the system use
+			the default again.
+*/
+void dbg_logger_level(const char *sys, int level);
+
+/*
+	Function: dbg_logger_rate_limit
+		Limits how many lines every system can log per second, errors
+		are never dropped. The number of dropped lines is logged once
+		the system logs again. 0 disables the limit.
+*/
+void dbg_logger_rate_limit(int lines_per_second);
+
+/*
+	Function: dbg_logger_async_start
+		Hands the log lines to a background thread instead of calling
+		the loggers on the logging thread, so a slow terminal or log
+		file doesn't stall the caller. If the queue is full, lines are
+		dropped and counted, errors wait until the thread made room.
+
+	Remarks:
+		The loggers must not be changed while the thread runs. The
+		queue is flushed on exit, crash handlers of the application
+		can write it out with <dbg_logger_write_queued>.
+*/
+void dbg_logger_async_start();
+
+/*
+	Function: dbg_logger_write_queued
+		Writes the lines still in the queue straight to stdout and the
+		log file. It only calls write(), never waits and takes no
+		locks, so it is safe to call from a signal handler.
+
+	Remarks:
+		Does nothing on Windows. A line the thread is writing at the
+		same time may be lost.
+*/
+void dbg_logger_write_queued();
+
+/*
+	Function: dbg_logger_async_stop
+		Writes out the queued lines and stops the background thread.
+*/
+void dbg_logger_async_stop();
+
+/*
+	Function: dbg_logger_flush
+		Waits until the lines logged so far went to the loggers.
+*/
+void dbg_logger_flush();
+
 #if defined(CONF_FAMILY_WINDOWS)
 void dbg_console_init();
 void dbg_console_cleanup();
@@ -1423,6 +1546,23 @@ unsigned str_quickhash(const char *str);
 struct SKELETON;
 void str_utf8_skeleton_begin(struct SKELETON* skel, const char* str);
 int str_utf8_skeleton_next(struct SKELETON* skel);
+
+/*
+	Function: str_utf8_to_skeleton
+		Converts a string to the code points of its visual appearance.
+		Two strings are confusable if their skeletons are equal, so
+		skeletons that are kept around can be compared with mem_comp.
+
+	Parameters:
+		str - String to convert.
+		buf - Buffer for the code points.
+		buf_len - Length of the buffer in code points. A byte of the
+			string gives at most 5 code points.
+
+	Returns:
+		Number of code points written, the skeleton is cut off at
+		buf_len.
+*/
 int str_utf8_to_skeleton(const char* str, int* buf, int buf_len);
 
 /*
@@ -1,16 +1,30 @@
 #include "confusables_data.h"
+#include "confusables_index.h"
 
 #include "../system.h"
 
 #include <stddef.h>
 
+static int popcount32(uint32_t x)
+{
+	x = x - ((x >> 1) & 0x55555555);
+	x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+	x = (x + (x >> 4)) & 0x0f0f0f0f;
+	return (x * 0x01010101) >> 24;
+}
+
 static int str_utf8_skeleton(int ch, const int **skeleton, int *skeleton_len)
 {
-	int i;
-	for(i = 0; i < NUM_DECOMPS; i++)
+	if(ch >= 0 && (ch >> CONFUSABLE_PAGE_SHIFT) < NUM_CONFUSABLE_BLOCKS)
 	{
-		if(ch == decomp_chars[i])
+		int page = confusable_blocks[ch >> CONFUSABLE_PAGE_SHIFT];
+		int word = (ch >> 5) & (NUM_CONFUSABLE_WORDS - 1);
+		uint32_t bit = (uint32_t)1 << (ch & 31);
+		uint32_t bits = confusable_bits[page][word];
+		if(bits & bit)
 		{
+			// the decompositions are sorted, count the ones before this one
+			int i = confusable_base[page][word] + popcount32(bits & (bit - 1));
 			int offset = decomp_slices[i].offset;
 			int length = decomp_lengths[decomp_slices[i].length];
 
@@ -18,10 +32,6 @@ static int str_utf8_skeleton(int ch, const int **skeleton, int *skeleton_len)
 			*skeleton_len = length;
 			return 1;
 		}
-		else if(ch < decomp_chars[i])
-		{
-			break;
-		}
 	}
 	*skeleton = NULL;
 	*skeleton_len = 1;
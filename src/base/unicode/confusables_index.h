@@ -0,0 +1,622 @@
+#include <stdint.h>
+
+// generated by scripts/generate_unicode_confusables_index.py
+
+enum
+{
+	CONFUSABLE_PAGE_SHIFT=8,
+	NUM_CONFUSABLE_BLOCKS=4352,
+	NUM_CONFUSABLE_PAGES=165,
+	NUM_CONFUSABLE_WORDS=8,
+};
+
+static const uint8_t confusable_blocks[NUM_CONFUSABLE_BLOCKS] = {
+	1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+	17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+	33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+	49, 50, 51, 52, 0, 0, 0, 0, 0, 53, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 54, 55, 0, 0, 0, 0, 0, 0, 0, 0, 0, 56, 0,
+	57, 0, 0, 0, 0, 58, 59, 0, 60, 0, 0, 61, 0, 0, 62, 0,
+	0, 0, 63, 0, 64, 0, 65, 66, 0, 67, 68, 0, 0, 0, 0, 69,
+	0, 0, 0, 0, 0, 0, 0, 0, 70, 0, 0, 0, 0, 71, 0, 0,
+	72, 73, 0, 0, 0, 74, 75, 0, 0, 0, 76, 77, 78, 79, 80, 81,
+	82, 0, 0, 83, 0, 0, 84, 0, 0, 0, 0, 0, 0, 0, 85, 86,
+	0, 0, 0, 0, 87, 0, 88, 89, 90, 91, 92, 93, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 94, 95, 0, 0, 96, 97, 0, 0, 98,
+	99, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 100, 101, 102, 103, 104, 105, 106, 107,
+	0, 108, 109, 110, 111, 112, 0, 0, 0, 0, 113, 0, 114, 115, 0, 116,
+	117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 0, 128, 129, 130, 0,
+	131, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 132, 0, 133, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 134, 135, 0, 0, 0, 136,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 137, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 138, 139, 0, 140, 141, 142, 143, 0, 0, 144, 0, 0, 0, 0, 0,
+	145, 146, 147, 0, 0, 0, 0, 0, 148, 149, 0, 0, 0, 0, 150, 0,
+	0, 151, 152, 153, 0, 0, 0, 154, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 155,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 156, 157, 158, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	159, 160, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	161, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 162,
+	163, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 164,
+};
+
+static const uint32_t confusable_bits[NUM_CONFUSABLE_PAGES][NUM_CONFUSABLE_WORDS] = {
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0xffffffff, 0x00030025, 0x00000200, 0x90003001, 0xffffffff, 0x0130a025, 0x3fffffff, 0xbf7fffff},
+	{0xffffffff, 0xfeffffff, 0xfffff3ff, 0xffffffff, 0xe7ce369f, 0xb8f9f0f3, 0xdffffffb, 0xff3fffff},
+	{0xdfffffff, 0x500ffffc, 0x0ecae3d2, 0x306aef4b, 0x00158804, 0xfe080ff9, 0x3f890d5c, 0x09504016},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xecf1ffff, 0xbfe7d7f0, 0xa7bffcba, 0x187f7c7a, 0xa7bf0300},
+	{0xfeaf71fb, 0xf7af583f, 0x79fb9c3f, 0x30ff000e, 0xcfcf3ff8, 0xe807fc0c, 0xffffffe7, 0x033fffff},
+	{0x38033402, 0x08000000, 0x2428b410, 0x3521404a, 0xfffe02b2, 0xbfffffff, 0x832000bf, 0x001f0002},
+	{0x17ffa63f, 0xa01008fc, 0xfffffc80, 0x43edfda3, 0xc1064922, 0x6cb02790, 0xbfff5bcf, 0xe3fffd9f},
+	{0x0002801e, 0xffff0000, 0x004207ff, 0x4006138c, 0x00000000, 0x0001ffc0, 0x00000401, 0x243ff800},
+	{0xfbc00000, 0x00003eef, 0x0e000000, 0x00000000, 0x00000000, 0x3ec7c392, 0xfff80000, 0xffffffff},
+	{0x001f615f, 0xdc120200, 0xfffeffff, 0x200000ec, 0x0000004e, 0xd0000000, 0xb080399f, 0x4000244f},
+	{0x001187ce, 0xd0480000, 0x4e023987, 0x002304c0, 0x001ba04e, 0xf0000000, 0x00003bbf, 0xfc01474c},
+	{0x0000004e, 0xd0000001, 0x30c0399f, 0x0000014c, 0x10100404, 0xc0010000, 0x00803dc7, 0x05b57dc0},
+	{0x0018001f, 0xc2806025, 0x00603ddf, 0x0000004f, 0x501c00ee, 0xd0068008, 0x00603ddf, 0x000081ce},
+	{0x1219170f, 0xdc520009, 0x84807ddf, 0x1a40fc4e, 0x0000000c, 0x00000000, 0xff5f8400, 0x000c8e00},
+	{0x00b08808, 0x07fa0042, 0x00017fa2, 0x00000000, 0xec002100, 0x1ffa0000, 0x30013f00, 0x00000000},
+	{0xcb00500d, 0xc2a00000, 0x10842008, 0xfffe0600, 0xfeffe0df, 0x1fffffff, 0x00604040, 0x00000000},
+	{0xa0010001, 0x7ffffe40, 0xc3c00801, 0x401fbffd, 0x7c00bffe, 0x00000001, 0x00000000, 0x80080080},
+	{0xfff82512, 0xafffffff, 0x7dceaffe, 0xfffb9d54, 0xbfffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0x00000001, 0x00000008, 0x00000001, 0x00000001, 0x00100000, 0x00000000, 0x00010000, 0x00000000},
+	{0x00000000, 0x00000000, 0xe0000000, 0x00000000, 0x00000000, 0xe88b5f37, 0xc634d88d, 0x181d48c4},
+	{0x07bff009, 0xfd8af880, 0xff9054ff, 0xfffca79f, 0xfffc21e3, 0x83fff420, 0xf0027e00, 0xffc003ff},
+	{0xff80f00f, 0x1fff801f, 0x1800c003, 0xf0800300, 0x001fc0bf, 0x00b08000, 0x40000030, 0x00818400},
+	{0x0000009c, 0x0030c01c, 0x00000000, 0x3fffe000, 0x00000001, 0x00840000, 0x01601006, 0x00013802},
+	{0x001c0000, 0x003c0000, 0x000c0000, 0x000c0000, 0x00000000, 0xfff00008, 0x263fffff, 0x00000000},
+	{0x00007a08, 0x00000000, 0x00200000, 0x00000000, 0x00400060, 0x02480200, 0x380fffc4, 0x00052539},
+	{0x00000000, 0x0fff0fff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00030000, 0x00000000},
+	{0x0f800000, 0x00000000, 0x7fe00000, 0x9fffffff, 0x00010001, 0x7fff0a00, 0x00000000, 0x00000000},
+	{0x0004555f, 0xfff00000, 0x910c001f, 0x000ff800, 0x00000007, 0x00003ffe, 0x00000000, 0x000fffc0},
+	{0x00000000, 0x10fffff0, 0x00000000, 0x80000000, 0x00000000, 0x00000000, 0xffff0000, 0x039021ff},
+	{0x1013a910, 0x40000bd7, 0x00040000, 0xf97dc800, 0x80011008, 0x0c000004, 0xffffffff, 0xfbffffff},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x2fffffff, 0xffffffff, 0xffffffff, 0x83ffffff},
+	{0x3f3fffff, 0xffffffff, 0xaaff3f3f, 0x3fffffff, 0xffffffff, 0xffdfffff, 0xefcfffdf, 0x7fdcffff},
+	{0xbf7fffff, 0x56fffff4, 0xe48c439a, 0x0201ffdf, 0x00000000, 0x20407b32, 0xffff0000, 0x0001ffff},
+	{0x3e6fffef, 0xfbfbffd2, 0x000003ef, 0xffffffff, 0x0c220018, 0xc0204000, 0x0000e000, 0x00000000},
+	{0x43f69259, 0x1141bf78, 0x46830292, 0x0333ec0d, 0x2260033f, 0x0000f030, 0x03c0013f, 0x8010fc0f},
+	{0x00000001, 0x00000620, 0x96000002, 0x87f81b3e, 0x90000000, 0x00004424, 0x0000004e, 0x70000100},
+	{0x00000000, 0x00000000, 0x00000400, 0xfff003ff, 0xffffffff, 0x013fffff, 0x080000a0, 0x00000000},
+	{0x0000800b, 0x00000008, 0x00000000, 0x000a0000, 0x20910100, 0x258a0001, 0x00004c82, 0x00000041},
+	{0x00010200, 0x01010020, 0x00004000, 0x00000604, 0x00000000, 0x00001000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x003cc300, 0x00e00000, 0x00000000, 0x02002b04, 0x00000300},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00001800, 0x00000000, 0x0000c028, 0x02000000, 0x40010000, 0x024000b0, 0x03700000},
+	{0x2000107f, 0xe00186ff, 0x00000000, 0x00704400, 0x00000000, 0x00000c20, 0x10800000, 0x28000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000f000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000280, 0xc5744370, 0x34127d7d, 0x10073440, 0x02038210},
+	{0x00000000, 0x07820000, 0x22328302, 0x80000009, 0x00000000, 0x00000000, 0x00000000, 0xffffffff},
+	{0xc4000000, 0xa2275fc0, 0x00000001, 0x00000000, 0xcbddca2c, 0xc606a95f, 0xbf5fbb3f, 0x000dfb35},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x003fffff, 0x00000000},
+	{0x0c34038d, 0x0748fc00, 0x5555d000, 0x36db02a5, 0x5e100000, 0xd5555911, 0x37dbcba5, 0x4f902000},
+	{0x00000000, 0xfffe0000, 0xffffffff, 0xffffffff, 0x00007fff, 0x00000000, 0x8c5b0000, 0x00000001},
+	{0x7fffffff, 0xffffffff, 0x0000000f, 0x00000000, 0x00000000, 0x00000000, 0x00000fff, 0x00000000},
+	{0x00000000, 0x00000000, 0xff000000, 0x0001ffff, 0x00000000, 0x00000000, 0x00000000, 0x7fffffff},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00080000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x08000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000001, 0x80400000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000004, 0x10000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x80000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00800000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000800, 0x00000000, 0x00000000, 0x00000000, 0x80000800},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00040000, 0x00010000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x01000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000200, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000208, 0x00000000, 0x00000000, 0x00000000, 0x00400000},
+	{0x00000000, 0x00000040, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000200},
+	{0x00000000, 0x00000080, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x02000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00008000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00400000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000040, 0x00010400, 0x00400000},
+	{0x00000002, 0x00000080, 0x00000002, 0x00000000, 0x00000000, 0x00000080, 0x00000000, 0x00000000},
+	{0x00000000, 0x80000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000002, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x40000000, 0x00000000, 0x00000000, 0x20000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00008000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000008, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000040, 0x00000000, 0x00000000, 0x04000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x08000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000080, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x40000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00004000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x01000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000008, 0x00000000, 0x00000000, 0x00000000, 0x00040000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000008, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x50100000, 0xc4011180, 0xfedf0005, 0xefbffcef},
+	{0x00004000, 0x00000000, 0x000320b0, 0x7ff78100, 0xc7200000, 0x00030002, 0x88006000, 0x00138800},
+	{0x00500000, 0x3ffe0300, 0x0400cc01, 0x05804c02, 0xef209200, 0x00fe0800, 0x00000000, 0x00800000},
+	{0x00000844, 0x000100f8, 0x00000000, 0x00000000, 0x00000003, 0xfff00000, 0x0000003f, 0x8003ffff},
+	{0x00000000, 0x00003fc0, 0x000fff80, 0x1fffffff, 0x0004000f, 0xfff80008, 0x00008041, 0x00000020},
+	{0x00000000, 0x007ffe00, 0x00483008, 0x38000000, 0x00000000, 0xc19d0000, 0x00000002, 0x0060f800},
+	{0x00000000, 0xe0240000, 0x042c6186, 0x5c37000d, 0x9809488b, 0x0844c604, 0x00000000, 0x000037f8},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xffff0000, 0xfffff87f, 0x0fffffff},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x00000001, 0x00000000, 0x00000000, 0x80000000},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0x7fe53fff, 0xfffffc65, 0xffffffff, 0xffff3fff, 0xffffffff, 0xffffffff, 0x03ffffff, 0x00000000},
+	{0xe0f8005f, 0x5f7fffff, 0xffffffdb, 0xffffffff, 0xffffffff, 0x0003ffff, 0xfff80000, 0xffffffff},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0xffffffff, 0xffffffff, 0xffff0000, 0xffffffff, 0xfffcffff, 0xffffffff, 0x000000ff, 0x1fff0000},
+	{0x0200ffff, 0x07f3ffff, 0x0100fe00, 0x00000100, 0xffffffff, 0xffffffff, 0xffffffff, 0x9fffffff},
+	{0x04002086, 0x7f19ef2e, 0x534997ab, 0x00000020, 0x00000000, 0x00000000, 0x00000000, 0x1e002108},
+	{0x00000002, 0x00000000, 0x00000000, 0x00000000, 0x03c04000, 0x00000001, 0x00000000, 0x20000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x08f524e4, 0x017f282f, 0x00008000, 0x00240113},
+	{0x84a60206, 0x00000005, 0x00000000, 0x07c00000, 0x00000000, 0x00000000, 0x000a0000, 0x00000000},
+	{0x88220012, 0xa0001629, 0x0000290c, 0x00000000, 0x00000000, 0x10110001, 0x0907601c, 0x02400c00},
+	{0x31480000, 0x000000e0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x0000f06e, 0x87000000, 0x00810000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000060},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x14000000},
+	{0x00000000, 0x000000f0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x0001ffc0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000007, 0xff000000, 0x0000007f, 0x80000000, 0x14000007, 0x2fff0800, 0x00002000, 0x00000000},
+	{0x00000007, 0x001fff80, 0x00000060, 0x00080000, 0x00000007, 0xfff80000, 0x58001e81, 0x00000000},
+	{0x00000000, 0x40fff000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x80000000, 0x000007ff},
+	{0x0000000f, 0xd8000000, 0x0080399f, 0x001f1fcc, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x02080000, 0xffe0a410, 0x4000107f, 0x00000000, 0xeb540000, 0xffff6f8f, 0x0047003f, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xff3f8000, 0x3f000001, 0x00000000},
+	{0x00000000, 0xffff0000, 0x00000005, 0x00000000, 0x00000000, 0x00fff800, 0x00000000, 0x00000000},
+	{0xe000c441, 0x00000fff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x07fff000, 0x00000000, 0x00000000, 0x00000000, 0x19a4d35d, 0x11e0555f, 0x00049279},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xfcfe0000, 0x00000011},
+	{0x000007fe, 0x7bf80000, 0x0ffe0080, 0x00000000, 0x03fffc00, 0x00000000, 0x00000000, 0x01f077c0},
+	{0x00000000, 0xff7f8000, 0x00000004, 0x00000000, 0xfffc0000, 0x007ffeff, 0x00000000, 0x00000000},
+	{0x00000000, 0xb47e0000, 0x000000bf, 0x00000000, 0x00fb7c00, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00780000},
+	{0x00000000, 0x01000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x02000000},
+	{0x00000000, 0x01ff0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x001f0000},
+	{0x00000000, 0x007f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x14400580, 0xac202140, 0xfffe800d, 0xffffffff, 0x000780ff, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x60000000, 0x0000000f, 0x00000000, 0x00000000},
+	{0x00100000, 0x00000000, 0xc0000000, 0xffffe3ff, 0x00000fe7, 0xf8003c00, 0x00000001, 0x00000000},
+	{0x1cfca844, 0x8fc10c06, 0x0000003c, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0xffffffff, 0xffffffff, 0xffdfffff, 0xffffffff, 0xdfffffff, 0xebffde64, 0xffffffef, 0xffffffff},
+	{0xdfdfe7bf, 0x7bffffff, 0xfffdfc5f, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffff3f, 0xffffffff, 0xffffffff},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffcfff, 0xffffffff},
+	{0xffffffff, 0xf87fffff, 0xffffffff, 0x00201fff, 0xf8000010, 0x0000fffe, 0x00000000, 0x00000000},
+	{0xf9ffff7f, 0x000007db, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x007f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000f000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x007f3b80, 0x00000000},
+	{0x00000000, 0x00000000, 0x000007f0, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0xffffffef, 0x0af7fe96, 0xaa96ea84, 0x5ef7f796, 0x0ffffbff, 0x0ffffbee, 0x00000000, 0x00000000},
+	{0xffff07ff, 0x000007ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x000001ff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x03040000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00100597, 0x04000100, 0x50301000, 0x00021900, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000100},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+	{0x3fffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000002, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x0000ffff},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x20000000},
+	{0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+	{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x20000000},
+};
+
+static const uint16_t confusable_base[NUM_CONFUSABLE_PAGES][NUM_CONFUSABLE_WORDS] = {
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 32, 37, 38, 43, 75, 83, 113},
+	{143, 175, 206, 236, 268, 289, 309, 339},
+	{369, 400, 420, 436, 453, 459, 477, 493},
+	{501, 533, 565, 597, 623, 646, 669, 688},
+	{702, 726, 748, 770, 783, 806, 821, 851},
+	{875, 884, 885, 894, 904, 924, 955, 966},
+	{972, 994, 1004, 1027, 1047, 1057, 1070, 1096},
+	{1122, 1128, 1144, 1157, 1166, 1166, 1177, 1179},
+	{1192, 1201, 1213, 1216, 1216, 1216, 1233, 1246},
+	{1278, 1292, 1300, 1331, 1337, 1341, 1344, 1358},
+	{1366, 1377, 1382, 1395, 1401, 1411, 1415, 1427},
+	{1441, 1445, 1449, 1463, 1467, 1471, 1474, 1485},
+	{1500, 1507, 1516, 1530, 1535, 1546, 1553, 1567},
+	{1574, 1587, 1597, 1613, 1627, 1629, 1629, 1645},
+	{1651, 1657, 1668, 1679, 1679, 1686, 1697, 1706},
+	{1706, 1716, 1721, 1726, 1743, 1768, 1797, 1801},
+	{1801, 1805, 1828, 1836, 1856, 1875, 1876, 1876},
+	{1879, 1897, 1927, 1951, 1974, 2005, 2037, 2069},
+	{2101, 2102, 2103, 2104, 2105, 2106, 2106, 2107},
+	{2107, 2107, 2107, 2110, 2110, 2110, 2129, 2144},
+	{2155, 2171, 2187, 2208, 2233, 2254, 2271, 2282},
+	{2302, 2319, 2338, 2344, 2351, 2365, 2369, 2372},
+	{2376, 2380, 2387, 2387, 2404, 2405, 2407, 2413},
+	{2418, 2421, 2425, 2427, 2429, 2429, 2442, 2467},
+	{2467, 2473, 2473, 2474, 2474, 2477, 2481, 2499},
+	{2508, 2508, 2532, 2532, 2532, 2532, 2532, 2534},
+	{2534, 2539, 2539, 2549, 2579, 2581, 2598, 2598},
+	{2598, 2609, 2621, 2631, 2640, 2643, 2656, 2656},
+	{2670, 2670, 2691, 2691, 2692, 2692, 2692, 2708},
+	{2722, 2731, 2741, 2742, 2757, 2761, 2764, 2796},
+	{2827, 2859, 2891, 2923, 2955, 2984, 3016, 3048},
+	{3075, 3103, 3135, 3159, 3189, 3221, 3252, 3280},
+	{3308, 3338, 3363, 3377, 3394, 3394, 3405, 3421},
+	{3438, 3464, 3490, 3499, 3531, 3537, 3541, 3544},
+	{3544, 3560, 3575, 3585, 3599, 3611, 3617, 3628},
+	{3640, 3641, 3644, 3649, 3667, 3669, 3673, 3677},
+	{3681, 3681, 3681, 3682, 3704, 3736, 3759, 3762},
+	{3762, 3766, 3767, 3767, 3769, 3774, 3781, 3786},
+	{3788, 3790, 3793, 3794, 3797, 3797, 3798, 3798},
+	{3798, 3798, 3798, 3798, 3806, 3809, 3809, 3815},
+	{3817, 3818, 3818, 3818, 3818, 3818, 3818, 3818},
+	{3818, 3818, 3820, 3820, 3824, 3825, 3827, 3832},
+	{3837, 3846, 3861, 3861, 3866, 3866, 3869, 3871},
+	{3873, 3873, 3873, 3873, 3873, 3873, 3873, 3873},
+	{3877, 3877, 3877, 3877, 3879, 3893, 3910, 3918},
+	{3924, 3924, 3929, 3938, 3941, 3941, 3941, 3941},
+	{3973, 3976, 3991, 3992, 3992, 4010, 4026, 4051},
+	{4065, 4097, 4129, 4161, 4193, 4225, 4257, 4279},
+	{4279, 4290, 4301, 4312, 4327, 4333, 4348, 4368},
+	{4376, 4376, 4391, 4423, 4455, 4470, 4470, 4478},
+	{4479, 4510, 4542, 4546, 4546, 4546, 4546, 4558},
+	{4558, 4558, 4558, 4566, 4583, 4583, 4583, 4583},
+	{4614, 4614, 4614, 4614, 4614, 4614, 4615, 4615},
+	{4615, 4615, 4615, 4615, 4615, 4616, 4616, 4616},
+	{4616, 4616, 4617, 4617, 4617, 4617, 4617, 4617},
+	{4617, 4618, 4620, 4620, 4620, 4620, 4620, 4620},
+	{4620, 4621, 4622, 4622, 4622, 4622, 4622, 4622},
+	{4622, 4622, 4622, 4623, 4623, 4623, 4623, 4623},
+	{4623, 4623, 4623, 4623, 4623, 4623, 4623, 4624},
+	{4624, 4624, 4624, 4624, 4625, 4625, 4625, 4625},
+	{4627, 4628, 4628, 4628, 4628, 4628, 4628, 4628},
+	{4628, 4628, 4629, 4630, 4630, 4630, 4630, 4630},
+	{4630, 4630, 4631, 4631, 4631, 4631, 4631, 4631},
+	{4631, 4632, 4632, 4632, 4632, 4632, 4632, 4632},
+	{4632, 4632, 4632, 4632, 4634, 4634, 4634, 4634},
+	{4635, 4635, 4636, 4636, 4636, 4636, 4636, 4636},
+	{4637, 4637, 4637, 4637, 4637, 4637, 4637, 4637},
+	{4638, 4638, 4639, 4639, 4639, 4639, 4639, 4639},
+	{4639, 4639, 4639, 4640, 4640, 4640, 4640, 4640},
+	{4640, 4640, 4640, 4641, 4641, 4641, 4641, 4641},
+	{4641, 4641, 4641, 4641, 4642, 4642, 4642, 4642},
+	{4642, 4642, 4642, 4642, 4642, 4642, 4643, 4645},
+	{4646, 4647, 4648, 4649, 4649, 4649, 4650, 4650},
+	{4650, 4650, 4651, 4651, 4651, 4651, 4651, 4651},
+	{4651, 4651, 4651, 4652, 4652, 4652, 4652, 4652},
+	{4652, 4653, 4653, 4653, 4654, 4654, 4654, 4654},
+	{4654, 4654, 4654, 4654, 4654, 4655, 4655, 4655},
+	{4655, 4655, 4655, 4655, 4656, 4656, 4656, 4656},
+	{4656, 4656, 4656, 4656, 4656, 4657, 4657, 4657},
+	{4658, 4658, 4658, 4658, 4658, 4659, 4659, 4659},
+	{4659, 4659, 4660, 4660, 4660, 4660, 4660, 4660},
+	{4660, 4660, 4660, 4660, 4660, 4660, 4660, 4661},
+	{4661, 4661, 4661, 4661, 4661, 4661, 4662, 4662},
+	{4662, 4662, 4662, 4662, 4662, 4662, 4663, 4663},
+	{4663, 4663, 4663, 4664, 4664, 4664, 4664, 4665},
+	{4665, 4665, 4665, 4665, 4665, 4665, 4665, 4666},
+	{4666, 4666, 4666, 4666, 4666, 4669, 4676, 4692},
+	{4719, 4720, 4720, 4726, 4742, 4748, 4751, 4755},
+	{4760, 4762, 4777, 4783, 4790, 4801, 4809, 4809},
+	{4810, 4813, 4819, 4819, 4819, 4821, 4833, 4839},
+	{4858, 4858, 4866, 4879, 4908, 4913, 4927, 4930},
+	{4931, 4931, 4945, 4950, 4953, 4953, 4961, 4962},
+	{4969, 4969, 4974, 4984, 4996, 5007, 5015, 5015},
+	{5025, 5025, 5025, 5025, 5025, 5025, 5041, 5069},
+	{5097, 5098, 5098, 5098, 5098, 5098, 5098, 5098},
+	{5098, 5098, 5098, 5098, 5099, 5100, 5100, 5100},
+	{5101, 5102, 5102, 5102, 5102, 5102, 5102, 5102},
+	{5102, 5102, 5102, 5102, 5102, 5102, 5102, 5102},
+	{5103, 5104, 5104, 5104, 5104, 5104, 5104, 5104},
+	{5104, 5104, 5104, 5104, 5104, 5104, 5104, 5104},
+	{5105, 5137, 5169, 5201, 5233, 5265, 5297, 5329},
+	{5361, 5387, 5413, 5445, 5475, 5507, 5539, 5565},
+	{5565, 5579, 5608, 5638, 5670, 5702, 5720, 5733},
+	{5765, 5797, 5829, 5861, 5893, 5925, 5957, 5989},
+	{6021, 6053, 6085, 6101, 6133, 6163, 6195, 6203},
+	{6216, 6233, 6258, 6266, 6267, 6299, 6331, 6363},
+	{6393, 6398, 6419, 6436, 6437, 6437, 6437, 6437},
+	{6444, 6445, 6445, 6445, 6445, 6450, 6451, 6451},
+	{6452, 6452, 6452, 6452, 6452, 6465, 6480, 6481},
+	{6487, 6496, 6498, 6498, 6503, 6503, 6503, 6505},
+	{6505, 6511, 6519, 6524, 6524, 6524, 6528, 6538},
+	{6542, 6547, 6550, 6550, 6550, 6550, 6550, 6550},
+	{6550, 6559, 6563, 6565, 6565, 6565, 6565, 6565},
+	{6567, 6567, 6567, 6567, 6567, 6567, 6567, 6567},
+	{6569, 6569, 6573, 6573, 6573, 6573, 6573, 6573},
+	{6573, 6573, 6573, 6584, 6584, 6584, 6584, 6584},
+	{6584, 6587, 6595, 6602, 6603, 6608, 6622, 6623},
+	{6623, 6626, 6640, 6642, 6643, 6646, 6659, 6668},
+	{6668, 6668, 6681, 6681, 6681, 6681, 6681, 6682},
+	{6693, 6697, 6701, 6712, 6726, 6726, 6726, 6726},
+	{6726, 6728, 6743, 6752, 6752, 6761, 6788, 6798},
+	{6798, 6798, 6798, 6798, 6798, 6798, 6813, 6820},
+	{6820, 6820, 6836, 6838, 6838, 6838, 6851, 6851},
+	{6851, 6859, 6871, 6871, 6871, 6871, 6871, 6871},
+	{6871, 6871, 6886, 6886, 6886, 6886, 6902, 6917},
+	{6926, 6926, 6926, 6926, 6926, 6926, 6926, 6939},
+	{6941, 6951, 6962, 6974, 6974, 6990, 6990, 6990},
+	{7003, 7003, 7019, 7020, 7020, 7034, 7056, 7056},
+	{7056, 7056, 7066, 7073, 7073, 7085, 7085, 7085},
+	{7085, 7085, 7085, 7085, 7085, 7085, 7085, 7085},
+	{7089, 7089, 7090, 7090, 7090, 7090, 7090, 7090},
+	{7090, 7090, 7090, 7090, 7090, 7090, 7090, 7090},
+	{7091, 7091, 7100, 7100, 7100, 7100, 7100, 7100},
+	{7100, 7100, 7100, 7100, 7100, 7100, 7100, 7100},
+	{7105, 7105, 7112, 7112, 7112, 7112, 7112, 7112},
+	{7112, 7118, 7126, 7145, 7177, 7189, 7189, 7189},
+	{7189, 7189, 7189, 7189, 7189, 7191, 7195, 7195},
+	{7195, 7196, 7196, 7198, 7227, 7237, 7246, 7247},
+	{7247, 7261, 7273, 7277, 7277, 7277, 7277, 7277},
+	{7277, 7309, 7341, 7372, 7404, 7435, 7458, 7489},
+	{7521, 7548, 7578, 7605, 7637, 7669, 7701, 7733},
+	{7765, 7797, 7829, 7861, 7893, 7925, 7955, 7987},
+	{8019, 8051, 8083, 8115, 8147, 8179, 8211, 8241},
+	{8273, 8305, 8333, 8365, 8379, 8385, 8400, 8400},
+	{8400, 8429, 8438, 8438, 8438, 8438, 8438, 8438},
+	{8438, 8438, 8445, 8445, 8445, 8445, 8445, 8445},
+	{8445, 8445, 8445, 8445, 8445, 8445, 8445, 8445},
+	{8449, 8449, 8449, 8449, 8449, 8449, 8449, 8462},
+	{8462, 8462, 8462, 8469, 8469, 8469, 8469, 8469},
+	{8469, 8500, 8520, 8535, 8558, 8585, 8610, 8610},
+	{8610, 8637, 8648, 8648, 8648, 8648, 8648, 8648},
+	{8648, 8648, 8648, 8657, 8657, 8657, 8657, 8657},
+	{8657, 8660, 8660, 8660, 8660, 8660, 8660, 8660},
+	{8660, 8668, 8670, 8675, 8679, 8679, 8679, 8679},
+	{8679, 8679, 8679, 8679, 8679, 8679, 8679, 8679},
+	{8680, 8712, 8744, 8776, 8808, 8840, 8872, 8904},
+	{8936, 8968, 9000, 9032, 9064, 9096, 9128, 9160},
+	{9192, 9222, 9222, 9222, 9222, 9222, 9222, 9222},
+	{9222, 9223, 9255, 9287, 9319, 9319, 9319, 9319},
+	{9319, 9351, 9383, 9415, 9447, 9479, 9511, 9543},
+	{9559, 9560, 9560, 9560, 9560, 9560, 9560, 9560},
+	{9560, 9560, 9560, 9560, 9560, 9560, 9560, 9560},
+	{9561, 9562, 9562, 9562, 9562, 9562, 9562, 9562},
+	{9562, 9562, 9562, 9562, 9562, 9562, 9562, 9562},
+};
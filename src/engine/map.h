@@ -26,11 +26,14 @@ class IEngineMap : public IMap
 {
 	MACRO_INTERFACE("enginemap", 0)
 public:
-	virtual bool Load(const char *pMapName, class IStorage *pStorage=0) = 0;
+	// Flags are passed on to CDataFileReader::Open
+	virtual bool Load(const char *pMapName, class IStorage *pStorage=0, int Flags=0) = 0;
 	virtual bool IsLoaded() = 0;
 	virtual void Unload() = 0;
 	virtual SHA256_DIGEST Sha256() = 0;
 	virtual unsigned Crc() = 0;
+	// the whole map file when loaded with CDataFileReader::OPENFLAG_WHOLE_FILE, 0 otherwise
+	virtual const unsigned char *FileData(int *pSize) = 0;
 };
 
 extern IEngineMap *CreateEngineMap();
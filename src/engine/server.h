@@ -52,6 +52,19 @@ public:
 		return SendMsg(&Packer, Flags, ClientID);
 	}
 
+	// sends the message to all ingame clients whose bit is set in the
+	// mask, it is packed only once for all of them
+	virtual int SendMsgMask(CMsgPacker *pMsg, int Flags, int64 Mask) = 0;
+
+	template<class T>
+	int SendPackMsgMask(T *pMsg, int Flags, int64 Mask)
+	{
+		CMsgPacker Packer(pMsg->MsgID(), false);
+		if(pMsg->Pack(&Packer))
+			return -1;
+		return SendMsgMask(&Packer, Flags, Mask);
+	}
+
 	virtual void GetMapInfo(char *pMapName, int MapNameSize, int *pMapSize, SHA256_DIGEST *pSha256, int *pMapCrc) = 0;
 
 	virtual void SetClientName(int ClientID, char const *pName) = 0;
@@ -59,6 +72,10 @@ public:
 	virtual void SetClientCountry(int ClientID, int Country) = 0;
 	virtual void SetClientScore(int ClientID, int Score) = 0;
 
+	// marks the cached server info as outdated, call it when something
+	// the server browser shows changes outside of the engine
+	virtual void ExpireServerInfo() = 0;
+
 	virtual int SnapNewID() = 0;
 	virtual void SnapFreeID(int ID) = 0;
 	virtual void *SnapNewItem(int Type, int ID, int Size) = 0;
@@ -78,6 +95,9 @@ public:
 
 	virtual void DemoRecorder_HandleAutoStart() = 0;
 	virtual bool DemoRecorder_IsRecording() = 0;
+
+	// timings of the main loop, the game adds the phases it runs itself
+	virtual class CTickProfiler *TickProfiler() = 0;
 };
 
 class IGameServer : public IInterface
@@ -3,6 +3,7 @@
 
 #include <base/math.h>
 #include <base/system.h>
+#include <base/tl/threading.h>
 
 #include <engine/config.h>
 #include <engine/console.h>
@@ -18,6 +19,7 @@
 #include <engine/shared/demo.h>
 #include <engine/shared/econ.h>
 #include <engine/shared/filecollection.h>
+#include <engine/shared/jobs.h>
 #include <engine/shared/mapchecker.h>
 #include <engine/shared/netban.h>
 #include <engine/shared/network.h>
@@ -257,9 +259,8 @@ void CServerBan::ConBanExt(IConsole::IResult *pResult, void *pUser)
 void CServer::CClient::Reset()
 {
 	// reset input
-	for(int i = 0; i < 200; i++)
+	for(int i = 0; i < INPUT_WINDOW; i++)
 		m_aInputs[i].m_GameTick = -1;
-	m_CurrentInput = 0;
 	mem_zero(&m_LatestInput, sizeof(m_LatestInput));
 
 	m_Snapshots.PurgeAll();
@@ -268,6 +269,16 @@ void CServer::CClient::Reset()
 	m_SnapRate = CClient::SNAPRATE_INIT;
 	m_Score = 0;
 	m_MapChunk = 0;
+	m_MapChunksRequested = 0;
+	m_MapDownloading = false;
+}
+
+void CServer::CClient::ResetInputStats()
+{
+	m_NumInputs = 0;
+	m_NumLateInputs = 0;
+	m_NumEarlyInputs = 0;
+	m_NumDuplicateInputs = 0;
 }
 
 CServer::CServer() : m_DemoRecorder(&m_SnapshotDelta)
@@ -280,7 +291,12 @@ CServer::CServer() : m_DemoRecorder(&m_SnapshotDelta)
 	m_RunServer = 1;
 
 	m_pCurrentMapData = 0;
+	m_CurrentMapDataShared = false;
 	m_CurrentMapSize = 0;
+	m_NumMapChunks = 0;
+	m_MapChunkHeaderSize = 0;
+	m_MapBytesServed = 0;
+	m_MapDownloadsDone = 0;
 
 	m_NumMapEntries = 0;
 	m_pFirstMapEntry = 0;
@@ -294,14 +310,29 @@ CServer::CServer() : m_DemoRecorder(&m_SnapshotDelta)
 	m_RconRestrict = -1;
 
 	m_RconPasswordSet = 0;
+
+	m_ServerInfoNeedsUpdate = true;
+	m_ServerInfoRequests = 0;
+	m_ServerInfoRebuilds = 0;
+	m_ServerInfoRateStart = 0;
+	m_ServerInfoRateRequests = 0;
+	m_ServerInfoRate = 0;
+	m_ServerInfoPeakRate = 0;
 	m_GeneratedRconPassword = 0;
 
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		m_aSnapJobs[i].m_pServer = this;
+		m_aSnapJobs[i].m_ClientID = i;
+		m_aSnapJobs[i].m_pSnap = 0;
+	}
+
 	Init();
 }
 
 int CServer::TrySetClientName(int ClientID, const char* pName)
 {
-	char aTrimmedName[64];
+	char aTrimmedName[MAX_NAME_LENGTH];
 
 	// trim the name
 	str_copy(aTrimmedName, str_utf8_skip_whitespaces(pName), sizeof(aTrimmedName));
@@ -317,11 +348,14 @@ int CServer::TrySetClientName(int ClientID, const char* pName)
 		return -1;
 
 	// make sure that two clients don't have the same name
+	int aSkeleton[CClient::MAX_NAME_SKELETON_LENGTH];
+	int SkeletonLength = str_utf8_to_skeleton(aTrimmedName, aSkeleton, CClient::MAX_NAME_SKELETON_LENGTH);
 	for (int i = 0; i < MAX_CLIENTS; i++)
 	{
 		if (i != ClientID && m_aClients[i].m_State >= CClient::STATE_READY)
 		{
-			if (str_utf8_comp_confusable(aTrimmedName, m_aClients[i].m_aName) == 0)
+			if (m_aClients[i].m_NameSkeletonLength == SkeletonLength &&
+				mem_comp(m_aClients[i].m_aNameSkeleton, aSkeleton, SkeletonLength*sizeof(int)) == 0)
 				return -1;
 		}
 	}
@@ -333,6 +367,9 @@ int CServer::TrySetClientName(int ClientID, const char* pName)
 
 	// set the client name
 	str_copy(m_aClients[ClientID].m_aName, pName, MAX_NAME_LENGTH);
+	mem_copy(m_aClients[ClientID].m_aNameSkeleton, aSkeleton, SkeletonLength*sizeof(int));
+	m_aClients[ClientID].m_NameSkeletonLength = SkeletonLength;
+	ExpireServerInfo();
 	return 0;
 }
 
@@ -361,6 +398,7 @@ void CServer::SetClientClan(int ClientID, const char *pClan)
 		return;
 
 	str_copy(m_aClients[ClientID].m_aClan, pClan, MAX_CLAN_LENGTH);
+	ExpireServerInfo();
 }
 
 void CServer::SetClientCountry(int ClientID, int Country)
@@ -369,13 +407,25 @@ void CServer::SetClientCountry(int ClientID, int Country)
 		return;
 
 	m_aClients[ClientID].m_Country = Country;
+	ExpireServerInfo();
 }
 
 void CServer::SetClientScore(int ClientID, int Score)
 {
 	if(ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State < CClient::STATE_READY)
 		return;
-	m_aClients[ClientID].m_Score = Score;
+
+	// called every tick, only expire the info if the score moved
+	if(m_aClients[ClientID].m_Score != Score)
+	{
+		m_aClients[ClientID].m_Score = Score;
+		ExpireServerInfo();
+	}
+}
+
+void CServer::ExpireServerInfo()
+{
+	m_ServerInfoNeedsUpdate = true;
 }
 
 void CServer::Kick(int ClientID, const char *pReason)
@@ -420,6 +470,7 @@ int CServer::Init()
 	{
 		m_aClients[i].m_State = CClient::STATE_EMPTY;
 		m_aClients[i].m_aName[0] = 0;
+		m_aClients[i].m_NameSkeletonLength = 0;
 		m_aClients[i].m_aClan[0] = 0;
 		m_aClients[i].m_Country = -1;
 		m_aClients[i].m_Snapshots.Init();
@@ -555,6 +606,10 @@ void CServer::InitRconPasswordIfUnset()
 
 int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 {
+	// broadcast
+	if(ClientID == -1)
+		return SendMsgMask(pMsg, Flags, -1);
+
 	CNetChunk Packet;
 	if(!pMsg)
 		return -1;
@@ -564,6 +619,30 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 	Packet.m_pData = pMsg->Data();
 	Packet.m_DataSize = pMsg->Size();
 
+	if(Flags&MSGFLAG_VITAL)
+		Packet.m_Flags |= NETSENDFLAG_VITAL;
+	if(Flags&MSGFLAG_FLUSH)
+		Packet.m_Flags |= NETSENDFLAG_FLUSH;
+
+	// write message to demo recorder
+	if(!(Flags&MSGFLAG_NORECORD))
+		m_DemoRecorder.RecordMessage(pMsg->Data(), pMsg->Size());
+
+	if(!(Flags&MSGFLAG_NOSEND))
+		m_NetServer.Send(&Packet);
+	return 0;
+}
+
+int CServer::SendMsgMask(CMsgPacker *pMsg, int Flags, int64 Mask)
+{
+	CNetChunk Packet;
+	if(!pMsg)
+		return -1;
+
+	mem_zero(&Packet, sizeof(CNetChunk));
+	Packet.m_pData = pMsg->Data();
+	Packet.m_DataSize = pMsg->Size();
+
 	if(Flags&MSGFLAG_VITAL)
 		Packet.m_Flags |= NETSENDFLAG_VITAL;
 	if(Flags&MSGFLAG_FLUSH)
@@ -575,26 +654,25 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
 
 	if(!(Flags&MSGFLAG_NOSEND))
 	{
-		if(ClientID == -1)
-		{
-			// broadcast
-			int i;
-			for(i = 0; i < MAX_CLIENTS; i++)
-				if(m_aClients[i].m_State == CClient::STATE_INGAME && !m_aClients[i].m_Quitting)
-				{
-					Packet.m_ClientID = i;
-					m_NetServer.Send(&Packet);
-				}
-		}
-		else
-			m_NetServer.Send(&Packet);
+		// every connection copies the same packed chunk
+		for(int i = 0; i < MAX_CLIENTS; i++)
+			if((Mask&(1LL<<i)) && m_aClients[i].m_State == CClient::STATE_INGAME && !m_aClients[i].m_Quitting)
+			{
+				Packet.m_ClientID = i;
+				m_NetServer.Send(&Packet);
+			}
 	}
 	return 0;
 }
 
 void CServer::DoSnapshot()
 {
+	// collect all packets of this snapshot and hand them to the socket at once
+	m_NetServer.BeginSendBatch();
+
+	m_TickProfiler.Begin(CTickProfiler::PHASE_SNAP);
 	GameServer()->OnPreSnap();
+	m_TickProfiler.End(CTickProfiler::PHASE_SNAP);
 
 	// create snapshot for demo recording
 	if(m_DemoRecorder.IsRecording())
@@ -603,12 +681,16 @@ void CServer::DoSnapshot()
 		int SnapshotSize;
 
 		// build snap and possibly add some messages
+		m_TickProfiler.Begin(CTickProfiler::PHASE_SNAP);
 		m_SnapshotBuilder.Init();
 		GameServer()->OnSnap(-1);
 		SnapshotSize = m_SnapshotBuilder.Finish(aData);
+		m_TickProfiler.End(CTickProfiler::PHASE_SNAP);
 
 		// write snapshot
+		m_TickProfiler.Begin(CTickProfiler::PHASE_RECORD);
 		m_DemoRecorder.RecordSnapshot(Tick(), aData, SnapshotSize);
+		m_TickProfiler.End(CTickProfiler::PHASE_RECORD);
 	}
 
 	// create snapshots for all clients
@@ -629,99 +711,153 @@ void CServer::DoSnapshot()
 		{
 			char aData[CSnapshot::MAX_SIZE];
 			CSnapshot *pData = (CSnapshot*)aData;	// Fix compiler warning for strict-aliasing
-			char aDeltaData[CSnapshot::MAX_SIZE];
-			char aCompData[CSnapshot::MAX_SIZE];
 			int SnapshotSize;
-			int Crc;
-			static CSnapshot EmptySnap;
-			CSnapshot *pDeltashot = &EmptySnap;
-			int DeltashotSize;
-			int DeltaTick = -1;
-			int DeltaSize;
 
+			m_TickProfiler.Begin(CTickProfiler::PHASE_SNAP);
 			m_SnapshotBuilder.Init();
 
 			GameServer()->OnSnap(i);
 
 			// finish snapshot
 			SnapshotSize = m_SnapshotBuilder.Finish(pData);
-			Crc = pData->Crc();
 
 			// remove old snapshos
 			// keep 3 seconds worth of snapshots
 			m_aClients[i].m_Snapshots.PurgeUntil(m_CurrentGameTick-SERVER_TICK_SPEED*3);
 
-			// save it the snapshot
-			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0);
+			// save it the snapshot, with the hash that later deltas against it need
+			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, true);
+			m_TickProfiler.End(CTickProfiler::PHASE_SNAP);
+
+			// delta and compression only touch this client's data, so
+			// they can run while the next client's snapshot gets built
+			CSnapJob *pJob = &m_aSnapJobs[i];
+			pJob->m_pSnap = m_aClients[i].m_Snapshots.m_pLast->m_pSnap;
+			pJob->m_pSnapHash = m_aClients[i].m_Snapshots.m_pLast->m_pHash;
+			if(m_SnapJobPool.NumThreads())
+				m_SnapJobPool.Add(&pJob->m_Job, CreateSnapDeltaJob, pJob);
+			else
+				CreateSnapDeltaJob(pJob);
+		}
+	}
 
-			// find snapshot that we can preform delta against
-			EmptySnap.Clear();
+	// send the snapshots in client order
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		CSnapJob *pJob = &m_aSnapJobs[i];
+		if(!pJob->m_pSnap)
+			continue;
 
-			{
-				DeltashotSize = m_aClients[i].m_Snapshots.Get(m_aClients[i].m_LastAckedSnapshot, 0, &pDeltashot, 0);
-				if(DeltashotSize >= 0)
-					DeltaTick = m_aClients[i].m_LastAckedSnapshot;
-				else
-				{
-					// no acked package found, force client to recover rate
-					if(m_aClients[i].m_SnapRate == CClient::SNAPRATE_FULL)
-						m_aClients[i].m_SnapRate = CClient::SNAPRATE_RECOVER;
-				}
-			}
+		while(pJob->m_Job.Status() != CJob::STATE_DONE)
+			thread_yield();
+		sync_barrier();
 
-			// create delta
-			DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, aDeltaData);
+		// the job might have run on another thread, it timed itself
+		m_TickProfiler.Add(CTickProfiler::PHASE_DELTA, pJob->m_DeltaTime);
 
-			if(DeltaSize)
-			{
-				// compress it
-				int SnapshotSize;
-				const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
-				int NumPackets;
+		m_TickProfiler.Begin(CTickProfiler::PHASE_NETWORK);
+		SendSnapshot(pJob);
+		m_TickProfiler.End(CTickProfiler::PHASE_NETWORK);
+		pJob->m_pSnap = 0;
+	}
 
-				SnapshotSize = CVariableInt::Compress(aDeltaData, DeltaSize, aCompData, sizeof(aCompData));
-				NumPackets = (SnapshotSize+MaxSize-1)/MaxSize;
+	m_TickProfiler.Begin(CTickProfiler::PHASE_SNAP);
+	GameServer()->OnPostSnap();
+	m_TickProfiler.End(CTickProfiler::PHASE_SNAP);
 
-				for(int n = 0, Left = SnapshotSize; Left > 0; n++)
-				{
-					int Chunk = Left < MaxSize ? Left : MaxSize;
-					Left -= Chunk;
+	m_TickProfiler.Begin(CTickProfiler::PHASE_NETWORK);
+	m_NetServer.EndSendBatch();
+	m_TickProfiler.End(CTickProfiler::PHASE_NETWORK);
+}
 
-					if(NumPackets == 1)
-					{
-						CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick-DeltaTick);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n*MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i);
-					}
-					else
-					{
-						CMsgPacker Msg(NETMSG_SNAP, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick-DeltaTick);
-						Msg.AddInt(NumPackets);
-						Msg.AddInt(n);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n*MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i);
-					}
-				}
+int CServer::CreateSnapDeltaJob(void *pUser)
+{
+	CSnapJob *pJob = (CSnapJob *)pUser;
+	CServer *pThis = pJob->m_pServer;
+	CClient *pClient = &pThis->m_aClients[pJob->m_ClientID];
+
+	int64 Start = time_get();
+	pJob->m_Crc = pJob->m_pSnap->Crc();
+
+	// find snapshot that we can preform delta against
+	CSnapshot *pDeltashot = &pJob->m_EmptySnap;
+	CSnapshotHash *pDeltashotHash = (CSnapshotHash *)pJob->m_aEmptySnapHash;
+	pJob->m_EmptySnap.Clear();
+	pDeltashotHash->Build(pDeltashot);
+	pJob->m_DeltaTick = -1;
+
+	CSnapshotStorage::CHolder *pHolder = pClient->m_Snapshots.Find(pClient->m_LastAckedSnapshot);
+	if(pHolder)
+	{
+		pDeltashot = pHolder->m_pSnap;
+		pDeltashotHash = pHolder->m_pHash;
+		pJob->m_DeltaTick = pClient->m_LastAckedSnapshot;
+	}
+	else
+	{
+		// no acked package found, force client to recover rate
+		if(pClient->m_SnapRate == CClient::SNAPRATE_FULL)
+			pClient->m_SnapRate = CClient::SNAPRATE_RECOVER;
+	}
+
+	// create delta
+	pJob->m_DeltaSize = pThis->m_SnapshotDelta.CreateDelta(pDeltashot, pDeltashotHash, pJob->m_pSnap, pJob->m_pSnapHash, pJob->m_aDeltaData);
+
+	// compress it
+	pJob->m_CompSize = 0;
+	if(pJob->m_DeltaSize)
+		pJob->m_CompSize = CVariableInt::Compress(pJob->m_aDeltaData, pJob->m_DeltaSize, pJob->m_aCompData, sizeof(pJob->m_aCompData));
+
+	pJob->m_DeltaTime = time_get() - Start;
+	return 0;
+}
+
+void CServer::SendSnapshot(CSnapJob *pJob)
+{
+	int ClientID = pJob->m_ClientID;
+	int DeltaTick = pJob->m_DeltaTick;
+
+	if(pJob->m_DeltaSize)
+	{
+		const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
+		int NumPackets = (pJob->m_CompSize+MaxSize-1)/MaxSize;
+
+		for(int n = 0, Left = pJob->m_CompSize; Left > 0; n++)
+		{
+			int Chunk = Left < MaxSize ? Left : MaxSize;
+			Left -= Chunk;
+
+			if(NumPackets == 1)
+			{
+				CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
+				Msg.AddInt(m_CurrentGameTick);
+				Msg.AddInt(m_CurrentGameTick-DeltaTick);
+				Msg.AddInt(pJob->m_Crc);
+				Msg.AddInt(Chunk);
+				Msg.AddRaw(&pJob->m_aCompData[n*MaxSize], Chunk);
+				SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
 			}
 			else
 			{
-				CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
+				CMsgPacker Msg(NETMSG_SNAP, true);
 				Msg.AddInt(m_CurrentGameTick);
 				Msg.AddInt(m_CurrentGameTick-DeltaTick);
-				SendMsg(&Msg, MSGFLAG_FLUSH, i);
+				Msg.AddInt(NumPackets);
+				Msg.AddInt(n);
+				Msg.AddInt(pJob->m_Crc);
+				Msg.AddInt(Chunk);
+				Msg.AddRaw(&pJob->m_aCompData[n*MaxSize], Chunk);
+				SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
 			}
 		}
 	}
-
-	GameServer()->OnPostSnap();
+	else
+	{
+		CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
+		Msg.AddInt(m_CurrentGameTick);
+		Msg.AddInt(m_CurrentGameTick-DeltaTick);
+		SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
+	}
 }
 
 
@@ -729,7 +865,9 @@ int CServer::NewClientCallback(int ClientID, void *pUser)
 {
 	CServer *pThis = (CServer *)pUser;
 	pThis->m_aClients[ClientID].m_State = CClient::STATE_AUTH;
+	pThis->ExpireServerInfo();
 	pThis->m_aClients[ClientID].m_aName[0] = 0;
+	pThis->m_aClients[ClientID].m_NameSkeletonLength = 0;
 	pThis->m_aClients[ClientID].m_aClan[0] = 0;
 	pThis->m_aClients[ClientID].m_Country = -1;
 	pThis->m_aClients[ClientID].m_Authed = AUTHED_NO;
@@ -739,6 +877,7 @@ int CServer::NewClientCallback(int ClientID, void *pUser)
 	pThis->m_aClients[ClientID].m_NoRconNote = false;
 	pThis->m_aClients[ClientID].m_Quitting = false;
 	pThis->m_aClients[ClientID].Reset();
+	pThis->m_aClients[ClientID].ResetInputStats();
 	pThis->GameServer()->OnClientEngineJoin(ClientID);
 	return 0;
 }
@@ -761,7 +900,9 @@ int CServer::DelClientCallback(int ClientID, const char *pReason, void *pUser)
 	}
 
 	pThis->m_aClients[ClientID].m_State = CClient::STATE_EMPTY;
+	pThis->ExpireServerInfo();
 	pThis->m_aClients[ClientID].m_aName[0] = 0;
+	pThis->m_aClients[ClientID].m_NameSkeletonLength = 0;
 	pThis->m_aClients[ClientID].m_aClan[0] = 0;
 	pThis->m_aClients[ClientID].m_Country = -1;
 	pThis->m_aClients[ClientID].m_Authed = AUTHED_NO;
@@ -797,6 +938,74 @@ void CServer::SendMap(int ClientID)
 	SendMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_FLUSH, ClientID);
 }
 
+void CServer::SendMapData(int ClientID)
+{
+	CClient *pClient = &m_aClients[ClientID];
+	if(pClient->m_State != CClient::STATE_CONNECTING && pClient->m_State != CClient::STATE_CONNECTING_AS_SPEC)
+		pClient->m_MapDownloading = false;
+	if(!pClient->m_MapDownloading)
+		return;
+
+	// keep the client's window full instead of waiting for its next
+	// request. the chunks it asked for are always sent, it only acks
+	// them with its next request
+	int Window = g_Config.m_SvMapWindow*1024;
+	while(pClient->m_MapChunk >= 0)
+	{
+		int Chunk = pClient->m_MapChunk;
+		int Offset = Chunk * MAP_CHUNK_SIZE;
+		int ChunkSize = min((int)MAP_CHUNK_SIZE, m_CurrentMapSize-Offset);
+		int MsgSize = m_MapChunkHeaderSize + ChunkSize;
+		if(pClient->m_MapChunksRequested > 0)
+			pClient->m_MapChunksRequested--;
+		else if(m_NetServer.ClientUnackedBytes(ClientID) + MsgSize > Window)
+			break;
+
+		unsigned char aMsg[NET_MAX_PAYLOAD];
+		mem_copy(aMsg, m_aMapChunkHeader, m_MapChunkHeaderSize);
+		mem_copy(aMsg + m_MapChunkHeaderSize, &m_pCurrentMapData[Offset], ChunkSize);
+
+		// map data is of no use in demos, so this skips SendMsg
+		CNetChunk Packet;
+		mem_zero(&Packet, sizeof(Packet));
+		Packet.m_ClientID = ClientID;
+		Packet.m_Flags = NETSENDFLAG_VITAL|NETSENDFLAG_FLUSH;
+		Packet.m_pData = aMsg;
+		Packet.m_DataSize = MsgSize;
+		m_NetServer.Send(&Packet);
+		// dropped because its buffer overflowed
+		if(pClient->m_State == CClient::STATE_EMPTY)
+			return;
+		m_MapBytesServed += ChunkSize;
+
+		if(Chunk == m_NumMapChunks-1)
+		{
+			pClient->m_MapChunk = -1;
+			pClient->m_MapDownloading = false;
+			m_MapDownloadsDone++;
+		}
+		else
+			pClient->m_MapChunk++;
+
+		if(g_Config.m_Debug)
+		{
+			char aBuf[64];
+			str_format(aBuf, sizeof(aBuf), "sending chunk %d with size %d", Chunk, ChunkSize);
+			Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "server", aBuf);
+		}
+	}
+}
+
+void CServer::FreeMapData()
+{
+	if(m_pCurrentMapData && !m_CurrentMapDataShared)
+		mem_free((void *)m_pCurrentMapData);
+	m_pCurrentMapData = 0;
+	m_CurrentMapDataShared = false;
+	m_CurrentMapSize = 0;
+	m_NumMapChunks = 0;
+}
+
 void CServer::SendConnectionReady(int ClientID)
 {
 	CMsgPacker Msg(NETMSG_CON_READY, true);
@@ -947,34 +1156,11 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 		{
 			if((pPacket->m_Flags&NET_CHUNKFLAG_VITAL) != 0 && (m_aClients[ClientID].m_State == CClient::STATE_CONNECTING || m_aClients[ClientID].m_State == CClient::STATE_CONNECTING_AS_SPEC))
 			{
-				int ChunkSize = MAP_CHUNK_SIZE;
-
-				// send map chunks
-				for(int i = 0; i < m_MapChunksPerRequest && m_aClients[ClientID].m_MapChunk >= 0; ++i)
-				{
-					int Chunk = m_aClients[ClientID].m_MapChunk;
-					int Offset = Chunk * ChunkSize;
-
-					// check for last part
-					if(Offset+ChunkSize >= m_CurrentMapSize)
-					{
-						ChunkSize = m_CurrentMapSize-Offset;
-						m_aClients[ClientID].m_MapChunk = -1;
-					}
-					else
-						m_aClients[ClientID].m_MapChunk++;
-
-					CMsgPacker Msg(NETMSG_MAP_DATA, true);
-					Msg.AddRaw(&m_pCurrentMapData[Offset], ChunkSize);
-					SendMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_FLUSH, ClientID);
-
-					if(g_Config.m_Debug)
-					{
-						char aBuf[64];
-						str_format(aBuf, sizeof(aBuf), "sending chunk %d with size %d", Chunk, ChunkSize);
-						Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "server", aBuf);
-					}
-				}
+				// the first request starts the download, the server keeps it going
+				if(m_aClients[ClientID].m_MapChunk == 0 && m_NumMapChunks > 0)
+					m_aClients[ClientID].m_MapDownloading = true;
+				m_aClients[ClientID].m_MapChunksRequested = m_MapChunksPerRequest;
+				SendMapData(ClientID);
 			}
 		}
 		else if(Msg == NETMSG_READY)
@@ -1005,13 +1191,14 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 				str_format(aBuf, sizeof(aBuf), "player has entered the game. ClientID=%d addr=%s", ClientID, aAddrStr);
 				Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
 				m_aClients[ClientID].m_State = CClient::STATE_INGAME;
+				ExpireServerInfo();
 				SendServerInfo(ClientID);
 				GameServer()->OnClientEnter(ClientID);
 			}
 		}
 		else if(Msg == NETMSG_INPUT)
 		{
-			CClient::CInput *pInput;
+			CClient::CInput Input;
 			int64 TagTime;
 			int64 Now = time_get();
 
@@ -1040,15 +1227,27 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 
 			m_aClients[ClientID].m_LastInputTick = IntendedTick;
 
-			pInput = &m_aClients[ClientID].m_aInputs[m_aClients[ClientID].m_CurrentInput];
-
+			m_aClients[ClientID].m_NumInputs++;
 			if(IntendedTick <= Tick())
+			{
+				m_aClients[ClientID].m_NumLateInputs++;
 				IntendedTick = Tick()+1;
+			}
 
-			pInput->m_GameTick = IntendedTick;
-
+			mem_zero(Input.m_aData, sizeof(Input.m_aData));
+			Input.m_GameTick = IntendedTick;
 			for(int i = 0; i < Size/4; i++)
-				pInput->m_aData[i] = Unpacker.GetInt();
+				Input.m_aData[i] = Unpacker.GetInt();
+
+			// the first input for a tick wins, like the first match of the
+			// old linear scan did
+			CClient::CInput *pSlot = m_aClients[ClientID].InputSlot(IntendedTick);
+			if(IntendedTick - Tick() > CClient::INPUT_WINDOW)
+				m_aClients[ClientID].m_NumEarlyInputs++;
+			else if(pSlot->m_GameTick == IntendedTick)
+				m_aClients[ClientID].m_NumDuplicateInputs++;
+			else
+				*pSlot = Input;
 
 			int PingCorrection = clamp(Unpacker.GetInt(), 0, 50);
 			if(m_aClients[ClientID].m_Snapshots.Get(m_aClients[ClientID].m_LastAckedSnapshot, &TagTime, 0, 0) >= 0)
@@ -1057,10 +1256,7 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 				m_aClients[ClientID].m_Latency = max(0, m_aClients[ClientID].m_Latency - PingCorrection);
 			}
 
-			mem_copy(m_aClients[ClientID].m_LatestInput.m_aData, pInput->m_aData, MAX_INPUT_SIZE*sizeof(int));
-
-			m_aClients[ClientID].m_CurrentInput++;
-			m_aClients[ClientID].m_CurrentInput %= 200;
+			mem_copy(m_aClients[ClientID].m_LatestInput.m_aData, Input.m_aData, MAX_INPUT_SIZE*sizeof(int));
 
 			// call the mod with the fresh input data
 			if(m_aClients[ClientID].m_State == CClient::STATE_INGAME)
@@ -1187,7 +1383,7 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 	}
 }
 
-void CServer::GenerateServerInfo(CPacker *pPacker, int Token)
+void CServer::GenerateServerInfo(CPacker *pPacker, bool SendClients)
 {
 	// count the players
 	int PlayerCount = 0, ClientCount = 0;
@@ -1202,13 +1398,6 @@ void CServer::GenerateServerInfo(CPacker *pPacker, int Token)
 		}
 	}
 
-	if(Token != -1)
-	{
-		pPacker->Reset();
-		pPacker->AddRaw(SERVERBROWSE_INFO, sizeof(SERVERBROWSE_INFO));
-		pPacker->AddInt(Token);
-	}
-
 	pPacker->AddString(GameServer()->Version(), 32);
 	pPacker->AddString(g_Config.m_SvName, 64);
 	pPacker->AddString(g_Config.m_SvHostname, 128);
@@ -1227,7 +1416,7 @@ void CServer::GenerateServerInfo(CPacker *pPacker, int Token)
 	pPacker->AddInt(ClientCount); // num clients
 	pPacker->AddInt(m_NetServer.MaxClients()); // max clients
 
-	if(Token != -1)
+	if(SendClients)
 	{
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
@@ -1246,7 +1435,7 @@ void CServer::GenerateServerInfo(CPacker *pPacker, int Token)
 void CServer::SendServerInfo(int ClientID)
 {
 	CMsgPacker Msg(NETMSG_SERVERINFO, true);
-	GenerateServerInfo(&Msg, -1);
+	GenerateServerInfo(&Msg, false);
 	if(ClientID == -1)
 	{
 		for(int i = 0; i < MAX_CLIENTS; i++)
@@ -1259,6 +1448,42 @@ void CServer::SendServerInfo(int ClientID)
 		SendMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_FLUSH, ClientID);
 }
 
+void CServer::SendServerInfoConnless(const NETADDR *pAddr, TOKEN ResponseToken, int Token)
+{
+	int64 Now = time_get();
+	m_ServerInfoRequests++;
+	m_ServerInfoRateRequests++;
+	if(Now > m_ServerInfoRateStart + time_freq())
+	{
+		m_ServerInfoRate = m_ServerInfoRateRequests;
+		m_ServerInfoPeakRate = max(m_ServerInfoPeakRate, m_ServerInfoRate);
+		m_ServerInfoRateRequests = 0;
+		m_ServerInfoRateStart = Now;
+	}
+
+	if(m_ServerInfoNeedsUpdate)
+	{
+		m_ServerInfoCache.Reset();
+		GenerateServerInfo(&m_ServerInfoCache, true);
+		m_ServerInfoNeedsUpdate = false;
+		m_ServerInfoRebuilds++;
+	}
+
+	CPacker Packer;
+	Packer.Reset();
+	Packer.AddRaw(SERVERBROWSE_INFO, sizeof(SERVERBROWSE_INFO));
+	Packer.AddInt(Token);
+	Packer.AddRaw(m_ServerInfoCache.Data(), m_ServerInfoCache.Size());
+
+	CNetChunk Response;
+	Response.m_ClientID = -1;
+	Response.m_Address = *pAddr;
+	Response.m_Flags = NETSENDFLAG_CONNLESS;
+	Response.m_pData = Packer.Data();
+	Response.m_DataSize = Packer.Size();
+	m_NetServer.Send(&Response, ResponseToken);
+}
+
 
 void CServer::PumpNetwork()
 {
@@ -1283,17 +1508,7 @@ void CServer::PumpNetwork()
 				if(Unpacker.Error())
 					continue;
 
-				CPacker Packer;
-				CNetChunk Response;
-				
-				GenerateServerInfo(&Packer, SrvBrwsToken);
-
-				Response.m_ClientID = -1;
-				Response.m_Address = Packet.m_Address;
-				Response.m_Flags = NETSENDFLAG_CONNLESS;
-				Response.m_pData = Packer.Data();
-				Response.m_DataSize = Packer.Size();
-				m_NetServer.Send(&Response, ResponseToken);
+				SendServerInfoConnless(&Packet.m_Address, ResponseToken, SrvBrwsToken);
 			}
 		}
 		else
@@ -1329,8 +1544,14 @@ int CServer::LoadMap(const char *pMapName)
 		return 0;
 	}
 
-	if(!m_pMap->Load(aBuf))
+	if(!m_pMap->Load(aBuf, 0, CDataFileReader::OPENFLAG_WHOLE_FILE))
+	{
+		// the map may have been replaced before it failed, taking the shared data with it
+		int Size;
+		if(m_CurrentMapDataShared && m_pMap->FileData(&Size) != m_pCurrentMapData)
+			FreeMapData();
 		return 0;
+	}
 
 	// stop recording when we change map
 	m_DemoRecorder.Stop();
@@ -1350,17 +1571,31 @@ int CServer::LoadMap(const char *pMapName)
 	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBufMsg);
 
 	str_copy(m_aCurrentMap, pMapName, sizeof(m_aCurrentMap));
+	ExpireServerInfo();
 
-	// load complete map into memory for download
+	// serve downloads from the file the map was loaded from, only read it
+	// again when the map doesn't keep it
+	FreeMapData();
+	m_pCurrentMapData = m_pMap->FileData(&m_CurrentMapSize);
+	if(m_pCurrentMapData)
+		m_CurrentMapDataShared = true;
+	else
 	{
 		IOHANDLE File = Storage()->OpenFile(aBuf, IOFLAG_READ, IStorage::TYPE_ALL);
-		m_CurrentMapSize = (int)io_length(File);
-		if(m_pCurrentMapData)
-			mem_free(m_pCurrentMapData);
-		m_pCurrentMapData = (unsigned char *)mem_alloc(m_CurrentMapSize, 1);
-		io_read(File, m_pCurrentMapData, m_CurrentMapSize);
-		io_close(File);
+		if(File)
+		{
+			m_CurrentMapSize = (int)io_length(File);
+			unsigned char *pData = (unsigned char *)mem_alloc(max(m_CurrentMapSize, 1), 1);
+			io_read(File, pData, m_CurrentMapSize);
+			io_close(File);
+			m_pCurrentMapData = pData;
+		}
 	}
+	m_NumMapChunks = (m_CurrentMapSize + MAP_CHUNK_SIZE-1) / MAP_CHUNK_SIZE;
+
+	CMsgPacker Msg(NETMSG_MAP_DATA, true);
+	m_MapChunkHeaderSize = Msg.Size();
+	mem_copy(m_aMapChunkHeader, Msg.Data(), m_MapChunkHeaderSize);
 	return 1;
 }
 
@@ -1417,6 +1652,9 @@ int CServer::Run()
 
 	m_NetServer.SetCallbacks(NewClientCallback, DelClientCallback, this);
 
+	if(g_Config.m_SvSnapThreads)
+		m_SnapJobPool.Init(g_Config.m_SvSnapThreads);
+
 	m_Econ.Init(Console(), &m_ServerBan);
 
 #if defined(CONF_FAMILY_UNIX)
@@ -1498,22 +1736,20 @@ int CServer::Run()
 				NewTicks++;
 
 				// apply new input
+				m_TickProfiler.Begin(CTickProfiler::PHASE_INPUT);
 				for(int c = 0; c < MAX_CLIENTS; c++)
 				{
-					if(m_aClients[c].m_State == CClient::STATE_EMPTY)
+					if(m_aClients[c].m_State != CClient::STATE_INGAME)
 						continue;
-					for(int i = 0; i < 200; i++)
-					{
-						if(m_aClients[c].m_aInputs[i].m_GameTick == Tick())
-						{
-							if(m_aClients[c].m_State == CClient::STATE_INGAME)
-								GameServer()->OnClientPredictedInput(c, m_aClients[c].m_aInputs[i].m_aData);
-							break;
-						}
-					}
+					CClient::CInput *pInput = m_aClients[c].InputSlot(Tick());
+					if(pInput->m_GameTick == Tick())
+						GameServer()->OnClientPredictedInput(c, pInput->m_aData);
 				}
+				m_TickProfiler.End(CTickProfiler::PHASE_INPUT);
 
+				m_TickProfiler.Begin(CTickProfiler::PHASE_TICK);
 				GameServer()->OnTick();
+				m_TickProfiler.End(CTickProfiler::PHASE_TICK);
 			}
 
 			// snap game
@@ -1525,6 +1761,10 @@ int CServer::Run()
 				UpdateClientRconCommands();
 				UpdateClientMapListEntries();
 
+				for(int c = 0; c < MAX_CLIENTS; c++)
+					if(m_aClients[c].m_MapDownloading)
+						SendMapData(c);
+
 #if defined(CONF_FAMILY_UNIX)
 				m_Fifo.Update();
 #endif
@@ -1533,7 +1773,17 @@ int CServer::Run()
 			// master server stuff
 			m_Register.RegisterUpdate(m_NetServer.NetType());
 
+			m_TickProfiler.Begin(CTickProfiler::PHASE_NETWORK);
 			PumpNetwork();
+			m_TickProfiler.End(CTickProfiler::PHASE_NETWORK);
+
+			// a frame is everything since the last one that ran ticks,
+			// the network time of the idle passes is counted in too
+			if(NewTicks)
+			{
+				m_TickProfiler.EndFrame(m_CurrentGameTick);
+				m_TickProfiler.SetEnabled(g_Config.m_SvTickProfiler);
+			}
 
 			if(ReportTime < time_get())
 			{
@@ -1580,8 +1830,7 @@ int CServer::Run()
 	GameServer()->OnShutdown(true);
 	m_pMap->Unload();
 
-	if(m_pCurrentMapData)
-		mem_free(m_pCurrentMapData);
+	FreeMapData();
 	return 0;
 }
 
@@ -1668,6 +1917,101 @@ void CServer::ConStatus(IConsole::IResult *pResult, void *pUser)
 	}
 }
 
+void CServer::ConServerInfoStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "info requests=%lld rebuilds=%lld rate=%d/s peak=%d/s size=%d",
+		pThis->m_ServerInfoRequests, pThis->m_ServerInfoRebuilds, pThis->m_ServerInfoRate, pThis->m_ServerInfoPeakRate, pThis->m_ServerInfoCache.Size());
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
+void CServer::ConMapDownloadStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	int Active = 0;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+		if(pThis->m_aClients[i].m_MapDownloading)
+			Active++;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "map size=%d chunks=%d downloads=%d active=%d served=%lld bytes",
+		pThis->m_CurrentMapSize, pThis->m_NumMapChunks, pThis->m_MapDownloadsDone, Active, pThis->m_MapBytesServed);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
+void CServer::ConDemoStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CDemoRecorder *pRecorder = &pThis->m_DemoRecorder;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "recording=%d backlog=%d peak_backlog=%d stalled=%lld bytes",
+		pRecorder->IsRecording(), pRecorder->Backlog(), pRecorder->PeakBacklog(), pRecorder->StalledBytes());
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_recorder", aBuf);
+}
+
+void CServer::ConTickProfile(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CTickProfiler *pProfiler = &pThis->m_TickProfiler;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "frames=%lld%s", pProfiler->NumFrames(), pProfiler->IsEnabled() ? "" : " (disabled)");
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+	for(int p = 0; p < CTickProfiler::NUM_PHASES; p++)
+	{
+		pProfiler->Format(p, aBuf, sizeof(aBuf));
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+	}
+	pProfiler->FormatWorst(aBuf, sizeof(aBuf));
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+}
+
+void CServer::ConTickProfileReset(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	pThis->m_TickProfiler.Reset();
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", "reset");
+}
+
+void CServer::ConTickProfileDump(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const char *pFilename = pResult->GetString(0);
+
+	char aBuf[256];
+	IOHANDLE File = pThis->Storage()->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		str_format(aBuf, sizeof(aBuf), "failed to open '%s'", pFilename);
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+		return;
+	}
+	pThis->m_TickProfiler.Dump(File);
+	io_close(File);
+
+	str_format(aBuf, sizeof(aBuf), "histograms written to '%s'", pFilename);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+}
+
+void CServer::ConInputStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	char aBuf[256];
+
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		if(pThis->m_aClients[i].m_State == CClient::STATE_EMPTY || (pResult->NumArguments() && pResult->GetInteger(0) != i))
+			continue;
+
+		const CClient *pClient = &pThis->m_aClients[i];
+		str_format(aBuf, sizeof(aBuf), "id=%d name='%s' latency=%d inputs=%d late=%d early=%d duplicate=%d", i, pClient->m_aName,
+			pClient->m_Latency, pClient->m_NumInputs, pClient->m_NumLateInputs, pClient->m_NumEarlyInputs, pClient->m_NumDuplicateInputs);
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	}
+}
+
 void CServer::ConShutdown(IConsole::IResult *pResult, void *pUser)
 {
 	((CServer *)pUser)->m_RunServer = 0;
@@ -1750,10 +2094,18 @@ void CServer::ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserD
 	if(pResult->NumArguments())
 	{
 		str_clean_whitespaces(g_Config.m_SvName);
+		((CServer *)pUserData)->ExpireServerInfo();
 		((CServer *)pUserData)->SendServerInfo(-1);
 	}
 }
 
+void CServer::ConchainExpireServerInfo(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+{
+	pfnCallback(pResult, pCallbackUserData);
+	if(pResult->NumArguments())
+		((CServer *)pUserData)->ExpireServerInfo();
+}
+
 void CServer::ConchainMaxclientsperipUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	pfnCallback(pResult, pCallbackUserData);
@@ -1819,6 +2171,13 @@ void CServer::RegisterCommands()
 	// register console commands
 	Console()->Register("kick", "i?r", CFGFLAG_SERVER, ConKick, this, "Kick player with specified id for any reason");
 	Console()->Register("status", "", CFGFLAG_SERVER, ConStatus, this, "List players");
+	Console()->Register("input_stats", "?i", CFGFLAG_SERVER, ConInputStats, this, "Show input timing counters of all players or of one client id");
+	Console()->Register("map_download_stats", "", CFGFLAG_SERVER, ConMapDownloadStats, this, "Show how much map data was sent to downloading clients");
+	Console()->Register("demo_stats", "", CFGFLAG_SERVER, ConDemoStats, this, "Show how far the demo writer is behind");
+	Console()->Register("tick_profile", "", CFGFLAG_SERVER, ConTickProfile, this, "Show how long the phases of the server ticks take");
+	Console()->Register("tick_profile_reset", "", CFGFLAG_SERVER, ConTickProfileReset, this, "Clear the tick timings");
+	Console()->Register("tick_profile_dump", "s[file]", CFGFLAG_SERVER, ConTickProfileDump, this, "Write the tick timing histograms to a file");
+	Console()->Register("server_info_stats", "", CFGFLAG_SERVER, ConServerInfoStats, this, "Show how often the server info was requested and rebuilt");
 	Console()->Register("shutdown", "", CFGFLAG_SERVER, ConShutdown, this, "Shut down");
 	Console()->Register("logout", "", CFGFLAG_SERVER, ConLogout, this, "Logout of rcon");
 
@@ -1829,6 +2188,10 @@ void CServer::RegisterCommands()
 
 	Console()->Chain("sv_name", ConchainSpecialInfoupdate, this);
 	Console()->Chain("password", ConchainSpecialInfoupdate, this);
+	Console()->Chain("sv_hostname", ConchainExpireServerInfo, this);
+	Console()->Chain("sv_map", ConchainExpireServerInfo, this);
+	Console()->Chain("sv_skill_level", ConchainExpireServerInfo, this);
+	Console()->Chain("sv_player_slots", ConchainExpireServerInfo, this);
 
 	Console()->Chain("sv_max_clients_per_ip", ConchainMaxclientsperipUpdate, this);
 	Console()->Chain("mod_command", ConchainModCommandUpdate, this);
@@ -7,6 +7,7 @@
 #include <engine/server.h>
 #include <engine/shared/memheap.h>
 #include <engine/shared/fifo.h>
+#include <engine/shared/tickprofiler.h>
 
 class CSnapIDPool
 {
@@ -100,7 +101,13 @@ public:
 
 			SNAPRATE_INIT=0,
 			SNAPRATE_FULL,
-			SNAPRATE_RECOVER
+			SNAPRATE_RECOVER,
+
+			// inputs are stored at their tick modulo this, must be a power of two
+			INPUT_WINDOW=256,
+
+			// a byte of the name gives at most 5 code points
+			MAX_NAME_SKELETON_LENGTH=MAX_NAME_LENGTH*5,
 		};
 
 		class CInput
@@ -120,10 +127,18 @@ public:
 		CSnapshotStorage m_Snapshots;
 
 		CInput m_LatestInput;
-		CInput m_aInputs[200]; // TODO: handle input better
-		int m_CurrentInput;
+		CInput m_aInputs[INPUT_WINDOW];
+
+		// input timing, kept for the whole connection
+		int m_NumInputs;
+		int m_NumLateInputs; // arrived for a tick that was already simulated
+		int m_NumEarlyInputs; // too far ahead for the input window, dropped
+		int m_NumDuplicateInputs; // the tick already had an input, dropped
 
 		char m_aName[MAX_NAME_LENGTH];
+		// what the name looks like, see str_utf8_to_skeleton
+		int m_aNameSkeleton[MAX_NAME_SKELETON_LENGTH];
+		int m_NameSkeletonLength;
 		char m_aClan[MAX_CLAN_LENGTH];
 		int m_Version;
 		int m_Country;
@@ -131,20 +146,50 @@ public:
 		int m_Authed;
 		int m_AuthTries;
 
-		int m_MapChunk;
+		int m_MapChunk; // next chunk to send, -1 once the map has been sent
+		int m_MapChunksRequested; // sent regardless of the window
+		bool m_MapDownloading;
 		bool m_NoRconNote;
 		bool m_Quitting;
 		const IConsole::CCommandInfo *m_pRconCmdToSend;
 		const CMapListEntry *m_pMapListEntryToSend;
 
 		void Reset();
+		void ResetInputStats();
+		CInput *InputSlot(int Tick) { return &m_aInputs[Tick&(INPUT_WINDOW-1)]; }
 	};
 
 	CClient m_aClients[MAX_CLIENTS];
 
+	// per client delta and compression stage of a snapshot
+	class CSnapJob
+	{
+	public:
+		CJob m_Job;
+		CServer *m_pServer;
+		int m_ClientID;
+
+		CSnapshot *m_pSnap;
+		CSnapshotHash *m_pSnapHash;
+		CSnapshot m_EmptySnap;
+		int m_aEmptySnapHash[1+CSnapshotHash::MIN_SLOTS*2]; // CSnapshotHash of the empty snapshot
+		int m_Crc;
+		int m_DeltaTick;
+		int m_DeltaSize;
+		int m_CompSize;
+		int64 m_DeltaTime;
+
+		char m_aDeltaData[CSnapshot::MAX_SIZE];
+		char m_aCompData[CSnapshot::MAX_SIZE];
+	};
+
+	CSnapJob m_aSnapJobs[MAX_CLIENTS];
+	CJobPool m_SnapJobPool;
+
 	CSnapshotDelta m_SnapshotDelta;
 	CSnapshotBuilder m_SnapshotBuilder;
 	CSnapIDPool m_IDPool;
+	CTickProfiler m_TickProfiler;
 	CNetServer m_NetServer;
 	CEcon m_Econ;
 #if defined(CONF_FAMILY_UNIX)
@@ -173,9 +218,16 @@ public:
 	char m_aCurrentMap[64];
 	SHA256_DIGEST m_CurrentMapSha256;
 	unsigned m_CurrentMapCrc;
-	unsigned char *m_pCurrentMapData;
+	const unsigned char *m_pCurrentMapData;
+	bool m_CurrentMapDataShared; // held by m_pMap, not freed here
 	int m_CurrentMapSize;
 	int m_MapChunksPerRequest;
+	// every map data message starts with the same packed header
+	int m_NumMapChunks;
+	unsigned char m_aMapChunkHeader[8];
+	int m_MapChunkHeaderSize;
+	int64 m_MapBytesServed;
+	int m_MapDownloadsDone;
 
 	//maplist
 	struct CMapListEntry
@@ -199,6 +251,17 @@ public:
 	int m_RconPasswordSet;
 	int m_GeneratedRconPassword;
 
+	// server info for the browser, everything after the token, packed
+	// again only after something in it changed
+	CPacker m_ServerInfoCache;
+	bool m_ServerInfoNeedsUpdate;
+	int64 m_ServerInfoRequests;
+	int64 m_ServerInfoRebuilds;
+	int64 m_ServerInfoRateStart;
+	int m_ServerInfoRateRequests;
+	int m_ServerInfoRate;
+	int m_ServerInfoPeakRate;
+
 	CDemoRecorder m_DemoRecorder;
 	CRegister m_Register;
 	CMapChecker m_MapChecker;
@@ -212,11 +275,15 @@ public:
 	virtual void SetClientCountry(int ClientID, int Country);
 	virtual void SetClientScore(int ClientID, int Score);
 
+	virtual void ExpireServerInfo();
+
 	void Kick(int ClientID, const char *pReason);
 
 	void DemoRecorder_HandleAutoStart();
 	bool DemoRecorder_IsRecording();
 
+	virtual CTickProfiler *TickProfiler() { return &m_TickProfiler; }
+
 	int64 TickStartTime(int Tick);
 
 	int Init();
@@ -238,13 +305,18 @@ public:
 	int MaxClients() const;
 
 	virtual int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID);
+	virtual int SendMsgMask(CMsgPacker *pMsg, int Flags, int64 Mask);
 
 	void DoSnapshot();
+	static int CreateSnapDeltaJob(void *pUser);
+	void SendSnapshot(CSnapJob *pJob);
 
 	static int NewClientCallback(int ClientID, void *pUser);
 	static int DelClientCallback(int ClientID, const char *pReason, void *pUser);
 
 	void SendMap(int ClientID);
+	void SendMapData(int ClientID);
+	void FreeMapData();
 	void SendConnectionReady(int ClientID);
 	void SendRconLine(int ClientID, const char *pLine);
 	static void SendRconLineAuthed(const char *pLine, void *pUser, bool Highlighted);
@@ -259,7 +331,8 @@ public:
 	void ProcessClientPacket(CNetChunk *pPacket);
 
 	void SendServerInfo(int ClientID);
-	void GenerateServerInfo(CPacker *pPacker, int Token);
+	void GenerateServerInfo(CPacker *pPacker, bool SendClients);
+	void SendServerInfoConnless(const NETADDR *pAddr, TOKEN ResponseToken, int Token);
 
 	void PumpNetwork();
 
@@ -279,7 +352,15 @@ public:
 	static void ConMapReload(IConsole::IResult *pResult, void *pUser);
 	static void ConSaveConfig(IConsole::IResult *pResult, void *pUser);
 	static void ConLogout(IConsole::IResult *pResult, void *pUser);
+	static void ConServerInfoStats(IConsole::IResult *pResult, void *pUser);
+	static void ConInputStats(IConsole::IResult *pResult, void *pUser);
+	static void ConMapDownloadStats(IConsole::IResult *pResult, void *pUser);
+	static void ConDemoStats(IConsole::IResult *pResult, void *pUser);
+	static void ConTickProfile(IConsole::IResult *pResult, void *pUser);
+	static void ConTickProfileReset(IConsole::IResult *pResult, void *pUser);
+	static void ConTickProfileDump(IConsole::IResult *pResult, void *pUser);
 	static void ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
+	static void ConchainExpireServerInfo(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainMaxclientsperipUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainModCommandUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainConsoleOutputLevelUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
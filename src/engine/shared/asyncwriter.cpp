@@ -0,0 +1,359 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/math.h>
+#include <base/system.h>
+#include <base/tl/threading.h>
+
+#include <zlib.h>
+
+#include "asyncwriter.h"
+
+enum
+{
+	COMPRESSED_BUFFER_SIZE=64*1024,
+};
+
+CAsyncWriter::CAsyncWriter()
+{
+	m_File = 0;
+	m_pConsumer = 0;
+	m_pRecord = 0;
+	m_MaxRecordSize = 0;
+	m_pThread = 0;
+	m_pBuffer = 0;
+	m_Head = 0;
+	m_Tail = 0;
+	m_PeakBacklog = 0;
+	m_StalledBytes = 0;
+	m_pStream = 0;
+	m_pCompressed = 0;
+}
+
+CAsyncWriter::~CAsyncWriter()
+{
+	Close();
+}
+
+bool CAsyncWriter::Open(IOHANDLE File, int BufferSize, int FlushInterval, int Flags)
+{
+	if(IsOpen() || !File)
+		return false;
+
+	m_File = File;
+	m_Flags = Flags;
+	m_FlushInterval = time_freq()*FlushInterval/1000;
+	m_LastFlush = time_get();
+	m_Unflushed = false;
+
+	if(m_Flags&FLAG_COMPRESS)
+	{
+		m_pStream = (z_stream *)mem_alloc(sizeof(z_stream), 1);
+		mem_zero(m_pStream, sizeof(z_stream));
+		m_pCompressed = (unsigned char *)mem_alloc(COMPRESSED_BUFFER_SIZE, 1);
+		// window bits + 16 writes a gzip header
+		if(deflateInit2(m_pStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			dbg_msg("asyncwriter", "failed to initialize zlib, writing uncompressed");
+			mem_free(m_pStream);
+			mem_free(m_pCompressed);
+			m_pStream = 0;
+			m_pCompressed = 0;
+			m_Flags &= ~FLAG_COMPRESS;
+		}
+	}
+
+	Start(BufferSize);
+	return true;
+}
+
+bool CAsyncWriter::OpenRecords(IConsumer *pConsumer, int BufferSize, int MaxRecordSize)
+{
+	if(IsOpen() || !pConsumer)
+		return false;
+
+	m_pConsumer = pConsumer;
+	m_MaxRecordSize = MaxRecordSize;
+	m_pRecord = (unsigned char *)mem_alloc(max(MaxRecordSize, 1), 1);
+	m_Flags = 0;
+	m_FlushInterval = 0;
+	m_LastFlush = time_get();
+	m_Unflushed = false;
+
+	Start(BufferSize);
+	return true;
+}
+
+void CAsyncWriter::Start(int BufferSize)
+{
+	m_BufferSize = 1;
+	while(m_BufferSize < (unsigned)BufferSize)
+		m_BufferSize <<= 1;
+	m_pBuffer = (unsigned char *)mem_alloc(m_BufferSize, 1);
+	m_Head = 0;
+	m_Tail = 0;
+
+	m_PeakBacklog = 0;
+	m_StalledBytes = 0;
+
+	m_Shutdown = false;
+	m_WakePending = false;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_init(&m_Semaphore);
+#endif
+	m_pThread = thread_init(WriterThread, this);
+}
+
+void CAsyncWriter::Close()
+{
+	if(!IsOpen())
+		return;
+
+	// the writer drains everything before it exits
+	m_Shutdown = true;
+	sync_barrier();
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_signal(&m_Semaphore);
+#endif
+	thread_wait(m_pThread);
+	thread_destroy(m_pThread);
+	m_pThread = 0;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_destroy(&m_Semaphore);
+#endif
+
+	if(m_pStream)
+	{
+		deflateEnd(m_pStream);
+		mem_free(m_pStream);
+		mem_free(m_pCompressed);
+		m_pStream = 0;
+		m_pCompressed = 0;
+	}
+
+	if(m_File)
+		io_close(m_File);
+	m_File = 0;
+	m_pConsumer = 0;
+	mem_free(m_pRecord);
+	m_pRecord = 0;
+	mem_free(m_pBuffer);
+	m_pBuffer = 0;
+}
+
+void CAsyncWriter::Wake()
+{
+	if(m_WakePending)
+		return;
+	m_WakePending = true;
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_signal(&m_Semaphore);
+#endif
+}
+
+void CAsyncWriter::Write(const void *pData, int DataSize)
+{
+	const unsigned char *pSrc = (const unsigned char *)pData;
+	unsigned Size = DataSize;
+	bool Stalled = false;
+
+	while(Size)
+	{
+		unsigned Free = m_BufferSize - (m_Head - m_Tail);
+		if(Free == 0)
+		{
+			if(!Stalled)
+			{
+				m_StalledBytes += Size;
+				Stalled = true;
+			}
+			Wake();
+			thread_yield();
+			continue;
+		}
+
+		unsigned Offset = m_Head&(m_BufferSize-1);
+		unsigned Chunk = min(min(Free, Size), m_BufferSize - Offset);
+		mem_copy(m_pBuffer + Offset, pSrc, Chunk);
+		sync_barrier();
+		m_Head += Chunk;
+
+		pSrc += Chunk;
+		Size -= Chunk;
+	}
+
+	int Backlog = m_Head - m_Tail;
+	if(Backlog > m_PeakBacklog)
+		m_PeakBacklog = Backlog;
+
+	// don't let the buffer run full before the next flush
+	if((unsigned)Backlog > m_BufferSize/2)
+		Wake();
+}
+
+void CAsyncWriter::WriteRecord(const void *pHeader, int HeaderSize, const void *pData, int DataSize)
+{
+	// the size and the padding are stored with the record
+	int Size = HeaderSize + DataSize;
+	unsigned Total = sizeof(int) + ((Size+3)&~3);
+	if(!m_pConsumer || Size < 0 || Size > m_MaxRecordSize || Total > m_BufferSize)
+		return;
+
+	bool Stalled = false;
+	while(m_BufferSize - (m_Head - m_Tail) < Total)
+	{
+		if(!Stalled)
+		{
+			m_StalledBytes += Total;
+			Stalled = true;
+		}
+		Wake();
+		thread_yield();
+	}
+
+	// the record may wrap around the end of the buffer, the writer only
+	// sees it once it is complete
+	unsigned Pos = m_Head;
+	for(int Part = 0; Part < 3; Part++)
+	{
+		const unsigned char *pSrc = Part == 0 ? (const unsigned char *)&Size : Part == 1 ? (const unsigned char *)pHeader : (const unsigned char *)pData;
+		unsigned Left = Part == 0 ? sizeof(int) : Part == 1 ? HeaderSize : DataSize;
+		while(Left)
+		{
+			unsigned Offset = Pos&(m_BufferSize-1);
+			unsigned Chunk = min(Left, m_BufferSize - Offset);
+			mem_copy(m_pBuffer + Offset, pSrc, Chunk);
+			pSrc += Chunk;
+			Pos += Chunk;
+			Left -= Chunk;
+		}
+	}
+	sync_barrier();
+	m_Head += Total;
+
+	int Backlog = m_Head - m_Tail;
+	if(Backlog > m_PeakBacklog)
+		m_PeakBacklog = Backlog;
+
+	if((unsigned)Backlog > m_BufferSize/2)
+		Wake();
+}
+
+void CAsyncWriter::Flush()
+{
+	// also wake the writer while it holds data that still has to go to disk
+	if(m_Head != m_Tail || m_Unflushed)
+		Wake();
+}
+
+void CAsyncWriter::WriterThread(void *pUser)
+{
+	CAsyncWriter *pSelf = (CAsyncWriter *)pUser;
+
+	if(pSelf->m_pConsumer)
+		pSelf->m_pConsumer->OnStart();
+
+	while(1)
+	{
+#if !defined(CONF_PLATFORM_MACOSX)
+		semaphore_wait(&pSelf->m_Semaphore);
+#else
+		thread_sleep(10);
+#endif
+		pSelf->m_WakePending = false;
+		sync_barrier();
+		bool Shutdown = pSelf->m_Shutdown;
+
+		if(pSelf->m_pConsumer)
+		{
+			pSelf->DrainRecords();
+			pSelf->m_pConsumer->OnDrained(Shutdown);
+			if(Shutdown)
+				break;
+			continue;
+		}
+
+		pSelf->Drain();
+
+		int64 Now = time_get();
+		if(Shutdown || (pSelf->m_Unflushed && Now - pSelf->m_LastFlush >= pSelf->m_FlushInterval))
+		{
+			pSelf->Output(0, 0, Shutdown ? Z_FINISH : Z_SYNC_FLUSH);
+			io_flush(pSelf->m_File);
+			pSelf->m_LastFlush = Now;
+			pSelf->m_Unflushed = false;
+		}
+
+		if(Shutdown)
+			break;
+	}
+}
+
+void CAsyncWriter::Drain()
+{
+	unsigned Head = m_Head;
+	sync_barrier();
+	while(m_Tail != Head)
+	{
+		unsigned Offset = m_Tail&(m_BufferSize-1);
+		unsigned Chunk = min(Head - m_Tail, m_BufferSize - Offset);
+		Output(m_pBuffer + Offset, Chunk, Z_NO_FLUSH);
+		sync_barrier();
+		m_Tail += Chunk;
+		m_Unflushed = true;
+	}
+}
+
+void CAsyncWriter::Read(unsigned Pos, void *pData, int Size)
+{
+	unsigned char *pDst = (unsigned char *)pData;
+	unsigned Left = Size;
+	while(Left)
+	{
+		unsigned Offset = Pos&(m_BufferSize-1);
+		unsigned Chunk = min(Left, m_BufferSize - Offset);
+		mem_copy(pDst, m_pBuffer + Offset, Chunk);
+		pDst += Chunk;
+		Pos += Chunk;
+		Left -= Chunk;
+	}
+}
+
+void CAsyncWriter::DrainRecords()
+{
+	unsigned Head = m_Head;
+	sync_barrier();
+	while(m_Tail != Head)
+	{
+		int Size;
+		Read(m_Tail, &Size, sizeof(Size));
+		Read(m_Tail + sizeof(Size), m_pRecord, Size);
+		// the record is copied out, the producer may reuse its space
+		sync_barrier();
+		m_Tail += sizeof(Size) + ((Size+3)&~3);
+
+		m_pConsumer->OnRecord(m_pRecord, Size);
+	}
+}
+
+void CAsyncWriter::Output(const void *pData, int DataSize, int Mode)
+{
+	if(!(m_Flags&FLAG_COMPRESS))
+	{
+		if(DataSize)
+			io_write(m_File, pData, DataSize);
+		return;
+	}
+
+	m_pStream->next_in = (Bytef *)pData;
+	m_pStream->avail_in = DataSize;
+	do
+	{
+		m_pStream->next_out = m_pCompressed;
+		m_pStream->avail_out = COMPRESSED_BUFFER_SIZE;
+		deflate(m_pStream, Mode);
+		int Size = COMPRESSED_BUFFER_SIZE - m_pStream->avail_out;
+		if(Size)
+			io_write(m_File, m_pCompressed, Size);
+	}
+	while(m_pStream->avail_out == 0);
+}
@@ -0,0 +1,118 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef ENGINE_SHARED_ASYNCWRITER_H
+#define ENGINE_SHARED_ASYNCWRITER_H
+
+#include <base/system.h>
+
+/*
+	Class: CAsyncWriter
+		Streams data to a file from a background thread. Write only copies
+		into a single producer, single consumer ring buffer, so the calling
+		thread never touches the disk.
+
+		In record mode the writer thread hands whole records to a consumer
+		instead, which does the expensive part of writing them.
+*/
+class CAsyncWriter
+{
+public:
+	enum
+	{
+		FLAG_COMPRESS=1, // zlib stream in gzip format
+	};
+
+	// gets the records on the writer thread
+	class IConsumer
+	{
+	public:
+		virtual ~IConsumer() {}
+		// before the first record
+		virtual void OnStart() {}
+		// every record, in the order they were written
+		virtual void OnRecord(const void *pData, int Size) = 0;
+		// after the writer emptied the buffer, Shutdown is set for the last call
+		virtual void OnDrained(bool Shutdown) {}
+	};
+
+	CAsyncWriter();
+	~CAsyncWriter();
+
+	/*
+		Function: Open
+			Starts the writer thread, takes ownership of the file.
+
+		Parameters:
+			File - File to write to, gets closed by Close.
+			BufferSize - Size of the ring buffer, rounded up to a power of two.
+			FlushInterval - Minimum milliseconds between flushes of the file.
+			Flags - FLAG_COMPRESS or 0.
+	*/
+	bool Open(IOHANDLE File, int BufferSize, int FlushInterval, int Flags);
+
+	/*
+		Function: OpenRecords
+			Starts the writer thread in record mode.
+
+		Parameters:
+			pConsumer - Gets the records, must outlive Close.
+			BufferSize - Size of the ring buffer, rounded up to a power of two.
+			MaxRecordSize - Largest record that can be written.
+	*/
+	bool OpenRecords(IConsumer *pConsumer, int BufferSize, int MaxRecordSize);
+	void Close();
+	bool IsOpen() const { return m_pThread != 0; }
+
+	void Write(const void *pData, int DataSize);
+	// queues a record made of a header and data, the consumer gets both in
+	// one piece. records larger than the buffer or MaxRecordSize are ignored
+	void WriteRecord(const void *pHeader, int HeaderSize, const void *pData, int DataSize);
+	// hands the buffered data to the writer thread without waiting for it,
+	// the file itself is flushed at most once per flush interval
+	void Flush();
+
+	// bytes currently waiting in the ring buffer, only valid on the
+	// writing thread. the counters are kept until the next Open
+	int Backlog() const { return m_Head - m_Tail; }
+	int PeakBacklog() const { return m_PeakBacklog; }
+	// bytes that had to wait for space in the ring buffer
+	int64 StalledBytes() const { return m_StalledBytes; }
+
+private:
+	static void WriterThread(void *pUser);
+	void Start(int BufferSize);
+	void Wake();
+	void Drain();
+	void DrainRecords();
+	void Read(unsigned Pos, void *pData, int Size);
+	void Output(const void *pData, int DataSize, int Mode);
+
+	IOHANDLE m_File;
+	IConsumer *m_pConsumer;
+	unsigned char *m_pRecord;
+	int m_MaxRecordSize;
+	void *m_pThread;
+	int m_Flags;
+	int64 m_FlushInterval;
+	int64 m_LastFlush;
+	volatile bool m_Unflushed;
+
+	unsigned char *m_pBuffer;
+	unsigned m_BufferSize;
+	volatile unsigned m_Head; // written by the producer only
+	volatile unsigned m_Tail; // written by the writer thread only
+
+	volatile bool m_Shutdown;
+	volatile bool m_WakePending;
+#if !defined(CONF_PLATFORM_MACOSX)
+	SEMAPHORE m_Semaphore;
+#endif
+
+	struct z_stream_s *m_pStream;
+	unsigned char *m_pCompressed;
+
+	int m_PeakBacklog;
+	int64 m_StalledBytes;
+};
+
+#endif
@@ -14,6 +14,8 @@ MACRO_CONFIG_INT(PlayerCountry, player_country, -1, -1, 1000, CFGFLAG_SAVE|CFGFL
 MACRO_CONFIG_STR(Password, password, 32, "", CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER|CFGFLAG_NONTEEHISTORIC, "Password to the server")
 MACRO_CONFIG_STR(Logfile, logfile, 128, "", CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER, "Filename to log all output to")
 MACRO_CONFIG_INT(LogfileTimestamp, logfile_timestamp, 0, 0, 1, CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER, "Add a time stamp to the log file's name")
+MACRO_CONFIG_INT(LogAsync, log_async, 1, 0, 1, CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER, "Write the log from a background thread, takes effect on start")
+MACRO_CONFIG_INT(LogRateLimit, log_rate_limit, 0, 0, 1000000, CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER, "Maximum number of lines every system may log per second, errors are always logged (0 = no limit)")
 MACRO_CONFIG_INT(ConsoleOutputLevel, console_output_level, 0, 0, 2, CFGFLAG_SAVE|CFGFLAG_CLIENT|CFGFLAG_SERVER, "Adjusts the amount of information in the console")
 MACRO_CONFIG_INT(ShowConsoleWindow, show_console_window, 1, 0, 3, CFGFLAG_SAVE|CFGFLAG_CLIENT, "Show console window (0 = never, 1 = debug, 2 = release, 3 = always")
 
@@ -82,7 +84,12 @@ MACRO_CONFIG_INT(SvExternalPort, sv_external_port, 0, 0, 0, CFGFLAG_SAVE|CFGFLAG
 MACRO_CONFIG_STR(SvMap, sv_map, 128, "Kobra 4", CFGFLAG_SAVE|CFGFLAG_SERVER, "Map to use on the server")
 MACRO_CONFIG_INT(SvMaxClients, sv_max_clients, 64, 1, MAX_CLIENTS, CFGFLAG_SAVE|CFGFLAG_SERVER, "Maximum number of clients that are allowed on a server")
 MACRO_CONFIG_INT(SvMaxClientsPerIP, sv_max_clients_per_ip, 4, 1, MAX_CLIENTS, CFGFLAG_SAVE|CFGFLAG_SERVER, "Maximum number of clients with the same IP that can connect to the server")
-MACRO_CONFIG_INT(SvMapDownloadSpeed, sv_map_download_speed, 2, 1, 16, CFGFLAG_SAVE|CFGFLAG_SERVER, "Number of map data packages a client gets on each request")
+MACRO_CONFIG_INT(SvMapDownloadSpeed, sv_map_download_speed, 2, 1, 16, CFGFLAG_SAVE|CFGFLAG_SERVER, "Number of map data packages a client receives before it asks for more")
+MACRO_CONFIG_INT(SvMapWindow, sv_map_window, 16, 2, 24, CFGFLAG_SAVE|CFGFLAG_SERVER, "Kilobytes of map data a downloading client may have unacknowledged")
+MACRO_CONFIG_INT(SvSnapThreads, sv_snap_threads, 0, 0, 16, CFGFLAG_SAVE|CFGFLAG_SERVER, "Number of worker threads that create and compress the snapshot deltas (0 = main thread only, needs restart)")
+MACRO_CONFIG_INT(SvCoreThreads, sv_core_threads, 0, 0, 16, CFGFLAG_SAVE|CFGFLAG_SERVER, "Number of worker threads that prepare the character core ticks and advance the dead reckoning cores (0 = main thread only, applies on map change)")
+MACRO_CONFIG_INT(SvSnapViewIndex, sv_snap_view_index, 1, 0, 1, CFGFLAG_SAVE|CFGFLAG_SERVER, "Only snap the entities in the grid cells around a client's view (0 = let every entity clip itself)")
+MACRO_CONFIG_INT(SvTickProfiler, sv_tick_profiler, 1, 0, 1, CFGFLAG_SAVE|CFGFLAG_SERVER, "Measure how long the phases of each server tick take, see tick_profile")
 MACRO_CONFIG_INT(SvHighBandwidth, sv_high_bandwidth, 0, 0, 1, CFGFLAG_SAVE|CFGFLAG_SERVER, "Use high bandwidth mode. Doubles the bandwidth required for the server. LAN use only")
 MACRO_CONFIG_INT(SvRegister, sv_register, 1, 0, 1, CFGFLAG_SAVE|CFGFLAG_SERVER, "Register server with master server for public listing")
 MACRO_CONFIG_STR(SvRconPassword, sv_rcon_password, 32, "", CFGFLAG_SAVE|CFGFLAG_SERVER|CFGFLAG_NONTEEHISTORIC, "Remote console password (full access)")
@@ -92,6 +99,8 @@ MACRO_CONFIG_INT(SvRconBantime, sv_rcon_bantime, 5, 0, 1440, CFGFLAG_SAVE|CFGFLA
 MACRO_CONFIG_INT(SvAutoDemoRecord, sv_auto_demo_record, 0, 0, 1, CFGFLAG_SAVE|CFGFLAG_SERVER, "Automatically record demos")
 MACRO_CONFIG_INT(SvAutoDemoMax, sv_auto_demo_max, 10, 0, 1000, CFGFLAG_SAVE|CFGFLAG_SERVER, "Maximum number of automatically recorded demos (0 = no limit)")
 MACRO_CONFIG_INT(SvTeeHistorian, sv_tee_historian, 0, 0, 1, CFGFLAG_SERVER, "Activate the tee historian that writes complete gameplay data to disk (WARNING: This will use a lot of disk space)")
+MACRO_CONFIG_INT(SvTeeHistorianCompress, sv_tee_historian_compress, 0, 0, 1, CFGFLAG_SERVER, "Compress tee historian files with zlib (gzip format)")
+MACRO_CONFIG_INT(SvTeeHistorianFlushInterval, sv_tee_historian_flush_interval, 1000, 0, 60000, CFGFLAG_SERVER, "Minimum milliseconds between flushes of the tee historian file to disk")
 
 MACRO_CONFIG_STR(EcBindaddr, ec_bindaddr, 128, "localhost", CFGFLAG_SAVE|CFGFLAG_ECON, "Address to bind the external console to. Anything but 'localhost' is dangerous")
 MACRO_CONFIG_INT(EcPort, ec_port, 0, 0, 0, CFGFLAG_SAVE|CFGFLAG_ECON, "Port to use for the external console")
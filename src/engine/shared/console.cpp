@@ -481,9 +481,43 @@ void CConsole::PossibleMaps(const char *pStr, FPossibleCallback pfnCallback, voi
 	}
 }
 
+unsigned CConsole::CommandHash(const char *pName)
+{
+	// fnv-1a over the lower case name
+	unsigned Hash = 2166136261u;
+	for(; *pName; pName++)
+	{
+		unsigned char c = *pName;
+		if(c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		Hash = (Hash ^ c) * 16777619u;
+	}
+	return Hash&(COMMAND_HASH_SIZE-1);
+}
+
+void CConsole::AddCommandHash(CCommand *pCommand)
+{
+	// commands with the same name are found in the order of the sorted
+	// list, where the newer one comes first as well
+	CCommand **ppFirst = &m_apCommandHash[CommandHash(pCommand->m_pName)];
+	pCommand->m_pNextHash = *ppFirst;
+	*ppFirst = pCommand;
+}
+
+void CConsole::RemoveCommandHash(CCommand *pCommand)
+{
+	for(CCommand **ppCommand = &m_apCommandHash[CommandHash(pCommand->m_pName)]; *ppCommand; ppCommand = &(*ppCommand)->m_pNextHash)
+		if(*ppCommand == pCommand)
+		{
+			*ppCommand = pCommand->m_pNextHash;
+			pCommand->m_pNextHash = 0;
+			return;
+		}
+}
+
 CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandHash[CommandHash(pName)]; pCommand; pCommand = pCommand->m_pNextHash)
 	{
 		if(pCommand->m_Flags&FlagMask)
 		{
@@ -802,6 +836,7 @@ CConsole::CConsole(int FlagMask)
 	m_pLastMapEntry = 0;
 	m_ExecutionQueue.Reset();
 	m_pFirstCommand = 0;
+	mem_zero(m_apCommandHash, sizeof(m_apCommandHash));
 	m_pFirstExec = 0;
 	mem_zero(m_aPrintCB, sizeof(m_aPrintCB));
 	m_NumPrintCB = 0;
@@ -885,12 +920,11 @@ void CConsole::ParseArguments(int NumArgs, const char **ppArguments)
 
 void CConsole::AddCommandSorted(CCommand *pCommand)
 {
+	AddCommandHash(pCommand);
+
 	if(!m_pFirstCommand || str_comp(pCommand->m_pName, m_pFirstCommand->m_pName) <= 0)
 	{
-		if(m_pFirstCommand && m_pFirstCommand->m_pNext)
-			pCommand->m_pNext = m_pFirstCommand;
-		else
-			pCommand->m_pNext = 0;
+		pCommand->m_pNext = m_pFirstCommand;
 		m_pFirstCommand = pCommand;
 	}
 	else
@@ -995,6 +1029,7 @@ void CConsole::DeregisterTemp(const char *pName)
 	// add to recycle list
 	if(pRemoved)
 	{
+		RemoveCommandHash(pRemoved);
 		pRemoved->m_pNext = m_pRecycleList;
 		m_pRecycleList = pRemoved;
 	}
@@ -1016,6 +1051,18 @@ void CConsole::DeregisterTempAll()
 		}
 	}
 
+	for(int i = 0; i < COMMAND_HASH_SIZE; i++)
+	{
+		CCommand **ppCommand = &m_apCommandHash[i];
+		while(*ppCommand)
+		{
+			if((*ppCommand)->m_Temp)
+				*ppCommand = (*ppCommand)->m_pNextHash;
+			else
+				ppCommand = &(*ppCommand)->m_pNextHash;
+		}
+	}
+
 	m_TempCommands.Reset();
 	m_pRecycleList = 0;
 }
@@ -1131,7 +1178,7 @@ void CConsole::StoreCommands(bool Store)
 
 const IConsole::CCommandInfo *CConsole::GetCommandInfo(const char *pName, int FlagMask, bool Temp)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandHash[CommandHash(pName)]; pCommand; pCommand = pCommand->m_pNextHash)
 	{
 		if(pCommand->m_Flags&FlagMask && pCommand->m_Temp == Temp)
 		{
@@ -12,6 +12,7 @@ class CConsole : public IConsole
 	{
 	public:
 		CCommand *m_pNext;
+		CCommand *m_pNextHash;
 		int m_Flags;
 		bool m_Temp;
 		FCommandCallback m_pfnCallback;
@@ -37,6 +38,17 @@ class CConsole : public IConsole
 	const char *m_paStrokeStr[2];
 	CCommand *m_pFirstCommand;
 
+	// all commands by case insensitive name hash, m_pFirstCommand keeps
+	// them sorted by name
+	enum
+	{
+		COMMAND_HASH_SIZE=1024, // must be a power of two
+	};
+	CCommand *m_apCommandHash[COMMAND_HASH_SIZE];
+	static unsigned CommandHash(const char *pName);
+	void AddCommandHash(CCommand *pCommand);
+	void RemoveCommandHash(CCommand *pCommand);
+
 	class CExecFile
 	{
 	public:
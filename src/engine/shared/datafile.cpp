@@ -66,9 +66,13 @@ struct CDatafile
 	int m_DataStartOffset;
 	char **m_ppDataPtrs;
 	char *m_pData;
+
+	// set when the whole file is kept in memory, nothing is written to it
+	char *m_pFileData;
+	unsigned m_FileDataSize;
 };
 
-bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int StorageType)
+bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int StorageType, int Flags)
 {
 	dbg_msg("datafile", "loading. filename='%s'", pFilename);
 
@@ -79,11 +83,38 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 		return false;
 	}
 
+	// read the whole file at once, big endian machines need to swap the data while reading it
+	char *pFileData = 0;
+	unsigned FileDataSize = 0;
+	unsigned FileSize = (unsigned)io_length(File);
+#if !defined(CONF_ARCH_ENDIAN_BIG)
+	if(Flags&OPENFLAG_WHOLE_FILE)
+	{
+		pFileData = (char *)mem_alloc(max(FileSize, 1u), 1);
+		FileDataSize = io_read(File, pFileData, FileSize);
+		if(FileDataSize != FileSize)
+		{
+			dbg_msg("datafile", "couldn't read the whole file, wanted=%u got=%u", FileSize, FileDataSize);
+			mem_free(pFileData);
+			io_close(File);
+			return false;
+		}
+		// the file isn't needed anymore
+		io_close(File);
+		File = 0;
+	}
+#endif
 
 	// take the hashes of the file and store them
 	SHA256_CTX Sha256Ctx;
 	sha256_init(&Sha256Ctx);
 	unsigned Crc = crc32(0L, 0x0, 0);
+	if(pFileData)
+	{
+		sha256_update(&Sha256Ctx, pFileData, FileDataSize);
+		Crc = crc32(Crc, (const Bytef *)pFileData, FileDataSize); // ignore_convention
+	}
+	else
 	{
 		enum
 		{
@@ -103,16 +134,26 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 
 		io_seek(File, 0, IOSEEK_START);
 	}
+	SHA256_DIGEST Sha256 = sha256_finish(&Sha256Ctx);
 
 	// TODO: change this header
 	CDatafileHeader Header;
-	io_read(File, &Header, sizeof(Header));
+	if(pFileData)
+	{
+		mem_zero(&Header, sizeof(Header));
+		if(FileDataSize >= sizeof(Header))
+			mem_copy(&Header, pFileData, sizeof(Header));
+	}
+	else
+		io_read(File, &Header, sizeof(Header));
 	if(Header.m_aID[0] != 'A' || Header.m_aID[1] != 'T' || Header.m_aID[2] != 'A' || Header.m_aID[3] != 'D')
 	{
 		if(Header.m_aID[0] != 'D' || Header.m_aID[1] != 'A' || Header.m_aID[2] != 'T' || Header.m_aID[3] != 'A')
 		{
 			dbg_msg("datafile", "wrong signature. %x %x %x %x", Header.m_aID[0], Header.m_aID[1], Header.m_aID[2], Header.m_aID[3]);
-			io_close(File);
+			mem_free(pFileData);
+			if(File)
+				io_close(File);
 			return 0;
 		}
 	}
@@ -123,7 +164,9 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	if(Header.m_Version != 3 && Header.m_Version != 4)
 	{
 		dbg_msg("datafile", "wrong version. version=%x", Header.m_Version);
-		io_close(File);
+		mem_free(pFileData);
+		if(File)
+			io_close(File);
 		return 0;
 	}
 
@@ -138,9 +181,12 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	int64 AllocSize = Size;
 	AllocSize += sizeof(CDatafile); // add space for info structure
 	AllocSize += Header.m_NumRawData*sizeof(void*); // add space for data pointers
-	if(Size > (int64(1)<<31) || Header.m_NumItemTypes < 0 || Header.m_NumItems < 0 || Header.m_NumRawData < 0 || Header.m_ItemSize < 0)
+	if(Size > (int64(1)<<31) || Header.m_NumItemTypes < 0 || Header.m_NumItems < 0 || Header.m_NumRawData < 0 || Header.m_ItemSize < 0 ||
+		(pFileData && int64(sizeof(CDatafileHeader)) + Size > FileDataSize))
 	{
-		io_close(File);
+		mem_free(pFileData);
+		if(File)
+			io_close(File);
 		dbg_msg("datafile", "unable to load file, invalid file information");
 		return false;
 	}
@@ -149,23 +195,31 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	pTmpDataFile->m_Header = Header;
 	pTmpDataFile->m_DataStartOffset = sizeof(CDatafileHeader) + Size;
 	pTmpDataFile->m_ppDataPtrs = (char**)(pTmpDataFile+1);
-	pTmpDataFile->m_pData = (char *)(pTmpDataFile+1)+Header.m_NumRawData*sizeof(char *);
 	pTmpDataFile->m_File = File;
-	pTmpDataFile->m_Sha256 = sha256_finish(&Sha256Ctx);
+	pTmpDataFile->m_Sha256 = Sha256;
 	pTmpDataFile->m_Crc = Crc;
+	pTmpDataFile->m_pFileData = pFileData;
+	pTmpDataFile->m_FileDataSize = FileDataSize;
 
 	// clear the data pointers
 	mem_zero(pTmpDataFile->m_ppDataPtrs, Header.m_NumRawData*sizeof(void*));
 
 	// read types, offsets, sizes and item data
-	unsigned ReadSize = io_read(File, pTmpDataFile->m_pData, Size);
-	if(ReadSize != Size)
+	unsigned ReadSize = Size;
+	pTmpDataFile->m_pData = (char *)(pTmpDataFile+1)+Header.m_NumRawData*sizeof(char *);
+	if(pFileData)
+		mem_copy(pTmpDataFile->m_pData, pFileData + sizeof(CDatafileHeader), Size);
+	else
 	{
-		io_close(pTmpDataFile->m_File);
-		mem_free(pTmpDataFile);
-		pTmpDataFile = 0;
-		dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", unsigned(Size), ReadSize);
-		return false;
+		ReadSize = io_read(File, pTmpDataFile->m_pData, Size);
+		if(ReadSize != Size)
+		{
+			io_close(pTmpDataFile->m_File);
+			mem_free(pTmpDataFile);
+			pTmpDataFile = 0;
+			dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", unsigned(Size), ReadSize);
+			return false;
+		}
 	}
 
 	Close();
@@ -177,10 +231,10 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 
 	//if(DEBUG)
 	{
-		dbg_msg("datafile", "allocsize=%d", unsigned(AllocSize));
-		dbg_msg("datafile", "readsize=%d", ReadSize);
-		dbg_msg("datafile", "swaplen=%d", Header.m_Swaplen);
-		dbg_msg("datafile", "item_size=%d", m_pDataFile->m_Header.m_ItemSize);
+		dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "allocsize=%d", unsigned(AllocSize));
+		dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "readsize=%d%s", ReadSize, pFileData ? " (in memory)" : "");
+		dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "swaplen=%d", Header.m_Swaplen);
+		dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "item_size=%d", m_pDataFile->m_Header.m_ItemSize);
 	}
 
 	m_pDataFile->m_Info.m_pItemTypes = (CDatafileItemType *)m_pDataFile->m_pData;
@@ -269,6 +323,35 @@ void *CDataFileReader::GetDataImpl(int Index, int Swap)
 	if(Index < 0 || Index >= m_pDataFile->m_Header.m_NumRawData)
 		return 0;
 
+	// serve files kept in memory without reading anything
+	if(!m_pDataFile->m_ppDataPtrs[Index] && m_pDataFile->m_pFileData)
+	{
+		int FileDataSize = GetFileDataSize(Index);
+		int64 Offset = int64(m_pDataFile->m_DataStartOffset) + m_pDataFile->m_Info.m_pDataOffsets[Index];
+		if(FileDataSize < 0 || m_pDataFile->m_Info.m_pDataOffsets[Index] < 0 || Offset + FileDataSize > m_pDataFile->m_FileDataSize)
+		{
+			dbg_msg("datafile", "data index=%d is out of bounds", Index);
+			return 0;
+		}
+		char *pFileData = m_pDataFile->m_pFileData + Offset;
+
+		if(m_pDataFile->m_Header.m_Version == 4)
+		{
+			// v4 has compressed data, inflate it straight from the file data
+			unsigned long UncompressedSize = m_pDataFile->m_Info.m_pDataSizes[Index];
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "loading data index=%d size=%d uncompressed=%lu", Index, FileDataSize, UncompressedSize);
+			m_pDataFile->m_ppDataPtrs[Index] = (char *)mem_alloc(UncompressedSize, 1);
+			if(uncompress((Bytef*)m_pDataFile->m_ppDataPtrs[Index], &UncompressedSize, (Bytef*)pFileData, FileDataSize) != Z_OK) // ignore_convention
+				dbg_msg("datafile", "failed to decompress data index=%d", Index);
+		}
+		else
+		{
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "loading data index=%d size=%d", Index, FileDataSize);
+			m_pDataFile->m_ppDataPtrs[Index] = (char *)mem_alloc(FileDataSize, 1);
+			mem_copy(m_pDataFile->m_ppDataPtrs[Index], pFileData, FileDataSize);
+		}
+	}
+
 	// load it if needed
 	if(!m_pDataFile->m_ppDataPtrs[Index])
 	{
@@ -285,7 +368,7 @@ void *CDataFileReader::GetDataImpl(int Index, int Swap)
 			unsigned long UncompressedSize = m_pDataFile->m_Info.m_pDataSizes[Index];
 			unsigned long s;
 
-			dbg_msg("datafile", "loading data index=%d size=%d uncompressed=%lu", Index, DataSize, UncompressedSize);
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "loading data index=%d size=%d uncompressed=%lu", Index, DataSize, UncompressedSize);
 			m_pDataFile->m_ppDataPtrs[Index] = (char *)mem_alloc(UncompressedSize, 1);
 
 			// read the compressed data
@@ -305,7 +388,7 @@ void *CDataFileReader::GetDataImpl(int Index, int Swap)
 		else
 		{
 			// load the data
-			dbg_msg("datafile", "loading data index=%d size=%d", Index, DataSize);
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "loading data index=%d size=%d", Index, DataSize);
 			m_pDataFile->m_ppDataPtrs[Index] = (char *)mem_alloc(DataSize, 1);
 			io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset+m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START);
 			io_read(m_pDataFile->m_File, m_pDataFile->m_ppDataPtrs[Index], DataSize);
@@ -430,7 +513,9 @@ bool CDataFileReader::Close()
 	for(i = 0; i < m_pDataFile->m_Header.m_NumRawData; i++)
 		mem_free(m_pDataFile->m_ppDataPtrs[i]);
 
-	io_close(m_pDataFile->m_File);
+	if(m_pDataFile->m_File)
+		io_close(m_pDataFile->m_File);
+	mem_free(m_pDataFile->m_pFileData);
 	mem_free(m_pDataFile);
 	m_pDataFile = 0;
 	return true;
@@ -448,6 +533,17 @@ unsigned CDataFileReader::Crc() const
 	return m_pDataFile->m_Crc;
 }
 
+const unsigned char *CDataFileReader::FileData(int *pSize) const
+{
+	if(!m_pDataFile || !m_pDataFile->m_pFileData)
+	{
+		*pSize = 0;
+		return 0;
+	}
+	*pSize = m_pDataFile->m_FileDataSize;
+	return (const unsigned char *)m_pDataFile->m_pFileData;
+}
+
 
 CDataFileWriter::CDataFileWriter()
 {
@@ -592,7 +688,7 @@ int CDataFileWriter::Finish()
 	for(int i = 0; i < m_NumItems; i++)
 	{
 		if(DEBUG)
-			dbg_msg("datafile", "item=%d size=%d (%d)", i, m_pItems[i].m_Size, (int)(m_pItems[i].m_Size+sizeof(CDatafileItem)));
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "item=%d size=%d (%d)", i, m_pItems[i].m_Size, (int)(m_pItems[i].m_Size+sizeof(CDatafileItem)));
 		ItemSize += m_pItems[i].m_Size + sizeof(CDatafileItem);
 	}
 
@@ -610,7 +706,7 @@ int CDataFileWriter::Finish()
 	(void)SwapSize;
 
 	if(DEBUG)
-		dbg_msg("datafile", "num_m_aItemTypes=%d TypesSize=%d m_aItemsize=%d DataSize=%d", m_NumItemTypes, TypesSize, ItemSize, DataSize);
+		dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "num_m_aItemTypes=%d TypesSize=%d m_aItemsize=%d DataSize=%d", m_NumItemTypes, TypesSize, ItemSize, DataSize);
 
 	// construct Header
 	{
@@ -629,7 +725,7 @@ int CDataFileWriter::Finish()
 
 		// write Header
 		if(DEBUG)
-			dbg_msg("datafile", "HeaderSize=%d", (int)sizeof(Header));
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "HeaderSize=%d", (int)sizeof(Header));
 #if defined(CONF_ARCH_ENDIAN_BIG)
 		swap_endian(&Header, sizeof(int), sizeof(Header)/sizeof(int));
 #endif
@@ -647,7 +743,7 @@ int CDataFileWriter::Finish()
 			Info.m_Start = Count;
 			Info.m_Num = m_pItemTypes[i].m_Num;
 			if(DEBUG)
-				dbg_msg("datafile", "writing type=%x start=%d num=%d", Info.m_Type, Info.m_Start, Info.m_Num);
+				dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing type=%x start=%d num=%d", Info.m_Type, Info.m_Start, Info.m_Num);
 #if defined(CONF_ARCH_ENDIAN_BIG)
 			swap_endian(&Info, sizeof(int), sizeof(CDatafileItemType)/sizeof(int));
 #endif
@@ -666,7 +762,7 @@ int CDataFileWriter::Finish()
 			while(k != -1)
 			{
 				if(DEBUG)
-					dbg_msg("datafile", "writing item offset num=%d offset=%d", k, Offset);
+					dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing item offset num=%d offset=%d", k, Offset);
 				int Temp = Offset;
 #if defined(CONF_ARCH_ENDIAN_BIG)
 				swap_endian(&Temp, sizeof(int), sizeof(Temp)/sizeof(int));
@@ -684,7 +780,7 @@ int CDataFileWriter::Finish()
 	for(int i = 0, Offset = 0; i < m_NumDatas; i++)
 	{
 		if(DEBUG)
-			dbg_msg("datafile", "writing data offset num=%d offset=%d", i, Offset);
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing data offset num=%d offset=%d", i, Offset);
 		int Temp = Offset;
 #if defined(CONF_ARCH_ENDIAN_BIG)
 		swap_endian(&Temp, sizeof(int), sizeof(Temp)/sizeof(int));
@@ -697,7 +793,7 @@ int CDataFileWriter::Finish()
 	for(int i = 0; i < m_NumDatas; i++)
 	{
 		if(DEBUG)
-			dbg_msg("datafile", "writing data uncompressed size num=%d size=%d", i, m_pDatas[i].m_UncompressedSize);
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing data uncompressed size num=%d size=%d", i, m_pDatas[i].m_UncompressedSize);
 		int UncompressedSize = m_pDatas[i].m_UncompressedSize;
 #if defined(CONF_ARCH_ENDIAN_BIG)
 		swap_endian(&UncompressedSize, sizeof(int), sizeof(UncompressedSize)/sizeof(int));
@@ -718,7 +814,7 @@ int CDataFileWriter::Finish()
 				Item.m_TypeAndID = (i<<16)|m_pItems[k].m_ID;
 				Item.m_Size = m_pItems[k].m_Size;
 				if(DEBUG)
-					dbg_msg("datafile", "writing item type=%x idx=%d id=%d size=%d", i, k, m_pItems[k].m_ID, m_pItems[k].m_Size);
+					dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing item type=%x idx=%d id=%d size=%d", i, k, m_pItems[k].m_ID, m_pItems[k].m_Size);
 
 #if defined(CONF_ARCH_ENDIAN_BIG)
 				swap_endian(&Item, sizeof(int), sizeof(Item)/sizeof(int));
@@ -737,7 +833,7 @@ int CDataFileWriter::Finish()
 	for(int i = 0; i < m_NumDatas; i++)
 	{
 		if(DEBUG)
-			dbg_msg("datafile", "writing data id=%d size=%d", i, m_pDatas[i].m_CompressedSize);
+			dbg_msg_level(LOG_LEVEL_DEBUG, "datafile", "writing data id=%d size=%d", i, m_pDatas[i].m_CompressedSize);
 		io_write(m_File, m_pDatas[i].m_pCompressedData, m_pDatas[i].m_CompressedSize);
 	}
 
@@ -14,12 +14,17 @@ class CDataFileReader
 	int GetFileDataSize(int Index);
 
 public:
+	enum
+	{
+		OPENFLAG_WHOLE_FILE=1, // read the whole file at once and keep it, see FileData
+	};
+
 	CDataFileReader() : m_pDataFile(0) {}
 	~CDataFileReader() { Close(); }
 
 	bool IsOpen() const { return m_pDataFile != 0; }
 
-	bool Open(class IStorage *pStorage, const char *pFilename, int StorageType);
+	bool Open(class IStorage *pStorage, const char *pFilename, int StorageType, int Flags = 0);
 	bool Close();
 
 	void *GetData(int Index);
@@ -37,6 +42,10 @@ public:
 
 	SHA256_DIGEST Sha256() const;
 	unsigned Crc() const;
+
+	// the untouched file, only kept when opened with OPENFLAG_WHOLE_FILE.
+	// valid until the file is closed
+	const unsigned char *FileData(int *pSize) const;
 };
 
 // write access
@@ -117,6 +117,7 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 
 	m_LastKeyFrame = -1;
 	m_LastTickMarker = -1;
+	m_WriterLastTickMarker = -1;
 	m_FirstTick = -1;
 	m_NumTimelineMarkers = 0;
 
@@ -125,6 +126,8 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 	m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_recorder", aBuf);
 	m_File = DemoFile;
 
+	m_Writer.OpenRecords(this, QUEUE_SIZE, 2*sizeof(int) + CSnapshot::MAX_SIZE);
+
 	return 0;
 }
 
@@ -156,9 +159,40 @@ enum
 	CHUNKFLAG_BIGSIZE = 0x10
 };
 
+/*
+	Queue records
+		int	= Chunk type, CHUNKTYPE_SNAPSHOT or CHUNKTYPE_MESSAGE
+		int	= Tick
+		Size bytes of data
+*/
+
+void CDemoRecorder::Enqueue(int Type, int Tick, const void *pData, int Size)
+{
+	if(!m_File || Size < 0 || Size > CSnapshot::MAX_SIZE)
+		return;
+
+	int aHeader[2] = {Type, Tick};
+	m_Writer.WriteRecord(aHeader, sizeof(aHeader), pData, Size);
+
+	// a snapshot ends a tick, messages wait for it
+	if(Type == CHUNKTYPE_SNAPSHOT)
+		m_Writer.Flush();
+}
+
+void CDemoRecorder::OnRecord(const void *pData, int Size)
+{
+	const int *pHeader = (const int *)pData;
+	const void *pRecord = pHeader + 2;
+	Size -= 2*sizeof(int);
+	if(pHeader[0] == CHUNKTYPE_SNAPSHOT)
+		WriteSnapshot(pHeader[1], pRecord, Size);
+	else
+		Write(pHeader[0], pRecord, Size);
+}
+
 void CDemoRecorder::WriteTickMarker(int Tick, int Keyframe)
 {
-	if(m_LastTickMarker == -1 || Tick-m_LastTickMarker > 63 || Keyframe)
+	if(m_WriterLastTickMarker == -1 || Tick-m_WriterLastTickMarker > 63 || Keyframe)
 	{
 		unsigned char aChunk[5];
 		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER;
@@ -175,13 +209,11 @@ void CDemoRecorder::WriteTickMarker(int Tick, int Keyframe)
 	else
 	{
 		unsigned char aChunk[1];
-		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | (Tick-m_LastTickMarker);
+		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | (Tick-m_WriterLastTickMarker);
 		io_write(m_File, aChunk, sizeof(aChunk));
 	}
 
-	m_LastTickMarker = Tick;
-	if(m_FirstTick < 0)
-		m_FirstTick = Tick;
+	m_WriterLastTickMarker = Tick;
 }
 
 void CDemoRecorder::Write(int Type, const void *pData, int Size)
@@ -201,13 +233,13 @@ void CDemoRecorder::Write(int Type, const void *pData, int Size)
 	Size = CVariableInt::Compress(aBuffer2, Size, aBuffer, sizeof(aBuffer)); // buffer2 -> buffer
 	if(Size < 0)
 	{
-		m_pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "demo_recorder", "error during intpack compression");
+		dbg_msg("demo_recorder", "error during intpack compression");
 		return;
 	}
 	Size = CNetBase::Compress(aBuffer, Size, aBuffer2, sizeof(aBuffer2)); // buffer -> buffer2
 	if(Size < 0)
 	{
-		m_pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "demo_recorder", "error during network compression");
+		dbg_msg("demo_recorder", "error during network compression");
 		return;
 	}
 
@@ -237,7 +269,7 @@ void CDemoRecorder::Write(int Type, const void *pData, int Size)
 	io_write(m_File, aBuffer2, Size);
 }
 
-void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
+void CDemoRecorder::WriteSnapshot(int Tick, const void *pData, int Size)
 {
 	if(m_LastKeyFrame == -1 || (Tick-m_LastKeyFrame) > SERVER_TICK_SPEED*5)
 	{
@@ -269,9 +301,22 @@ void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
 	}
 }
 
+void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
+{
+	if(!m_File)
+		return;
+
+	// every snapshot gets a tick marker in the file
+	m_LastTickMarker = Tick;
+	if(m_FirstTick < 0)
+		m_FirstTick = Tick;
+
+	Enqueue(CHUNKTYPE_SNAPSHOT, Tick, pData, Size);
+}
+
 void CDemoRecorder::RecordMessage(const void *pData, int Size)
 {
-	Write(CHUNKTYPE_MESSAGE, pData, Size);
+	Enqueue(CHUNKTYPE_MESSAGE, -1, pData, Size);
 }
 
 int CDemoRecorder::Stop()
@@ -279,6 +324,15 @@ int CDemoRecorder::Stop()
 	if(!m_File)
 		return -1;
 
+	// the writer drains the queue before it exits
+	m_Writer.Close();
+	if(m_Writer.StalledBytes())
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "disk could not keep up, %lld bytes had to wait for queue space (peak backlog %d bytes)", m_Writer.StalledBytes(), m_Writer.PeakBacklog());
+		m_pConsole->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "demo_recorder", aBuf);
+	}
+
 	// add the demo length to the header
 	io_seek(m_File, gs_LengthOffset, IOSEEK_START);
 	int DemoLength = Length();
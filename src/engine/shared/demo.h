@@ -6,10 +6,22 @@
 #include <engine/demo.h>
 #include <engine/shared/protocol.h>
 
+#include "asyncwriter.h"
 #include "snapshot.h"
 
-class CDemoRecorder : public IDemoRecorder
+/*
+	Class: CDemoRecorder
+		Records snapshots and messages to a demo file. The recording
+		calls only queue the data on a record writer, its thread creates
+		the deltas, compresses the chunks and writes them to the file.
+*/
+class CDemoRecorder : public IDemoRecorder, private CAsyncWriter::IConsumer
 {
+	enum
+	{
+		QUEUE_SIZE=1024*1024,
+	};
+
 	class IConsole *m_pConsole;
 	IOHANDLE m_File;
 	int m_LastTickMarker;
@@ -20,8 +32,18 @@ class CDemoRecorder : public IDemoRecorder
 	int m_NumTimelineMarkers;
 	int m_aTimelineMarkers[MAX_TIMELINE_MARKERS];
 
+	// queue between the recording calls and the writer thread
+	CAsyncWriter m_Writer;
+
+	// only used by the writer thread
+	int m_WriterLastTickMarker;
+
+	void Enqueue(int Type, int Tick, const void *pData, int Size);
+	virtual void OnRecord(const void *pData, int Size);
+
 	void WriteTickMarker(int Tick, int Keyframe);
 	void Write(int Type, const void *pData, int Size);
+	void WriteSnapshot(int Tick, const void *pData, int Size);
 public:
 	CDemoRecorder(class CSnapshotDelta *pSnapshotDelta);
 
@@ -35,6 +57,12 @@ public:
 	bool IsRecording() const { return m_File != 0; }
 
 	int Length() const { return (m_LastTickMarker - m_FirstTick)/SERVER_TICK_SPEED; }
+
+	// bytes currently waiting for the writer thread
+	int Backlog() const { return m_Writer.Backlog(); }
+	int PeakBacklog() const { return m_Writer.PeakBacklog(); }
+	// bytes that had to wait for space in the queue
+	int64 StalledBytes() const { return m_Writer.StalledBytes(); }
 };
 
 class CDemoPlayer : public IDemoPlayer
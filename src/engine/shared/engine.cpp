@@ -1,5 +1,6 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <signal.h>
 #include <stdlib.h> // srand
 
 #include <base/system.h>
@@ -17,6 +18,21 @@ static int HostLookupThread(void *pUser)
 	return net_host_lookup(pLookup->m_aHostname, &pLookup->m_Addr, pLookup->m_Nettype);
 }
 
+static const int s_aCrashSignals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+static void (*s_apfnOldCrashHandlers[sizeof(s_aCrashSignals)/sizeof(s_aCrashSignals[0])])(int);
+
+// writes out the queued log lines, then crashes the way it would have
+static void CrashHandler(int Signal)
+{
+	dbg_logger_write_queued();
+	for(unsigned i = 0; i < sizeof(s_aCrashSignals)/sizeof(s_aCrashSignals[0]); i++)
+	{
+		if(s_aCrashSignals[i] == Signal)
+			signal(Signal, s_apfnOldCrashHandlers[i] == SIG_ERR || s_apfnOldCrashHandlers[i] == SIG_IGN ? SIG_DFL : s_apfnOldCrashHandlers[i]);
+	}
+	raise(Signal);
+}
+
 class CEngine : public IEngine
 {
 public:
@@ -46,6 +62,33 @@ public:
 		}
 	}
 
+	static void Con_LogLevel(IConsole::IResult *pResult, void *pUserData)
+	{
+		CEngine *pEngine = static_cast<CEngine *>(pUserData);
+		static const char *s_apLevels[NUM_LOG_LEVELS] = {"error", "warn", "info", "debug"};
+
+		int Level = -1;
+		for(int i = 0; i < NUM_LOG_LEVELS; i++)
+		{
+			if(str_comp_nocase(pResult->GetString(0), s_apLevels[i]) == 0)
+				Level = i;
+		}
+		const char *pSystem = pResult->NumArguments() > 1 ? pResult->GetString(1) : 0;
+		if(Level == -1 && (!pSystem || str_comp_nocase(pResult->GetString(0), "default") != 0))
+		{
+			pEngine->m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "engine", "log levels are error, warn, info and debug, 'default' resets a system");
+			return;
+		}
+		dbg_logger_level(pSystem, Level);
+	}
+
+	static void ConchainLogRateLimit(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+	{
+		pfnCallback(pResult, pCallbackUserData);
+		if(pResult->NumArguments() == 1)
+			dbg_logger_rate_limit(g_Config.m_LogRateLimit);
+	}
+
 	CEngine(const char *pAppname)
 	{
 		srand(time_get());
@@ -80,6 +123,8 @@ public:
 			return;
 
 		m_pConsole->Register("dbg_lognetwork", "", CFGFLAG_SERVER|CFGFLAG_CLIENT, Con_DbgLognetwork, this, "Log the network");
+		m_pConsole->Register("log_level", "s[level] ?s[system]", CFGFLAG_SERVER|CFGFLAG_CLIENT, Con_LogLevel, this, "Set the most verbose level that is logged, of all systems or of one");
+		m_pConsole->Chain("log_rate_limit", ConchainLogRateLimit, this);
 	}
 
 	void InitLogfile()
@@ -96,6 +141,25 @@ public:
 			str_format(aLogFilename, sizeof(aLogFilename), "%s%s.txt", g_Config.m_Logfile, aBuf);
 			dbg_logger_file(aLogFilename);
 		}
+
+		dbg_logger_rate_limit(g_Config.m_LogRateLimit);
+		// the loggers are complete now, they can move to their thread
+		if(g_Config.m_LogAsync)
+		{
+			dbg_logger_async_start();
+			static bool s_CrashHandlersInstalled = false;
+			if(!s_CrashHandlersInstalled)
+			{
+				for(unsigned i = 0; i < sizeof(s_aCrashSignals)/sizeof(s_aCrashSignals[0]); i++)
+					s_apfnOldCrashHandlers[i] = signal(s_aCrashSignals[i], CrashHandler);
+				s_CrashHandlersInstalled = true;
+			}
+		}
+	}
+
+	~CEngine()
+	{
+		dbg_logger_async_stop();
 	}
 
 	void HostLookup(CHostLookup *pLookup, const char *pHostname, int Nettype)
@@ -1,6 +1,7 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include <base/system.h>
+#include <base/tl/threading.h>
 #include "jobs.h"
 
 CJobPool::CJobPool()
@@ -9,6 +10,9 @@ CJobPool::CJobPool()
 	m_NumThreads = 0;
 	m_Shutdown = false;
 	m_Lock = lock_create();
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_init(&m_Semaphore);
+#endif
 	m_pFirstJob = 0;
 	m_pLastJob = 0;
 }
@@ -16,11 +20,18 @@ CJobPool::CJobPool()
 CJobPool::~CJobPool()
 {
 	m_Shutdown = true;
+#if !defined(CONF_PLATFORM_MACOSX)
+	for(int i = 0; i < m_NumThreads; i++)
+		semaphore_signal(&m_Semaphore);
+#endif
 	for(int i = 0; i < m_NumThreads; i++)
 	{
 		thread_wait(m_apThreads[i]);
 		thread_destroy(m_apThreads[i]);
 	}
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_destroy(&m_Semaphore);
+#endif
 	lock_destroy(m_Lock);
 }
 
@@ -32,6 +43,11 @@ void CJobPool::WorkerThread(void *pUser)
 	{
 		CJob *pJob = 0;
 
+#if !defined(CONF_PLATFORM_MACOSX)
+		// sleep until a job gets added
+		semaphore_wait(&pPool->m_Semaphore);
+#endif
+
 		// fetch job from queue
 		lock_wait(pPool->m_Lock);
 		if(pPool->m_pFirstJob)
@@ -50,10 +66,13 @@ void CJobPool::WorkerThread(void *pUser)
 		{
 			pJob->m_Status = CJob::STATE_RUNNING;
 			pJob->m_Result = pJob->m_pfnFunc(pJob->m_pFuncData);
+			sync_barrier();
 			pJob->m_Status = CJob::STATE_DONE;
 		}
+#if defined(CONF_PLATFORM_MACOSX)
 		else
 			thread_sleep(10);
+#endif
 	}
 
 }
@@ -84,6 +103,10 @@ int CJobPool::Add(CJob *pJob, JOBFUNC pfnFunc, void *pData)
 		m_pFirstJob = pJob;
 
 	lock_unlock(m_Lock);
+
+#if !defined(CONF_PLATFORM_MACOSX)
+	semaphore_signal(&m_Semaphore);
+#endif
 	return 0;
 }
 
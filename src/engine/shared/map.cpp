@@ -27,13 +27,13 @@ public:
 		m_DataFile.Close();
 	}
 
-	virtual bool Load(const char *pMapName, IStorage *pStorage)
+	virtual bool Load(const char *pMapName, IStorage *pStorage, int Flags)
 	{
 		if(!pStorage)
 			pStorage = Kernel()->RequestInterface<IStorage>();
 		if(!pStorage)
 			return false;
-		if(!m_DataFile.Open(pStorage, pMapName, IStorage::TYPE_ALL))
+		if(!m_DataFile.Open(pStorage, pMapName, IStorage::TYPE_ALL, Flags))
 			return false;
 		// check version
 		CMapItemVersion *pItem = (CMapItemVersion *)m_DataFile.FindItem(MAPITEMTYPE_VERSION, 0);
@@ -107,6 +107,11 @@ public:
 	{
 		return m_DataFile.Crc();
 	}
+
+	virtual const unsigned char *FileData(int *pSize)
+	{
+		return m_DataFile.FileData(pSize);
+	}
 };
 
 extern IEngineMap *CreateEngineMap() { return new CMap; }
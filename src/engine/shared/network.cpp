@@ -7,6 +7,65 @@
 #include "network.h"
 #include "huffman.h"
 
+void CNetSendQueue::Init(NETSOCKET Socket)
+{
+	m_Socket = Socket;
+	m_Active = false;
+	m_NumPackets = 0;
+	for(int i = 0; i < MAX_PACKETS; i++)
+		m_aPackets[i].data = m_aaBuffers[i];
+}
+
+void CNetSendQueue::Queue(const NETADDR *pAddr, const void *pData, int DataSize)
+{
+	if(m_NumPackets == MAX_PACKETS)
+		Flush();
+
+	NETDATAGRAM *pPacket = &m_aPackets[m_NumPackets++];
+	pPacket->addr = *pAddr;
+	pPacket->size = DataSize;
+	mem_copy(pPacket->data, pData, DataSize);
+}
+
+void CNetSendQueue::Flush()
+{
+	if(m_NumPackets)
+	{
+		int Sent = net_udp_send_batch(m_Socket, m_aPackets, m_NumPackets);
+		if(Sent < m_NumPackets)
+			dbg_msg("net", "failed to send %d of %d packets", m_NumPackets - Sent, m_NumPackets);
+	}
+	m_NumPackets = 0;
+}
+
+void CNetRecvQueue::Init(NETSOCKET Socket)
+{
+	m_Socket = Socket;
+	m_NumPackets = 0;
+	m_CurrentPacket = 0;
+	for(int i = 0; i < MAX_PACKETS; i++)
+		m_aPackets[i].data = m_aaBuffers[i];
+}
+
+int CNetRecvQueue::Fetch(NETADDR *pAddr, unsigned char **ppData)
+{
+	if(m_CurrentPacket >= m_NumPackets)
+	{
+		m_CurrentPacket = 0;
+		m_NumPackets = net_udp_recv_batch(m_Socket, m_aPackets, MAX_PACKETS, NET_MAX_PACKETSIZE);
+		if(m_NumPackets <= 0)
+		{
+			m_NumPackets = 0;
+			return 0;
+		}
+	}
+
+	NETDATAGRAM *pPacket = &m_aPackets[m_CurrentPacket++];
+	*pAddr = pPacket->addr;
+	*ppData = (unsigned char *)pPacket->data;
+	return pPacket->size;
+}
+
 void CNetRecvUnpacker::Clear()
 {
 	m_Valid = false;
@@ -113,7 +172,7 @@ void CNetBase::SendPacketConnless(NETSOCKET Socket, const NETADDR *pAddr, TOKEN
 	net_udp_send(Socket, pAddr, aBuffer, i+DataSize);
 }
 
-void CNetBase::SendPacket(NETSOCKET Socket, const NETADDR *pAddr, CNetPacketConstruct *pPacket)
+void CNetBase::SendPacket(NETSOCKET Socket, const NETADDR *pAddr, CNetPacketConstruct *pPacket, CNetSendQueue *pSendQueue)
 {
 	unsigned char aBuffer[NET_MAX_PACKETSIZE];
 	int CompressedSize = -1;
@@ -165,7 +224,10 @@ void CNetBase::SendPacket(NETSOCKET Socket, const NETADDR *pAddr, CNetPacketCons
 
 		dbg_assert(i == NET_PACKETHEADERSIZE, "inconsistency");
 
-		net_udp_send(Socket, pAddr, aBuffer, FinalSize);
+		if(pSendQueue && pSendQueue->Active())
+			pSendQueue->Queue(pAddr, aBuffer, FinalSize);
+		else
+			net_udp_send(Socket, pAddr, aBuffer, FinalSize);
 
 		// log raw socket data
 		if(ms_DataLogSent)
@@ -273,6 +273,50 @@ private:
 };
 
 
+// collects outgoing packets so they can be handed to the socket in one batch
+class CNetSendQueue
+{
+	enum
+	{
+		MAX_PACKETS = NET_MAX_CLIENTS*4,
+	};
+
+	NETSOCKET m_Socket;
+	bool m_Active;
+	int m_NumPackets;
+	NETDATAGRAM m_aPackets[MAX_PACKETS];
+	unsigned char m_aaBuffers[MAX_PACKETS][NET_MAX_PACKETSIZE];
+
+public:
+	void Init(NETSOCKET Socket);
+	void Begin() { m_Active = true; }
+	void End() { Flush(); m_Active = false; }
+	bool Active() const { return m_Active; }
+
+	void Queue(const NETADDR *pAddr, const void *pData, int DataSize);
+	void Flush();
+};
+
+// fetches incoming packets from the socket in batches
+class CNetRecvQueue
+{
+	enum
+	{
+		MAX_PACKETS = 32,
+	};
+
+	NETSOCKET m_Socket;
+	int m_NumPackets;
+	int m_CurrentPacket;
+	NETDATAGRAM m_aPackets[MAX_PACKETS];
+	unsigned char m_aaBuffers[MAX_PACKETS][NET_MAX_PACKETSIZE];
+
+public:
+	void Init(NETSOCKET Socket);
+	int Fetch(NETADDR *pAddr, unsigned char **ppData);
+};
+
+
 class CNetConnection
 {
 	// TODO: is this needed because this needs to be aware of
@@ -289,6 +333,7 @@ private:
 	bool m_BlockCloseMsg;
 
 	TStaticRingBuffer<CNetChunkResend, NET_CONN_BUFFERSIZE> m_Buffer;
+	int m_UnackedBytes; // payload of the vital chunks in m_Buffer
 
 	int64 m_LastUpdateTime;
 	int64 m_LastRecvTime;
@@ -304,6 +349,7 @@ private:
 
 	NETSOCKET m_Socket;
 	NETSTATS m_Stats;
+	CNetSendQueue *m_pSendQueue;
 
 	//
 	void Reset();
@@ -325,6 +371,7 @@ public:
 	void Disconnect(const char *pReason);
 
 	void SetToken(TOKEN Token);
+	void SetSendQueue(CNetSendQueue *pSendQueue) { m_pSendQueue = pSendQueue; }
 
 	TOKEN Token() const { return m_Token; }
 	TOKEN PeerToken() const { return m_PeerToken; }
@@ -350,6 +397,7 @@ public:
 	int64 ConnectTime() const { return m_LastUpdateTime; }
 
 	int AckSequence() const { return m_Ack; }
+	int UnackedBytes() const { return m_UnackedBytes; }
 };
 
 class CConsoleNetConnection
@@ -400,6 +448,29 @@ public:
 	int FetchChunk(CNetChunk *pChunk);
 };
 
+// maps peer addresses (including port) to server slots, open addressing with linear probing
+class CNetAddrIndex
+{
+	enum
+	{
+		HASH_SIZE = NET_MAX_CLIENTS*4,
+		HASH_MASK = HASH_SIZE-1,
+	};
+
+	NETADDR m_aAddr[HASH_SIZE];
+	int m_aSlot[HASH_SIZE]; // -1 for empty buckets
+
+	static unsigned Hash(const NETADDR *pAddr);
+	int FindBucket(const NETADDR *pAddr) const;
+
+public:
+	CNetAddrIndex() { Clear(); }
+	void Clear();
+	bool Insert(const NETADDR *pAddr, int Slot);
+	void Remove(const NETADDR *pAddr);
+	int Find(const NETADDR *pAddr) const { int Bucket = FindBucket(pAddr); return Bucket < 0 ? -1 : m_aSlot[Bucket]; }
+};
+
 // server side
 class CNetServer
 {
@@ -412,6 +483,7 @@ class CNetServer
 	NETSOCKET m_Socket;
 	class CNetBan *m_pNetBan;
 	CSlot m_aSlots[NET_MAX_CLIENTS];
+	CNetAddrIndex m_AddrIndex;
 	int m_MaxClients;
 	int m_MaxClientsPerIP;
 
@@ -420,6 +492,8 @@ class CNetServer
 	void *m_UserPtr;
 
 	CNetRecvUnpacker m_RecvUnpacker;
+	CNetRecvQueue m_RecvQueue;
+	CNetSendQueue m_SendQueue;
 
 	CNetTokenManager m_TokenManager;
 	CNetTokenCache m_TokenCache;
@@ -438,11 +512,17 @@ public:
 	int Update();
 	void AddToken(const NETADDR *pAddr, TOKEN Token) { m_TokenCache.AddToken(pAddr, Token, 0); };
 
+	// packets flushed by connections between these calls are sent in one batch
+	void BeginSendBatch() { m_SendQueue.Begin(); }
+	void EndSendBatch() { m_SendQueue.End(); }
+
 	//
 	int Drop(int ClientID, const char *pReason);
 
 	// status requests
 	const NETADDR *ClientAddr(int ClientID) const { return m_aSlots[ClientID].m_Connection.PeerAddress(); }
+	// vital data sent to a client that it did not acknowledge yet
+	int ClientUnackedBytes(int ClientID) const { return m_aSlots[ClientID].m_Connection.UnackedBytes(); }
 	NETSOCKET Socket() const { return m_Socket; }
 	class CNetBan *NetBan() const { return m_pNetBan; }
 	int NetType() const { return m_Socket.type; }
@@ -548,7 +628,7 @@ public:
 	static void SendControlMsg(NETSOCKET Socket, const NETADDR *pAddr, TOKEN Token, int Ack, int ControlMsg, const void *pExtra, int ExtraSize);
 	static void SendControlMsgWithToken(NETSOCKET Socket, const NETADDR *pAddr, TOKEN Token, int Ack, int ControlMsg, TOKEN MyToken, bool Extended);
 	static void SendPacketConnless(NETSOCKET Socket, const NETADDR *pAddr, TOKEN Token, TOKEN ResponseToken, const void *pData, int DataSize);
-	static void SendPacket(NETSOCKET Socket, const NETADDR *pAddr, CNetPacketConstruct *pPacket);
+	static void SendPacket(NETSOCKET Socket, const NETADDR *pAddr, CNetPacketConstruct *pPacket, CNetSendQueue *pSendQueue = 0);
 	static int UnpackPacket(unsigned char *pBuffer, int Size, CNetPacketConstruct *pPacket);
 
 	// The backroom is ack-NET_MAX_SEQUENCE/2. Used for knowing if we acked a packet or not
@@ -27,6 +27,7 @@ void CNetConnection::Reset()
 	mem_zero(&m_PeerAddr, sizeof(m_PeerAddr));
 
 	m_Buffer.Init();
+	m_UnackedBytes = 0;
 
 	mem_zero(&m_Construct, sizeof(m_Construct));
 }
@@ -61,6 +62,7 @@ void CNetConnection::Init(NETSOCKET Socket, bool BlockCloseMsg)
 
 	m_Socket = Socket;
 	m_BlockCloseMsg = BlockCloseMsg;
+	m_pSendQueue = 0;
 	mem_zero(m_ErrorString, sizeof(m_ErrorString));
 }
 
@@ -73,7 +75,10 @@ void CNetConnection::AckChunks(int Ack)
 			break;
 
 		if(CNetBase::IsSeqInBackroom(pResend->m_Sequence, Ack))
+		{
+			m_UnackedBytes -= pResend->m_DataSize;
 			m_Buffer.PopFirst();
+		}
 		else
 			break;
 	}
@@ -93,7 +98,7 @@ int CNetConnection::Flush()
 	// send of the packets
 	m_Construct.m_Ack = m_Ack;
 	m_Construct.m_Token = m_PeerToken;
-	CNetBase::SendPacket(m_Socket, &m_PeerAddr, &m_Construct);
+	CNetBase::SendPacket(m_Socket, &m_PeerAddr, &m_Construct, m_pSendQueue);
 
 	// update send times
 	m_LastSendTime = time_get();
@@ -140,6 +145,7 @@ int CNetConnection::QueueChunkEx(int Flags, int DataSize, const void *pData, int
 			pResend->m_FirstSendTime = time_get();
 			pResend->m_LastSendTime = pResend->m_FirstSendTime;
 			mem_copy(pResend->m_pData, pData, DataSize);
+			m_UnackedBytes += DataSize;
 		}
 		else
 		{
@@ -8,10 +8,78 @@
 #include "network.h"
 
 
+unsigned CNetAddrIndex::Hash(const NETADDR *pAddr)
+{
+	// FNV-1a over the significant address bytes and the port
+	int Length = pAddr->type == NETTYPE_IPV4 ? 4 : 16;
+	unsigned Hash = 2166136261u;
+	for(int i = 0; i < Length; i++)
+		Hash = (Hash ^ pAddr->ip[i]) * 16777619u;
+	Hash = (Hash ^ (pAddr->port&0xff)) * 16777619u;
+	Hash = (Hash ^ (pAddr->port>>8)) * 16777619u;
+	return Hash ^ (Hash>>16);
+}
+
+int CNetAddrIndex::FindBucket(const NETADDR *pAddr) const
+{
+	for(unsigned Bucket = Hash(pAddr)&HASH_MASK; m_aSlot[Bucket] != -1; Bucket = (Bucket+1)&HASH_MASK)
+	{
+		if(net_addr_comp(&m_aAddr[Bucket], pAddr) == 0)
+			return Bucket;
+	}
+	return -1;
+}
+
+void CNetAddrIndex::Clear()
+{
+	mem_zero(m_aAddr, sizeof(m_aAddr));
+	for(int i = 0; i < HASH_SIZE; i++)
+		m_aSlot[i] = -1;
+}
+
+bool CNetAddrIndex::Insert(const NETADDR *pAddr, int Slot)
+{
+	unsigned Bucket = Hash(pAddr)&HASH_MASK;
+	for(int i = 0; i < HASH_SIZE; i++, Bucket = (Bucket+1)&HASH_MASK)
+	{
+		if(m_aSlot[Bucket] == -1 || net_addr_comp(&m_aAddr[Bucket], pAddr) == 0)
+		{
+			m_aAddr[Bucket] = *pAddr;
+			m_aSlot[Bucket] = Slot;
+			return true;
+		}
+	}
+	return false;
+}
+
+void CNetAddrIndex::Remove(const NETADDR *pAddr)
+{
+	int Bucket = FindBucket(pAddr);
+	if(Bucket < 0)
+		return;
+
+	// backward shift deletion, keeps probe chains intact without tombstones
+	unsigned Hole = Bucket;
+	for(unsigned Next = (Hole+1)&HASH_MASK; m_aSlot[Next] != -1; Next = (Next+1)&HASH_MASK)
+	{
+		unsigned Home = Hash(&m_aAddr[Next])&HASH_MASK;
+		// move the entry into the hole if its home bucket is not between the hole and its position
+		if(((Next-Home)&HASH_MASK) >= ((Next-Hole)&HASH_MASK))
+		{
+			m_aAddr[Hole] = m_aAddr[Next];
+			m_aSlot[Hole] = m_aSlot[Next];
+			Hole = Next;
+		}
+	}
+	mem_zero(&m_aAddr[Hole], sizeof(m_aAddr[Hole]));
+	m_aSlot[Hole] = -1;
+}
+
 bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int MaxClientsPerIP, int Flags)
 {
 	// zero out the whole structure
 	mem_zero(this, sizeof(*this));
+	m_AddrIndex.Clear();
 
 	// open socket
 	m_Socket = net_udp_create(BindAddr, 0);
@@ -20,6 +88,8 @@ bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int Ma
 
 	m_TokenManager.Init(m_Socket);
 	m_TokenCache.Init(m_Socket, &m_TokenManager);
+	m_RecvQueue.Init(m_Socket);
+	m_SendQueue.Init(m_Socket);
 
 	m_pNetBan = pNetBan;
 
@@ -33,7 +103,10 @@ bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int Ma
 	m_MaxClientsPerIP = MaxClientsPerIP;
 
 	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
 		m_aSlots[i].m_Connection.Init(m_Socket, true);
+		m_aSlots[i].m_Connection.SetSendQueue(&m_SendQueue);
+	}
 
 	m_Flags = Flags;
 
@@ -67,6 +140,8 @@ int CNetServer::Drop(int ClientID, const char *pReason)
 	if(m_pfnDelClient)
 		m_pfnDelClient(ClientID, pReason, m_UserPtr);
 
+	if(m_aSlots[ClientID].m_Connection.State() != NET_CONNSTATE_OFFLINE)
+		m_AddrIndex.Remove(m_aSlots[ClientID].m_Connection.PeerAddress());
 	m_aSlots[ClientID].m_Connection.Disconnect(pReason);
 
 	return 0;
@@ -110,13 +185,14 @@ int CNetServer::Recv(CNetChunk *pChunk, TOKEN *pResponseToken)
 			return 1;
 
 		// TODO: empty the recvinfo
-		int Bytes = net_udp_recv(m_Socket, &Addr, m_RecvUnpacker.m_aBuffer, NET_MAX_PACKETSIZE);
+		unsigned char *pData;
+		int Bytes = m_RecvQueue.Fetch(&Addr, &pData);
 
 		// no more packets for now
 		if(Bytes <= 0)
 			break;
 
-		if(CNetBase::UnpackPacket(m_RecvUnpacker.m_aBuffer, Bytes, &m_RecvUnpacker.m_Data) == 0)
+		if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvUnpacker.m_Data) == 0)
 		{
 			// check for bans
 			char aBuf[128];
@@ -132,37 +208,31 @@ int CNetServer::Recv(CNetChunk *pChunk, TOKEN *pResponseToken)
 				continue;
 			}
 
-			bool Found = false;
 			// try to find matching slot
-			for(int i = 0; i < MaxClients(); i++)
+			int Slot = m_AddrIndex.Find(&Addr);
+			if(Slot >= 0)
 			{
-				if(net_addr_comp(m_aSlots[i].m_Connection.PeerAddress(), &Addr) == 0)
+				if(m_aSlots[Slot].m_Connection.Feed(&m_RecvUnpacker.m_Data, &Addr))
 				{
-					if(m_aSlots[i].m_Connection.Feed(&m_RecvUnpacker.m_Data, &Addr))
+					if(m_RecvUnpacker.m_Data.m_DataSize)
 					{
-						if(m_RecvUnpacker.m_Data.m_DataSize)
+						if(!(m_RecvUnpacker.m_Data.m_Flags&NET_PACKETFLAG_CONNLESS))
+							m_RecvUnpacker.Start(&Addr, &m_aSlots[Slot].m_Connection, Slot);
+						else
 						{
-							if(!(m_RecvUnpacker.m_Data.m_Flags&NET_PACKETFLAG_CONNLESS))
-								m_RecvUnpacker.Start(&Addr, &m_aSlots[i].m_Connection, i);
-							else
-							{
-								pChunk->m_Flags = NETSENDFLAG_CONNLESS;
-								pChunk->m_Address = *m_aSlots[i].m_Connection.PeerAddress();
-								pChunk->m_ClientID = i;
-								pChunk->m_DataSize = m_RecvUnpacker.m_Data.m_DataSize;
-								pChunk->m_pData = m_RecvUnpacker.m_Data.m_aChunkData;
-								if(pResponseToken)
-									*pResponseToken = NET_TOKEN_NONE;
-								return 1;
-							}
+							pChunk->m_Flags = NETSENDFLAG_CONNLESS;
+							pChunk->m_Address = *m_aSlots[Slot].m_Connection.PeerAddress();
+							pChunk->m_ClientID = Slot;
+							pChunk->m_DataSize = m_RecvUnpacker.m_Data.m_DataSize;
+							pChunk->m_pData = m_RecvUnpacker.m_Data.m_aChunkData;
+							if(pResponseToken)
+								*pResponseToken = NET_TOKEN_NONE;
+							return 1;
 						}
 					}
-					Found = true;
 				}
-			}
-
-			if(Found)
 				continue;
+			}
 
 			int Accept = m_TokenManager.ProcessMessage(&Addr, &m_RecvUnpacker.m_Data);
 			if(Accept <= 0)
@@ -204,6 +274,8 @@ int CNetServer::Recv(CNetChunk *pChunk, TOKEN *pResponseToken)
 							Found = true;
 							m_aSlots[i].m_Connection.SetToken(m_RecvUnpacker.m_Data.m_Token);
 							m_aSlots[i].m_Connection.Feed(&m_RecvUnpacker.m_Data, &Addr);
+							if(m_aSlots[i].m_Connection.State() != NET_CONNSTATE_OFFLINE)
+								m_AddrIndex.Insert(m_aSlots[i].m_Connection.PeerAddress(), i);
 							if(m_pfnNewClient)
 								m_pfnNewClient(i, m_UserPtr);
 							break;
@@ -245,14 +317,9 @@ int CNetServer::Send(CNetChunk *pChunk, TOKEN Token)
 			return -1;
 		}
 
+		// upgrade the packet, now that we know its recipent
 		if(pChunk->m_ClientID == -1)
-			for(int i = 0; i < MaxClients(); i++)
-				if(net_addr_comp(&pChunk->m_Address, m_aSlots[i].m_Connection.PeerAddress()) == 0)
-				{
-					// upgrade the packet, now that we know its recipent
-					pChunk->m_ClientID = i;
-					break;
-				}
+			pChunk->m_ClientID = m_AddrIndex.Find(&pChunk->m_Address);
 
 		if(Token != NET_TOKEN_NONE)
 		{
@@ -132,50 +132,71 @@ void CSnapshot::DebugDump() const
 }
 
 
-// CSnapshotDelta
+// CSnapshotHash
+
+static unsigned HashKey(int Key)
+{
+	return (unsigned)Key * 2654435761u;
+}
 
-struct CItemList
+int CSnapshotHash::NumSlots(int NumItems)
 {
-	int m_Num;
-	int m_aKeys[64];
-	int m_aIndex[64];
-};
+	// keep the table at most half full
+	int Num = MIN_SLOTS;
+	while(Num < NumItems*2)
+		Num <<= 1;
+	return Num;
+}
 
-enum
+int CSnapshotHash::Size(int NumItems)
 {
-	HASHLIST_SIZE = 256,
-};
+	// a key and an index per slot
+	return sizeof(CSnapshotHash) + NumSlots(NumItems)*2*sizeof(int);
+}
 
-static void GenerateHash(CItemList *pHashlist, const CSnapshot *pSnapshot)
+void CSnapshotHash::Build(const CSnapshot *pSnapshot)
 {
-	for(int i = 0; i < HASHLIST_SIZE; i++)
-		pHashlist[i].m_Num = 0;
+	dbg_assert(pSnapshot->NumItems() <= MAX_ITEMS, "too many snapshot items to hash");
+
+	int NumSlots = CSnapshotHash::NumSlots(pSnapshot->NumItems());
+	m_Mask = NumSlots-1;
+	int *pSlots = Slots();
+	for(int i = 0; i < NumSlots; i++)
+		pSlots[i*2+1] = -1;
 
 	for(int i = 0; i < pSnapshot->NumItems(); i++)
 	{
 		int Key = pSnapshot->GetItem(i)->Key();
-		int HashID = ((Key>>12)&0xf0) | (Key&0xf);
-		if(pHashlist[HashID].m_Num != 64)
+		int Slot = HashKey(Key)&m_Mask;
+		while(pSlots[Slot*2+1] != -1)
+		{
+			// keys are unique, but keep the first one if they are not
+			if(pSlots[Slot*2] == Key)
+				break;
+			Slot = (Slot+1)&m_Mask;
+		}
+		if(pSlots[Slot*2+1] == -1)
 		{
-			pHashlist[HashID].m_aIndex[pHashlist[HashID].m_Num] = i;
-			pHashlist[HashID].m_aKeys[pHashlist[HashID].m_Num] = Key;
-			pHashlist[HashID].m_Num++;
+			pSlots[Slot*2] = Key;
+			pSlots[Slot*2+1] = i;
 		}
 	}
 }
 
-static int GetItemIndexHashed(int Key, const CItemList *pHashlist)
+int CSnapshotHash::GetItemIndex(int Key) const
 {
-		int HashID = ((Key>>12)&0xf0) | (Key&0xf);
-		for(int i = 0; i < pHashlist[HashID].m_Num; i++)
-		{
-			if(pHashlist[HashID].m_aKeys[i] == Key)
-				return pHashlist[HashID].m_aIndex[i];
+	const int *pSlots = Slots();
+	for(int Slot = HashKey(Key)&m_Mask; pSlots[Slot*2+1] != -1; Slot = (Slot+1)&m_Mask)
+	{
+		if(pSlots[Slot*2] == Key)
+			return pSlots[Slot*2+1];
 	}
-
 	return -1;
 }
 
+
+// CSnapshotDelta
+
 int CSnapshotDelta::DiffItem(const int *pPast, const int *pCurrent, int *pOut, int Size)
 {
 	int Needed = 0;
@@ -233,8 +254,19 @@ CSnapshotDelta::CData *CSnapshotDelta::EmptyDelta()
 	return &m_Empty;
 }
 
-// TODO: OPT: this should be made much faster
 int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, CSnapshot *pTo, void *pDstData)
+{
+	static const int HASH_SIZE = (sizeof(CSnapshotHash) + 4*CSnapshotHash::MAX_ITEMS*sizeof(int) + sizeof(int)-1) / sizeof(int);
+	int aFromHash[HASH_SIZE];
+	int aToHash[HASH_SIZE];
+	CSnapshotHash *pFromHash = (CSnapshotHash *)aFromHash;
+	CSnapshotHash *pToHash = (CSnapshotHash *)aToHash;
+	pFromHash->Build(pFrom);
+	pToHash->Build(pTo);
+	return CreateDelta(pFrom, pFromHash, pTo, pToHash, pDstData);
+}
+
+int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, const CSnapshotHash *pFromHash, CSnapshot *pTo, const CSnapshotHash *pToHash, void *pDstData)
 {
 	CData *pDelta = (CData *)pDstData;
 	int *pData = (int *)pDelta->m_pData;
@@ -248,14 +280,11 @@ int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, CSnapshot *pTo, void *pD
 	pDelta->m_NumUpdateItems = 0;
 	pDelta->m_NumTempItems = 0;
 
-	CItemList Hashlist[HASHLIST_SIZE];
-	GenerateHash(Hashlist, pTo);
-
 	// pack deleted stuff
 	for(i = 0; i < pFrom->NumItems(); i++)
 	{
 		pFromItem = pFrom->GetItem(i);
-		if(GetItemIndexHashed(pFromItem->Key(), Hashlist) == -1)
+		if(pToHash->GetItemIndex(pFromItem->Key()) == -1)
 		{
 			// deleted
 			pDelta->m_NumDeletedItems++;
@@ -264,8 +293,7 @@ int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, CSnapshot *pTo, void *pD
 		}
 	}
 
-	GenerateHash(Hashlist, pFrom);
-	int aPastIndecies[1024];
+	int aPastIndecies[CSnapshotHash::MAX_ITEMS];
 
 	// fetch previous indices
 	// we do this as a separate pass because it helps the cache
@@ -273,7 +301,7 @@ int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, CSnapshot *pTo, void *pD
 	for(i = 0; i < NumItems; i++)
 	{
 		pCurItem = pTo->GetItem(i); // O(1) .. O(n)
-		aPastIndecies[i] = GetItemIndexHashed(pCurItem->Key(), Hashlist); // O(n) .. O(n^n)
+		aPastIndecies[i] = pFromHash->GetItemIndex(pCurItem->Key()); // O(1)
 	}
 
 	for(i = 0; i < NumItems; i++)
@@ -455,6 +483,7 @@ void CSnapshotStorage::Init()
 {
 	m_pFirst = 0;
 	m_pLast = 0;
+	m_pFree = 0;
 }
 
 void CSnapshotStorage::PurgeAll()
@@ -469,47 +498,58 @@ void CSnapshotStorage::PurgeAll()
 		pHolder = pNext;
 	}
 
+	for(pHolder = m_pFree; pHolder; pHolder = pNext)
+	{
+		pNext = pHolder->m_pNext;
+		mem_free(pHolder);
+	}
+
 	// no more snapshots in storage
 	m_pFirst = 0;
 	m_pLast = 0;
+	m_pFree = 0;
 }
 
 void CSnapshotStorage::PurgeUntil(int Tick)
 {
-	CHolder *pHolder = m_pFirst;
-	CHolder *pNext;
-
-	while(pHolder)
+	while(m_pFirst && m_pFirst->m_Tick < Tick)
 	{
-		pNext = pHolder->m_pNext;
-		if(pHolder->m_Tick >= Tick)
-			return; // no more to remove
-		mem_free(pHolder);
-
-		// did we come to the end of the list?
-		if (!pNext)
-			break;
-
-		m_pFirst = pNext;
-		pNext->m_pPrev = 0x0;
+		CHolder *pHolder = m_pFirst;
+		m_pFirst = pHolder->m_pNext;
+		if(m_pFirst)
+			m_pFirst->m_pPrev = 0;
+		else
+			m_pLast = 0;
 
-		pHolder = pNext;
+		// keep it for the next snapshots
+		pHolder->m_pNext = m_pFree;
+		m_pFree = pHolder;
 	}
-
-	// no more snapshots in storage
-	m_pFirst = 0;
-	m_pLast = 0;
 }
 
-void CSnapshotStorage::Add(int Tick, int64 Tagtime, int DataSize, void *pData, int CreateAlt)
+void CSnapshotStorage::Add(int Tick, int64 Tagtime, int DataSize, void *pData, int CreateAlt, bool CreateHash)
 {
-	// allocate memory for holder + snapshot_data
-	int TotalSize = sizeof(CHolder)+DataSize;
-
+	// room for the snapshot, its copy and its hash behind the holder
+	int HashSize = CreateHash ? CSnapshotHash::Size(((CSnapshot *)pData)->NumItems()) : 0;
+	int BufferSize = DataSize + HashSize;
 	if(CreateAlt)
-		TotalSize += DataSize;
+		BufferSize += DataSize;
 
-	CHolder *pHolder = (CHolder *)mem_alloc(TotalSize, 1);
+	CHolder *pHolder = m_pFree;
+	if(pHolder)
+		m_pFree = pHolder->m_pNext;
+	if(pHolder && pHolder->m_BufferSize < BufferSize)
+	{
+		mem_free(pHolder);
+		pHolder = 0;
+	}
+	if(!pHolder)
+	{
+		// round up so holders can be reused for slightly bigger snapshots
+		int AllocSize = (BufferSize + 1023) & ~1023;
+		pHolder = (CHolder *)mem_alloc(sizeof(CHolder)+AllocSize, 1);
+		pHolder->m_BufferSize = AllocSize;
+	}
 
 	// set data
 	pHolder->m_Tick = Tick;
@@ -518,14 +558,23 @@ void CSnapshotStorage::Add(int Tick, int64 Tagtime, int DataSize, void *pData, i
 	pHolder->m_pSnap = (CSnapshot*)(pHolder+1);
 	mem_copy(pHolder->m_pSnap, pData, DataSize);
 
+	char *pNext = ((char *)pHolder->m_pSnap) + DataSize;
 	if(CreateAlt) // create alternative if wanted
 	{
-		pHolder->m_pAltSnap = (CSnapshot*)(((char *)pHolder->m_pSnap) + DataSize);
+		pHolder->m_pAltSnap = (CSnapshot*)pNext;
 		mem_copy(pHolder->m_pAltSnap, pData, DataSize);
+		pNext += DataSize;
 	}
 	else
 		pHolder->m_pAltSnap = 0;
 
+	if(CreateHash)
+	{
+		pHolder->m_pHash = (CSnapshotHash *)pNext;
+		pHolder->m_pHash->Build(pHolder->m_pSnap);
+	}
+	else
+		pHolder->m_pHash = 0;
 
 	// link
 	pHolder->m_pNext = 0;
@@ -537,27 +586,30 @@ void CSnapshotStorage::Add(int Tick, int64 Tagtime, int DataSize, void *pData, i
 	m_pLast = pHolder;
 }
 
-int CSnapshotStorage::Get(int Tick, int64 *pTagtime, CSnapshot **ppData, CSnapshot **ppAltData)
+CSnapshotStorage::CHolder *CSnapshotStorage::Find(int Tick)
 {
-	CHolder *pHolder = m_pFirst;
-
-	while(pHolder)
+	// the wanted snapshot is usually one of the newest
+	for(CHolder *pHolder = m_pLast; pHolder; pHolder = pHolder->m_pPrev)
 	{
 		if(pHolder->m_Tick == Tick)
-		{
-			if(pTagtime)
-				*pTagtime = pHolder->m_Tagtime;
-			if(ppData)
-				*ppData = pHolder->m_pSnap;
-			if(ppAltData)
-				*ppAltData = pHolder->m_pAltSnap;
-			return pHolder->m_SnapSize;
-		}
-
-		pHolder = pHolder->m_pNext;
+			return pHolder;
 	}
+	return 0;
+}
 
-	return -1;
+int CSnapshotStorage::Get(int Tick, int64 *pTagtime, CSnapshot **ppData, CSnapshot **ppAltData)
+{
+	CHolder *pHolder = Find(Tick);
+	if(!pHolder)
+		return -1;
+
+	if(pTagtime)
+		*pTagtime = pHolder->m_Tagtime;
+	if(ppData)
+		*ppData = pHolder->m_pSnap;
+	if(ppAltData)
+		*ppAltData = pHolder->m_pAltSnap;
+	return pHolder->m_SnapSize;
 }
 
 // CSnapshotBuilder
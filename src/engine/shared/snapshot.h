@@ -57,6 +57,36 @@ public:
 };
 
 
+// CSnapshotHash
+
+/*
+	Class: CSnapshotHash
+		Open addressing table from item keys to item indices of one
+		snapshot. It lives in memory of Size(NumItems) bytes right behind
+		the snapshot it was built for.
+*/
+class CSnapshotHash
+{
+	int m_Mask;
+
+	int *Slots() { return (int *)(this+1); }
+	const int *Slots() const { return (const int *)(this+1); }
+	static int NumSlots(int NumItems);
+
+public:
+	enum
+	{
+		MAX_ITEMS=1024,
+		MIN_SLOTS=16,
+	};
+
+	static int Size(int NumItems);
+	void Build(const CSnapshot *pSnapshot);
+	// index of the item with the key or -1
+	int GetItemIndex(int Key) const;
+};
+
+
 // CSnapshotDelta
 
 class CSnapshotDelta
@@ -89,6 +119,8 @@ public:
 	void SetStaticsize(int ItemType, int Size);
 	CData *EmptyDelta();
 	int CreateDelta(const class CSnapshot *pFrom, class CSnapshot *pTo, void *pData);
+	// same as above with the hashes of both snapshots already built
+	int CreateDelta(const class CSnapshot *pFrom, const CSnapshotHash *pFromHash, class CSnapshot *pTo, const CSnapshotHash *pToHash, void *pData);
 	int UnpackDelta(const class CSnapshot *pFrom, class CSnapshot *pTo, const void *pData, int DataSize);
 };
 
@@ -110,17 +142,25 @@ public:
 		int m_SnapSize;
 		CSnapshot *m_pSnap;
 		CSnapshot *m_pAltSnap;
+		CSnapshotHash *m_pHash;
+
+		int m_BufferSize; // bytes allocated behind the holder
 	};
 
 
 	CHolder *m_pFirst;
 	CHolder *m_pLast;
+	// purged holders, reused by Add so a steady stream of snapshots
+	// doesn't allocate
+	CHolder *m_pFree;
 
 	void Init();
+	// also releases the purged holders
 	void PurgeAll();
 	void PurgeUntil(int Tick);
-	void Add(int Tick, int64 Tagtime, int DataSize, void *pData, int CreateAlt);
+	void Add(int Tick, int64 Tagtime, int DataSize, void *pData, int CreateAlt, bool CreateHash=false);
 	int Get(int Tick, int64 *pTagtime, CSnapshot **ppData, CSnapshot **ppAltData);
+	CHolder *Find(int Tick);
 };
 
 class CSnapshotBuilder
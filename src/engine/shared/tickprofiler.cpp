@@ -0,0 +1,180 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/math.h>
+#include <base/system.h>
+
+#include "tickprofiler.h"
+
+static const char *s_apPhaseNames[CTickProfiler::NUM_PHASES] = {"input", "tick", "snap", "delta", "network", "record"};
+
+CTickProfiler::CTickProfiler()
+{
+	m_Enabled = true;
+	Reset();
+}
+
+void CTickProfiler::Reset()
+{
+	mem_zero(m_aPhases, sizeof(m_aPhases));
+	m_NumFrames = 0;
+	mem_zero(m_aCurrent, sizeof(m_aCurrent));
+	mem_zero(m_aCurrentCalls, sizeof(m_aCurrentCalls));
+	m_Depth = 0;
+	m_WorstTick = -1;
+	m_WorstTotal = 0;
+	mem_zero(m_aWorst, sizeof(m_aWorst));
+}
+
+void CTickProfiler::SetEnabled(bool Enabled)
+{
+	dbg_assert(m_Depth == 0, "profiler toggled inside a phase");
+	m_Enabled = Enabled;
+}
+
+void CTickProfiler::Begin(int Phase)
+{
+	if(!m_Enabled)
+		return;
+	dbg_assert(m_Depth < MAX_DEPTH, "profiler phases nested too deep");
+	CScope *pScope = &m_aStack[m_Depth++];
+	pScope->m_Phase = Phase;
+	pScope->m_Children = 0;
+	pScope->m_Start = time_get();
+}
+
+void CTickProfiler::End(int Phase)
+{
+	if(!m_Enabled)
+		return;
+	int64 Now = time_get();
+	dbg_assert(m_Depth > 0 && m_aStack[m_Depth-1].m_Phase == Phase, "profiler phase ended out of order");
+	CScope *pScope = &m_aStack[--m_Depth];
+	int64 Duration = Now - pScope->m_Start;
+	Add(Phase, Duration - pScope->m_Children);
+	if(m_Depth > 0)
+		m_aStack[m_Depth-1].m_Children += Duration;
+}
+
+void CTickProfiler::Add(int Phase, int64 Duration)
+{
+	if(!m_Enabled)
+		return;
+	m_aCurrent[Phase] += Duration;
+	m_aCurrentCalls[Phase]++;
+}
+
+void CTickProfiler::EndFrame(int Tick)
+{
+	if(!m_Enabled)
+		return;
+
+	int64 Freq = time_freq();
+	int64 Total = 0;
+	for(int p = 0; p < NUM_PHASES; p++)
+	{
+		// microseconds from here on
+		int64 Time = m_aCurrent[p]*1000000/Freq;
+		m_aCurrent[p] = Time;
+		Total += Time;
+
+		CPhase *pPhase = &m_aPhases[p];
+		int Bucket = 0;
+		while(Bucket < NUM_BUCKETS-1 && Time >= ((int64)1<<Bucket))
+			Bucket++;
+		pPhase->m_aBuckets[Bucket]++;
+		pPhase->m_Total += Time;
+		pPhase->m_Calls += m_aCurrentCalls[p];
+		if(Time > pPhase->m_Max)
+			pPhase->m_Max = Time;
+	}
+	m_NumFrames++;
+
+	if(Total > m_WorstTotal)
+	{
+		m_WorstTick = Tick;
+		m_WorstTotal = Total;
+		mem_copy(m_aWorst, m_aCurrent, sizeof(m_aWorst));
+	}
+
+	mem_zero(m_aCurrent, sizeof(m_aCurrent));
+	mem_zero(m_aCurrentCalls, sizeof(m_aCurrentCalls));
+}
+
+const char *CTickProfiler::PhaseName(int Phase)
+{
+	return s_apPhaseNames[Phase];
+}
+
+int64 CTickProfiler::Mean(int Phase) const
+{
+	return m_NumFrames ? m_aPhases[Phase].m_Total/m_NumFrames : 0;
+}
+
+int64 CTickProfiler::Percentile(int Phase, int Percent) const
+{
+	if(!m_NumFrames)
+		return 0;
+	// the bucket of the first frame beyond the percentile
+	int64 Rank = m_NumFrames*Percent/100;
+	int64 Seen = 0;
+	for(int b = 0; b < NUM_BUCKETS; b++)
+	{
+		Seen += m_aPhases[Phase].m_aBuckets[b];
+		if(Seen > Rank)
+			return b == 0 ? 0 : min(((int64)1<<b) - 1, m_aPhases[Phase].m_Max);
+	}
+	return m_aPhases[Phase].m_Max;
+}
+
+int64 CTickProfiler::CallRate(int Phase) const
+{
+	return m_NumFrames ? m_aPhases[Phase].m_Calls*100/m_NumFrames : 0;
+}
+
+void CTickProfiler::Format(int Phase, char *pBuf, int BufSize) const
+{
+	int64 Rate = CallRate(Phase);
+	str_format(pBuf, BufSize, "%-8s calls=%lld.%02lld mean=%lldus per_call=%lldus p50<=%lldus p99<=%lldus max=%lldus",
+		PhaseName(Phase), Rate/100, Rate%100, Mean(Phase), Rate ? Mean(Phase)*100/Rate : 0,
+		Percentile(Phase, 50), Percentile(Phase, 99), Max(Phase));
+}
+
+void CTickProfiler::FormatWorst(char *pBuf, int BufSize) const
+{
+	str_format(pBuf, BufSize, "worst tick=%d total=%lldus", m_WorstTick, m_WorstTotal);
+	for(int p = 0; p < NUM_PHASES; p++)
+	{
+		char aPhase[64];
+		str_format(aPhase, sizeof(aPhase), " %s=%lldus", PhaseName(p), m_aWorst[p]);
+		str_append(pBuf, aPhase, BufSize);
+	}
+}
+
+void CTickProfiler::Dump(IOHANDLE File) const
+{
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "frames %lld", m_NumFrames);
+	io_write(File, aBuf, str_length(aBuf));
+	io_write_newline(File);
+
+	// one row per phase, the bucket b counts frames below 2^b us
+	for(int p = 0; p < NUM_PHASES; p++)
+	{
+		Format(p, aBuf, sizeof(aBuf));
+		io_write(File, aBuf, str_length(aBuf));
+		io_write_newline(File);
+
+		str_format(aBuf, sizeof(aBuf), "%s", PhaseName(p));
+		io_write(File, aBuf, str_length(aBuf));
+		for(int b = 0; b < NUM_BUCKETS; b++)
+		{
+			str_format(aBuf, sizeof(aBuf), " %lld", m_aPhases[p].m_aBuckets[b]);
+			io_write(File, aBuf, str_length(aBuf));
+		}
+		io_write_newline(File);
+	}
+
+	FormatWorst(aBuf, sizeof(aBuf));
+	io_write(File, aBuf, str_length(aBuf));
+	io_write_newline(File);
+}
@@ -0,0 +1,104 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef ENGINE_SHARED_TICKPROFILER_H
+#define ENGINE_SHARED_TICKPROFILER_H
+
+#include <base/system.h>
+
+/*
+	Class: CTickProfiler
+		Collects how long the phases of the server's main loop take. The
+		times of one frame, a pass of the loop that ran game ticks, are
+		summed per phase and go into a histogram with power of two
+		buckets, so the cost is a few time_get calls per frame.
+
+		Phases can be nested, the inner one is taken out of the time of
+		the outer one. Not thread safe, jobs measure themselves and the
+		main thread adds their time.
+*/
+class CTickProfiler
+{
+public:
+	enum
+	{
+		PHASE_INPUT=0,
+		PHASE_TICK,
+		PHASE_SNAP,
+		PHASE_DELTA,
+		PHASE_NETWORK,
+		PHASE_RECORD,
+		NUM_PHASES,
+
+		// 1us up to 2^23us, about 8s
+		NUM_BUCKETS=24,
+		MAX_DEPTH=8,
+	};
+
+	CTickProfiler();
+
+	void Reset();
+	// only between frames, a disabled profiler ignores everything
+	void SetEnabled(bool Enabled);
+	bool IsEnabled() const { return m_Enabled; }
+
+	void Begin(int Phase);
+	void End(int Phase);
+	// adds time measured elsewhere, outside of the nesting
+	void Add(int Phase, int64 Duration);
+	// closes the frame, the sums go into the histograms
+	void EndFrame(int Tick);
+
+	static const char *PhaseName(int Phase);
+
+	int64 NumFrames() const { return m_NumFrames; }
+	// microseconds
+	int64 Mean(int Phase) const;
+	int64 Max(int Phase) const { return m_aPhases[Phase].m_Max; }
+	// upper bound of the bucket that contains the percentile, at most the max
+	int64 Percentile(int Phase, int Percent) const;
+	// Begin/End pairs and Adds per 100 frames
+	int64 CallRate(int Phase) const;
+
+	// the frame that took the longest
+	int WorstTick() const { return m_WorstTick; }
+	int64 WorstTotal() const { return m_WorstTotal; }
+	int64 WorstPhase(int Phase) const { return m_aWorst[Phase]; }
+
+	// one line per phase, for the console
+	void Format(int Phase, char *pBuf, int BufSize) const;
+	void FormatWorst(char *pBuf, int BufSize) const;
+	// the full histograms
+	void Dump(IOHANDLE File) const;
+
+private:
+	struct CPhase
+	{
+		int64 m_aBuckets[NUM_BUCKETS];
+		int64 m_Total;
+		int64 m_Max;
+		int64 m_Calls;
+	};
+
+	struct CScope
+	{
+		int m_Phase;
+		int64 m_Start;
+		int64 m_Children;
+	};
+
+	bool m_Enabled;
+	CPhase m_aPhases[NUM_PHASES];
+	int64 m_NumFrames;
+
+	// the frame that is being measured
+	int64 m_aCurrent[NUM_PHASES];
+	int m_aCurrentCalls[NUM_PHASES];
+	CScope m_aStack[MAX_DEPTH];
+	int m_Depth;
+
+	int m_WorstTick;
+	int64 m_WorstTotal;
+	int64 m_aWorst[NUM_PHASES];
+};
+
+#endif
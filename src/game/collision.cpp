@@ -145,30 +145,119 @@ int CCollision::GetTile(int x, int y)
 	return 0;
 }
 
-// TODO: rewrite this smarter!
+// Walks the samples the line checks have always used, one per pixel, but only
+// hands out the first sample of each run that rounds into the same tile. The
+// checks below depend on the tile only, so every crossed tile is looked up once
+// while the reported positions stay exactly the old sample positions.
+class CTileWalker
+{
+	vec2 m_Pos0;
+	vec2 m_Pos1;
+	float m_Div;
+	int m_Last;
+
+	int m_Index;
+	vec2 m_Pos;
+	int m_X;
+	int m_Y;
+
+	// floor division, so tile borders stay 32 pixels apart below zero as well
+	static int TileOf(int v) { return v < 0 ? (v - 31) / 32 : v / 32; }
+
+	bool InTile(int i) const
+	{
+		vec2 Pos = Sample(i);
+		return TileOf(round_to_int(Pos.x)) == TileOf(m_X) && TileOf(round_to_int(Pos.y)) == TileOf(m_Y);
+	}
+
+	// rough index of the last sample before the line leaves the tile on one axis
+	int AxisEnd(float From, float To, int Tile) const
+	{
+		float Border;
+		if (To > From)
+			Border = (Tile + 1) * 32 - 0.5f;
+		else if (To < From)
+			Border = Tile * 32 - 0.5f;
+		else
+			return m_Last;
+		float Index = (Border - From) / (To - From) * m_Div;
+		return Index < m_Last ? (int)Index : m_Last;
+	}
+
+public:
+	CTileWalker(vec2 Pos0, vec2 Pos1, float Div, int Last)
+	{
+		m_Pos0 = Pos0;
+		m_Pos1 = Pos1;
+		m_Div = Div;
+		m_Last = Last;
+		m_Index = -1;
+	}
+
+	// samples taken at 0, 1, 2, ... while below Distance
+	static int LastBelow(float Distance)
+	{
+		if (!(Distance > 0))
+			return -1;
+		int Last = (int)Distance;
+		return Last < Distance ? Last : Last - 1;
+	}
+
+	vec2 Sample(int i) const
+	{
+		float a = i / m_Div;
+		return mix(m_Pos0, m_Pos1, a);
+	}
+
+	bool Next()
+	{
+		if (m_Index < 0)
+			m_Index = 0;
+		else
+		{
+			// samples move monotonically on both axes, so the samples inside
+			// the current tile are one run. the estimate only saves steps
+			int End = min(AxisEnd(m_Pos0.x, m_Pos1.x, TileOf(m_X)), AxisEnd(m_Pos0.y, m_Pos1.y, TileOf(m_Y)));
+			End = clamp(End, m_Index, m_Last);
+			while (End < m_Last && InTile(End + 1))
+				End++;
+			while (End > m_Index && !InTile(End))
+				End--;
+			m_Index = End + 1;
+		}
+		if (m_Index > m_Last)
+			return false;
+
+		m_Pos = Sample(m_Index);
+		m_X = round_to_int(m_Pos.x);
+		m_Y = round_to_int(m_Pos.y);
+		return true;
+	}
+
+	vec2 Pos() const { return m_Pos; }
+	vec2 Before() const { return m_Index ? Sample(m_Index - 1) : m_Pos0; }
+	int X() const { return m_X; }
+	int Y() const { return m_Y; }
+};
+
 int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision)
 {
 	float Distance = distance(Pos0, Pos1);
 	int End(Distance + 1);
-	vec2 Last = Pos0;
-	int ix = 0, iy = 0; // Temporary position for checking collision
-	for (int i = 0; i <= End; i++)
+	CTileWalker Walker(Pos0, Pos1, (float)End, End);
+	while (Walker.Next())
 	{
-		float a = i / (float)End;
-		vec2 Pos = mix(Pos0, Pos1, a);
-		ix = round_to_int(Pos.x);
-		iy = round_to_int(Pos.y);
+		int ix = Walker.X();
+		int iy = Walker.Y();
 
 		if (CheckPoint(ix, iy))
 		{
 			if (pOutCollision)
-				* pOutCollision = Pos;
+				* pOutCollision = Walker.Pos();
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			return GetCollisionAt(ix, iy);
 		}
-
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
@@ -181,18 +270,15 @@ int CCollision::IntersectLineTeleHook(vec2 Pos0, vec2 Pos1, vec2* pOutCollision,
 {
 	float Distance = distance(Pos0, Pos1);
 	int End(Distance + 1);
-	vec2 Last = Pos0;
-	int ix = 0, iy = 0; // Temporary position for checking collision
 	int dx = 0, dy = 0; // Offset for checking the "through" tile
 	ThroughOffset(Pos0, Pos1, &dx, &dy);
-	for (int i = 0; i <= End; i++)
+	CTileWalker Walker(Pos0, Pos1, (float)End, End);
+	while (Walker.Next())
 	{
-		float a = i / (float)End;
-		vec2 Pos = mix(Pos0, Pos1, a);
-		ix = round_to_int(Pos.x);
-		iy = round_to_int(Pos.y);
+		int ix = Walker.X();
+		int iy = Walker.Y();
 
-		int Index = GetPureMapIndex(Pos);
+		int Index = GetPureMapIndex(Walker.Pos());
 		if (g_Config.m_SvOldTeleportHook)
 			* pTeleNr = IsTeleport(Index);
 		else
@@ -200,9 +286,9 @@ int CCollision::IntersectLineTeleHook(vec2 Pos0, vec2 Pos1, vec2* pOutCollision,
 		if (*pTeleNr)
 		{
 			if (pOutCollision)
-				* pOutCollision = Pos;
+				* pOutCollision = Walker.Pos();
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			return TILE_TELEINHOOK;
 		}
 
@@ -219,13 +305,11 @@ int CCollision::IntersectLineTeleHook(vec2 Pos0, vec2 Pos1, vec2* pOutCollision,
 		if (hit)
 		{
 			if (pOutCollision)
-				* pOutCollision = Pos;
+				* pOutCollision = Walker.Pos();
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			return hit;
 		}
-
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
@@ -238,16 +322,13 @@ int CCollision::IntersectLineTeleWeapon(vec2 Pos0, vec2 Pos1, vec2* pOutCollisio
 {
 	float Distance = distance(Pos0, Pos1);
 	int End(Distance + 1);
-	vec2 Last = Pos0;
-	int ix = 0, iy = 0; // Temporary position for checking collision
-	for (int i = 0; i <= End; i++)
+	CTileWalker Walker(Pos0, Pos1, (float)End, End);
+	while (Walker.Next())
 	{
-		float a = i / (float)End;
-		vec2 Pos = mix(Pos0, Pos1, a);
-		ix = round_to_int(Pos.x);
-		iy = round_to_int(Pos.y);
+		int ix = Walker.X();
+		int iy = Walker.Y();
 
-		int Index = GetPureMapIndex(Pos);
+		int Index = GetPureMapIndex(Walker.Pos());
 		if (g_Config.m_SvOldTeleportWeapons)
 			* pTeleNr = IsTeleport(Index);
 		else
@@ -255,22 +336,20 @@ int CCollision::IntersectLineTeleWeapon(vec2 Pos0, vec2 Pos1, vec2* pOutCollisio
 		if (*pTeleNr)
 		{
 			if (pOutCollision)
-				* pOutCollision = Pos;
+				* pOutCollision = Walker.Pos();
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			return TILE_TELEINWEAPON;
 		}
 
 		if (CheckPoint(ix, iy))
 		{
 			if (pOutCollision)
-				* pOutCollision = Pos;
+				* pOutCollision = Walker.Pos();
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			return GetCollisionAt(ix, iy);
 		}
-
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
@@ -755,9 +834,19 @@ int CCollision::GetMapIndex(vec2 Pos)
 		return -1;
 }
 
-std::list<int> CCollision::GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxIndices)
+void CMapIndices::Grow()
+{
+	int *pIndices = new int[m_Capacity*2];
+	mem_copy(pIndices, m_pIndices, m_Num*sizeof(int));
+	if(m_pIndices != m_aIndices)
+		delete[] m_pIndices;
+	m_pIndices = pIndices;
+	m_Capacity *= 2;
+}
+
+void CCollision::GetMapIndices(vec2 PrevPos, vec2 Pos, CMapIndices* pIndices)
 {
-	std::list< int > Indices;
+	pIndices->Clear();
 	float d = distance(PrevPos, Pos);
 	int End(d + 1);
 	if (!d)
@@ -767,12 +856,7 @@ std::list<int> CCollision::GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxInd
 		int Index = Ny * m_Width + Nx;
 
 		if (TileExists(Index))
-		{
-			Indices.push_back(Index);
-			return Indices;
-		}
-		else
-			return Indices;
+			pIndices->Add(Index);
 	}
 	else
 	{
@@ -790,14 +874,10 @@ std::list<int> CCollision::GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxInd
 			Index = Ny * m_Width + Nx;
 			if (TileExists(Index) && LastIndex != Index)
 			{
-				if (MaxIndices && Indices.size() > MaxIndices)
-					return Indices;
-				Indices.push_back(Index);
+				pIndices->Add(Index);
 				LastIndex = Index;
 			}
 		}
-
-		return Indices;
 	}
 }
 
@@ -1028,12 +1108,10 @@ void ThroughOffset(vec2 Pos0, vec2 Pos1, int* Ox, int* Oy)
 int CCollision::IntersectNoLaser(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision)
 {
 	float d = distance(Pos0, Pos1);
-	vec2 Last = Pos0;
-
-	for (float f = 0; f < d; f++)
+	CTileWalker Walker(Pos0, Pos1, d, CTileWalker::LastBelow(d));
+	while (Walker.Next())
 	{
-		float a = f / d;
-		vec2 Pos = mix(Pos0, Pos1, a);
+		vec2 Pos = Walker.Pos();
 		int Nx = clamp(round_to_int(Pos.x) / 32, 0, m_Width - 1);
 		int Ny = clamp(round_to_int(Pos.y) / 32, 0, m_Height - 1);
 		if (GetIndex(Nx, Ny) == TILE_SOLID
@@ -1044,12 +1122,11 @@ int CCollision::IntersectNoLaser(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2
 			if (pOutCollision)
 				* pOutCollision = Pos;
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			if (GetFIndex(Nx, Ny) == TILE_NOLASER)	return GetFCollisionAt(Pos.x, Pos.y);
 			else return GetCollisionAt(Pos.x, Pos.y);
 
 		}
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
@@ -1061,22 +1138,19 @@ int CCollision::IntersectNoLaser(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2
 int CCollision::IntersectNoLaserNW(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision)
 {
 	float d = distance(Pos0, Pos1);
-	vec2 Last = Pos0;
-
-	for (float f = 0; f < d; f++)
+	CTileWalker Walker(Pos0, Pos1, d, CTileWalker::LastBelow(d));
+	while (Walker.Next())
 	{
-		float a = f / d;
-		vec2 Pos = mix(Pos0, Pos1, a);
+		vec2 Pos = Walker.Pos();
 		if (IsNoLaser(round_to_int(Pos.x), round_to_int(Pos.y)) || IsFNoLaser(round_to_int(Pos.x), round_to_int(Pos.y)))
 		{
 			if (pOutCollision)
 				* pOutCollision = Pos;
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			if (IsNoLaser(round_to_int(Pos.x), round_to_int(Pos.y))) return GetCollisionAt(Pos.x, Pos.y);
 			else return  GetFCollisionAt(Pos.x, Pos.y);
 		}
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
@@ -1088,25 +1162,22 @@ int CCollision::IntersectNoLaserNW(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, ve
 int CCollision::IntersectAir(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision)
 {
 	float d = distance(Pos0, Pos1);
-	vec2 Last = Pos0;
-
-	for (float f = 0; f < d; f++)
+	CTileWalker Walker(Pos0, Pos1, d, CTileWalker::LastBelow(d));
+	while (Walker.Next())
 	{
-		float a = f / d;
-		vec2 Pos = mix(Pos0, Pos1, a);
+		vec2 Pos = Walker.Pos();
 		if (IsSolid(round_to_int(Pos.x), round_to_int(Pos.y)) || (!GetTile(round_to_int(Pos.x), round_to_int(Pos.y)) && !GetFTile(round_to_int(Pos.x), round_to_int(Pos.y))))
 		{
 			if (pOutCollision)
 				* pOutCollision = Pos;
 			if (pOutBeforeCollision)
-				* pOutBeforeCollision = Last;
+				* pOutBeforeCollision = Walker.Before();
 			if (!GetTile(round_to_int(Pos.x), round_to_int(Pos.y)) && !GetFTile(round_to_int(Pos.x), round_to_int(Pos.y)))
 				return -1;
 			else
 				if (!GetTile(round_to_int(Pos.x), round_to_int(Pos.y))) return GetTile(round_to_int(Pos.x), round_to_int(Pos.y));
 				else return GetFTile(round_to_int(Pos.x), round_to_int(Pos.y));
 		}
-		Last = Pos;
 	}
 	if (pOutCollision)
 		* pOutCollision = Pos1;
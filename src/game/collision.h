@@ -6,7 +6,45 @@
 #include <base/vmath.h>
 #include <engine/shared/protocol.h>
 
-#include <list>
+// map indices of the tiles a moving point crossed, in the order it crossed
+// them. lives on the stack and only allocates for moves that cross more
+// special tiles than fit into it
+class CMapIndices
+{
+public:
+	enum
+	{
+		// far more special tiles than a character crosses in one tick
+		NUM_INLINE_INDICES=256,
+	};
+
+	CMapIndices() { m_pIndices = m_aIndices; m_Capacity = NUM_INLINE_INDICES; m_Num = 0; }
+	~CMapIndices() { if(m_pIndices != m_aIndices) delete[] m_pIndices; }
+
+	void Clear() { m_Num = 0; }
+	void Add(int Index)
+	{
+		if(m_Num == m_Capacity)
+			Grow();
+		m_pIndices[m_Num++] = Index;
+	}
+
+	int Num() const { return m_Num; }
+	bool Empty() const { return m_Num == 0; }
+	int operator[](int i) const { return m_pIndices[i]; }
+
+private:
+	void Grow();
+
+	// not copyable, the indices may live on the heap
+	CMapIndices(const CMapIndices &Other);
+	CMapIndices &operator=(const CMapIndices &Other);
+
+	int m_aIndices[NUM_INLINE_INDICES];
+	int *m_pIndices;
+	int m_Capacity;
+	int m_Num;
+};
 
 class CCollision
 {
@@ -53,7 +91,7 @@ public:
 	int Entity(int x, int y, int Layer);
 	int GetPureMapIndex(float x, float y);
 	int GetPureMapIndex(vec2 Pos) { return GetPureMapIndex(Pos.x, Pos.y); }
-	std::list<int> GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxIndices = 0);
+	void GetMapIndices(vec2 PrevPos, vec2 Pos, CMapIndices* pIndices);
 	int GetMapIndex(vec2 Pos);
 	bool TileExists(int Index);
 	bool TileExistsNext(int Index);
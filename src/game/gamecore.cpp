@@ -102,90 +102,35 @@ void CCharacterCore::Reset()
 }
 
 void CCharacterCore::Tick(bool UseInput)
+{
+	CTickState State;
+	TickPrepare(UseInput, &State);
+	TickApply(UseInput, &State);
+}
+
+void CCharacterCore::TickPrepare(bool UseInput, CTickState *pState)
 {
 	float PhysSize = 28.0f;
-	int MapIndex = Collision()->GetPureMapIndex(m_Pos);
-	int MapIndexL = Collision()->GetPureMapIndex(vec2(m_Pos.x + (28 / 2) + 4, m_Pos.y));
-	int MapIndexR = Collision()->GetPureMapIndex(vec2(m_Pos.x - (28 / 2) - 4, m_Pos.y));
-	int MapIndexT = Collision()->GetPureMapIndex(vec2(m_Pos.x, m_Pos.y + (28 / 2) + 4));
-	int MapIndexB = Collision()->GetPureMapIndex(vec2(m_Pos.x, m_Pos.y - (28 / 2) - 4));
-	m_TileIndex = Collision()->GetTileIndex(MapIndex);
-	m_TileFlags = Collision()->GetTileFlags(MapIndex);
-	m_TileIndexL = Collision()->GetTileIndex(MapIndexL);
-	m_TileFlagsL = Collision()->GetTileFlags(MapIndexL);
-	m_TileIndexR = Collision()->GetTileIndex(MapIndexR);
-	m_TileFlagsR = Collision()->GetTileFlags(MapIndexR);
-	m_TileIndexB = Collision()->GetTileIndex(MapIndexB);
-	m_TileFlagsB = Collision()->GetTileFlags(MapIndexB);
-	m_TileIndexT = Collision()->GetTileIndex(MapIndexT);
-	m_TileFlagsT = Collision()->GetTileFlags(MapIndexT);
-	m_TileFIndex = Collision()->GetFTileIndex(MapIndex);
-	m_TileFFlags = Collision()->GetFTileFlags(MapIndex);
-	m_TileFIndexL = Collision()->GetFTileIndex(MapIndexL);
-	m_TileFFlagsL = Collision()->GetFTileFlags(MapIndexL);
-	m_TileFIndexR = Collision()->GetFTileIndex(MapIndexR);
-	m_TileFFlagsR = Collision()->GetFTileFlags(MapIndexR);
-	m_TileFIndexB = Collision()->GetFTileIndex(MapIndexB);
-	m_TileFFlagsB = Collision()->GetFTileFlags(MapIndexB);
-	m_TileFIndexT = Collision()->GetFTileIndex(MapIndexT);
-	m_TileFFlagsT = Collision()->GetFTileFlags(MapIndexT);
-	m_TileSIndex = (UseInput && IsRightTeam(MapIndex)) ? Collision()->GetDTileIndex(MapIndex) : 0;
-	m_TileSFlags = (UseInput && IsRightTeam(MapIndex)) ? Collision()->GetDTileFlags(MapIndex) : 0;
-	m_TileSIndexL = (UseInput && IsRightTeam(MapIndexL)) ? Collision()->GetDTileIndex(MapIndexL) : 0;
-	m_TileSFlagsL = (UseInput && IsRightTeam(MapIndexL)) ? Collision()->GetDTileFlags(MapIndexL) : 0;
-	m_TileSIndexR = (UseInput && IsRightTeam(MapIndexR)) ? Collision()->GetDTileIndex(MapIndexR) : 0;
-	m_TileSFlagsR = (UseInput && IsRightTeam(MapIndexR)) ? Collision()->GetDTileFlags(MapIndexR) : 0;
-	m_TileSIndexB = (UseInput && IsRightTeam(MapIndexB)) ? Collision()->GetDTileIndex(MapIndexB) : 0;
-	m_TileSFlagsB = (UseInput && IsRightTeam(MapIndexB)) ? Collision()->GetDTileFlags(MapIndexB) : 0;
-	m_TileSIndexT = (UseInput && IsRightTeam(MapIndexT)) ? Collision()->GetDTileIndex(MapIndexT) : 0;
-	m_TileSFlagsT = (UseInput && IsRightTeam(MapIndexT)) ? Collision()->GetDTileFlags(MapIndexT) : 0;
 	m_TriggeredEvents = 0;
+	pState->m_HookDrag = false;
+	pState->m_TeleNr = 0;
+	pState->m_NumContacts = 0;
 
 	// get ground state
-	bool Grounded = false;
+	pState->m_Grounded = false;
 	if(m_pCollision->CheckPoint(m_Pos.x+PhysSize/2, m_Pos.y+PhysSize/2+5))
-		Grounded = true;
+		pState->m_Grounded = true;
 	if(m_pCollision->CheckPoint(m_Pos.x-PhysSize/2, m_Pos.y+PhysSize/2+5))
-		Grounded = true;
+		pState->m_Grounded = true;
 
 	vec2 TargetDirection = normalize(vec2(m_Input.m_TargetX, m_Input.m_TargetY));
 
-	m_Vel.y += m_pWorld->m_Tuning.m_Gravity;
-
-	float MaxSpeed = Grounded ? m_pWorld->m_Tuning.m_GroundControlSpeed : m_pWorld->m_Tuning.m_AirControlSpeed;
-	float Accel = Grounded ? m_pWorld->m_Tuning.m_GroundControlAccel : m_pWorld->m_Tuning.m_AirControlAccel;
-	float Friction = Grounded ? m_pWorld->m_Tuning.m_GroundFriction : m_pWorld->m_Tuning.m_AirFriction;
-
 	// handle input
 	if(UseInput)
 	{
 		m_Direction = m_Input.m_Direction;
 		m_Angle = (int)(angle(vec2(m_Input.m_TargetX, m_Input.m_TargetY))*256.0f);
 
-		// handle jump
-		if(m_Input.m_Jump)
-		{
-			if(!(m_Jumped&1))
-			{
-				if(Grounded)
-				{
-					m_TriggeredEvents |= COREEVENTFLAG_GROUND_JUMP;
-					m_Vel.y = -m_pWorld->m_Tuning.m_GroundJumpImpulse;
-					m_Jumped |= 1;
-					m_JumpedTotal = 1;
-				}
-				else if(!(m_Jumped&2))
-				{
-					m_TriggeredEvents |= COREEVENTFLAG_AIR_JUMP;
-					m_Vel.y = -m_pWorld->m_Tuning.m_AirJumpImpulse;
-					m_Jumped |= 3;
-					m_JumpedTotal++;
-				}
-			}
-		}
-		else
-			m_Jumped &= ~1;
-
 		// handle hook
 		if(m_Input.m_Hook)
 		{
@@ -207,23 +152,6 @@ void CCharacterCore::Tick(bool UseInput)
 		}
 	}
 
-	// add the speed modification according to players wanted direction
-	if(m_Direction < 0)
-		m_Vel.x = SaturatedAdd(-MaxSpeed, MaxSpeed, m_Vel.x, -Accel);
-	if(m_Direction > 0)
-		m_Vel.x = SaturatedAdd(-MaxSpeed, MaxSpeed, m_Vel.x, Accel);
-	if(m_Direction == 0)
-		m_Vel.x *= Friction;
-
-	// handle jumping
-	// 1 bit = to keep track if a jump has been made on this input
-	// 2 bit = to keep track if a air-jump has been made
-	if (Grounded)
-	{
-		m_Jumped &= ~2;
-		m_JumpedTotal = 0;
-	}
-
 	// do hook
 	if(m_HookState == HOOK_IDLE)
 	{
@@ -275,7 +203,8 @@ void CCharacterCore::Tick(bool UseInput)
 			for(int i = 0; i < MAX_CLIENTS; i++)
 			{
 				CCharacterCore *pCharCore = m_pWorld->m_apCharacters[i];
-				if (!pCharCore || pCharCore == this || !m_pTeams->CanCollide(i, m_Id))
+				// by id as well, the core may be a copy of the one in the world
+				if (!pCharCore || pCharCore == this || i == m_Id || !m_pTeams->CanCollide(i, m_Id))
 					continue;
 
 				vec2 ClosestPoint = closest_point_on_line(m_HookPos, NewPos, pCharCore->m_Pos);
@@ -306,16 +235,15 @@ void CCharacterCore::Tick(bool UseInput)
 				m_HookState = HOOK_RETRACT_START;
 			}
 
-			if (GoingThroughTele && m_pTeleOuts && m_pTeleOuts->size() && (*m_pTeleOuts)[teleNr - 1].size())
+			if (GoingThroughTele && m_pTeleOuts && m_pTeleOuts->size())
 			{
-				m_TriggeredEvents = 0;
-				m_HookedPlayer = -1;
-
-				m_NewHook = true;
-				int Num = (*m_pTeleOuts)[teleNr - 1].size();
-				m_HookPos = (*m_pTeleOuts)[teleNr - 1][(Num == 1) ? 0 : rand() % Num] + TargetDirection * PhysSize * 1.5f;
-				m_HookDir = TargetDirection;
-				m_HookTeleBase = m_HookPos;
+				// find() instead of [] so that the outs aren't written to,
+				// the exit itself is picked with rand() in TickApply
+				std::map<int, std::vector<vec2> >::const_iterator Outs = m_pTeleOuts->find(teleNr - 1);
+				if(Outs != m_pTeleOuts->end() && Outs->second.size())
+					pState->m_TeleNr = teleNr;
+				else
+					m_HookPos = NewPos;
 			}
 			else
 			{
@@ -345,28 +273,7 @@ void CCharacterCore::Tick(bool UseInput)
 		}
 
 		// don't do this hook rutine when we are hook to a player
-		if(m_HookedPlayer == -1 && distance(m_HookPos, m_Pos) > 46.0f)
-		{
-			vec2 HookVel = normalize(m_HookPos-m_Pos)*m_pWorld->m_Tuning.m_HookDragAccel;
-			// the hook as more power to drag you up then down.
-			// this makes it easier to get on top of an platform
-			if(HookVel.y > 0)
-				HookVel.y *= 0.3f;
-
-			// the hook will boost it's power if the player wants to move
-			// in that direction. otherwise it will dampen everything abit
-			if((HookVel.x < 0 && m_Direction < 0) || (HookVel.x > 0 && m_Direction > 0))
-				HookVel.x *= 0.95f;
-			else
-				HookVel.x *= 0.75f;
-
-			vec2 NewVel = m_Vel+HookVel;
-
-			// check if we are under the legal limit for the hook
-			if(length(NewVel) < m_pWorld->m_Tuning.m_HookDragSpeed || length(NewVel) < length(m_Vel))
-				m_Vel = NewVel; // no problem. apply
-
-		}
+		pState->m_HookDrag = m_HookedPlayer == -1 && distance(m_HookPos, m_Pos) > 46.0f;
 
 		// release hook (max hook time is 1.25
 		m_HookTick++;
@@ -387,14 +294,167 @@ void CCharacterCore::Tick(bool UseInput)
 				continue;
 
 			//player *p = (player*)ent;
-			if (pCharCore == this || (m_Id != -1 && !m_pTeams->CanCollide(m_Id, i)))
+			if (pCharCore == this || i == m_Id || (m_Id != -1 && !m_pTeams->CanCollide(m_Id, i)))
 				continue; // make sure that we don't nudge our self
 
-			// handle player <-> player collision
+			// player <-> player collision and hook influence are applied later
 			float Distance = distance(m_Pos, pCharCore->m_Pos);
-			vec2 Dir = normalize(m_Pos - pCharCore->m_Pos);
+			bool Collide = m_pWorld->m_Tuning.m_PlayerCollision && m_pTeams->CanCollide(m_Id, i) && Distance < PhysSize*1.25f && Distance > 0.0f;
+			bool Hook = m_Hook && m_HookedPlayer == i && m_pWorld->m_Tuning.m_PlayerHooking && Distance > PhysSize*1.50f; // TODO: fix tweakable variable
+			if(!Collide && !Hook)
+				continue;
 
-			if(m_pWorld->m_Tuning.m_PlayerCollision && m_pTeams->CanCollide(m_Id, i) && Distance < PhysSize*1.25f && Distance > 0.0f)
+			CTickState::CContact *pContact = &pState->m_aContacts[pState->m_NumContacts++];
+			pContact->m_ClientID = i;
+			pContact->m_Distance = Distance;
+			pContact->m_Dir = normalize(m_Pos - pCharCore->m_Pos);
+			pContact->m_Collide = Collide;
+			pContact->m_Hook = Hook;
+		}
+	}
+}
+
+void CCharacterCore::TickApply(bool UseInput, const CTickState *pState)
+{
+	float PhysSize = 28.0f;
+	int MapIndex = Collision()->GetPureMapIndex(m_Pos);
+	int MapIndexL = Collision()->GetPureMapIndex(vec2(m_Pos.x + (28 / 2) + 4, m_Pos.y));
+	int MapIndexR = Collision()->GetPureMapIndex(vec2(m_Pos.x - (28 / 2) - 4, m_Pos.y));
+	int MapIndexT = Collision()->GetPureMapIndex(vec2(m_Pos.x, m_Pos.y + (28 / 2) + 4));
+	int MapIndexB = Collision()->GetPureMapIndex(vec2(m_Pos.x, m_Pos.y - (28 / 2) - 4));
+	m_TileIndex = Collision()->GetTileIndex(MapIndex);
+	m_TileFlags = Collision()->GetTileFlags(MapIndex);
+	m_TileIndexL = Collision()->GetTileIndex(MapIndexL);
+	m_TileFlagsL = Collision()->GetTileFlags(MapIndexL);
+	m_TileIndexR = Collision()->GetTileIndex(MapIndexR);
+	m_TileFlagsR = Collision()->GetTileFlags(MapIndexR);
+	m_TileIndexB = Collision()->GetTileIndex(MapIndexB);
+	m_TileFlagsB = Collision()->GetTileFlags(MapIndexB);
+	m_TileIndexT = Collision()->GetTileIndex(MapIndexT);
+	m_TileFlagsT = Collision()->GetTileFlags(MapIndexT);
+	m_TileFIndex = Collision()->GetFTileIndex(MapIndex);
+	m_TileFFlags = Collision()->GetFTileFlags(MapIndex);
+	m_TileFIndexL = Collision()->GetFTileIndex(MapIndexL);
+	m_TileFFlagsL = Collision()->GetFTileFlags(MapIndexL);
+	m_TileFIndexR = Collision()->GetFTileIndex(MapIndexR);
+	m_TileFFlagsR = Collision()->GetFTileFlags(MapIndexR);
+	m_TileFIndexB = Collision()->GetFTileIndex(MapIndexB);
+	m_TileFFlagsB = Collision()->GetFTileFlags(MapIndexB);
+	m_TileFIndexT = Collision()->GetFTileIndex(MapIndexT);
+	m_TileFFlagsT = Collision()->GetFTileFlags(MapIndexT);
+	m_TileSIndex = (UseInput && IsRightTeam(MapIndex)) ? Collision()->GetDTileIndex(MapIndex) : 0;
+	m_TileSFlags = (UseInput && IsRightTeam(MapIndex)) ? Collision()->GetDTileFlags(MapIndex) : 0;
+	m_TileSIndexL = (UseInput && IsRightTeam(MapIndexL)) ? Collision()->GetDTileIndex(MapIndexL) : 0;
+	m_TileSFlagsL = (UseInput && IsRightTeam(MapIndexL)) ? Collision()->GetDTileFlags(MapIndexL) : 0;
+	m_TileSIndexR = (UseInput && IsRightTeam(MapIndexR)) ? Collision()->GetDTileIndex(MapIndexR) : 0;
+	m_TileSFlagsR = (UseInput && IsRightTeam(MapIndexR)) ? Collision()->GetDTileFlags(MapIndexR) : 0;
+	m_TileSIndexB = (UseInput && IsRightTeam(MapIndexB)) ? Collision()->GetDTileIndex(MapIndexB) : 0;
+	m_TileSFlagsB = (UseInput && IsRightTeam(MapIndexB)) ? Collision()->GetDTileFlags(MapIndexB) : 0;
+	m_TileSIndexT = (UseInput && IsRightTeam(MapIndexT)) ? Collision()->GetDTileIndex(MapIndexT) : 0;
+	m_TileSFlagsT = (UseInput && IsRightTeam(MapIndexT)) ? Collision()->GetDTileFlags(MapIndexT) : 0;
+
+	bool Grounded = pState->m_Grounded;
+
+	m_Vel.y += m_pWorld->m_Tuning.m_Gravity;
+
+	float MaxSpeed = Grounded ? m_pWorld->m_Tuning.m_GroundControlSpeed : m_pWorld->m_Tuning.m_AirControlSpeed;
+	float Accel = Grounded ? m_pWorld->m_Tuning.m_GroundControlAccel : m_pWorld->m_Tuning.m_AirControlAccel;
+	float Friction = Grounded ? m_pWorld->m_Tuning.m_GroundFriction : m_pWorld->m_Tuning.m_AirFriction;
+
+	// handle input
+	if(UseInput)
+	{
+		// handle jump
+		if(m_Input.m_Jump)
+		{
+			if(!(m_Jumped&1))
+			{
+				if(Grounded)
+				{
+					m_TriggeredEvents |= COREEVENTFLAG_GROUND_JUMP;
+					m_Vel.y = -m_pWorld->m_Tuning.m_GroundJumpImpulse;
+					m_Jumped |= 1;
+					m_JumpedTotal = 1;
+				}
+				else if(!(m_Jumped&2))
+				{
+					m_TriggeredEvents |= COREEVENTFLAG_AIR_JUMP;
+					m_Vel.y = -m_pWorld->m_Tuning.m_AirJumpImpulse;
+					m_Jumped |= 3;
+					m_JumpedTotal++;
+				}
+			}
+		}
+		else
+			m_Jumped &= ~1;
+	}
+
+	// add the speed modification according to players wanted direction
+	if(m_Direction < 0)
+		m_Vel.x = SaturatedAdd(-MaxSpeed, MaxSpeed, m_Vel.x, -Accel);
+	if(m_Direction > 0)
+		m_Vel.x = SaturatedAdd(-MaxSpeed, MaxSpeed, m_Vel.x, Accel);
+	if(m_Direction == 0)
+		m_Vel.x *= Friction;
+
+	// handle jumping
+	// 1 bit = to keep track if a jump has been made on this input
+	// 2 bit = to keep track if a air-jump has been made
+	if (Grounded)
+	{
+		m_Jumped &= ~2;
+		m_JumpedTotal = 0;
+	}
+
+	if(pState->m_TeleNr)
+	{
+		// the hook went through a teleporter in TickPrepare
+		m_TriggeredEvents = 0;
+		m_HookedPlayer = -1;
+
+		m_NewHook = true;
+		vec2 TargetDirection = normalize(vec2(m_Input.m_TargetX, m_Input.m_TargetY));
+		std::vector<vec2> &TeleOuts = (*m_pTeleOuts)[pState->m_TeleNr - 1];
+		int Num = TeleOuts.size();
+		m_HookPos = TeleOuts[(Num == 1) ? 0 : rand() % Num] + TargetDirection * PhysSize * 1.5f;
+		m_HookDir = TargetDirection;
+		m_HookTeleBase = m_HookPos;
+	}
+
+	if(pState->m_HookDrag)
+	{
+		vec2 HookVel = normalize(m_HookPos-m_Pos)*m_pWorld->m_Tuning.m_HookDragAccel;
+		// the hook as more power to drag you up then down.
+		// this makes it easier to get on top of an platform
+		if(HookVel.y > 0)
+			HookVel.y *= 0.3f;
+
+		// the hook will boost it's power if the player wants to move
+		// in that direction. otherwise it will dampen everything abit
+		if((HookVel.x < 0 && m_Direction < 0) || (HookVel.x > 0 && m_Direction > 0))
+			HookVel.x *= 0.95f;
+		else
+			HookVel.x *= 0.75f;
+
+		vec2 NewVel = m_Vel+HookVel;
+
+		// check if we are under the legal limit for the hook
+		if(length(NewVel) < m_pWorld->m_Tuning.m_HookDragSpeed || length(NewVel) < length(m_Vel))
+			m_Vel = NewVel; // no problem. apply
+
+	}
+
+	if(m_pWorld)
+	{
+		for(int c = 0; c < pState->m_NumContacts; c++)
+		{
+			const CTickState::CContact *pContact = &pState->m_aContacts[c];
+			CCharacterCore *pCharCore = m_pWorld->m_apCharacters[pContact->m_ClientID];
+			float Distance = pContact->m_Distance;
+			vec2 Dir = pContact->m_Dir;
+
+			// handle player <-> player collision
+			if(pContact->m_Collide)
 			{
 				float a = (PhysSize*1.45f - Distance);
 				float Velocity = 0.5f;
@@ -409,40 +469,37 @@ void CCharacterCore::Tick(bool UseInput)
 			}
 
 			// handle hook influence
-			if(m_Hook && m_HookedPlayer == i && m_pWorld->m_Tuning.m_PlayerHooking)
+			if(pContact->m_Hook)
 			{
-				if(Distance > PhysSize*1.50f) // TODO: fix tweakable variable
-				{
-					float Accel = m_pWorld->m_Tuning.m_HookDragAccel * (Distance/m_pWorld->m_Tuning.m_HookLength);
-					float DragSpeed = m_pWorld->m_Tuning.m_HookDragSpeed;
-
-					// add force to the hooked player
-					vec2 Temp = pCharCore->m_Vel;
-					Temp.x = SaturatedAdd(-DragSpeed, DragSpeed, pCharCore->m_Vel.x, Accel * Dir.x * 1.5f);
-					Temp.y = SaturatedAdd(-DragSpeed, DragSpeed, pCharCore->m_Vel.y, Accel * Dir.y * 1.5f);
-					if (Temp.x > 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_270) || (pCharCore->m_TileIndexL == TILE_STOP && pCharCore->m_TileFlagsL == ROTATION_270) || (pCharCore->m_TileIndexL == TILE_STOPS && (pCharCore->m_TileFlagsL == ROTATION_90 || pCharCore->m_TileFlagsL == ROTATION_270)) || (pCharCore->m_TileIndexL == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_270) || (pCharCore->m_TileFIndexL == TILE_STOP && pCharCore->m_TileFFlagsL == ROTATION_270) || (pCharCore->m_TileFIndexL == TILE_STOPS && (pCharCore->m_TileFFlagsL == ROTATION_90 || pCharCore->m_TileFFlagsL == ROTATION_270)) || (pCharCore->m_TileFIndexL == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_270) || (pCharCore->m_TileSIndexL == TILE_STOP && pCharCore->m_TileSFlagsL == ROTATION_270) || (pCharCore->m_TileSIndexL == TILE_STOPS && (pCharCore->m_TileSFlagsL == ROTATION_90 || pCharCore->m_TileSFlagsL == ROTATION_270)) || (pCharCore->m_TileSIndexL == TILE_STOPA)))
-						Temp.x = 0;
-					if (Temp.x < 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_90) || (pCharCore->m_TileIndexR == TILE_STOP && pCharCore->m_TileFlagsR == ROTATION_90) || (pCharCore->m_TileIndexR == TILE_STOPS && (pCharCore->m_TileFlagsR == ROTATION_90 || pCharCore->m_TileFlagsR == ROTATION_270)) || (pCharCore->m_TileIndexR == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_90) || (pCharCore->m_TileFIndexR == TILE_STOP && pCharCore->m_TileFFlagsR == ROTATION_90) || (pCharCore->m_TileFIndexR == TILE_STOPS && (pCharCore->m_TileFFlagsR == ROTATION_90 || pCharCore->m_TileFFlagsR == ROTATION_270)) || (pCharCore->m_TileFIndexR == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_90) || (pCharCore->m_TileSIndexR == TILE_STOP && pCharCore->m_TileSFlagsR == ROTATION_90) || (pCharCore->m_TileSIndexR == TILE_STOPS && (pCharCore->m_TileSFlagsR == ROTATION_90 || pCharCore->m_TileSFlagsR == ROTATION_270)) || (pCharCore->m_TileSIndexR == TILE_STOPA)))
-						Temp.x = 0;
-					if (Temp.y < 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_180) || (pCharCore->m_TileIndexB == TILE_STOP && pCharCore->m_TileFlagsB == ROTATION_180) || (pCharCore->m_TileIndexB == TILE_STOPS && (pCharCore->m_TileFlagsB == ROTATION_0 || pCharCore->m_TileFlagsB == ROTATION_180)) || (pCharCore->m_TileIndexB == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_180) || (pCharCore->m_TileFIndexB == TILE_STOP && pCharCore->m_TileFFlagsB == ROTATION_180) || (pCharCore->m_TileFIndexB == TILE_STOPS && (pCharCore->m_TileFFlagsB == ROTATION_0 || pCharCore->m_TileFFlagsB == ROTATION_180)) || (pCharCore->m_TileFIndexB == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_180) || (pCharCore->m_TileSIndexB == TILE_STOP && pCharCore->m_TileSFlagsB == ROTATION_180) || (pCharCore->m_TileSIndexB == TILE_STOPS && (pCharCore->m_TileSFlagsB == ROTATION_0 || pCharCore->m_TileSFlagsB == ROTATION_180)) || (pCharCore->m_TileSIndexB == TILE_STOPA)))
-						Temp.y = 0;
-					if (Temp.y > 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_0) || (pCharCore->m_TileIndexT == TILE_STOP && pCharCore->m_TileFlagsT == ROTATION_0) || (pCharCore->m_TileIndexT == TILE_STOPS && (pCharCore->m_TileFlagsT == ROTATION_0 || pCharCore->m_TileFlagsT == ROTATION_180)) || (pCharCore->m_TileIndexT == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_0) || (pCharCore->m_TileFIndexT == TILE_STOP && pCharCore->m_TileFFlagsT == ROTATION_0) || (pCharCore->m_TileFIndexT == TILE_STOPS && (pCharCore->m_TileFFlagsT == ROTATION_0 || pCharCore->m_TileFFlagsT == ROTATION_180)) || (pCharCore->m_TileFIndexT == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_0) || (pCharCore->m_TileSIndexT == TILE_STOP && pCharCore->m_TileSFlagsT == ROTATION_0) || (pCharCore->m_TileSIndexT == TILE_STOPS && (pCharCore->m_TileSFlagsT == ROTATION_0 || pCharCore->m_TileSFlagsT == ROTATION_180)) || (pCharCore->m_TileSIndexT == TILE_STOPA)))
-						Temp.y = 0;
-					pCharCore->m_Vel = Temp;
-
-					// add a little bit force to the guy who has the grip
-					Temp.x = SaturatedAdd(-DragSpeed, DragSpeed, m_Vel.x, -Accel * Dir.x * 0.25f);
-					Temp.y = SaturatedAdd(-DragSpeed, DragSpeed, m_Vel.y, -Accel * Dir.y * 0.25f);
-					if (Temp.x > 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_270) || (m_TileIndexL == TILE_STOP && m_TileFlagsL == ROTATION_270) || (m_TileIndexL == TILE_STOPS && (m_TileFlagsL == ROTATION_90 || m_TileFlagsL == ROTATION_270)) || (m_TileIndexL == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_270) || (m_TileFIndexL == TILE_STOP && m_TileFFlagsL == ROTATION_270) || (m_TileFIndexL == TILE_STOPS && (m_TileFFlagsL == ROTATION_90 || m_TileFFlagsL == ROTATION_270)) || (m_TileFIndexL == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_270) || (m_TileSIndexL == TILE_STOP && m_TileSFlagsL == ROTATION_270) || (m_TileSIndexL == TILE_STOPS && (m_TileSFlagsL == ROTATION_90 || m_TileSFlagsL == ROTATION_270)) || (m_TileSIndexL == TILE_STOPA)))
-						Temp.x = 0;
-					if (Temp.x < 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_90) || (m_TileIndexR == TILE_STOP && m_TileFlagsR == ROTATION_90) || (m_TileIndexR == TILE_STOPS && (m_TileFlagsR == ROTATION_90 || m_TileFlagsR == ROTATION_270)) || (m_TileIndexR == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_90) || (m_TileFIndexR == TILE_STOP && m_TileFFlagsR == ROTATION_90) || (m_TileFIndexR == TILE_STOPS && (m_TileFFlagsR == ROTATION_90 || m_TileFFlagsR == ROTATION_270)) || (m_TileFIndexR == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_90) || (m_TileSIndexR == TILE_STOP && m_TileSFlagsR == ROTATION_90) || (m_TileSIndexR == TILE_STOPS && (m_TileSFlagsR == ROTATION_90 || m_TileSFlagsR == ROTATION_270)) || (m_TileSIndexR == TILE_STOPA)))
-						Temp.x = 0;
-					if (Temp.y < 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_180) || (m_TileIndexB == TILE_STOP && m_TileFlagsB == ROTATION_180) || (m_TileIndexB == TILE_STOPS && (m_TileFlagsB == ROTATION_0 || m_TileFlagsB == ROTATION_180)) || (m_TileIndexB == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_180) || (m_TileFIndexB == TILE_STOP && m_TileFFlagsB == ROTATION_180) || (m_TileFIndexB == TILE_STOPS && (m_TileFFlagsB == ROTATION_0 || m_TileFFlagsB == ROTATION_180)) || (m_TileFIndexB == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_180) || (m_TileSIndexB == TILE_STOP && m_TileSFlagsB == ROTATION_180) || (m_TileSIndexB == TILE_STOPS && (m_TileSFlagsB == ROTATION_0 || m_TileSFlagsB == ROTATION_180)) || (m_TileSIndexB == TILE_STOPA)))
-						Temp.y = 0;
-					if (Temp.y > 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_0) || (m_TileIndexT == TILE_STOP && m_TileFlagsT == ROTATION_0) || (m_TileIndexT == TILE_STOPS && (m_TileFlagsT == ROTATION_0 || m_TileFlagsT == ROTATION_180)) || (m_TileIndexT == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_0) || (m_TileFIndexT == TILE_STOP && m_TileFFlagsT == ROTATION_0) || (m_TileFIndexT == TILE_STOPS && (m_TileFFlagsT == ROTATION_0 || m_TileFFlagsT == ROTATION_180)) || (m_TileFIndexT == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_0) || (m_TileSIndexT == TILE_STOP && m_TileSFlagsT == ROTATION_0) || (m_TileSIndexT == TILE_STOPS && (m_TileSFlagsT == ROTATION_0 || m_TileSFlagsT == ROTATION_180)) || (m_TileSIndexT == TILE_STOPA)))
-						Temp.y = 0;
-					m_Vel = Temp;
-				}
+				float Accel = m_pWorld->m_Tuning.m_HookDragAccel * (Distance/m_pWorld->m_Tuning.m_HookLength);
+				float DragSpeed = m_pWorld->m_Tuning.m_HookDragSpeed;
+
+				// add force to the hooked player
+				vec2 Temp = pCharCore->m_Vel;
+				Temp.x = SaturatedAdd(-DragSpeed, DragSpeed, pCharCore->m_Vel.x, Accel * Dir.x * 1.5f);
+				Temp.y = SaturatedAdd(-DragSpeed, DragSpeed, pCharCore->m_Vel.y, Accel * Dir.y * 1.5f);
+				if (Temp.x > 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_270) || (pCharCore->m_TileIndexL == TILE_STOP && pCharCore->m_TileFlagsL == ROTATION_270) || (pCharCore->m_TileIndexL == TILE_STOPS && (pCharCore->m_TileFlagsL == ROTATION_90 || pCharCore->m_TileFlagsL == ROTATION_270)) || (pCharCore->m_TileIndexL == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_270) || (pCharCore->m_TileFIndexL == TILE_STOP && pCharCore->m_TileFFlagsL == ROTATION_270) || (pCharCore->m_TileFIndexL == TILE_STOPS && (pCharCore->m_TileFFlagsL == ROTATION_90 || pCharCore->m_TileFFlagsL == ROTATION_270)) || (pCharCore->m_TileFIndexL == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_270) || (pCharCore->m_TileSIndexL == TILE_STOP && pCharCore->m_TileSFlagsL == ROTATION_270) || (pCharCore->m_TileSIndexL == TILE_STOPS && (pCharCore->m_TileSFlagsL == ROTATION_90 || pCharCore->m_TileSFlagsL == ROTATION_270)) || (pCharCore->m_TileSIndexL == TILE_STOPA)))
+					Temp.x = 0;
+				if (Temp.x < 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_90) || (pCharCore->m_TileIndexR == TILE_STOP && pCharCore->m_TileFlagsR == ROTATION_90) || (pCharCore->m_TileIndexR == TILE_STOPS && (pCharCore->m_TileFlagsR == ROTATION_90 || pCharCore->m_TileFlagsR == ROTATION_270)) || (pCharCore->m_TileIndexR == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_90) || (pCharCore->m_TileFIndexR == TILE_STOP && pCharCore->m_TileFFlagsR == ROTATION_90) || (pCharCore->m_TileFIndexR == TILE_STOPS && (pCharCore->m_TileFFlagsR == ROTATION_90 || pCharCore->m_TileFFlagsR == ROTATION_270)) || (pCharCore->m_TileFIndexR == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_90) || (pCharCore->m_TileSIndexR == TILE_STOP && pCharCore->m_TileSFlagsR == ROTATION_90) || (pCharCore->m_TileSIndexR == TILE_STOPS && (pCharCore->m_TileSFlagsR == ROTATION_90 || pCharCore->m_TileSFlagsR == ROTATION_270)) || (pCharCore->m_TileSIndexR == TILE_STOPA)))
+					Temp.x = 0;
+				if (Temp.y < 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_180) || (pCharCore->m_TileIndexB == TILE_STOP && pCharCore->m_TileFlagsB == ROTATION_180) || (pCharCore->m_TileIndexB == TILE_STOPS && (pCharCore->m_TileFlagsB == ROTATION_0 || pCharCore->m_TileFlagsB == ROTATION_180)) || (pCharCore->m_TileIndexB == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_180) || (pCharCore->m_TileFIndexB == TILE_STOP && pCharCore->m_TileFFlagsB == ROTATION_180) || (pCharCore->m_TileFIndexB == TILE_STOPS && (pCharCore->m_TileFFlagsB == ROTATION_0 || pCharCore->m_TileFFlagsB == ROTATION_180)) || (pCharCore->m_TileFIndexB == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_180) || (pCharCore->m_TileSIndexB == TILE_STOP && pCharCore->m_TileSFlagsB == ROTATION_180) || (pCharCore->m_TileSIndexB == TILE_STOPS && (pCharCore->m_TileSFlagsB == ROTATION_0 || pCharCore->m_TileSFlagsB == ROTATION_180)) || (pCharCore->m_TileSIndexB == TILE_STOPA)))
+					Temp.y = 0;
+				if (Temp.y > 0 && ((pCharCore->m_TileIndex == TILE_STOP && pCharCore->m_TileFlags == ROTATION_0) || (pCharCore->m_TileIndexT == TILE_STOP && pCharCore->m_TileFlagsT == ROTATION_0) || (pCharCore->m_TileIndexT == TILE_STOPS && (pCharCore->m_TileFlagsT == ROTATION_0 || pCharCore->m_TileFlagsT == ROTATION_180)) || (pCharCore->m_TileIndexT == TILE_STOPA) || (pCharCore->m_TileFIndex == TILE_STOP && pCharCore->m_TileFFlags == ROTATION_0) || (pCharCore->m_TileFIndexT == TILE_STOP && pCharCore->m_TileFFlagsT == ROTATION_0) || (pCharCore->m_TileFIndexT == TILE_STOPS && (pCharCore->m_TileFFlagsT == ROTATION_0 || pCharCore->m_TileFFlagsT == ROTATION_180)) || (pCharCore->m_TileFIndexT == TILE_STOPA) || (pCharCore->m_TileSIndex == TILE_STOP && pCharCore->m_TileSFlags == ROTATION_0) || (pCharCore->m_TileSIndexT == TILE_STOP && pCharCore->m_TileSFlagsT == ROTATION_0) || (pCharCore->m_TileSIndexT == TILE_STOPS && (pCharCore->m_TileSFlagsT == ROTATION_0 || pCharCore->m_TileSFlagsT == ROTATION_180)) || (pCharCore->m_TileSIndexT == TILE_STOPA)))
+					Temp.y = 0;
+				pCharCore->m_Vel = Temp;
+
+				// add a little bit force to the guy who has the grip
+				Temp.x = SaturatedAdd(-DragSpeed, DragSpeed, m_Vel.x, -Accel * Dir.x * 0.25f);
+				Temp.y = SaturatedAdd(-DragSpeed, DragSpeed, m_Vel.y, -Accel * Dir.y * 0.25f);
+				if (Temp.x > 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_270) || (m_TileIndexL == TILE_STOP && m_TileFlagsL == ROTATION_270) || (m_TileIndexL == TILE_STOPS && (m_TileFlagsL == ROTATION_90 || m_TileFlagsL == ROTATION_270)) || (m_TileIndexL == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_270) || (m_TileFIndexL == TILE_STOP && m_TileFFlagsL == ROTATION_270) || (m_TileFIndexL == TILE_STOPS && (m_TileFFlagsL == ROTATION_90 || m_TileFFlagsL == ROTATION_270)) || (m_TileFIndexL == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_270) || (m_TileSIndexL == TILE_STOP && m_TileSFlagsL == ROTATION_270) || (m_TileSIndexL == TILE_STOPS && (m_TileSFlagsL == ROTATION_90 || m_TileSFlagsL == ROTATION_270)) || (m_TileSIndexL == TILE_STOPA)))
+					Temp.x = 0;
+				if (Temp.x < 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_90) || (m_TileIndexR == TILE_STOP && m_TileFlagsR == ROTATION_90) || (m_TileIndexR == TILE_STOPS && (m_TileFlagsR == ROTATION_90 || m_TileFlagsR == ROTATION_270)) || (m_TileIndexR == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_90) || (m_TileFIndexR == TILE_STOP && m_TileFFlagsR == ROTATION_90) || (m_TileFIndexR == TILE_STOPS && (m_TileFFlagsR == ROTATION_90 || m_TileFFlagsR == ROTATION_270)) || (m_TileFIndexR == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_90) || (m_TileSIndexR == TILE_STOP && m_TileSFlagsR == ROTATION_90) || (m_TileSIndexR == TILE_STOPS && (m_TileSFlagsR == ROTATION_90 || m_TileSFlagsR == ROTATION_270)) || (m_TileSIndexR == TILE_STOPA)))
+					Temp.x = 0;
+				if (Temp.y < 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_180) || (m_TileIndexB == TILE_STOP && m_TileFlagsB == ROTATION_180) || (m_TileIndexB == TILE_STOPS && (m_TileFlagsB == ROTATION_0 || m_TileFlagsB == ROTATION_180)) || (m_TileIndexB == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_180) || (m_TileFIndexB == TILE_STOP && m_TileFFlagsB == ROTATION_180) || (m_TileFIndexB == TILE_STOPS && (m_TileFFlagsB == ROTATION_0 || m_TileFFlagsB == ROTATION_180)) || (m_TileFIndexB == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_180) || (m_TileSIndexB == TILE_STOP && m_TileSFlagsB == ROTATION_180) || (m_TileSIndexB == TILE_STOPS && (m_TileSFlagsB == ROTATION_0 || m_TileSFlagsB == ROTATION_180)) || (m_TileSIndexB == TILE_STOPA)))
+					Temp.y = 0;
+				if (Temp.y > 0 && ((m_TileIndex == TILE_STOP && m_TileFlags == ROTATION_0) || (m_TileIndexT == TILE_STOP && m_TileFlagsT == ROTATION_0) || (m_TileIndexT == TILE_STOPS && (m_TileFlagsT == ROTATION_0 || m_TileFlagsT == ROTATION_180)) || (m_TileIndexT == TILE_STOPA) || (m_TileFIndex == TILE_STOP && m_TileFFlags == ROTATION_0) || (m_TileFIndexT == TILE_STOP && m_TileFFlagsT == ROTATION_0) || (m_TileFIndexT == TILE_STOPS && (m_TileFFlagsT == ROTATION_0 || m_TileFFlagsT == ROTATION_180)) || (m_TileFIndexT == TILE_STOPA) || (m_TileSIndex == TILE_STOP && m_TileSFlags == ROTATION_0) || (m_TileSIndexT == TILE_STOP && m_TileSFlagsT == ROTATION_0) || (m_TileSIndexT == TILE_STOPS && (m_TileSFlagsT == ROTATION_0 || m_TileSFlagsT == ROTATION_180)) || (m_TileSIndexT == TILE_STOPA)))
+					Temp.y = 0;
+				m_Vel = Temp;
 			}
 		}
 
@@ -186,6 +186,41 @@ public:
 	void Tick(bool UseInput);
 	void Move();
 
+	// what TickPrepare found out about the world for TickApply
+	struct CTickState
+	{
+		bool m_Grounded;
+		bool m_HookDrag;
+		int m_TeleNr;
+
+		struct CContact
+		{
+			int m_ClientID;
+			float m_Distance;
+			vec2 m_Dir;
+			bool m_Collide;
+			bool m_Hook;
+		};
+		int m_NumContacts;
+		CContact m_aContacts[MAX_CLIENTS];
+	};
+
+	/*
+		Function: TickPrepare
+			First half of <Tick>. Handles the input and the hook against
+			the positions of the other characters and only writes to this
+			core, so all cores of a world can be prepared in parallel as
+			long as nobody moves.
+
+		Function: TickApply
+			Second half of <Tick>. Applies gravity, jumps, collisions and
+			the hook forces, including the ones on the hooked player.
+			Applying the prepared cores in client order gives the same
+			result, to the bit, as ticking them one after another.
+	*/
+	void TickPrepare(bool UseInput, CTickState *pState);
+	void TickApply(bool UseInput, const CTickState *pState);
+
 	void Read(const CNetObj_CharacterCore *pObjCore);
 	void Write(CNetObj_CharacterCore *pObjCore);
 	void Quantize();
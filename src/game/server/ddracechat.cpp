@@ -746,6 +746,7 @@ void CGameContext::ConShowOthers(IConsole::IResult *pResult, void *pUserData)
 			pPlayer->m_ShowOthers = pResult->GetInteger(0);
 		else
 			pPlayer->m_ShowOthers = !pPlayer->m_ShowOthers;
+		pSelf->OnViewChange();
 	}
 	else
 		pSelf->Console()->Print(
@@ -796,6 +797,7 @@ void CGameContext::ConSpecTeam(IConsole::IResult *pResult, void *pUserData)
 		pPlayer->m_SpecTeam = pResult->GetInteger(0);
 	else
 		pPlayer->m_SpecTeam = !pPlayer->m_SpecTeam;
+	pSelf->OnViewChange();
 }
 
 bool CheckClientID(int ClientID)
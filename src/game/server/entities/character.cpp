@@ -67,7 +67,7 @@ bool CCharacter::Spawn(CPlayer *pPlayer, vec2 Pos)
 	m_QueuedWeapon = -1;
 
 	m_pPlayer = pPlayer;
-	m_Pos = Pos;
+	SetPos(Pos);
 
 	m_Core.Reset();
 	m_Core.Init(&GameServer()->m_World.m_Core, GameServer()->Collision(), &((CGameControllerDDrace*)GameServer()->m_pController)->m_Teams.m_Core, &((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts);
@@ -78,6 +78,8 @@ bool CCharacter::Spawn(CPlayer *pPlayer, vec2 Pos)
 	m_ReckoningTick = 0;
 	mem_zero(&m_SendCore, sizeof(m_SendCore));
 	mem_zero(&m_ReckoningCore, sizeof(m_ReckoningCore));
+	m_ReckoningAdvanced = false;
+	m_CorePrepared = false;
 
 	GameServer()->m_World.InsertEntity(this);
 	m_Alive = true;
@@ -100,6 +102,7 @@ void CCharacter::Destroy()
 {
 	GameServer()->m_World.m_Core.m_apCharacters[m_pPlayer->GetCID()] = 0;
 	m_Alive = false;
+	Teams()->OnViewChange();
 }
 
 void CCharacter::SetWeapon(int W)
@@ -120,7 +123,7 @@ void CCharacter::SetWeapon(int W)
 void CCharacter::SetSolo(bool Solo)
 {
 	m_Solo = Solo;
-	Teams()->m_Core.SetSolo(m_pPlayer->GetCID(), Solo);
+	Teams()->SetSolo(m_pPlayer->GetCID(), Solo);
 }
 
 bool CCharacter::IsGrounded()
@@ -739,7 +742,14 @@ void CCharacter::Tick()
 	DDraceTick();
 
 	m_Core.m_Input = m_Input;
-	m_Core.Tick(true);
+	if(m_CorePrepared && mem_comp(&m_Core, &m_PreparedCoreBase, sizeof(m_Core)) == 0 && GameWorld()->PreparedCoresValid())
+	{
+		mem_copy(&m_Core, &m_PreparedCore, sizeof(m_Core));
+		m_Core.TickApply(true, &m_PreparedState);
+	}
+	else
+		m_Core.Tick(true);
+	m_CorePrepared = false;
 
 	// handle Weapons
 	HandleWeapons();
@@ -751,14 +761,10 @@ void CCharacter::Tick()
 
 void CCharacter::TickDefered()
 {
-	// advance the dummy
-	{
-		CWorldCore TempWorld;
-		m_ReckoningCore.Init(&TempWorld, GameServer()->Collision(), &((CGameControllerDDrace*)GameServer()->m_pController)->m_Teams.m_Core, &((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts);
-		m_ReckoningCore.Tick(false);
-		m_ReckoningCore.Move();
-		m_ReckoningCore.Quantize();
-	}
+	// advance the dummy, unless a core job did already
+	if(!m_ReckoningAdvanced)
+		AdvanceReckoning(true);
+	m_ReckoningAdvanced = false;
 
 	//lastsentcore
 	vec2 StartPos = m_Core.m_Pos;
@@ -770,7 +776,7 @@ void CCharacter::TickDefered()
 	bool StuckAfterMove = GameServer()->Collision()->TestBox(m_Core.m_Pos, vec2(28.0f, 28.0f));
 	m_Core.Quantize();
 	bool StuckAfterQuant = GameServer()->Collision()->TestBox(m_Core.m_Pos, vec2(28.0f, 28.0f));
-	m_Pos = m_Core.m_Pos;
+	SetPos(m_Core.m_Pos);
 
 	if(!StuckBefore && (StuckAfterMove || StuckAfterQuant))
 	{
@@ -802,8 +808,7 @@ void CCharacter::TickDefered()
 
 	if(m_pPlayer->GetTeam() == TEAM_SPECTATORS)
 	{
-		m_Pos.x = m_Input.m_TargetX;
-		m_Pos.y = m_Input.m_TargetY;
+		SetPos(vec2(m_Input.m_TargetX, m_Input.m_TargetY));
 	}
 
 	// update the m_SendCore if needed
@@ -825,6 +830,39 @@ void CCharacter::TickDefered()
 	}
 }
 
+bool CCharacter::AdvanceReckoning(bool MainThread)
+{
+	CWorldCore TempWorld;
+	CCharacterCore Core = m_ReckoningCore;
+	Core.Init(&TempWorld, GameServer()->Collision(), &((CGameControllerDDrace*)GameServer()->m_pController)->m_Teams.m_Core, &((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts);
+
+	CCharacterCore::CTickState State;
+	Core.TickPrepare(false, &State);
+	// the teleporter exit is random, keep the order of the rand() calls
+	if(State.m_TeleNr && !MainThread)
+		return false;
+	Core.TickApply(false, &State);
+	Core.Move();
+	Core.Quantize();
+
+	m_ReckoningCore = Core;
+	m_ReckoningAdvanced = true;
+	return true;
+}
+
+void CCharacter::PrepareCore()
+{
+	m_CorePrepared = false;
+	if(m_Paused)
+		return;
+
+	mem_copy(&m_PreparedCoreBase, &m_Core, sizeof(m_Core));
+	m_PreparedCoreBase.m_Input = m_Input;
+	mem_copy(&m_PreparedCore, &m_PreparedCoreBase, sizeof(m_Core));
+	m_PreparedCore.TickPrepare(true, &m_PreparedState);
+	m_CorePrepared = true;
+}
+
 void CCharacter::TickPaused()
 {
 	++m_AttackTick;
@@ -857,6 +895,7 @@ bool CCharacter::IncreaseArmor(int Amount)
 void CCharacter::Die(int Killer, int Weapon)
 {
 	m_Alive = false;
+	Teams()->OnViewChange();
 	int ModeSpecial = GameServer()->m_pController->OnCharacterDeath(this, GameServer()->m_apPlayers[Killer], Weapon);
 
 	char aBuf[256];
@@ -1013,18 +1052,42 @@ void CCharacter::Snap(int SnappingClient)
 	if(!pCharacter)
 		return;
 
+	// the part that is the same for everyone was built in PreSnap
+	*pCharacter = m_SnapCharacter;
+
+	if(m_pPlayer->GetCID() == SnappingClient || SnappingClient == -1 ||
+		(!g_Config.m_SvStrictSpectateMode && m_pPlayer->GetCID() == GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID()))
+	{
+		pCharacter->m_Health = m_Health;
+		pCharacter->m_Armor = m_Armor;
+		if (m_FreezeTime > 0 || m_FreezeTime == -1 || m_DeepFreeze)
+			pCharacter->m_AmmoCount = m_FreezeTick + g_Config.m_SvFreezeDelay * Server()->TickSpeed();
+		else if(m_ActiveWeapon == WEAPON_NINJA)
+			pCharacter->m_AmmoCount = m_Ninja.m_ActivationTick + g_pData->m_Weapons.m_Ninja.m_Duration * Server()->TickSpeed() / 1000;
+		else if(m_aWeapons[m_ActiveWeapon].m_Ammo > 0)
+			pCharacter->m_AmmoCount = !m_FreezeTime ? m_aWeapons[m_ActiveWeapon].m_Ammo : 0;
+	}
+}
+
+void CCharacter::PreSnap()
+{
+	if (m_Paused)
+		return;
+
+	mem_zero(&m_SnapCharacter, sizeof(m_SnapCharacter));
+
 	// write down the m_Core
 	if(!m_ReckoningTick || GameServer()->m_World.m_Paused)
 	{
 		// no dead reckoning when paused because the client doesn't know
 		// how far to perform the reckoning
-		pCharacter->m_Tick = 0;
-		m_Core.Write(pCharacter);
+		m_SnapCharacter.m_Tick = 0;
+		m_Core.Write(&m_SnapCharacter);
 	}
 	else
 	{
-		pCharacter->m_Tick = m_ReckoningTick;
-		m_SendCore.Write(pCharacter);
+		m_SnapCharacter.m_Tick = m_ReckoningTick;
+		m_SendCore.Write(&m_SnapCharacter);
 	}
 
 	// set emote
@@ -1034,66 +1097,53 @@ void CCharacter::Snap(int SnappingClient)
 		m_EmoteStop = -1;
 	}
 
-	pCharacter->m_Emote = m_EmoteType;
+	m_SnapCharacter.m_Emote = m_EmoteType;
 
-	pCharacter->m_AmmoCount = 0;
-	pCharacter->m_Health = 0;
-	pCharacter->m_Armor = 0;
-	pCharacter->m_TriggeredEvents = m_TriggeredEvents;
+	m_SnapCharacter.m_AmmoCount = 0;
+	m_SnapCharacter.m_Health = 0;
+	m_SnapCharacter.m_Armor = 0;
+	m_SnapCharacter.m_TriggeredEvents = m_TriggeredEvents;
 
-	pCharacter->m_Weapon = m_ActiveWeapon;
-	pCharacter->m_AttackTick = m_AttackTick;
+	m_SnapCharacter.m_Weapon = m_ActiveWeapon;
+	m_SnapCharacter.m_AttackTick = m_AttackTick;
 
-	pCharacter->m_Direction = m_Input.m_Direction;
+	m_SnapCharacter.m_Direction = m_Input.m_Direction;
 
 	// change eyes and use ninja graphic if player is freeze
 	if (m_DeepFreeze)
 	{
-		if (pCharacter->m_Emote == EMOTE_NORMAL)
-			pCharacter->m_Emote = EMOTE_PAIN;
-		pCharacter->m_Weapon = WEAPON_NINJA;
+		if (m_SnapCharacter.m_Emote == EMOTE_NORMAL)
+			m_SnapCharacter.m_Emote = EMOTE_PAIN;
+		m_SnapCharacter.m_Weapon = WEAPON_NINJA;
 	}
 	else if (m_FreezeTime > 0 || m_FreezeTime == -1)
 	{
-		if (pCharacter->m_Emote == EMOTE_NORMAL)
-			pCharacter->m_Emote = EMOTE_BLINK;
-		pCharacter->m_Weapon = WEAPON_NINJA;
+		if (m_SnapCharacter.m_Emote == EMOTE_NORMAL)
+			m_SnapCharacter.m_Emote = EMOTE_BLINK;
+		m_SnapCharacter.m_Weapon = WEAPON_NINJA;
 	}
 
 	// change eyes, use ninja graphic and set ammo count if player has ninjajetpack
 	if (m_pPlayer->m_NinjaJetpack && m_Jetpack && m_ActiveWeapon == WEAPON_GUN && !m_DeepFreeze && !(m_FreezeTime > 0 || m_FreezeTime == -1))
 	{
-		if (pCharacter->m_Emote == EMOTE_NORMAL)
-			pCharacter->m_Emote = EMOTE_HAPPY;
-		pCharacter->m_Weapon = WEAPON_NINJA;
-		pCharacter->m_AmmoCount = 10;
-	}
-
-	if(m_pPlayer->GetCID() == SnappingClient || SnappingClient == -1 ||
-		(!g_Config.m_SvStrictSpectateMode && m_pPlayer->GetCID() == GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID()))
-	{
-		pCharacter->m_Health = m_Health;
-		pCharacter->m_Armor = m_Armor;
-		if (m_FreezeTime > 0 || m_FreezeTime == -1 || m_DeepFreeze)
-			pCharacter->m_AmmoCount = m_FreezeTick + g_Config.m_SvFreezeDelay * Server()->TickSpeed();
-		else if(m_ActiveWeapon == WEAPON_NINJA)
-			pCharacter->m_AmmoCount = m_Ninja.m_ActivationTick + g_pData->m_Weapons.m_Ninja.m_Duration * Server()->TickSpeed() / 1000;
-		else if(m_aWeapons[m_ActiveWeapon].m_Ammo > 0)
-			pCharacter->m_AmmoCount = !m_FreezeTime ? m_aWeapons[m_ActiveWeapon].m_Ammo : 0;
+		if (m_SnapCharacter.m_Emote == EMOTE_NORMAL)
+			m_SnapCharacter.m_Emote = EMOTE_HAPPY;
+		m_SnapCharacter.m_Weapon = WEAPON_NINJA;
+		m_SnapCharacter.m_AmmoCount = 10;
 	}
 
 	if (GetPlayer()->m_Afk || GetPlayer()->IsPaused())
 	{
 		if (m_FreezeTime > 0 || m_FreezeTime == -1 || m_DeepFreeze)
-			pCharacter->m_Emote = EMOTE_NORMAL;
+			m_SnapCharacter.m_Emote = EMOTE_NORMAL;
 		else
-			pCharacter->m_Emote = EMOTE_BLINK;
+			m_SnapCharacter.m_Emote = EMOTE_BLINK;
 	}
 
-	if(pCharacter->m_Emote == EMOTE_NORMAL)
+	if(m_SnapCharacter.m_Emote == EMOTE_NORMAL)
 	{
 		if(250 - ((Server()->Tick() - m_LastAction)%(250)) < 5)
-			pCharacter->m_Emote = EMOTE_BLINK;
+			m_SnapCharacter.m_Emote = EMOTE_BLINK;
 	}
 
 	if (m_pPlayer->m_Halloween)
@@ -1977,12 +2027,13 @@ void CCharacter::DDracePostCoreTick()
 		return;
 
 	// handle Anti-Skip tiles
-	std::list < int > Indices = GameServer()->Collision()->GetMapIndices(m_PrevPos, m_Pos);
-	if (!Indices.empty())
+	CMapIndices Indices;
+	GameServer()->Collision()->GetMapIndices(m_PrevPos, m_Pos, &Indices);
+	if (!Indices.Empty())
 	{
-		for (std::list < int >::iterator i = Indices.begin(); i != Indices.end(); i++)
+		for (int i = 0; i < Indices.Num(); i++)
 		{
-			HandleTiles(*i);
+			HandleTiles(Indices[i]);
 			if (!m_Alive)
 				return;
 		}
@@ -2145,7 +2196,7 @@ void CCharacter::Rescue()
 		if (GameServer()->Collision()->GetTileIndex(index) == TILE_FREEZE || GameServer()->Collision()->GetFTileIndex(index) == TILE_FREEZE) {
 			m_LastRescue = Server()->Tick();
 			m_Core.m_Pos = m_PrevSavePos;
-			m_Pos = m_PrevSavePos;
+			SetPos(m_PrevSavePos);
 			m_PrevPos = m_PrevSavePos;
 			m_Core.m_Vel = vec2(0, 0);
 			m_Core.m_HookedPlayer = -1;
@@ -25,6 +25,7 @@ public:
 	virtual void Tick();
 	virtual void TickDefered();
 	virtual void TickPaused();
+	virtual void PreSnap();
 	virtual void Snap(int SnappingClient);
 	virtual void PostSnap();
 
@@ -33,6 +34,30 @@ public:
 
 	bool IsGrounded();
 
+	/*
+		Function: AdvanceReckoning
+			Ticks the dead reckoning core. It doesn't see the other
+			characters, so the cores can be advanced on worker threads
+			before the deferred ticks.
+
+		Arguments:
+			MainThread - Whether rand() may be called, it is needed when
+				the hook goes through a teleporter.
+
+		Returns:
+			False if the core was left untouched for the main thread.
+	*/
+	bool AdvanceReckoning(bool MainThread);
+
+	/*
+		Function: PrepareCore
+			Runs the first half of the core tick on a copy of the core.
+			<Tick> applies it if neither the core nor what the world
+			looked like changed in between, otherwise it ticks the core
+			from scratch. Called for all characters on worker threads.
+	*/
+	void PrepareCore();
+
 	void SetWeapon(int W);
 	void SetSolo(bool Solo);
 	void HandleWeaponSwitch();
@@ -130,7 +155,15 @@ private:
 	// info for dead reckoning
 	int m_ReckoningTick; // tick that we are performing dead reckoning From
 	CCharacterCore m_SendCore; // core that we should send
+	CNetObj_Character m_SnapCharacter; // snapshot item shared by all clients
 	CCharacterCore m_ReckoningCore; // the dead reckoning core
+	bool m_ReckoningAdvanced; // already advanced for this tick
+
+	// the first half of this tick's core tick, see PrepareCore
+	bool m_CorePrepared;
+	CCharacterCore m_PreparedCoreBase; // m_Core when it was prepared
+	CCharacterCore m_PreparedCore;
+	CCharacterCore::CTickState m_PreparedState;
 
 	// DDrace
 
@@ -257,7 +290,6 @@ public:
 	void SetNinjaActivationTick(int ActivationTick) { m_Ninja.m_ActivationTick = ActivationTick; };
 	void SetNinjaCurrentMoveTime(int CurrentMoveTime) { m_Ninja.m_CurrentMoveTime = CurrentMoveTime; };
 
-	void SetPos(vec2 Pos) { m_Pos = Pos; };
 };
 
 enum
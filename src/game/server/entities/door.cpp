@@ -20,6 +20,7 @@ CDoor::CDoor(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	GameServer()->Collision()->IntersectNoLaser(Pos, To, &this->m_To, 0);
 	ResetCollision();
 	GameWorld()->InsertEntity(this);
+	SetSnapRange(m_Length);
 }
 
 void CDoor::Open(int Tick, bool ActivatedTeam[])
@@ -21,6 +21,7 @@ CDragger::CDragger(CGameWorld *pGameWorld, vec2 Pos, float Strength, bool NW,
 	m_NW = NW;
 	m_CaughtTeam = CaughtTeam;
 	GameWorld()->InsertEntity(this);
+	UpdateSnapRange();
 
 	for (int i = 0; i < MAX_CLIENTS; i++)
 	{
@@ -257,8 +258,16 @@ void CDragger::Reset()
 	GameServer()->m_World.DestroyEntity(this);
 }
 
+void CDragger::UpdateSnapRange()
+{
+	// the targets are checked against the range before they move, leave
+	// them a tick of fast movement
+	SetSnapRange(g_Config.m_SvDraggerRange + 128.0f);
+}
+
 void CDragger::Tick()
 {
+	UpdateSnapRange();
 	if (((CGameControllerDDrace*) GameServer()->m_pController)->m_Teams.GetTeamState(
 			m_CaughtTeam) == CGameTeams::TEAMSTATE_EMPTY)
 		return;
@@ -272,7 +281,7 @@ void CDragger::Tick()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 		Move();
 	}
 	Drag();
@@ -12,6 +12,7 @@ class CDragger: public CEntity
 	int m_EvalTick;
 	void Move();
 	void Drag();
+	void UpdateSnapRange();
 	CCharacter * m_Target;
 	bool m_NW;
 	int m_CaughtTeam;
@@ -21,7 +21,7 @@ void CFlag::Reset()
 {
 	m_pCarrier = 0;
 	m_AtStand = true;
-	m_Pos = m_StandPos;
+	SetPos(m_StandPos);
 	m_Vel = vec2(0, 0);
 	m_GrabTick = 0;
 }
@@ -46,7 +46,7 @@ void CFlag::TickDefered()
 	if(m_pCarrier)
 	{
 		// update flag position
-		m_Pos = m_pCarrier->GetPos();
+		SetPos(m_pCarrier->GetPos());
 	}
 	else
 	{
@@ -68,7 +68,9 @@ void CFlag::TickDefered()
 			else
 			{
 				m_Vel.y += GameServer()->m_World.m_Core.m_Tuning.m_Gravity;
-				GameServer()->Collision()->MoveBox(&m_Pos, &m_Vel, vec2(ms_PhysSize, ms_PhysSize), 0.5f);
+				vec2 Pos = m_Pos;
+				GameServer()->Collision()->MoveBox(&Pos, &m_Vel, vec2(ms_PhysSize, ms_PhysSize), 0.5f);
+				SetPos(Pos);
 			}
 		}
 	}
@@ -104,28 +104,21 @@ void CGun::Tick()
 		{
 			m_Core=GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos+=m_Core;
+		SetPos(m_Pos + m_Core);
 	}
 	if (m_LastFire + Server()->TickSpeed() / g_Config.m_SvPlasmaPerSec <= Server()->Tick())
 		Fire();
 
 }
 
-void CGun::Snap(int SnappingClient)
+void CGun::PreSnap()
 {
-	if(NetworkClipped(SnappingClient))
-		return;
-
-	CCharacter *Char = GameServer()->GetPlayerChar(SnappingClient);
-
-	if(SnappingClient > -1 && (GameServer()->m_apPlayers[SnappingClient]->GetTeam() == -1
-				|| GameServer()->m_apPlayers[SnappingClient]->IsPaused())
-			&& GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID() != -1)
-		Char = GameServer()->GetPlayerChar(GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID());
-
+	int64_t Mask = -1LL;
 	int Tick = (Server()->Tick()%Server()->TickSpeed())%11;
-	if (Char && Char->IsAlive() && (m_Layer == LAYER_SWITCH && !GameServer()->Collision()->m_pSwitchers[m_Number].m_Status[Char->Team()]) && (!Tick)) return;
-	CNetObj_Laser *pObj = static_cast<CNetObj_Laser *>(Server()->SnapNewItem(NETOBJTYPE_LASER, GetID(), sizeof(CNetObj_Laser)));
+	if (m_Layer == LAYER_SWITCH && !Tick)
+		Mask &= ~SwitchHiddenMask(true);
+
+	CNetObj_Laser *pObj = static_cast<CNetObj_Laser *>(GameWorld()->SnapNewSharedItem(NETOBJTYPE_LASER, GetID(), sizeof(CNetObj_Laser), Mask, m_Pos));
 
 	if (!pObj)
 		return;
@@ -24,7 +24,7 @@ public:
 
 	virtual void Reset();
 	virtual void Tick();
-	virtual void Snap(int SnappingClient);
+	virtual void PreSnap();
 };
 
 #endif // GAME_SERVER_ENTITIES_GUN_H
@@ -45,7 +45,7 @@ bool CLaser::HitCharacter(vec2 From, vec2 To)
 	if (!pHit || (pHit == pOwnerChar && g_Config.m_SvOldLaser) || (pHit != pOwnerChar && pOwnerChar ? (pOwnerChar->m_Hit & CCharacter::DISABLE_HIT_RIFLE && m_Type == WEAPON_LASER) || (pOwnerChar->m_Hit & CCharacter::DISABLE_HIT_SHOTGUN && m_Type == WEAPON_SHOTGUN) : !g_Config.m_SvHit))
 		return false;
 	m_From = From;
-	m_Pos = At;
+	SetPos(At);
 	m_Energy = -1;
 	if (m_Type == WEAPON_SHOTGUN)
 	{
@@ -98,7 +98,7 @@ void CLaser::DoBounce()
 	if (m_WasTele)
 	{
 		m_PrevPos = m_TelePos;
-		m_Pos = m_TelePos;
+		SetPos(m_TelePos);
 		m_TelePos = vec2(0, 0);
 	}
 
@@ -112,7 +112,7 @@ void CLaser::DoBounce()
 		{
 			// intersected
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 
 			vec2 TempPos = m_Pos;
 			vec2 TempDir = m_Dir * 4.0f;
@@ -128,7 +128,7 @@ void CLaser::DoBounce()
 			{
 				GameServer()->Collision()->SetCollisionAt(round_to_int(Coltile.x), round_to_int(Coltile.y), f);
 			}
-			m_Pos = TempPos;
+			SetPos(TempPos);
 			m_Dir = normalize(TempDir);
 
 			if (!m_TuneZone)
@@ -163,7 +163,7 @@ void CLaser::DoBounce()
 		if (!HitCharacter(m_Pos, To))
 		{
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 			m_Energy = -1;
 		}
 	}
@@ -263,28 +263,19 @@ void CLaser::TickPaused()
 	++m_EvalTick;
 }
 
-void CLaser::Snap(int SnappingClient)
+void CLaser::PreSnap()
 {
-	if (NetworkClipped(SnappingClient))
-		return;
-	CCharacter* OwnerChar = 0;
-	if (m_Owner >= 0)
-		OwnerChar = GameServer()->GetPlayerChar(m_Owner);
-	if (!OwnerChar)
-		return;
-
 	CCharacter* pOwnerChar = 0;
-	int64_t TeamMask = -1LL;
-
 	if (m_Owner >= 0)
 		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
+	if (!pOwnerChar)
+		return;
 
-	if (pOwnerChar && pOwnerChar->IsAlive())
+	int64_t TeamMask = -1LL;
+	if (pOwnerChar->IsAlive())
 		TeamMask = pOwnerChar->Teams()->TeamMask(pOwnerChar->Team(), -1, m_Owner);
 
-	if (!CmaskIsSet(TeamMask, SnappingClient))
-		return;
-	CNetObj_Laser* pObj = static_cast<CNetObj_Laser*>(Server()->SnapNewItem(NETOBJTYPE_LASER, GetID(), sizeof(CNetObj_Laser)));
+	CNetObj_Laser* pObj = static_cast<CNetObj_Laser*>(GameWorld()->SnapNewSharedItem(NETOBJTYPE_LASER, GetID(), sizeof(CNetObj_Laser), TeamMask, m_Pos));
 	if (!pObj)
 		return;
 
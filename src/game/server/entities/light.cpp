@@ -20,19 +20,20 @@ CLight::CLight(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	m_Length = Length;
 	m_EvalTick = Server()->Tick();
 	GameWorld()->InsertEntity(this);
+	SetSnapRange(m_Length);
 	Step();
 }
 
 bool CLight::HitCharacter()
 {
-	std::list<CCharacter *> HitCharacters =
-			GameServer()->m_World.IntersectedCharacters(m_Pos, m_To, 0.0f, 0);
-	if (HitCharacters.empty())
+	CCharacter *apHitCharacters[MAX_CLIENTS];
+	int Num = GameServer()->m_World.IntersectedCharacters(m_Pos, m_To, 0.0f,
+			apHitCharacters, MAX_CLIENTS, 0);
+	if (!Num)
 		return false;
-	for (std::list<CCharacter *>::iterator i = HitCharacters.begin();
-			i != HitCharacters.end(); i++)
+	for (int i = 0; i < Num; i++)
 	{
-		CCharacter * Char = *i;
+		CCharacter * Char = apHitCharacters[i];
 		if (m_Layer == LAYER_SWITCH
 				&& !GameServer()->Collision()->m_pSwitchers[m_Number].m_Status[Char->Team()])
 			continue;
@@ -95,7 +96,7 @@ void CLight::Tick()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 		Step();
 	}
 
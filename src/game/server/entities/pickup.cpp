@@ -147,26 +147,15 @@ void CPickup::TickPaused()
 		++m_SpawnTick;*/
 }
 
-void CPickup::Snap(int SnappingClient)
+void CPickup::PreSnap()
 {
-	/*if(m_SpawnTick != -1 || NetworkClipped(SnappingClient))
-		return;*/
-
-	CCharacter *Char = GameServer()->GetPlayerChar(SnappingClient);
-
-	if(SnappingClient > -1 && (GameServer()->m_apPlayers[SnappingClient]->GetTeam() == -1
-				|| GameServer()->m_apPlayers[SnappingClient]->IsPaused())
-			&& GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID() != -1)
-		Char = GameServer()->GetPlayerChar(GameServer()->m_apPlayers[SnappingClient]->GetSpectatorID());
-
+	int64_t Mask = -1LL;
 	int Tick = (Server()->Tick()%Server()->TickSpeed())%11;
-	if (Char && Char->IsAlive() &&
-			(m_Layer == LAYER_SWITCH &&
-					!GameServer()->Collision()->m_pSwitchers[m_Number].m_Status[Char->Team()])
-					&& (!Tick))
-		return;
+	if (m_Layer == LAYER_SWITCH && !Tick)
+		Mask &= ~SwitchHiddenMask(true);
 
-	CNetObj_Pickup *pP = static_cast<CNetObj_Pickup *>(Server()->SnapNewItem(NETOBJTYPE_PICKUP, GetID(), sizeof(CNetObj_Pickup)));
+	// pickups are sent regardless of the view position
+	CNetObj_Pickup *pP = static_cast<CNetObj_Pickup *>(GameWorld()->SnapNewSharedItem(NETOBJTYPE_PICKUP, GetID(), sizeof(CNetObj_Pickup), Mask, m_Pos, false));
 	if(!pP)
 		return;
 
@@ -185,6 +174,6 @@ void CPickup::Move()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 	}
 }
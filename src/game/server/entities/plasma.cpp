@@ -44,7 +44,7 @@ bool CPlasma::HitCharacter()
 
 void CPlasma::Move()
 {
-	m_Pos += m_Core;
+	SetPos(m_Pos + m_Core);
 	m_Core *= ACCEL;
 }
 
@@ -215,7 +215,7 @@ void CProjectile::Tick()
 		if (Collide && m_Bouncing != 0)
 		{
 			m_StartTick = Server()->Tick();
-			m_Pos = NewPos + (-(m_Direction * 4));
+			SetPos(NewPos + (-(m_Direction * 4)));
 			if (m_Bouncing == 1)
 				m_Direction.x = -m_Direction.x;
 			else if (m_Bouncing == 2)
@@ -224,7 +224,7 @@ void CProjectile::Tick()
 				m_Direction.x = 0;
 			if (fabs(m_Direction.y) < 1e-6)
 				m_Direction.y = 0;
-			m_Pos += m_Direction;
+			SetPos(m_Pos + m_Direction);
 		}
 		else if (m_Type == WEAPON_GUN)
 		{
@@ -272,7 +272,7 @@ void CProjectile::Tick()
 	if (z && ((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts[z - 1].size())
 	{
 		int Num = ((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts[z - 1].size();
-		m_Pos = ((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts[z - 1][(!Num) ? Num : rand() % Num];
+		SetPos(((CGameControllerDDrace*)GameServer()->m_pController)->m_TeleOuts[z - 1][(!Num) ? Num : rand() % Num]);
 		m_StartTick = Server()->Tick();
 	}
 }
@@ -292,31 +292,24 @@ void CProjectile::FillInfo(CNetObj_Projectile* pProj)
 	pProj->m_Type = m_Type;
 }
 
-void CProjectile::Snap(int SnappingClient)
+void CProjectile::PreSnap()
 {
 	float Ct = (Server()->Tick() - m_StartTick) / (float)Server()->TickSpeed();
 
-	if (NetworkClipped(SnappingClient, GetPos(Ct)))
-		return;
-
-	CCharacter* pSnapChar = GameServer()->GetPlayerChar(SnappingClient);
+	int64_t Mask = -1LL;
 	int Tick = (Server()->Tick() % Server()->TickSpeed()) % ((m_Explosive) ? 6 : 20);
-	if (pSnapChar && pSnapChar->IsAlive() && (m_Layer == LAYER_SWITCH && !GameServer()->Collision()->m_pSwitchers[m_Number].m_Status[pSnapChar->Team()] && (!Tick)))
-		return;
+	if (m_Layer == LAYER_SWITCH && !Tick)
+		Mask &= ~SwitchHiddenMask(false);
 
 	CCharacter* pOwnerChar = 0;
-	int64_t TeamMask = -1LL;
 
 	if (m_Owner >= 0)
 		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
 
 	if (pOwnerChar && pOwnerChar->IsAlive())
-		TeamMask = pOwnerChar->Teams()->TeamMask(pOwnerChar->Team(), -1, m_Owner);
-
-	if (m_Owner != -1 && !CmaskIsSet(TeamMask, SnappingClient))
-		return;
+		Mask &= pOwnerChar->Teams()->TeamMask(pOwnerChar->Team(), -1, m_Owner);
 
-	CNetObj_Projectile* pProj = static_cast<CNetObj_Projectile*>(Server()->SnapNewItem(NETOBJTYPE_PROJECTILE, GetID(), sizeof(CNetObj_Projectile)));
+	CNetObj_Projectile* pProj = static_cast<CNetObj_Projectile*>(GameWorld()->SnapNewSharedItem(NETOBJTYPE_PROJECTILE, GetID(), sizeof(CNetObj_Projectile), Mask, GetPos(Ct)));
 	if (!pProj)
 		return;
 
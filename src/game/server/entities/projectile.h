@@ -28,7 +28,7 @@ public:
 	virtual void Reset();
 	virtual void Tick();
 	virtual void TickPaused();
-	virtual void Snap(int SnappingClient);
+	virtual void PreSnap();
 
 private:
 	vec2 m_Direction;
@@ -1,6 +1,7 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 
+#include "entities/character.h"
 #include "entity.h"
 #include "gamecontext.h"
 #include "player.h"
@@ -27,6 +28,17 @@ CEntity::~CEntity()
 	Server()->SnapFreeID(m_ID);
 }
 
+void CEntity::SetPos(vec2 Pos)
+{
+	m_Pos = Pos;
+	GameWorld()->MoveEntity(this);
+}
+
+void CEntity::SetSnapRange(float Range)
+{
+	GameWorld()->ExtendSnapRange(m_ObjType, Range);
+}
+
 int CEntity::NetworkClipped(int SnappingClient)
 {
 	return NetworkClipped(SnappingClient, m_Pos);
@@ -34,18 +46,7 @@ int CEntity::NetworkClipped(int SnappingClient)
 
 int CEntity::NetworkClipped(int SnappingClient, vec2 CheckPos)
 {
-	if(SnappingClient == -1)
-		return 0;
-
-	float dx = GameServer()->m_apPlayers[SnappingClient]->m_ViewPos.x-CheckPos.x;
-	float dy = GameServer()->m_apPlayers[SnappingClient]->m_ViewPos.y-CheckPos.y;
-
-	if(absolute(dx) > 1000.0f || absolute(dy) > 800.0f)
-		return 1;
-
-	if(distance(GameServer()->m_apPlayers[SnappingClient]->m_ViewPos, CheckPos) > 4000.0f)
-		return 1;
-	return 0;
+	return GameWorld()->NetworkClipped(SnappingClient, CheckPos);
 }
 
 bool CEntity::GameLayerClipped(vec2 CheckPos)
@@ -94,3 +95,22 @@ bool CEntity::GetNearestAirPosPlayer(vec2 PlayerPos, vec2* OutPos)
 	}
 	return false;
 }
+
+int64_t CEntity::SwitchHiddenMask(bool FollowSpectator)
+{
+	int64_t Mask = 0;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		CPlayer *pPlayer = GameServer()->m_apPlayers[i];
+		if(!pPlayer)
+			continue;
+
+		CCharacter *pChr = pPlayer->GetCharacter();
+		if(FollowSpectator && (pPlayer->GetTeam() == TEAM_SPECTATORS || pPlayer->IsPaused()) && pPlayer->GetSpectatorID() != -1)
+			pChr = GameServer()->GetPlayerChar(pPlayer->GetSpectatorID());
+
+		if(pChr && pChr->IsAlive() && !GameServer()->Collision()->m_pSwitchers[m_Number].m_Status[pChr->Team()])
+			Mask |= CmaskOne(i);
+	}
+	return Mask;
+}
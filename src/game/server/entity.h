@@ -25,6 +25,7 @@ private:
 
 	CEntity *m_pPrevTypeEntity;
 	CEntity *m_pNextTypeEntity;
+	CEntityGrid::CNode m_GridNode;
 
 	int m_ID;
 	int m_ObjType;
@@ -43,7 +44,8 @@ protected:
 
 	/*
 		Variable: m_Pos
-			Contains the current posititon of the entity.
+			Contains the current posititon of the entity. Only change
+			it through SetPos, the world's entity grid depends on it.
 	*/
 	vec2 m_Pos;
 
@@ -71,6 +73,10 @@ public:
 
 	/* Setters */
 	void MarkForDestroy()				{ m_MarkedForDestroy = true; }
+	void SetPos(vec2 Pos);
+	// for entities that can be seen away from their position, like the
+	// end of a laser, up to this distance
+	void SetSnapRange(float Range);
 
 	/* Other functions */
 
@@ -106,6 +112,15 @@ public:
 	*/
 	virtual void TickPaused() {}
 
+	/*
+		Function: PreSnap
+			Called once per snapshot before any client is snapped.
+			Entities that look the same for every client add their
+			items to the world's shared item table here instead of
+			building them again in Snap().
+	*/
+	virtual void PreSnap() {}
+
 	/*
 		Function: Snap
 			Called when a new snapshot is being generated for a specific
@@ -145,6 +160,21 @@ public:
 	bool GetNearestAirPos(vec2 Pos, vec2 ColPos, vec2* pOutPos);
 	bool GetNearestAirPosPlayer(vec2 PlayerPos, vec2* OutPos);
 
+	/*
+		Function: SwitchHiddenMask
+			Finds the clients whose character is alive in a team for
+			which this entity's switch is inactive.
+
+		Arguments:
+			FollowSpectator - Use the spectated character for spectators
+				and paused players.
+
+		Returns:
+			Mask of the clients that should not see the entity while it
+			blinks.
+	*/
+	int64_t SwitchHiddenMask(bool FollowSpectator);
+
 	int m_Number;
 	int m_Layer;
 };
@@ -0,0 +1,144 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/math.h>
+#include <base/system.h>
+
+#include "entitygrid.h"
+
+CEntityGrid::CEntityGrid()
+{
+	m_ppCells = 0;
+	m_pNum = 0;
+	m_NumTypes = 0;
+	m_Width = 0;
+	m_Height = 0;
+}
+
+CEntityGrid::~CEntityGrid()
+{
+	delete[] m_ppCells;
+	delete[] m_pNum;
+}
+
+void CEntityGrid::Init(int NumTypes, float Width, float Height)
+{
+	delete[] m_ppCells;
+	delete[] m_pNum;
+
+	m_NumTypes = NumTypes;
+	m_Width = max(1, (int)(Width / CELL_SIZE) + 1);
+	m_Height = max(1, (int)(Height / CELL_SIZE) + 1);
+	m_ppCells = new CNode*[m_Width * m_Height * m_NumTypes];
+	mem_zero(m_ppCells, m_Width * m_Height * m_NumTypes * sizeof(CNode *));
+	m_pNum = new int[m_NumTypes];
+	mem_zero(m_pNum, m_NumTypes * sizeof(int));
+}
+
+int CEntityGrid::CellCoord(float Value, int NumCells) const
+{
+	// also catches nan
+	if(!(Value >= 0.0f))
+		return 0;
+	if(Value >= (float)NumCells * CELL_SIZE)
+		return NumCells - 1;
+	return (int)(Value / CELL_SIZE);
+}
+
+int CEntityGrid::CellIndex(vec2 Pos) const
+{
+	return CellCoord(Pos.y, m_Height) * m_Width + CellCoord(Pos.x, m_Width);
+}
+
+void CEntityGrid::Insert(CNode *pNode, void *pOwner, int Type, unsigned Serial, vec2 Pos)
+{
+	if(!IsInitialized() || pNode->InGrid())
+		return;
+
+	pNode->m_pOwner = pOwner;
+	pNode->m_Type = Type;
+	pNode->m_Serial = Serial;
+	pNode->m_Cell = CellIndex(Pos);
+
+	CNode **ppFirst = &m_ppCells[pNode->m_Cell * m_NumTypes + Type];
+	pNode->m_pPrev = 0;
+	pNode->m_pNext = *ppFirst;
+	if(*ppFirst)
+		(*ppFirst)->m_pPrev = pNode;
+	*ppFirst = pNode;
+	m_pNum[Type]++;
+}
+
+void CEntityGrid::Remove(CNode *pNode)
+{
+	if(!pNode->InGrid())
+		return;
+
+	if(pNode->m_pPrev)
+		pNode->m_pPrev->m_pNext = pNode->m_pNext;
+	else
+		m_ppCells[pNode->m_Cell * m_NumTypes + pNode->m_Type] = pNode->m_pNext;
+	if(pNode->m_pNext)
+		pNode->m_pNext->m_pPrev = pNode->m_pPrev;
+
+	pNode->m_pPrev = 0;
+	pNode->m_pNext = 0;
+	pNode->m_Cell = -1;
+	m_pNum[pNode->m_Type]--;
+}
+
+void CEntityGrid::Move(CNode *pNode, vec2 Pos)
+{
+	if(!pNode->InGrid() || pNode->m_Cell == CellIndex(Pos))
+		return;
+
+	Remove(pNode);
+	Insert(pNode, pNode->m_pOwner, pNode->m_Type, pNode->m_Serial, Pos);
+}
+
+int CEntityGrid::NumCells(vec2 Min, vec2 Max) const
+{
+	return (CellCoord(Max.x, m_Width) - CellCoord(Min.x, m_Width) + 1) * (CellCoord(Max.y, m_Height) - CellCoord(Min.y, m_Height) + 1);
+}
+
+int CEntityGrid::Query(int Type, vec2 Min, vec2 Max, CNode **ppNodes, int MaxNodes) const
+{
+	int MinX = CellCoord(Min.x, m_Width);
+	int MaxX = CellCoord(Max.x, m_Width);
+	int MinY = CellCoord(Min.y, m_Height);
+	int MaxY = CellCoord(Max.y, m_Height);
+
+	int Num = 0;
+	for(int y = MinY; y <= MaxY; y++)
+		for(int x = MinX; x <= MaxX; x++)
+			for(CNode *pNode = m_ppCells[(y * m_Width + x) * m_NumTypes + Type]; pNode; pNode = pNode->m_pNext)
+			{
+				if(Num == MaxNodes)
+					return -1;
+
+				// insertion sort by serial, the result sets are small
+				int i = Num++;
+				for(; i > 0 && ppNodes[i-1]->m_Serial < pNode->m_Serial; i--)
+					ppNodes[i] = ppNodes[i-1];
+				ppNodes[i] = pNode;
+			}
+	return Num;
+}
+
+int CEntityGrid::Collect(int Type, vec2 Min, vec2 Max, CNode **ppNodes, int MaxNodes) const
+{
+	int MinX = CellCoord(Min.x, m_Width);
+	int MaxX = CellCoord(Max.x, m_Width);
+	int MinY = CellCoord(Min.y, m_Height);
+	int MaxY = CellCoord(Max.y, m_Height);
+
+	int Num = 0;
+	for(int y = MinY; y <= MaxY; y++)
+		for(int x = MinX; x <= MaxX; x++)
+			for(CNode *pNode = m_ppCells[(y * m_Width + x) * m_NumTypes + Type]; pNode; pNode = pNode->m_pNext)
+			{
+				if(Num == MaxNodes)
+					return -1;
+				ppNodes[Num++] = pNode;
+			}
+	return Num;
+}
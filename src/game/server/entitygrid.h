@@ -0,0 +1,105 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_ENTITYGRID_H
+#define GAME_SERVER_ENTITYGRID_H
+
+#include <base/vmath.h>
+
+/*
+	Class: CEntityGrid
+		Uniform grid over the map that buckets entities by position and
+		type, so range queries only look at the cells they overlap.
+		Positions outside of the map go to the border cells.
+*/
+class CEntityGrid
+{
+public:
+	enum
+	{
+		CELL_SIZE=256,
+	};
+
+	// embedded into every entity, links it into its cell
+	class CNode
+	{
+		friend class CEntityGrid;
+
+		CNode *m_pPrev;
+		CNode *m_pNext;
+		int m_Cell;
+		int m_Type;
+		unsigned m_Serial;
+		void *m_pOwner;
+
+	public:
+		CNode() { m_pPrev = 0; m_pNext = 0; m_Cell = -1; m_Type = 0; m_Serial = 0; m_pOwner = 0; }
+		bool InGrid() const { return m_Cell >= 0; }
+		void *Owner() const { return m_pOwner; }
+	};
+
+	CEntityGrid();
+	~CEntityGrid();
+
+	/*
+		Function: Init
+			Allocates the cells, drops everything that was in the grid.
+
+		Parameters:
+			NumTypes - Number of entity types.
+			Width - Width of the covered area in pixels.
+			Height - Height of the covered area in pixels.
+	*/
+	void Init(int NumTypes, float Width, float Height);
+	bool IsInitialized() const { return m_ppCells != 0; }
+
+	/*
+		Function: Insert
+			Adds a node to the cell of a position.
+
+		Parameters:
+			pNode - Node to add.
+			pOwner - What queries return for the node.
+			Type - Entity type of the node.
+			Serial - Queries return nodes with higher serials first.
+			Pos - Position of the owner.
+	*/
+	void Insert(CNode *pNode, void *pOwner, int Type, unsigned Serial, vec2 Pos);
+	void Remove(CNode *pNode);
+	// moves the node to the cell of a new position, cheap if the cell stays the same
+	void Move(CNode *pNode, vec2 Pos);
+	bool InCell(const CNode *pNode, vec2 Pos) const { return pNode->m_Cell == CellIndex(Pos); }
+
+	/*
+		Function: Query
+			Collects all nodes of a type in the cells that overlap a box,
+			ordered by descending serial.
+
+		Returns:
+			Number of nodes written to ppNodes or -1 if there are more
+			than MaxNodes.
+	*/
+	int Query(int Type, vec2 Min, vec2 Max, CNode **ppNodes, int MaxNodes) const;
+
+	/*
+		Function: Collect
+			Like <Query>, but the nodes come in cell order instead of by
+			serial, for result sets too large to sort.
+	*/
+	int Collect(int Type, vec2 Min, vec2 Max, CNode **ppNodes, int MaxNodes) const;
+
+	// number of cells a query box touches, to tell whether a query beats a linear scan
+	int NumCells(vec2 Min, vec2 Max) const;
+	int Num(int Type) const { return m_pNum[Type]; }
+
+private:
+	int CellCoord(float Value, int NumCells) const;
+	int CellIndex(vec2 Pos) const;
+
+	CNode **m_ppCells;
+	int *m_pNum;
+	int m_NumTypes;
+	int m_Width;
+	int m_Height;
+};
+
+#endif
@@ -1,36 +1,103 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <math.h>
+
 #include <base/system.h>
 #include "eventhandler.h"
 #include "gamecontext.h"
 #include "player.h"
 
+static const float s_ViewDistance = 1500.0f;
+
 //////////////////////////////////////////////////
 // Event handler
 //////////////////////////////////////////////////
 CEventHandler::CEventHandler()
 {
 	m_pGameServer = 0;
+	m_EventsCapacity = MIN_EVENTS;
+	m_DataCapacity = MIN_EVENTS*64;
+	m_pEvents = new CEvent[m_EventsCapacity];
+	m_pData = new char[m_DataCapacity];
+	m_NumIndexed = 0;
+	m_NumDropped = 0;
+	m_NumSnapFailed = 0;
+	m_TotalDropped = 0;
+	m_TotalSnapFailed = 0;
+	for(int i = 0; i < NUM_BUCKETS; i++)
+	{
+		m_aBucketFirst[i] = -1;
+		m_aBucketLast[i] = -1;
+		m_aBucketMasks[i] = 0;
+	}
 	Clear();
 }
 
+CEventHandler::~CEventHandler()
+{
+	delete[] m_pEvents;
+	delete[] m_pData;
+}
+
 void CEventHandler::SetGameServer(CGameContext *pGameServer)
 {
 	m_pGameServer = pGameServer;
 }
 
+int CEventHandler::Bucket(int CellX, int CellY)
+{
+	// the buckets tile the map, neighbouring cells never share one
+	return ((CellY&15)<<4) | (CellX&15);
+}
+
+bool CEventHandler::Grow(int NumEvents, int DataSize)
+{
+	if(NumEvents > MAX_EVENTS || DataSize > MAX_DATASIZE)
+		return false;
+
+	if(NumEvents > m_EventsCapacity)
+	{
+		int Capacity = m_EventsCapacity;
+		while(Capacity < NumEvents)
+			Capacity *= 2;
+		CEvent *pEvents = new CEvent[Capacity];
+		mem_copy(pEvents, m_pEvents, m_NumEvents*sizeof(CEvent));
+		delete[] m_pEvents;
+		m_pEvents = pEvents;
+		m_EventsCapacity = Capacity;
+	}
+	if(DataSize > m_DataCapacity)
+	{
+		int Capacity = m_DataCapacity;
+		while(Capacity < DataSize)
+			Capacity *= 2;
+		char *pData = new char[Capacity];
+		mem_copy(pData, m_pData, m_CurrentOffset);
+		delete[] m_pData;
+		m_pData = pData;
+		m_DataCapacity = Capacity;
+	}
+	return true;
+}
+
 void* CEventHandler::Create(int Type, int Size, int64_t Mask)
 {
-	if(m_NumEvents == MAX_EVENTS)
-		return 0;
-	if(m_CurrentOffset+Size >= MAX_DATASIZE)
-		return 0;
+	if(m_NumEvents == m_EventsCapacity || m_CurrentOffset+Size > m_DataCapacity)
+	{
+		if(!Grow(m_NumEvents+1, m_CurrentOffset+Size))
+		{
+			m_NumDropped++;
+			return 0;
+		}
+	}
 
-	void *p = &m_aData[m_CurrentOffset];
-	m_aOffsets[m_NumEvents] = m_CurrentOffset;
-	m_aTypes[m_NumEvents] = Type;
-	m_aSizes[m_NumEvents] = Size;
-	m_aClientMasks[m_NumEvents] = Mask;
+	void *p = &m_pData[m_CurrentOffset];
+	CEvent *pEvent = &m_pEvents[m_NumEvents];
+	pEvent->m_Offset = m_CurrentOffset;
+	pEvent->m_Type = Type;
+	pEvent->m_Size = Size;
+	pEvent->m_ClientMask = Mask;
+	pEvent->m_Next = -1;
 	m_CurrentOffset += Size;
 	m_NumEvents++;
 	return p;
@@ -38,23 +105,138 @@ void* CEventHandler::Create(int Type, int Size, int64_t Mask)
 
 void CEventHandler::Clear()
 {
+	if(m_NumDropped || m_NumSnapFailed)
+	{
+		dbg_msg_level(LOG_LEVEL_WARN, "events", "dropped %d events, %d times an event didn't fit into a snapshot", m_NumDropped, m_NumSnapFailed);
+		m_TotalDropped += m_NumDropped;
+		m_TotalSnapFailed += m_NumSnapFailed;
+	}
+
+	if(m_NumIndexed)
+	{
+		for(int i = 0; i < NUM_BUCKETS; i++)
+		{
+			m_aBucketFirst[i] = -1;
+			m_aBucketLast[i] = -1;
+			m_aBucketMasks[i] = 0;
+		}
+	}
+
 	m_NumEvents = 0;
+	m_NumIndexed = 0;
 	m_CurrentOffset = 0;
+	m_NumDropped = 0;
+	m_NumSnapFailed = 0;
 }
 
-void CEventHandler::Snap(int SnappingClient)
+void CEventHandler::Index()
+{
+	// the positions are filled in after Create, so the events are bucketed lazily
+	for(; m_NumIndexed < m_NumEvents; m_NumIndexed++)
+	{
+		CEvent *pEvent = &m_pEvents[m_NumIndexed];
+		const CNetEvent_Common *pCommon = (const CNetEvent_Common *)&m_pData[pEvent->m_Offset];
+		int b = Bucket(pCommon->m_X>>CELL_SHIFT, pCommon->m_Y>>CELL_SHIFT);
+		if(m_aBucketLast[b] == -1)
+			m_aBucketFirst[b] = m_NumIndexed;
+		else
+			m_pEvents[m_aBucketLast[b]].m_Next = m_NumIndexed;
+		m_aBucketLast[b] = m_NumIndexed;
+		m_aBucketMasks[b] |= pEvent->m_ClientMask;
+	}
+}
+
+void CEventHandler::SnapEvent(int Index)
 {
+	const CEvent *pEvent = &m_pEvents[Index];
+	void *d = GameServer()->Server()->SnapNewItem(pEvent->m_Type, Index, pEvent->m_Size);
+	if(d)
+		mem_copy(d, &m_pData[pEvent->m_Offset], pEvent->m_Size);
+	else
+		m_NumSnapFailed++;
+}
+
+int CEventHandler::CollectLinear(int SnappingClient, vec2 ViewPos, int *pIndices)
+{
+	int Num = 0;
 	for(int i = 0; i < m_NumEvents; i++)
 	{
-		if(SnappingClient == -1 || CmaskIsSet(m_aClientMasks[i], SnappingClient))
+		if(CmaskIsSet(m_pEvents[i].m_ClientMask, SnappingClient))
+		{
+			CNetEvent_Common *ev = (CNetEvent_Common *)&m_pData[m_pEvents[i].m_Offset];
+			if(distance(ViewPos, vec2(ev->m_X, ev->m_Y)) < s_ViewDistance)
+				pIndices[Num++] = i;
+		}
+	}
+	return Num;
+}
+
+int CEventHandler::Collect(int SnappingClient, vec2 ViewPos, int *pIndices)
+{
+	const int MaxCells = 4*4;
+
+	if(m_NumEvents <= MaxCells)
+		return CollectLinear(SnappingClient, ViewPos, pIndices);
+
+	Index();
+
+	// the view distance covers at most 4x4 cells
+	int MinX = (int)floorf(ViewPos.x - s_ViewDistance)>>CELL_SHIFT;
+	int MaxX = (int)floorf(ViewPos.x + s_ViewDistance)>>CELL_SHIFT;
+	int MinY = (int)floorf(ViewPos.y - s_ViewDistance)>>CELL_SHIFT;
+	int MaxY = (int)floorf(ViewPos.y + s_ViewDistance)>>CELL_SHIFT;
+
+	int aNext[MaxCells];
+	int NumLists = 0;
+	for(int y = MinY; y <= MaxY; y++)
+	{
+		for(int x = MinX; x <= MaxX; x++)
 		{
-			CNetEvent_Common *ev = (CNetEvent_Common *)&m_aData[m_aOffsets[i]];
-			if(SnappingClient == -1 || distance(GameServer()->m_apPlayers[SnappingClient]->m_ViewPos, vec2(ev->m_X, ev->m_Y)) < 1500.0f)
-			{
-				void *d = GameServer()->Server()->SnapNewItem(m_aTypes[i], i, m_aSizes[i]);
-				if(d)
-					mem_copy(d, &m_aData[m_aOffsets[i]], m_aSizes[i]);
-			}
+			int b = Bucket(x, y);
+			if(m_aBucketFirst[b] != -1 && CmaskIsSet(m_aBucketMasks[b], SnappingClient))
+				aNext[NumLists++] = m_aBucketFirst[b];
 		}
 	}
+
+	// merge the buckets to keep the events in order of creation
+	int Num = 0;
+	while(NumLists)
+	{
+		int Min = 0;
+		for(int l = 1; l < NumLists; l++)
+		{
+			if(aNext[l] < aNext[Min])
+				Min = l;
+		}
+
+		int i = aNext[Min];
+		const CEvent *pEvent = &m_pEvents[i];
+		if(pEvent->m_Next == -1)
+			aNext[Min] = aNext[--NumLists];
+		else
+			aNext[Min] = pEvent->m_Next;
+
+		if(CmaskIsSet(pEvent->m_ClientMask, SnappingClient))
+		{
+			CNetEvent_Common *ev = (CNetEvent_Common *)&m_pData[pEvent->m_Offset];
+			if(distance(ViewPos, vec2(ev->m_X, ev->m_Y)) < s_ViewDistance)
+				pIndices[Num++] = i;
+		}
+	}
+	return Num;
+}
+
+void CEventHandler::Snap(int SnappingClient)
+{
+	if(SnappingClient == -1)
+	{
+		for(int i = 0; i < m_NumEvents; i++)
+			SnapEvent(i);
+		return;
+	}
+
+	int aIndices[MAX_EVENTS];
+	int Num = Collect(SnappingClient, GameServer()->m_apPlayers[SnappingClient]->m_ViewPos, aIndices);
+	for(int i = 0; i < Num; i++)
+		SnapEvent(aIndices[i]);
 }
@@ -5,30 +5,109 @@
 
 #include <stdint.h>
 
-//
+#include <base/vmath.h>
+
+/*
+	Class: CEventHandler
+		Collects the events of a tick and snaps them to the clients.
+		The events are bucketed by position and client mask when the first
+		snapshot of the tick is built, so every client only looks at the
+		events around its view.
+*/
 class CEventHandler
 {
-	static const int MAX_EVENTS = 128;
-	static const int MAX_DATASIZE = 128*64;
+	enum
+	{
+		// the snapshot can't hold more items anyway
+		MAX_EVENTS=1024,
+		MAX_DATASIZE=MAX_EVENTS*64,
+		MIN_EVENTS=128,
+
+		CELL_SHIFT=10,
+		NUM_BUCKETS=256,
+	};
+
+	struct CEvent
+	{
+		int m_Type;
+		int m_Offset;
+		int m_Size;
+		int64_t m_ClientMask;
+		int m_Next; // next event in the same bucket, in order of creation
+	};
+
+	CEvent *m_pEvents;
+	char *m_pData;
+	int m_EventsCapacity;
+	int m_DataCapacity;
 
-	int m_aTypes[MAX_EVENTS]; // TODO: remove some of these arrays
-	int m_aOffsets[MAX_EVENTS];
-	int m_aSizes[MAX_EVENTS];
-	int64_t m_aClientMasks[MAX_EVENTS];
-	char m_aData[MAX_DATASIZE];
+	int m_aBucketFirst[NUM_BUCKETS];
+	int m_aBucketLast[NUM_BUCKETS];
+	int64_t m_aBucketMasks[NUM_BUCKETS];
+	int m_NumIndexed;
 
 	class CGameContext *m_pGameServer;
 
 	int m_CurrentOffset;
 	int m_NumEvents;
+
+	int m_NumDropped;
+	int m_NumSnapFailed;
+	int m_TotalDropped;
+	int m_TotalSnapFailed;
+
+	static int Bucket(int CellX, int CellY);
+	bool Grow(int NumEvents, int DataSize);
+	void Index();
+	void SnapEvent(int Index);
+
 public:
 	CGameContext *GameServer() const { return m_pGameServer; }
 	void SetGameServer(CGameContext *pGameServer);
 
 	CEventHandler();
+	~CEventHandler();
+
+	/*
+		Function: Create
+			Adds an event to the current tick. The position of the event
+			must be filled in before the next snapshot.
+
+		Returns:
+			Memory for the event data, 0 if the tick already holds too
+			many events. The memory is valid until the next call.
+	*/
 	void* Create(int Type, int Size, int64_t Mask = -1LL);
 	void Clear();
 	void Snap(int SnappingClient);
+
+	/*
+		Function: Collect
+			Finds the events a client sees from a view position, through
+			the buckets once there are more than a few events.
+
+		Parameters:
+			SnappingClient - Client the events are for.
+			ViewPos - Where the client looks at.
+			pIndices - Receives the indices of the events in order of
+				creation, must hold <NumEvents> entries.
+
+		Returns:
+			The number of events found.
+	*/
+	int Collect(int SnappingClient, vec2 ViewPos, int *pIndices);
+
+	/*
+		Function: CollectLinear
+			Same as <Collect>, but always looks at every event.
+	*/
+	int CollectLinear(int SnappingClient, vec2 ViewPos, int *pIndices);
+
+	int NumEvents() const { return m_NumEvents; }
+
+	// events that didn't fit into the pool or into a snapshot since the start
+	int TotalDropped() const { return m_TotalDropped; }
+	int TotalSnapFailed() const { return m_TotalSnapFailed; }
 };
 
 #endif
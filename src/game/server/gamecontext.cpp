@@ -6,6 +6,7 @@
 #include <engine/shared/memheap.h>
 #include <engine/shared/datafile.h>
 #include <engine/shared/linereader.h>
+#include <engine/shared/tickprofiler.h>
 #include <engine/storage.h>
 #include <engine/map.h>
 
@@ -103,7 +104,7 @@ void CGameContext::Clear()
 void CGameContext::TeeHistorianWrite(const void *pData, int DataSize, void *pUser)
 {
 	CGameContext *pSelf = (CGameContext *)pUser;
-	io_write(pSelf->m_TeeHistorianFile, pData, DataSize);
+	pSelf->m_TeeHistorianWriter.Write(pData, DataSize);
 }
 
 void CGameContext::CommandCallback(int ClientID, int FlagMask, const char *pCmd, IConsole::IResult *pResult, void *pUser)
@@ -249,11 +250,19 @@ void CGameContext::SendChatTarget(int To, const char *pText)
 	Server()->SendPackMsg(&Msg, MSGFLAG_VITAL, To);
 }
 
+void CGameContext::SendChatMask(int64_t Mask, const char *pText)
+{
+	CNetMsg_Sv_Chat Msg;
+	Msg.m_Mode = CHAT_ALL;
+	Msg.m_ClientID = -1;
+	Msg.m_pMessage = pText;
+	Msg.m_TargetID = -1;
+	Server()->SendPackMsgMask(&Msg, MSGFLAG_VITAL, Mask);
+}
+
 void CGameContext::SendChatTeam(int Team, const char *pText)
 {
-	for(int i = 0; i<MAX_CLIENTS; i++)
-		if(((CGameControllerDDrace*)m_pController)->m_Teams.m_Core.Team(i) == Team)
-			SendChatTarget(i, pText);
+	SendChatMask(((CGameControllerDDrace*)m_pController)->m_Teams.Members(Team), pText);
 }
 
 void CGameContext::SendChat(int ChatterClientID, int Mode, int To, const char *pText)
@@ -290,24 +299,24 @@ void CGameContext::SendChat(int ChatterClientID, int Mode, int To, const char *p
 	else if(Mode == CHAT_TEAM)
 	{
 		CTeamsCore* Teams = &((CGameControllerDDrace*)m_pController)->m_Teams.m_Core;
-		// pack one for the recording only
-		Server()->SendPackMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_NOSEND, -1);
 
-		// send to the clients
+		// collect the clients, the message is packed and recorded once
+		int64_t Mask = 0;
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
 			if(m_apPlayers[i] != 0) {
 				if(m_apPlayers[ChatterClientID]->GetTeam() == TEAM_SPECTATORS) {
 					if(m_apPlayers[i]->GetTeam() == TEAM_SPECTATORS) {
-						Server()->SendPackMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_NORECORD, i);
+						Mask |= CmaskOne(i);
 					}
 				} else {
 					if(Teams->Team(i) == GetDDRaceTeam(ChatterClientID) && m_apPlayers[i]->GetTeam() != TEAM_SPECTATORS) {
-						Server()->SendPackMsg(&Msg, MSGFLAG_VITAL|MSGFLAG_NORECORD, i);
+						Mask |= CmaskOne(i);
 					}
 				}
 			}
 		}
+		Server()->SendPackMsgMask(&Msg, MSGFLAG_VITAL, Mask);
 	}
 	else // Mode == CHAT_WHISPER
 	{
@@ -559,14 +568,16 @@ void CGameContext::OnTick()
 
 	if(m_TeeHistorianActive)
 	{
+		Server()->TickProfiler()->Begin(CTickProfiler::PHASE_RECORD);
 		if(!m_TeeHistorian.Starting())
 		{
 			m_TeeHistorian.EndInputs();
 			m_TeeHistorian.EndTick();
 		}
-		io_flush(m_TeeHistorianFile);
+		m_TeeHistorianWriter.Flush();
 		m_TeeHistorian.BeginTick(Server()->Tick());
 		m_TeeHistorian.BeginPlayers();
+		Server()->TickProfiler()->End(CTickProfiler::PHASE_RECORD);
 	}
 
 	// copy tuning
@@ -578,6 +589,7 @@ void CGameContext::OnTick()
 
 	if(m_TeeHistorianActive)
 	{
+		Server()->TickProfiler()->Begin(CTickProfiler::PHASE_RECORD);
 		for(int i = 0; i < MAX_CLIENTS; i++)
 		{
 			if(m_apPlayers[i] && m_apPlayers[i]->GetCharacter())
@@ -592,8 +604,9 @@ void CGameContext::OnTick()
 			}
 		}
 		m_TeeHistorian.EndPlayers();
-		io_flush(m_TeeHistorianFile);
+		m_TeeHistorianWriter.Flush();
 		m_TeeHistorian.BeginInputs();
+		Server()->TickProfiler()->End(CTickProfiler::PHASE_RECORD);
 	}
 
 	for(int i = 0; i < MAX_CLIENTS; i++)
@@ -799,6 +812,7 @@ void CGameContext::OnClientEnter(int ClientID)
 	}
 
 
+	int64_t OthersMask = 0;
 	for(int i = 0; i < MAX_CLIENTS; ++i)
 	{
 		if(i == ClientID || !m_apPlayers[i] || (!Server()->ClientIngame(i) && !m_apPlayers[i]->IsDummy()))
@@ -806,7 +820,7 @@ void CGameContext::OnClientEnter(int ClientID)
 
 		// new info for others
 		if(Server()->ClientIngame(i))
-			Server()->SendPackMsg(&NewClientInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, i);
+			OthersMask |= CmaskOne(i);
 
 		// existing infos for new player
 		CNetMsg_Sv_ClientInfo ClientInfoMsg;
@@ -825,6 +839,7 @@ void CGameContext::OnClientEnter(int ClientID)
 		}
 		Server()->SendPackMsg(&ClientInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, ClientID);
 	}
+	Server()->SendPackMsgMask(&NewClientInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, OthersMask);
 
 	// local info
 	NewClientInfoMsg.m_Local = 1;
@@ -867,6 +882,8 @@ void CGameContext::OnClientConnected(int ClientID, bool Dummy, bool AsSpec)
 	}
 
 	m_apPlayers[ClientID] = new(ClientID) CPlayer(this, ClientID, Dummy, AsSpec);
+	OnViewChange();
+	Server()->ExpireServerInfo();
 
 	if(Dummy)
 		return;
@@ -916,6 +933,8 @@ void CGameContext::OnClientDrop(int ClientID, const char *pReason)
 
 	delete m_apPlayers[ClientID];
 	m_apPlayers[ClientID] = 0;
+	OnViewChange();
+	Server()->ExpireServerInfo();
 
 	m_VoteUpdate = true;
 }
@@ -1597,6 +1616,24 @@ void CGameContext::ConSwitchOpen(IConsole::IResult* pResult, void* pUserData)
 	}
 }
 
+void CGameContext::ConEventStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *)pUserData;
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "dropped=%d snap_failed=%d", pSelf->m_Events.TotalDropped(), pSelf->m_Events.TotalSnapFailed());
+	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "events", aBuf);
+}
+
+void CGameContext::ConTeeHistorianStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *)pUserData;
+	const CAsyncWriter *pWriter = &pSelf->m_TeeHistorianWriter;
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "recording=%d backlog=%d peak_backlog=%d stalled=%lld bytes",
+		pWriter->IsOpen(), pWriter->Backlog(), pWriter->PeakBacklog(), pWriter->StalledBytes());
+	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "teehistorian", aBuf);
+}
+
 void CGameContext::ConPause(IConsole::IResult *pResult, void *pUserData)
 {
 	CGameContext *pSelf = (CGameContext *)pUserData;
@@ -1876,6 +1913,8 @@ void CGameContext::OnConsoleInit()
 	Console()->Register("tune_zone_enter", "i[zone] s[message]", CFGFLAG_SERVER|CFGFLAG_GAME, ConTuneSetZoneMsgEnter, this, "which message to display on zone enter; use 0 for normal area");
 	Console()->Register("tune_zone_leave", "i[zone] s[message]", CFGFLAG_SERVER|CFGFLAG_GAME, ConTuneSetZoneMsgLeave, this, "which message to display on zone leave; use 0 for normal area");
 	Console()->Register("switch_open", "i[switch]", CFGFLAG_SERVER|CFGFLAG_GAME, ConSwitchOpen, this, "Whether a switch is deactivated by default (otherwise activated)");
+	Console()->Register("event_stats", "", CFGFLAG_SERVER, ConEventStats, this, "Show how many events were dropped since the server started");
+	Console()->Register("teehistorian_stats", "", CFGFLAG_SERVER, ConTeeHistorianStats, this, "Show how far the teehistorian writer is behind");
 
 	Console()->Register("pausegame", "?i[on/off]", CFGFLAG_SERVER|CFGFLAG_STORE, ConPause, this, "Pause/unpause game");
 	Console()->Register("change_map", "?r[map]", CFGFLAG_SERVER|CFGFLAG_STORE, ConChangeMap, this, "Change map");
@@ -1910,6 +1949,7 @@ void CGameContext::OnInit()
 
 	m_Layers.Init(Kernel());
 	m_Collision.Init(&m_Layers);
+	m_World.InitGrid(m_Collision.GetWidth()*32.0f, m_Collision.GetHeight()*32.0f);
 
 	// Reset Tunezones
 	CTuningParams TuningParams;
@@ -1964,11 +2004,11 @@ void CGameContext::OnInit()
 		char aGameUuid[UUID_MAXSTRSIZE];
 		FormatUuid(m_GameUuid, aGameUuid, sizeof(aGameUuid));
 
-		char aFilename[64];
-		str_format(aFilename, sizeof(aFilename), "teehistorian/%s.teehistorian", aGameUuid);
+		char aFilename[128];
+		str_format(aFilename, sizeof(aFilename), "teehistorian/%s.teehistorian%s", aGameUuid, g_Config.m_SvTeeHistorianCompress ? ".gz" : "");
 
-		m_TeeHistorianFile = Kernel()->RequestInterface<IStorage>()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
-		if(!m_TeeHistorianFile)
+		IOHANDLE File = Kernel()->RequestInterface<IStorage>()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+		if(!File)
 		{
 			dbg_msg("teehistorian", "failed to open '%s'", aFilename);
 			exit(1);
@@ -1977,6 +2017,8 @@ void CGameContext::OnInit()
 		{
 			dbg_msg("teehistorian", "recording to '%s'", aFilename);
 		}
+		m_TeeHistorianWriter.Open(File, TEEHISTORIAN_BUFFER_SIZE, g_Config.m_SvTeeHistorianFlushInterval,
+			g_Config.m_SvTeeHistorianCompress ? CAsyncWriter::FLAG_COMPRESS : 0);
 
 		char aVersion[128];
 		if(GIT_SHORTREV_HASH)
@@ -2014,7 +2056,7 @@ void CGameContext::OnInit()
 				m_TeeHistorian.RecordAuthInitial(i, Level, Server()->AuthName(i));
 			}
 		}
-		io_flush(m_TeeHistorianFile);
+		m_TeeHistorianWriter.Flush();
 	}
 
 	if (g_Config.m_SvSoloServer)
@@ -2308,7 +2350,10 @@ void CGameContext::OnShutdown(bool FullShutdown)
 	if(m_TeeHistorianActive)
 	{
 		m_TeeHistorian.Finish();
-		io_close(m_TeeHistorianFile);
+		m_TeeHistorianWriter.Close();
+		if(m_TeeHistorianWriter.StalledBytes())
+			dbg_msg("teehistorian", "disk could not keep up, %lld bytes had to wait for buffer space (peak backlog %d bytes)",
+				m_TeeHistorianWriter.StalledBytes(), m_TeeHistorianWriter.PeakBacklog());
 	}
 
 	DeleteTempfile();
@@ -2378,7 +2423,10 @@ void CGameContext::OnSnap(int ClientID)
 			m_apPlayers[i]->Snap(ClientID);
 	}
 }
-void CGameContext::OnPreSnap() {}
+void CGameContext::OnPreSnap()
+{
+	m_World.PreSnap();
+}
 void CGameContext::OnPostSnap()
 {
 	m_World.PostSnap();
@@ -2522,6 +2570,12 @@ int CGameContext::GetDDRaceTeam(int ClientID)
 	return pController->m_Teams.m_Core.Team(ClientID);
 }
 
+void CGameContext::OnViewChange()
+{
+	CGameControllerDDrace* pController = (CGameControllerDDrace*)m_pController;
+	pController->m_Teams.OnViewChange();
+}
+
 void CGameContext::ResetTuning()
 {
 	CTuningParams TuningParams;
@@ -5,6 +5,7 @@
 
 #include <engine/console.h>
 #include <engine/server.h>
+#include <engine/shared/asyncwriter.h>
 
 #include <game/layers.h>
 #include <game/voting.h>
@@ -60,9 +61,14 @@ class CGameContext : public IGameServer
 	CTuningParams m_Tuning;
 	CTuningParams m_aTuningList[NUM_TUNEZONES];
 
+	enum
+	{
+		TEEHISTORIAN_BUFFER_SIZE = 1024*1024
+	};
+
 	bool m_TeeHistorianActive;
 	CTeeHistorian m_TeeHistorian;
-	IOHANDLE m_TeeHistorianFile;
+	CAsyncWriter m_TeeHistorianWriter;
 	CUuid m_GameUuid;
 
 	static void CommandCallback(int ClientID, int FlagMask, const char *pCmd, IConsole::IResult *pResult, void *pUser);
@@ -78,6 +84,8 @@ class CGameContext : public IGameServer
 	static void ConTuneSetZoneMsgEnter(IConsole::IResult* pResult, void* pUserData);
 	static void ConTuneSetZoneMsgLeave(IConsole::IResult* pResult, void* pUserData);
 	static void ConSwitchOpen(IConsole::IResult* pResult, void* pUserData);
+	static void ConEventStats(IConsole::IResult *pResult, void *pUserData);
+	static void ConTeeHistorianStats(IConsole::IResult *pResult, void *pUserData);
 	static void ConPause(IConsole::IResult* pResult, void* pUserData);	static void ConChangeMap(IConsole::IResult *pResult, void *pUserData);
 	static void ConRestart(IConsole::IResult *pResult, void *pUserData);
 	static void ConSay(IConsole::IResult *pResult, void *pUserData);
@@ -172,6 +180,7 @@ public:
 
 	// network
 	void SendChatTarget(int To, const char* pText);
+	void SendChatMask(int64_t Mask, const char *pText);
 	void SendChatTeam(int Team, const char* pText);
 	void SendChat(int ChatterClientID, int Mode, int To, const char *pText);
 	void SendBroadcast(const char *pText, int ClientID);
@@ -231,6 +240,8 @@ public:
 
 	int ProcessSpamProtection(int ClientID);
 	int GetDDRaceTeam(int ClientID);
+	// see CGameTeams::OnViewChange
+	void OnViewChange();
 	int64 m_NonEmptySince;
 	int64 m_LastMapVote;
 	void ForceVote(int EnforcerID, bool Success);
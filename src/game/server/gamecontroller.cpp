@@ -465,13 +465,11 @@ void IGameController::UpdateGameInfo(int ClientID)
 
 	if(ClientID == -1)
 	{
+		int64_t Mask = 0;
 		for(int i = 0; i < MAX_CLIENTS; ++i)
-		{
-			if(!GameServer()->m_apPlayers[i] || !Server()->ClientIngame(i))
-				continue;
-
-			Server()->SendPackMsg(&GameInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, i);
-		}
+			if(GameServer()->m_apPlayers[i])
+				Mask |= CmaskOne(i);
+		Server()->SendPackMsgMask(&GameInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, Mask);
 	}
 	else
 		Server()->SendPackMsg(&GameInfoMsg, MSGFLAG_VITAL|MSGFLAG_NORECORD, ClientID);
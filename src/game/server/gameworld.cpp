@@ -1,10 +1,14 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 
+#include <base/tl/threading.h>
+#include <engine/shared/config.h>
+
 #include "entities/character.h"
 #include "entity.h"
 #include "gamecontext.h"
 #include "gamecontroller.h"
+#include "gamemodes/ddrace.h"
 #include "gameworld.h"
 #include "player.h"
 
@@ -20,7 +24,16 @@ CGameWorld::CGameWorld()
 	m_Paused = false;
 	m_ResetRequested = false;
 	for(int i = 0; i < NUM_ENTTYPES; i++)
+	{
 		m_apFirstEntityTypes[i] = 0;
+		m_aMaxProximityRadius[i] = 0.0f;
+		m_aMaxSnapRange[i] = 0.0f;
+	}
+	m_NextSerial = 0;
+	m_NumQueryNodes = -1;
+	m_QueryIndex = 0;
+
+	m_CoresPrepared = false;
 }
 
 CGameWorld::~CGameWorld()
@@ -35,6 +48,16 @@ void CGameWorld::SetGameServer(CGameContext *pGameServer)
 {
 	m_pGameServer = pGameServer;
 	m_pServer = m_pGameServer->Server();
+
+	if(g_Config.m_SvCoreThreads)
+		m_CoreJobPool.Init(g_Config.m_SvCoreThreads);
+}
+
+void CGameWorld::InitGrid(float Width, float Height)
+{
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+		dbg_assert(m_apFirstEntityTypes[i] == 0, "entity grid initialized after entities were inserted");
+	m_Grid.Init(NUM_ENTTYPES, Width, Height);
 }
 
 CEntity *CGameWorld::FindFirst(int Type)
@@ -42,13 +65,41 @@ CEntity *CGameWorld::FindFirst(int Type)
 	return Type < 0 || Type >= NUM_ENTTYPES ? 0 : m_apFirstEntityTypes[Type];
 }
 
+CEntity *CGameWorld::QueryFirst(int Type, vec2 Min, vec2 Max)
+{
+	// grow the box by the largest entity of the type and a pixel against rounding
+	float Margin = m_aMaxProximityRadius[Type] + 1.0f;
+	Min -= vec2(Margin, Margin);
+	Max += vec2(Margin, Margin);
+
+	m_NumQueryNodes = -1;
+	if(m_Grid.IsInitialized() && m_Grid.NumCells(Min, Max) < m_Grid.Num(Type))
+		m_NumQueryNodes = m_Grid.Query(Type, Min, Max, m_apQueryNodes, MAX_QUERY_ENTITIES);
+	if(m_NumQueryNodes < 0)
+		return m_apFirstEntityTypes[Type];
+
+	// the grid returns the newest entities first, just like the type lists
+	m_QueryIndex = 0;
+	return QueryNext(0);
+}
+
+CEntity *CGameWorld::QueryNext(CEntity *pEnt)
+{
+	if(m_NumQueryNodes < 0)
+		return pEnt->m_pNextTypeEntity;
+	if(m_QueryIndex == m_NumQueryNodes)
+		return 0;
+	return (CEntity *)m_apQueryNodes[m_QueryIndex++]->Owner();
+}
+
 int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, int Type)
 {
 	if(Type < 0 || Type >= NUM_ENTTYPES)
 		return 0;
 
 	int Num = 0;
-	for(CEntity *pEnt = m_apFirstEntityTypes[Type];	pEnt; pEnt = pEnt->m_pNextTypeEntity)
+	vec2 Range = vec2(Radius, Radius);
+	for(CEntity *pEnt = QueryFirst(Type, Pos - Range, Pos + Range); pEnt; pEnt = QueryNext(pEnt))
 	{
 		if(distance(pEnt->m_Pos, Pos) < Radius+pEnt->m_ProximityRadius)
 		{
@@ -76,6 +127,15 @@ void CGameWorld::InsertEntity(CEntity *pEnt)
 	pEnt->m_pNextTypeEntity = m_apFirstEntityTypes[pEnt->m_ObjType];
 	pEnt->m_pPrevTypeEntity = 0x0;
 	m_apFirstEntityTypes[pEnt->m_ObjType] = pEnt;
+
+	if(pEnt->m_ProximityRadius > m_aMaxProximityRadius[pEnt->m_ObjType])
+		m_aMaxProximityRadius[pEnt->m_ObjType] = pEnt->m_ProximityRadius;
+	m_Grid.Insert(&pEnt->m_GridNode, pEnt, pEnt->m_ObjType, m_NextSerial++, pEnt->m_Pos);
+}
+
+void CGameWorld::MoveEntity(CEntity *pEnt)
+{
+	m_Grid.Move(&pEnt->m_GridNode, pEnt->m_Pos);
 }
 
 void CGameWorld::DestroyEntity(CEntity *pEnt)
@@ -103,18 +163,98 @@ void CGameWorld::RemoveEntity(CEntity *pEnt)
 
 	pEnt->m_pNextTypeEntity = 0;
 	pEnt->m_pPrevTypeEntity = 0;
+	m_Grid.Remove(&pEnt->m_GridNode);
+}
+
+void CGameWorld::PreSnap()
+{
+	m_SharedSnapItems.Clear();
+
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
+		{
+			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
+			pEnt->PreSnap();
+			pEnt = m_pNextTraverseEntity;
+		}
+
+	if(m_SharedSnapItems.NumDropped())
+		dbg_msg_level(LOG_LEVEL_WARN, "snap", "dropped %d shared items, the table is full with %d", m_SharedSnapItems.NumDropped(), m_SharedSnapItems.NumItems());
+}
+
+void *CGameWorld::SnapNewSharedItem(int Type, int ID, int Size, int64_t Mask, vec2 ClipPos, bool Clip)
+{
+	return m_SharedSnapItems.New(Type, ID, Size, Mask, ClipPos, Clip);
+}
+
+int CGameWorld::NetworkClipped(int SnappingClient, vec2 CheckPos)
+{
+	if(SnappingClient == -1)
+		return 0;
+
+	return CSharedSnapItems::Clipped(GameServer()->m_apPlayers[SnappingClient]->m_ViewPos, CheckPos);
+}
+
+void CGameWorld::ExtendSnapRange(int Type, float Range)
+{
+	if(Range > m_aMaxSnapRange[Type])
+		m_aMaxSnapRange[Type] = Range;
+}
+
+void CGameWorld::SnapSharedItem(int Index)
+{
+	const CSharedSnapItems::CItem *pItem = m_SharedSnapItems.Item(Index);
+	void *pData = Server()->SnapNewItem(pItem->m_Type, pItem->m_ID, pItem->m_Size);
+	if(pData)
+		mem_copy(pData, m_SharedSnapItems.ItemData(Index), pItem->m_Size);
 }
 
 //
 void CGameWorld::Snap(int SnappingClient)
 {
+	// the demo snapshot gets everything, clients only what they can see
+	if(SnappingClient == -1)
+	{
+		for(int i = 0; i < m_SharedSnapItems.NumItems(); i++)
+			SnapSharedItem(i);
+	}
+	else
+	{
+		int Num;
+		const int *pIndices = m_SharedSnapItems.Collect(SnappingClient, GameServer()->m_apPlayers[SnappingClient]->m_ViewPos, &Num);
+		for(int i = 0; i < Num; i++)
+			SnapSharedItem(pIndices[i]);
+	}
+
 	for(int i = 0; i < NUM_ENTTYPES; i++)
+	{
+		// the entities clip themselves, the grid only skips the ones
+		// that are out of view for sure. the box is the one of
+		// NetworkClipped, grown by the snap range and a pixel
+		int Num = -1;
+		if(g_Config.m_SvSnapViewIndex && SnappingClient != -1 && m_Grid.IsInitialized() &&
+			!(i == ENTTYPE_CHARACTER && GameServer()->m_apPlayers[SnappingClient]->m_ShowAll))
+		{
+			vec2 ViewPos = GameServer()->m_apPlayers[SnappingClient]->m_ViewPos;
+			vec2 Range = vec2(1000.0f, 800.0f) + vec2(m_aMaxSnapRange[i] + 1.0f, m_aMaxSnapRange[i] + 1.0f);
+			if(m_Grid.NumCells(ViewPos - Range, ViewPos + Range) < m_Grid.Num(i))
+				Num = m_Grid.Collect(i, ViewPos - Range, ViewPos + Range, m_apSnapNodes, MAX_SNAP_ENTITIES);
+		}
+
+		if(Num >= 0)
+		{
+			for(int j = 0; j < Num; j++)
+				((CEntity *)m_apSnapNodes[j]->Owner())->Snap(SnappingClient);
+			continue;
+		}
+
 		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
 		{
 			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
 			pEnt->Snap(SnappingClient);
 			pEnt = m_pNextTraverseEntity;
 		}
+	}
 }
 
 void CGameWorld::PostSnap()
@@ -168,12 +308,20 @@ void CGameWorld::Tick()
 	{
 		// update all objects
 		for(int i = 0; i < NUM_ENTTYPES; i++)
+		{
+			if(i == ENTTYPE_CHARACTER && m_CoreJobPool.NumThreads())
+				PrepareCores();
 			for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
 			{
 				m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
 				pEnt->Tick();
 				pEnt = m_pNextTraverseEntity;
 			}
+		}
+		m_CoresPrepared = false;
+
+		if(m_CoreJobPool.NumThreads())
+			AdvanceReckoning();
 
 		for(int i = 0; i < NUM_ENTTYPES; i++)
 			for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
@@ -197,6 +345,13 @@ void CGameWorld::Tick()
 
 	RemoveEntities();
 
+#ifdef CONF_DEBUG
+	// an entity that changed m_Pos without SetPos would be missed by the queries
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			dbg_assert(!m_Grid.IsInitialized() || m_Grid.InCell(&pEnt->m_GridNode, pEnt->m_Pos), "entity moved without updating the grid");
+#endif
+
 	int StrongWeakID = 0;
 	for (CCharacter* pChar = (CCharacter*)FindFirst(ENTTYPE_CHARACTER); pChar; pChar = (CCharacter*)pChar->TypeNext())
 	{
@@ -205,6 +360,91 @@ void CGameWorld::Tick()
 	}
 }
 
+void CGameWorld::RunCoreJobs(JOBFUNC pfnFunc)
+{
+	int NumCharacters = 0;
+	for(CEntity *pEnt = m_apFirstEntityTypes[ENTTYPE_CHARACTER]; pEnt && NumCharacters < MAX_CLIENTS; pEnt = pEnt->m_pNextTypeEntity)
+		m_apCoreCharacters[NumCharacters++] = (CCharacter *)pEnt;
+
+	// one slice per worker and one for the main thread
+	int NumSlices = min(m_CoreJobPool.NumThreads() + 1, NumCharacters);
+	int Start = 0;
+	for(int i = 0; i < NumSlices; i++)
+	{
+		int End = (NumCharacters * (i + 1)) / NumSlices;
+		m_aCoreJobs[i].m_ppCharacters = &m_apCoreCharacters[Start];
+		m_aCoreJobs[i].m_NumCharacters = End - Start;
+		if(i > 0)
+			m_CoreJobPool.Add(&m_aCoreJobs[i].m_Job, pfnFunc, &m_aCoreJobs[i]);
+		Start = End;
+	}
+	if(NumSlices > 0)
+		pfnFunc(&m_aCoreJobs[0]);
+
+	for(int i = 1; i < NumSlices; i++)
+	{
+		while(m_aCoreJobs[i].m_Job.Status() != CJob::STATE_DONE)
+			thread_yield();
+	}
+	sync_barrier();
+}
+
+void CGameWorld::PrepareCores()
+{
+	CTeamsCore *pTeams = &((CGameControllerDDrace *)GameServer()->m_pController)->m_Teams.m_Core;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		m_apPreparedCores[i] = m_Core.m_apCharacters[i];
+		if(m_apPreparedCores[i])
+			m_aPreparedPos[i] = m_apPreparedCores[i]->m_Pos;
+	}
+	mem_copy(&m_PreparedTeams, pTeams, sizeof(CTeamsCore));
+	mem_copy(&m_PreparedTuning, &m_Core.m_Tuning, sizeof(CTuningParams));
+
+	RunCoreJobs(PrepareCoresJob);
+	m_CoresPrepared = true;
+}
+
+int CGameWorld::PrepareCoresJob(void *pUser)
+{
+	CCoreJob *pJob = (CCoreJob *)pUser;
+	for(int i = 0; i < pJob->m_NumCharacters; i++)
+		pJob->m_ppCharacters[i]->PrepareCore();
+	return 0;
+}
+
+bool CGameWorld::PreparedCoresValid()
+{
+	if(!m_CoresPrepared)
+		return false;
+
+	// compare bit for bit, the prepared ticks have to match the serial ones exactly
+	CTeamsCore *pTeams = &((CGameControllerDDrace *)GameServer()->m_pController)->m_Teams.m_Core;
+	if(mem_comp(&m_PreparedTeams, pTeams, sizeof(CTeamsCore)) != 0 || mem_comp(&m_PreparedTuning, &m_Core.m_Tuning, sizeof(CTuningParams)) != 0)
+		return false;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		if(m_Core.m_apCharacters[i] != m_apPreparedCores[i])
+			return false;
+		if(m_apPreparedCores[i] && mem_comp(&m_apPreparedCores[i]->m_Pos, &m_aPreparedPos[i], sizeof(vec2)) != 0)
+			return false;
+	}
+	return true;
+}
+
+void CGameWorld::AdvanceReckoning()
+{
+	RunCoreJobs(AdvanceReckoningJob);
+}
+
+int CGameWorld::AdvanceReckoningJob(void *pUser)
+{
+	CCoreJob *pJob = (CCoreJob *)pUser;
+	// the ones left over are advanced in their deferred tick
+	for(int i = 0; i < pJob->m_NumCharacters; i++)
+		pJob->m_ppCharacters[i]->AdvanceReckoning(false);
+	return 0;
+}
 
 // TODO: should be more general
 CCharacter* CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, vec2& NewPos, CCharacter* pNotThis, int CollideWith, class CCharacter* pThisOnly)
@@ -213,8 +453,9 @@ CCharacter* CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
 	CCharacter *pClosest = 0;
 
-	CCharacter *p = (CCharacter *)FindFirst(ENTTYPE_CHARACTER);
-	for(; p; p = (CCharacter *)p->TypeNext())
+	vec2 Range = vec2(Radius, Radius);
+	CCharacter *p = (CCharacter *)QueryFirst(ENTTYPE_CHARACTER, vec2(min(Pos0.x, Pos1.x), min(Pos0.y, Pos1.y)) - Range, vec2(max(Pos0.x, Pos1.x), max(Pos0.y, Pos1.y)) + Range);
+	for(; p; p = (CCharacter *)QueryNext(p))
  	{
 		if(p == pNotThis)
 			continue;
@@ -246,8 +487,9 @@ CEntity *CGameWorld::ClosestEntity(vec2 Pos, float Radius, int Type, CEntity *pN
 	float ClosestRange = Radius*2;
 	CEntity *pClosest = 0;
 
-	CEntity *p = GameServer()->m_World.FindFirst(Type);
-	for(; p; p = p->TypeNext())
+	vec2 Range = vec2(Radius, Radius);
+	CEntity *p = GameServer()->m_World.QueryFirst(Type, Pos - Range, Pos + Range);
+	for(; p; p = GameServer()->m_World.QueryNext(p))
  	{
 		if(p == pNotThis)
 			continue;
@@ -272,8 +514,9 @@ CCharacter* CGameWorld::ClosestCharacter(vec2 Pos, float Radius, CEntity* pNotTh
 	float ClosestRange = Radius * 2;
 	CCharacter* pClosest = 0;
 
-	CCharacter* p = (CCharacter*)FindFirst(ENTTYPE_CHARACTER);
-	for (; p; p = (CCharacter*)p->TypeNext())
+	vec2 Range = vec2(Radius, Radius);
+	CCharacter* p = (CCharacter*)QueryFirst(ENTTYPE_CHARACTER, Pos - Range, Pos + Range);
+	for (; p; p = (CCharacter*)QueryNext(p))
 	{
 		if (p == pNotThis)
 			continue;
@@ -295,12 +538,13 @@ CCharacter* CGameWorld::ClosestCharacter(vec2 Pos, float Radius, CEntity* pNotTh
 	return pClosest;
 }
 
-std::list<class CCharacter*> CGameWorld::IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, class CEntity* pNotThis, int CollideWith)
+int CGameWorld::IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, class CCharacter** apChars, int Max, class CEntity* pNotThis, int CollideWith)
 {
-	std::list< CCharacter* > listOfChars;
+	int Num = 0;
 
-	CCharacter* pChr = (CCharacter*)FindFirst(CGameWorld::ENTTYPE_CHARACTER);
-	for (; pChr; pChr = (CCharacter*)pChr->TypeNext())
+	vec2 Range = vec2(Radius, Radius);
+	CCharacter* pChr = (CCharacter*)QueryFirst(CGameWorld::ENTTYPE_CHARACTER, vec2(min(Pos0.x, Pos1.x), min(Pos0.y, Pos1.y)) - Range, vec2(max(Pos0.x, Pos1.x), max(Pos0.y, Pos1.y)) + Range);
+	for (; pChr && Num < Max; pChr = (CCharacter*)QueryNext(pChr))
 	{
 		if (pChr == pNotThis)
 			continue;
@@ -313,10 +557,10 @@ std::list<class CCharacter*> CGameWorld::IntersectedCharacters(vec2 Pos0, vec2 P
 		if (Len < pChr->m_ProximityRadius + Radius)
 		{
 			pChr->m_Intersection = IntersectPos;
-			listOfChars.push_back(pChr);
+			apChars[Num++] = pChr;
 		}
 	}
-	return listOfChars;
+	return Num;
 }
 
 void CGameWorld::ReleaseHooked(int ClientID)
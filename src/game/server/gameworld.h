@@ -3,9 +3,11 @@
 #ifndef GAME_SERVER_GAMEWORLD_H
 #define GAME_SERVER_GAMEWORLD_H
 
+#include <engine/shared/jobs.h>
 #include <game/gamecore.h>
 
-#include <list>
+#include "entitygrid.h"
+#include "snapitems.h"
 
 class CEntity;
 class CCharacter;
@@ -29,12 +31,72 @@ public:
 	};
 
 private:
+	enum
+	{
+		MAX_QUERY_ENTITIES = 1024,
+		MAX_SNAP_ENTITIES = 4096,
+	};
+
+	struct CCoreJob
+	{
+		CJob m_Job;
+		CCharacter **m_ppCharacters;
+		int m_NumCharacters;
+	};
+
 	void Reset();
 	void RemoveEntities();
 
+	// runs a function for slices of all characters on the core job pool
+	// and the main thread, returns when all are done
+	void RunCoreJobs(JOBFUNC pfnFunc);
+
+	// prepares the core ticks of all characters on the core job pool
+	// right before the characters tick
+	void PrepareCores();
+	static int PrepareCoresJob(void *pUser);
+
+	// advances the dead reckoning cores of all characters on the core
+	// job pool before the deferred ticks
+	void AdvanceReckoning();
+	static int AdvanceReckoningJob(void *pUser);
+
+	// walk the entities of a type that may lie in a box, in list order.
+	// uses the grid when that is cheaper, not reentrant
+	CEntity *QueryFirst(int Type, vec2 Min, vec2 Max);
+	CEntity *QueryNext(CEntity *pEnt);
+
 	CEntity *m_pNextTraverseEntity;
 	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
 
+	// broadphase for the position queries, entities keep their cell up to
+	// date through CEntity::SetPos
+	CEntityGrid m_Grid;
+	unsigned m_NextSerial;
+	float m_aMaxProximityRadius[NUM_ENTTYPES];
+	CEntityGrid::CNode *m_apQueryNodes[MAX_QUERY_ENTITIES];
+	int m_NumQueryNodes;
+	int m_QueryIndex;
+
+	// how far from their position entities of a type can be seen
+	float m_aMaxSnapRange[NUM_ENTTYPES];
+	CEntityGrid::CNode *m_apSnapNodes[MAX_SNAP_ENTITIES];
+
+	// items that look the same for every client, built once per snapshot
+	CSharedSnapItems m_SharedSnapItems;
+	void SnapSharedItem(int Index);
+
+	CJobPool m_CoreJobPool;
+	CCoreJob m_aCoreJobs[MAX_CLIENTS];
+	CCharacter *m_apCoreCharacters[MAX_CLIENTS];
+
+	// what the prepared core ticks saw of the world
+	bool m_CoresPrepared;
+	CCharacterCore *m_apPreparedCores[MAX_CLIENTS];
+	vec2 m_aPreparedPos[MAX_CLIENTS];
+	CTeamsCore m_PreparedTeams;
+	CTuningParams m_PreparedTuning;
+
 	class CGameContext *m_pGameServer;
 	class IServer *m_pServer;
 
@@ -51,6 +113,29 @@ public:
 
 	void SetGameServer(CGameContext *pGameServer);
 
+	/*
+		Function: init_grid
+			Sets up the entity grid for the map, has to be called
+			before the first entity gets inserted.
+
+		Arguments:
+			width - Width of the map in pixels.
+			height - Height of the map in pixels.
+	*/
+	void InitGrid(float Width, float Height);
+
+	/*
+		Function: PreparedCoresValid
+			Checks whether the positions, teams and tuning the prepared
+			core ticks saw are unchanged. Game logic between two
+			character ticks can teleport, kill or re-team characters.
+
+		Returns:
+			True if a character whose own core is unchanged may apply
+			its prepared core tick.
+	*/
+	bool PreparedCoresValid();
+
 	CEntity *FindFirst(int Type);
 
 	/*
@@ -133,6 +218,15 @@ public:
 	*/
 	void RemoveEntity(CEntity *pEntity);
 
+	/*
+		Function: move_entity
+			Moves an entity to the grid cell of its current position.
+
+		Arguments:
+			entity - Entity that moved
+	*/
+	void MoveEntity(CEntity *pEntity);
+
 	/*
 		Function: destroy_entity
 			Destroys an entity in the world.
@@ -142,10 +236,64 @@ public:
 	*/
 	void DestroyEntity(CEntity *pEntity);
 
+	/*
+		Function: pre_snap
+			Calls pre_snap on all the entities in the world once per
+			snapshot tick to fill the shared item table.
+	*/
+	void PreSnap();
+
+	/*
+		Function: snap_new_shared_item
+			Adds an item that is identical for all clients to the shared
+			item table. It gets copied into the snapshot of every client
+			in the mask that does not network clip it.
+
+		Arguments:
+			type - Item type.
+			id - Item id.
+			size - Item size.
+			mask - Clients that are allowed to see the item.
+			clip_pos - Position to network clip the item against.
+			clip - Whether the item should be network clipped at all.
+
+		Returns:
+			Pointer to the zeroed item data or NULL if the table is full.
+			The memory is valid until the next call.
+	*/
+	void *SnapNewSharedItem(int Type, int ID, int Size, int64_t Mask, vec2 ClipPos, bool Clip = true);
+
+	/*
+		Function: network_clipped
+			Checks whether a position is out of view for a client.
+
+		Arguments:
+			snapping_client - ID of the client which snapshot is
+			being created, -1 for demo recording.
+			check_pos - Position to check.
+
+		Returns:
+			Non-zero if the position is out of view.
+	*/
+	int NetworkClipped(int SnappingClient, vec2 CheckPos);
+
+	/*
+		Function: extend_snap_range
+			Makes snap visit the entities of a type as long as a point
+			that far from their position is in view.
+
+		Arguments:
+			type - Entity type.
+			range - Distance in pixels.
+	*/
+	void ExtendSnapRange(int Type, float Range);
+
 	/*
 		Function: snap
-			Calls snap on all the entities in the world to create
-			the snapshot.
+			Copies the shared items around the client's view and calls snap on the
+			entities in the world to create the snapshot. Only the
+			entities in the grid cells around the client's view are
+			visited, unless sv_snap_view_index is off.
 
 		Arguments:
 			snapping_client - ID of the client which snapshot
@@ -165,7 +313,6 @@ public:
 
 	// DDrace
 
-	std::list<class CCharacter*> IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, vec2& NewPos, class CEntity* pNotThis, int CollideWith = -1);
 	void ReleaseHooked(int ClientID);
 
 
@@ -177,13 +324,14 @@ public:
 			pos0 - Start position
 			pos2 - End position
 			radius - How for from the line the CCharacter is allowed to be.
-			new_pos - Intersection position
+			chars - Array that gets filled with the hit CCharacters.
+			max - Number of CCharacters that fit into the array.
 			notthis - Entity to ignore intersecting with
 
 		Returns:
-			Returns list with all Characters on line.
+			Number of CCharacters on the line added to the array.
 	*/
-	std::list<class CCharacter*> IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, class CEntity* pNotThis = 0, int CollideWith = -1);
+	int IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, class CCharacter** apChars, int Max, class CEntity* pNotThis = 0, int CollideWith = -1);
 };
 
 #endif
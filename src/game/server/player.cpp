@@ -163,10 +163,12 @@ void CPlayer::Tick()
 
 		if(!m_pCharacter && (m_Team == TEAM_SPECTATORS || m_Paused) && m_pSpecFlag)
 		{
-			if(m_pSpecFlag->GetCarrier())
-				m_SpectatorID = m_pSpecFlag->GetCarrier()->GetPlayer()->GetCID();
-			else
-				m_SpectatorID = -1;
+			int SpectatorID = m_pSpecFlag->GetCarrier() ? m_pSpecFlag->GetCarrier()->GetPlayer()->GetCID() : -1;
+			if(SpectatorID != m_SpectatorID)
+			{
+				m_SpectatorID = SpectatorID;
+				GameServer()->OnViewChange();
+			}
 		}
 
 		if(m_pCharacter)
@@ -326,6 +328,7 @@ void CPlayer::OnDisconnect()
 				GameServer()->m_apPlayers[i]->m_SpectatorID = -1;
 			}
 		}
+		GameServer()->OnViewChange();
 	}
 }
 
@@ -412,6 +415,7 @@ void CPlayer::OnDirectInput(CNetObj_PlayerInput *NewInput)
 				m_pSpecFlag = 0;
 				m_SpectatorID = -1;
 			}
+			GameServer()->OnViewChange();
 		}
 	}
 	else if(m_ActiveSpecSwitch)
@@ -491,11 +495,13 @@ bool CPlayer::SetSpectatorID(int SpecMode, int SpectatorID)
 				if (!m_pSpecFlag)
 					return false;
 				m_SpecMode = SpecMode;
+				GameServer()->OnViewChange();
 				return true;
 			}
 			m_pSpecFlag = 0;
 			m_SpecMode = SpecMode;
 			m_SpectatorID = SpectatorID;
+			GameServer()->OnViewChange();
 			return true;
 		}
 	}
@@ -518,6 +524,7 @@ void CPlayer::SetTeam(int Team, bool DoChatMsg)
 	KillCharacter();
 
 	m_Team = Team;
+	Server()->ExpireServerInfo();
 	m_LastActionTick = Server()->Tick();
 	m_SpecMode = SPEC_FREEVIEW;
 	m_SpectatorID = -1;
@@ -539,6 +546,7 @@ void CPlayer::SetTeam(int Team, bool DoChatMsg)
 			}
 		}
 	}
+	GameServer()->OnViewChange();
 
 	// notify clients
 	CNetMsg_Sv_Team Msg;
@@ -665,6 +673,7 @@ void CPlayer::ProcessPause()
 	if (m_ForcePauseTime && m_ForcePauseTime < Server()->Tick())
 	{
 		m_ForcePauseTime = 0;
+		GameServer()->OnViewChange();
 		Pause(PAUSE_NONE, true);
 	}
 
@@ -714,6 +723,7 @@ int CPlayer::Pause(int State, bool Force)
 		// Update state
 		m_Paused = State;
 		m_LastPause = Server()->Tick();
+		GameServer()->OnViewChange();
 
 		CNetMsg_Sv_Team Msg;
 		Msg.m_ClientID = m_ClientID;
@@ -729,6 +739,7 @@ int CPlayer::Pause(int State, bool Force)
 int CPlayer::ForcePause(int Time)
 {
 	m_ForcePauseTime = Server()->Tick() + Server()->TickSpeed() * Time;
+	GameServer()->OnViewChange();
 
 	if (g_Config.m_SvPauseMessages)
 	{
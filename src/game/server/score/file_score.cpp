@@ -1,7 +1,7 @@
 /* (c) Shereef Marzouk. See "licence DDRace.txt" and the readme.txt in the root of the distribution for more information. */
 /* Based on Race mod stuff and tweaked by GreYFoX@GTi and others to fit our DDRace needs. */
 /* copyright (c) 2008 rajh and gregwar. Score stuff */
-#include <base/tl/sorted_array.h>
+#include <base/tl/threading.h>
 
 #include <engine/shared/config.h>
 #include <sstream>
@@ -11,8 +11,6 @@
 #include "file_score.h"
 #include <engine/shared/console.h>
 
-static LOCK gs_ScoreLock = 0;
-
 CFileScore::CPlayerScore::CPlayerScore(const char *pName, float Score,
 		float aCpTime[NUM_CHECKPOINTS])
 {
@@ -22,23 +20,122 @@ CFileScore::CPlayerScore::CPlayerScore(const char *pName, float Score,
 		m_aCpTime[i] = aCpTime[i];
 }
 
+bool CFileScore::CRanking::Set(const CPlayerScore &Score)
+{
+	int ID = m_Index.Find(Score.m_aName);
+	if (ID >= 0)
+	{
+		m_Index.Update(ID, Score.m_Score);
+		m_lScores[ID] = Score;
+		return true;
+	}
+
+	m_Index.Add(Score.m_aName, Score.m_Score);
+	m_lScores.add(Score);
+	return false;
+}
+
+void CFileScore::CJournal::Start(const char *pFilename, bool CheckpointSave)
+{
+	str_copy(m_aFilename, pFilename, sizeof(m_aFilename));
+	m_CheckpointSave = CheckpointSave;
+	m_NumStale = 0;
+	m_Writer.OpenRecords(this, QUEUE_SIZE*(sizeof(int) + sizeof(CPlayerScore)), sizeof(CPlayerScore));
+}
+
+void CFileScore::CJournal::Stop()
+{
+	m_Writer.Close();
+}
+
+void CFileScore::CJournal::Push(const CPlayerScore &Score)
+{
+	// only waits if the disk is a whole queue behind
+	m_Writer.WriteRecord(&Score, sizeof(Score), 0, 0);
+	m_Writer.Flush();
+}
+
+void CFileScore::CJournal::OnStart()
+{
+	// the thread keeps its own copy of the ranking to compact the file
+	m_NumStale = max(0, Load(m_aFilename, m_CheckpointSave, &m_Ranking));
+	m_File.open(m_aFilename, std::ios::out | std::ios::app);
+	if (m_File.fail())
+		dbg_msg("filescore", "opening '%s' for writing failed", m_aFilename);
+}
+
+void CFileScore::CJournal::OnRecord(const void *pData, int Size)
+{
+	CPlayerScore Score;
+	mem_copy(&Score, pData, sizeof(Score));
+	if (m_Ranking.Set(Score))
+		m_NumStale++;
+	if (!m_File.fail())
+		Write(m_File, Score, m_CheckpointSave);
+}
+
+void CFileScore::CJournal::OnDrained(bool Shutdown)
+{
+	m_File.flush();
+
+	if (m_NumStale > 0 && (Shutdown
+			|| m_NumStale >= max((int)MIN_COMPACT_RECORDS, m_Ranking.m_Index.Num() / 2)))
+	{
+		m_File.close();
+		if (Compact())
+			m_NumStale = 0;
+		if (!Shutdown)
+		{
+			m_File.clear();
+			m_File.open(m_aFilename, std::ios::out | std::ios::app);
+		}
+	}
+
+	if (Shutdown)
+	{
+		m_File.close();
+		m_File.clear();
+	}
+}
+
+bool CFileScore::CJournal::Compact()
+{
+	char aTmpFilename[sizeof(m_aFilename) + 8];
+	str_format(aTmpFilename, sizeof(aTmpFilename), "%s.tmp", m_aFilename);
+
+	std::ofstream f;
+	f.open(aTmpFilename, std::ios::out);
+	if (f.fail())
+	{
+		dbg_msg("filescore", "opening '%s' for writing failed", aTmpFilename);
+		return false;
+	}
+	for (int i = 1; i <= m_Ranking.m_Index.Num(); i++)
+		Write(f, *m_Ranking.Get(m_Ranking.m_Index.Nth(i)), m_CheckpointSave);
+	f.close();
+
+	// rename doesn't replace existing files everywhere
+	if (fs_rename(aTmpFilename, m_aFilename))
+	{
+		fs_remove(m_aFilename);
+		if (fs_rename(aTmpFilename, m_aFilename))
+		{
+			dbg_msg("filescore", "replacing '%s' failed", m_aFilename);
+			return false;
+		}
+	}
+	return true;
+}
+
 CFileScore::CFileScore(CGameContext *pGameServer) :
 				m_pGameServer(pGameServer), m_pServer(pGameServer->Server())
 {
-	if (gs_ScoreLock == 0)
-		gs_ScoreLock = lock_create();
-
 	Init();
 }
 
 CFileScore::~CFileScore()
 {
-	lock_wait(gs_ScoreLock);
-
-	// clear list
-	m_Top.clear();
-
-	lock_unlock(gs_ScoreLock);
+	m_Journal.Stop();
 }
 
 std::string SaveFile()
@@ -64,59 +161,25 @@ void CFileScore::MapVote(std::shared_ptr<CMapVoteResult> *ppResult, int ClientID
 	// TODO: implement
 }
 
-void CFileScore::SaveScoreThread(void *pUser)
+void CFileScore::Write(std::ostream &Stream, const CPlayerScore &Score, bool CheckpointSave)
 {
-	CFileScore *pSelf = (CFileScore *) pUser;
-	lock_wait(gs_ScoreLock);
-	std::fstream f;
-	f.open(SaveFile().c_str(), std::ios::out);
-	if(f.fail())
+	Stream << Score.m_aName << std::endl << Score.m_Score << std::endl;
+	if (CheckpointSave)
 	{
-		dbg_msg("filescore", "opening '%s' for writing failed", SaveFile().c_str());
-	}
-	else
-	{
-		int t = 0;
-		for (sorted_array<CPlayerScore>::range r = pSelf->m_Top.all();
-				!r.empty(); r.pop_front())
-		{
-			f << r.front().m_aName << std::endl << r.front().m_Score
-					<< std::endl;
-			if (g_Config.m_SvCheckpointSave)
-			{
-				for (int c = 0; c < NUM_CHECKPOINTS; c++)
-					f << r.front().m_aCpTime[c] << " ";
-				f << std::endl;
-			}
-			t++;
-			if (t % 50 == 0)
-				thread_sleep(1000);
-		}
+		for (int c = 0; c < NUM_CHECKPOINTS; c++)
+			Stream << Score.m_aCpTime[c] << " ";
+		Stream << std::endl;
 	}
-	f.close();
-	lock_unlock(gs_ScoreLock);
-}
-
-void CFileScore::Save()
-{
-	thread_init_and_detach(SaveScoreThread, this);
 }
 
-void CFileScore::Init()
+int CFileScore::Load(const char *pFilename, bool CheckpointSave, CRanking *pRanking)
 {
-	lock_wait(gs_ScoreLock);
-
-	// create folder if not exist
-	if (g_Config.m_SvScoreFolder[0])
-		fs_makedir(g_Config.m_SvScoreFolder);
-
+	int NumStale = 0;
 	std::fstream f;
-	f.open(SaveFile().c_str(), std::ios::in);
+	f.open(pFilename, std::ios::in);
 
 	if(f.fail())
-	{
-		dbg_msg("filescore", "opening '%s' for reading failed", SaveFile().c_str());
-	}
+		return -1;
 	while (!f.eof() && !f.fail())
 	{
 		std::string TmpName, TmpScore, TmpCpLine;
@@ -126,51 +189,68 @@ void CFileScore::Init()
 			std::getline(f, TmpScore);
 			float aTmpCpTime[NUM_CHECKPOINTS] =
 			{ 0 };
-			if (g_Config.m_SvCheckpointSave)
+			if (CheckpointSave)
 			{
 				std::getline(f, TmpCpLine);
 
 				std::istringstream iss(TmpCpLine);
 				int i = 0;
-				for(std::string p; std::getline(iss, p, ' '); i++)
+				for(std::string p; i < NUM_CHECKPOINTS && std::getline(iss, p, ' '); i++)
 					aTmpCpTime[i] = str_tofloat(p.c_str());
 			}
-			m_Top.add(
-					*new CPlayerScore(TmpName.c_str(), atof(TmpScore.c_str()),
-							aTmpCpTime));
+			// later records of a player replace the earlier ones
+			if (pRanking->Set(CPlayerScore(TmpName.c_str(), atof(TmpScore.c_str()),
+					aTmpCpTime)))
+				NumStale++;
 		}
 	}
 	f.close();
-	lock_unlock(gs_ScoreLock);
+	return NumStale;
+}
+
+void CFileScore::Init()
+{
+	// create folder if not exist
+	if (g_Config.m_SvScoreFolder[0])
+		fs_makedir(g_Config.m_SvScoreFolder);
+
+	// the file and its format stay the same until the map changes
+	str_copy(m_aFilename, SaveFile().c_str(), sizeof(m_aFilename));
+	m_CheckpointSave = g_Config.m_SvCheckpointSave;
+
+	if (Load(m_aFilename, m_CheckpointSave, &m_Ranking) < 0)
+		dbg_msg("filescore", "opening '%s' for reading failed", m_aFilename);
+	m_Journal.Start(m_aFilename, m_CheckpointSave);
 
 	// save the current best score
-	if (m_Top.size())
+	if (m_Ranking.m_Index.Num())
 		((CGameControllerDDrace*) GameServer()->m_pController)->m_CurrentRecord =
-				m_Top[0].m_Score;
+				m_Ranking.m_Index.Time(m_Ranking.m_Index.Nth(1));
 }
 
 CFileScore::CPlayerScore *CFileScore::SearchName(const char *pName,
 		int *pPosition, bool NoCase)
 {
-	CPlayerScore *pPlayer = 0;
-	int Pos = 1;
+	// exact matches come from the name index
+	int ID = m_Ranking.m_Index.Find(pName);
+	if (ID >= 0)
+	{
+		if (pPosition)
+			*pPosition = m_Ranking.m_Index.Rank(ID);
+		return m_Ranking.Get(ID);
+	}
+	if (!NoCase)
+		return 0;
+
+	// partial matches still need a scan, but only for searches by name
 	int Found = 0;
-	for (sorted_array<CPlayerScore>::range r = m_Top.all(); !r.empty();
-			r.pop_front())
+	for (int i = 0; i < m_Ranking.m_Index.Num(); i++)
 	{
-		if (str_find_nocase(r.front().m_aName, pName))
+		if (str_find_nocase(m_Ranking.m_Index.Name(i), pName))
 		{
-			if (pPosition)
-				*pPosition = Pos;
-			if (NoCase)
-			{
-				Found++;
-				pPlayer = &r.front();
-			}
-			if (!strcmp(r.front().m_aName, pName))
-				return &r.front();
+			Found++;
+			ID = i;
 		}
-		Pos++;
 	}
 	if (Found > 1)
 	{
@@ -178,32 +258,17 @@ CFileScore::CPlayerScore *CFileScore::SearchName(const char *pName,
 			*pPosition = -1;
 		return 0;
 	}
-	return pPlayer;
+	if (pPosition && ID >= 0)
+		*pPosition = m_Ranking.m_Index.Rank(ID);
+	return m_Ranking.Get(ID);
 }
 
 void CFileScore::UpdatePlayer(int ID, float Score,
 		float aCpTime[NUM_CHECKPOINTS])
 {
-	const char *pName = Server()->ClientName(ID);
-
-	lock_wait(gs_ScoreLock);
-	CPlayerScore *pPlayer = SearchScore(ID, 0);
-
-	if (pPlayer)
-	{
-		for (int c = 0; c < NUM_CHECKPOINTS; c++)
-			pPlayer->m_aCpTime[c] = aCpTime[c];
-
-		pPlayer->m_Score = Score;
-		str_copy(pPlayer->m_aName, pName, sizeof(pPlayer->m_aName));
-
-		sort(m_Top.all());
-	}
-	else
-		m_Top.add(*new CPlayerScore(pName, Score, aCpTime));
-
-	lock_unlock(gs_ScoreLock);
-	Save();
+	CPlayerScore PlayerScore(Server()->ClientName(ID), Score, aCpTime);
+	m_Ranking.Set(PlayerScore);
+	m_Journal.Push(PlayerScore);
 }
 
 void CFileScore::CheckBirthday(int ClientID)
@@ -214,12 +279,6 @@ void CFileScore::CheckBirthday(int ClientID)
 void CFileScore::LoadScore(int ClientID)
 {
 	CPlayerScore *pPlayer = SearchScore(ClientID, 0);
-	if (pPlayer)
-	{
-		lock_wait(gs_ScoreLock);
-		lock_unlock(gs_ScoreLock);
-		Save();
-	}
 
 	// set score
 	if (pPlayer)
@@ -247,13 +306,13 @@ void CFileScore::ShowTop5(IConsole::IResult *pResult, int ClientID,
 {
 	CGameContext *pSelf = (CGameContext *) pUserData;
 	char aBuf[512];
-	Debut = max(1, Debut < 0 ? m_Top.size() + Debut - 3 : Debut);
+	Debut = max(1, Debut < 0 ? m_Ranking.m_Index.Num() + Debut - 3 : Debut);
 	pSelf->SendChatTarget(ClientID, "----------- Top 5 -----------");
 	for (int i = 0; i < 5; i++)
 	{
-		if (i + Debut > m_Top.size())
+		if (i + Debut > m_Ranking.m_Index.Num())
 			break;
-		CPlayerScore *r = &m_Top[i + Debut - 1];
+		CPlayerScore *r = m_Ranking.Get(m_Ranking.m_Index.Nth(i + Debut));
 		str_format(aBuf, sizeof(aBuf),
 				"%d. %s Time: %d minute(s) %5.2f second(s)", i + Debut,
 				r->m_aName, (int)r->m_Score / 60,
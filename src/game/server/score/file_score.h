@@ -4,9 +4,13 @@
 #ifndef GAME_SERVER_SCORE_FILE_SCORE_H
 #define GAME_SERVER_SCORE_FILE_SCORE_H
 
-#include <base/tl/sorted_array.h>
+#include <fstream>
+
+#include <base/system.h>
+#include <engine/shared/asyncwriter.h>
 
 #include "../score.h"
+#include "score_index.h"
 
 class CFileScore: public IScore
 {
@@ -26,14 +30,61 @@ class CFileScore: public IScore
 		;
 		CPlayerScore(const char *pName, float Score,
 				float aCpTime[NUM_CHECKPOINTS]);
+	};
+
+	// all scores of the map, ranked through the index
+	class CRanking
+	{
+	public:
+		CScoreIndex m_Index;
+		array<CPlayerScore> m_lScores; // by index ID
 
-		bool operator<(const CPlayerScore& other) const
+		// returns whether the player already had a score
+		bool Set(const CPlayerScore &Score);
+		CPlayerScore *Get(int ID) { return ID < 0 ? 0 : &m_lScores[ID]; }
+	};
+
+	/*
+		Class: CJournal
+			Owns the records file. Finishes are queued by the game thread on
+			a record writer and appended to the file by its thread, which
+			keeps its own ranking to rewrite the file without the superseded
+			records once there are enough of them.
+	*/
+	class CJournal : private CAsyncWriter::IConsumer
+	{
+	public:
+		enum
 		{
-			return (this->m_Score < other.m_Score);
-		}
+			QUEUE_SIZE=64, // in records
+			MIN_COMPACT_RECORDS=64,
+		};
+
+		void Start(const char *pFilename, bool CheckpointSave);
+		// writes everything that is queued, compacts the file and stops the thread
+		void Stop();
+		void Push(const CPlayerScore &Score);
+
+	private:
+		virtual void OnStart();
+		virtual void OnRecord(const void *pData, int Size);
+		virtual void OnDrained(bool Shutdown);
+		bool Compact();
+
+		CAsyncWriter m_Writer;
+
+		// only used by the writer thread
+		char m_aFilename[512];
+		bool m_CheckpointSave;
+		CRanking m_Ranking;
+		int m_NumStale;
+		std::ofstream m_File;
 	};
 
-	sorted_array<CPlayerScore> m_Top;
+	CRanking m_Ranking;
+	CJournal m_Journal;
+	char m_aFilename[512];
+	bool m_CheckpointSave;
 
 	CGameContext *GameServer()
 	{
@@ -54,8 +105,10 @@ class CFileScore: public IScore
 	void UpdatePlayer(int ID, float Score, float aCpTime[NUM_CHECKPOINTS]);
 
 	void Init();
-	void Save();
-	static void SaveScoreThread(void *pUser);
+	// returns the number of records that were superseded by later ones or -1
+	// if the file could not be opened
+	static int Load(const char *pFilename, bool CheckpointSave, CRanking *pRanking);
+	static void Write(std::ostream &Stream, const CPlayerScore &Score, bool CheckpointSave);
 
 public:
 
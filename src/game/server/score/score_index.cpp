@@ -0,0 +1,205 @@
+/* (c) Shereef Marzouk. See "licence DDRace.txt" and the readme.txt in the root of the distribution for more information. */
+#include <base/system.h>
+
+#include "score_index.h"
+
+CScoreIndex::CScoreIndex()
+{
+	Clear();
+}
+
+void CScoreIndex::Clear()
+{
+	m_lEntries.clear();
+	m_lBuckets.clear();
+	m_Root = -1;
+	m_NextOrder = 0;
+	m_Seed = 0x2545F491;
+	Rehash(64);
+}
+
+bool CScoreIndex::Less(int a, int b) const
+{
+	const CEntry *pA = &m_lEntries[a];
+	const CEntry *pB = &m_lEntries[b];
+	if(pA->m_Time != pB->m_Time)
+		return pA->m_Time < pB->m_Time;
+	return pA->m_Order < pB->m_Order;
+}
+
+void CScoreIndex::UpdateSize(int Node)
+{
+	m_lEntries[Node].m_Size = Size(m_lEntries[Node].m_Left) + Size(m_lEntries[Node].m_Right) + 1;
+}
+
+void CScoreIndex::Split(int Node, int Key, int *pLeft, int *pRight)
+{
+	// left gets everything ranked before the key
+	if(Node < 0)
+	{
+		*pLeft = -1;
+		*pRight = -1;
+	}
+	else if(Less(Node, Key))
+	{
+		Split(m_lEntries[Node].m_Right, Key, &m_lEntries[Node].m_Right, pRight);
+		UpdateSize(Node);
+		*pLeft = Node;
+	}
+	else
+	{
+		Split(m_lEntries[Node].m_Left, Key, pLeft, &m_lEntries[Node].m_Left);
+		UpdateSize(Node);
+		*pRight = Node;
+	}
+}
+
+int CScoreIndex::Merge(int Left, int Right)
+{
+	if(Left < 0)
+		return Right;
+	if(Right < 0)
+		return Left;
+	if(m_lEntries[Left].m_Priority > m_lEntries[Right].m_Priority)
+	{
+		m_lEntries[Left].m_Right = Merge(m_lEntries[Left].m_Right, Right);
+		UpdateSize(Left);
+		return Left;
+	}
+	m_lEntries[Right].m_Left = Merge(Left, m_lEntries[Right].m_Left);
+	UpdateSize(Right);
+	return Right;
+}
+
+int CScoreIndex::Insert(int Node, int New)
+{
+	if(Node < 0)
+		return New;
+	if(m_lEntries[New].m_Priority > m_lEntries[Node].m_Priority)
+	{
+		Split(Node, New, &m_lEntries[New].m_Left, &m_lEntries[New].m_Right);
+		UpdateSize(New);
+		return New;
+	}
+	if(Less(New, Node))
+		m_lEntries[Node].m_Left = Insert(m_lEntries[Node].m_Left, New);
+	else
+		m_lEntries[Node].m_Right = Insert(m_lEntries[Node].m_Right, New);
+	UpdateSize(Node);
+	return Node;
+}
+
+int CScoreIndex::Remove(int Node, int Old)
+{
+	if(Node == Old)
+		return Merge(m_lEntries[Node].m_Left, m_lEntries[Node].m_Right);
+	if(Less(Old, Node))
+		m_lEntries[Node].m_Left = Remove(m_lEntries[Node].m_Left, Old);
+	else
+		m_lEntries[Node].m_Right = Remove(m_lEntries[Node].m_Right, Old);
+	UpdateSize(Node);
+	return Node;
+}
+
+void CScoreIndex::Rehash(int NumBuckets)
+{
+	m_lBuckets.set_size(NumBuckets);
+	for(int i = 0; i < NumBuckets; i++)
+		m_lBuckets[i] = -1;
+	for(int i = 0; i < m_lEntries.size(); i++)
+	{
+		int Bucket = str_quickhash(m_lEntries[i].m_aName)&(NumBuckets-1);
+		m_lEntries[i].m_NextInBucket = m_lBuckets[Bucket];
+		m_lBuckets[Bucket] = i;
+	}
+}
+
+int CScoreIndex::Add(const char *pName, float Time)
+{
+	CEntry Entry;
+	str_copy(Entry.m_aName, pName, sizeof(Entry.m_aName));
+	Entry.m_Time = Time;
+	Entry.m_Order = m_NextOrder++;
+	// xorshift, the treap only needs the priorities to be well mixed
+	m_Seed ^= m_Seed<<13;
+	m_Seed ^= m_Seed>>17;
+	m_Seed ^= m_Seed<<5;
+	Entry.m_Priority = m_Seed;
+	Entry.m_Left = -1;
+	Entry.m_Right = -1;
+	Entry.m_Size = 1;
+	int ID = m_lEntries.add(Entry);
+
+	if(m_lEntries.size() > m_lBuckets.size())
+		Rehash(m_lBuckets.size()*2);
+	else
+	{
+		int Bucket = str_quickhash(m_lEntries[ID].m_aName)&(m_lBuckets.size()-1);
+		m_lEntries[ID].m_NextInBucket = m_lBuckets[Bucket];
+		m_lBuckets[Bucket] = ID;
+	}
+
+	m_Root = Insert(m_Root, ID);
+	return ID;
+}
+
+void CScoreIndex::Update(int ID, float Time)
+{
+	m_Root = Remove(m_Root, ID);
+	m_lEntries[ID].m_Time = Time;
+	m_lEntries[ID].m_Order = m_NextOrder++;
+	m_lEntries[ID].m_Left = -1;
+	m_lEntries[ID].m_Right = -1;
+	m_lEntries[ID].m_Size = 1;
+	m_Root = Insert(m_Root, ID);
+}
+
+int CScoreIndex::Find(const char *pName) const
+{
+	int Bucket = str_quickhash(pName)&(m_lBuckets.size()-1);
+	for(int i = m_lBuckets[Bucket]; i >= 0; i = m_lEntries[i].m_NextInBucket)
+		if(str_comp(m_lEntries[i].m_aName, pName) == 0)
+			return i;
+	return -1;
+}
+
+int CScoreIndex::Rank(int ID) const
+{
+	int Rank = 0;
+	int Node = m_Root;
+	while(Node >= 0)
+	{
+		if(Node == ID)
+			return Rank + Size(m_lEntries[Node].m_Left) + 1;
+		if(Less(ID, Node))
+			Node = m_lEntries[Node].m_Left;
+		else
+		{
+			Rank += Size(m_lEntries[Node].m_Left) + 1;
+			Node = m_lEntries[Node].m_Right;
+		}
+	}
+	return -1;
+}
+
+int CScoreIndex::Nth(int Rank) const
+{
+	if(Rank < 1 || Rank > Num())
+		return -1;
+
+	int Node = m_Root;
+	while(Node >= 0)
+	{
+		int Left = Size(m_lEntries[Node].m_Left);
+		if(Rank <= Left)
+			Node = m_lEntries[Node].m_Left;
+		else if(Rank == Left + 1)
+			return Node;
+		else
+		{
+			Rank -= Left + 1;
+			Node = m_lEntries[Node].m_Right;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,76 @@
+/* (c) Shereef Marzouk. See "licence DDRace.txt" and the readme.txt in the root of the distribution for more information. */
+#ifndef GAME_SERVER_SCORE_SCORE_INDEX_H
+#define GAME_SERVER_SCORE_SCORE_INDEX_H
+
+#include <base/tl/array.h>
+#include <engine/shared/protocol.h>
+
+/*
+	Class: CScoreIndex
+		Ranking of finish times by player name. Names are found through a
+		hash table, the ranks come from a treap that counts the entries
+		below each node, so looking up a rank or the entry at a rank is
+		O(log n).
+
+		Entries are never removed, their ID is the order in which they
+		were added. Equal times are ranked by when they were set.
+*/
+class CScoreIndex
+{
+public:
+	CScoreIndex();
+
+	void Clear();
+
+	/*
+		Function: Add
+			Adds a player that is not ranked yet.
+
+		Returns:
+			The ID of the new entry.
+	*/
+	int Add(const char *pName, float Time);
+	// sets a new time, the entry is ranked behind other entries with the same time
+	void Update(int ID, float Time);
+
+	// ID of the entry with exactly this name or -1
+	int Find(const char *pName) const;
+	// 1 for the best time
+	int Rank(int ID) const;
+	// ID of the entry at a rank or -1 if there is none
+	int Nth(int Rank) const;
+
+	int Num() const { return m_lEntries.size(); }
+	const char *Name(int ID) const { return m_lEntries[ID].m_aName; }
+	float Time(int ID) const { return m_lEntries[ID].m_Time; }
+
+private:
+	struct CEntry
+	{
+		char m_aName[MAX_NAME_LENGTH];
+		float m_Time;
+		unsigned m_Order;
+		unsigned m_Priority;
+		int m_Left;
+		int m_Right;
+		int m_Size;
+		int m_NextInBucket;
+	};
+
+	bool Less(int a, int b) const;
+	int Size(int Node) const { return Node < 0 ? 0 : m_lEntries[Node].m_Size; }
+	void UpdateSize(int Node);
+	void Split(int Node, int Key, int *pLeft, int *pRight);
+	int Merge(int Left, int Right);
+	int Insert(int Node, int New);
+	int Remove(int Node, int Old);
+	void Rehash(int NumBuckets);
+
+	array<CEntry> m_lEntries;
+	array<int> m_lBuckets;
+	int m_Root;
+	unsigned m_NextOrder;
+	unsigned m_Seed;
+};
+
+#endif // GAME_SERVER_SCORE_SCORE_INDEX_H
@@ -0,0 +1,219 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <math.h>
+
+#include <base/math.h>
+#include <base/system.h>
+
+#include "snapitems.h"
+
+CSharedSnapItems::CSharedSnapItems()
+{
+	m_ItemsCapacity = MIN_ITEMS;
+	m_DataCapacity = MIN_ITEMS*64;
+	m_pItems = new CItem[m_ItemsCapacity];
+	m_pData = new char[m_DataCapacity];
+	m_pCollected = new int[m_ItemsCapacity];
+	m_NumItems = 0;
+	m_DataSize = 0;
+	m_NumDropped = 0;
+	for(int i = 0; i <= NUM_BUCKETS; i++)
+	{
+		m_aBucketFirst[i] = -1;
+		m_aBucketLast[i] = -1;
+		m_aBucketMasks[i] = 0;
+	}
+}
+
+CSharedSnapItems::~CSharedSnapItems()
+{
+	delete[] m_pItems;
+	delete[] m_pData;
+	delete[] m_pCollected;
+}
+
+int CSharedSnapItems::Cell(float Pos)
+{
+	// far out and broken positions end up in the outermost cells
+	const float Max = (float)(1<<30);
+	if(!(Pos > -Max))
+		return -(1<<30)>>CELL_SHIFT;
+	if(Pos >= Max)
+		return (1<<30)>>CELL_SHIFT;
+	return (int)floorf(Pos)>>CELL_SHIFT;
+}
+
+int CSharedSnapItems::Bucket(int CellX, int CellY)
+{
+	// the buckets tile the map, neighbouring cells never share one
+	return ((CellY&15)<<4) | (CellX&15);
+}
+
+bool CSharedSnapItems::Grow(int NumItems, int DataSize)
+{
+	if(NumItems > MAX_ITEMS || DataSize > MAX_DATA)
+		return false;
+
+	if(NumItems > m_ItemsCapacity)
+	{
+		int Capacity = m_ItemsCapacity;
+		while(Capacity < NumItems)
+			Capacity *= 2;
+		CItem *pItems = new CItem[Capacity];
+		mem_copy(pItems, m_pItems, m_NumItems*sizeof(CItem));
+		delete[] m_pItems;
+		m_pItems = pItems;
+		delete[] m_pCollected;
+		m_pCollected = new int[Capacity];
+		m_ItemsCapacity = Capacity;
+	}
+	if(DataSize > m_DataCapacity)
+	{
+		int Capacity = m_DataCapacity;
+		while(Capacity < DataSize)
+			Capacity *= 2;
+		char *pData = new char[Capacity];
+		mem_copy(pData, m_pData, m_DataSize);
+		delete[] m_pData;
+		m_pData = pData;
+		m_DataCapacity = Capacity;
+	}
+	return true;
+}
+
+void CSharedSnapItems::Clear()
+{
+	if(m_NumItems)
+	{
+		for(int i = 0; i <= NUM_BUCKETS; i++)
+		{
+			m_aBucketFirst[i] = -1;
+			m_aBucketLast[i] = -1;
+			m_aBucketMasks[i] = 0;
+		}
+	}
+
+	m_NumItems = 0;
+	m_DataSize = 0;
+	m_NumDropped = 0;
+}
+
+void *CSharedSnapItems::New(int Type, int ID, int Size, int64_t Mask, vec2 ClipPos, bool Clip)
+{
+	int DataSize = m_DataSize + ((Size+3)&~3);
+	if(m_NumItems == m_ItemsCapacity || DataSize > m_DataCapacity)
+	{
+		if(!Grow(m_NumItems+1, DataSize))
+		{
+			m_NumDropped++;
+			return 0;
+		}
+	}
+
+	int Index = m_NumItems++;
+	CItem *pItem = &m_pItems[Index];
+	pItem->m_Type = Type;
+	pItem->m_ID = ID;
+	pItem->m_Size = Size;
+	pItem->m_Offset = m_DataSize;
+	pItem->m_Mask = Mask;
+	pItem->m_ClipPos = ClipPos;
+	pItem->m_Clip = Clip;
+	pItem->m_Next = -1;
+
+	int b = Clip ? Bucket(Cell(ClipPos.x), Cell(ClipPos.y)) : (int)BUCKET_UNCLIPPED;
+	if(m_aBucketLast[b] == -1)
+		m_aBucketFirst[b] = Index;
+	else
+		m_pItems[m_aBucketLast[b]].m_Next = Index;
+	m_aBucketLast[b] = Index;
+	m_aBucketMasks[b] |= Mask;
+
+	void *pData = m_pData + m_DataSize;
+	m_DataSize = DataSize;
+	mem_zero(pData, Size);
+	return pData;
+}
+
+bool CSharedSnapItems::Clipped(vec2 ViewPos, vec2 CheckPos)
+{
+	float dx = ViewPos.x-CheckPos.x;
+	float dy = ViewPos.y-CheckPos.y;
+
+	if(absolute(dx) > 1000.0f || absolute(dy) > 800.0f)
+		return true;
+
+	if(distance(ViewPos, CheckPos) > 4000.0f)
+		return true;
+	return false;
+}
+
+int CSharedSnapItems::CollectLinear(int SnappingClient, vec2 ViewPos, int *pIndices) const
+{
+	int Num = 0;
+	for(int i = 0; i < m_NumItems; i++)
+	{
+		const CItem *pItem = &m_pItems[i];
+		if(!((pItem->m_Mask>>SnappingClient)&1) || (pItem->m_Clip && Clipped(ViewPos, pItem->m_ClipPos)))
+			continue;
+		pIndices[Num++] = i;
+	}
+	return Num;
+}
+
+const int *CSharedSnapItems::Collect(int SnappingClient, vec2 ViewPos, int *pNum)
+{
+	// the view box covers at most 3x3 cells, plus the unclipped items
+	const int MaxLists = 3*3+1;
+
+	// a broken view sees everything that isn't masked out
+	if(m_NumItems <= 2*MaxLists || ViewPos.x != ViewPos.x || ViewPos.y != ViewPos.y)
+	{
+		*pNum = CollectLinear(SnappingClient, ViewPos, m_pCollected);
+		return m_pCollected;
+	}
+
+	int aNext[MaxLists];
+	int NumLists = 0;
+	if(m_aBucketFirst[BUCKET_UNCLIPPED] != -1 && ((m_aBucketMasks[BUCKET_UNCLIPPED]>>SnappingClient)&1))
+		aNext[NumLists++] = m_aBucketFirst[BUCKET_UNCLIPPED];
+
+	int MinX = Cell(ViewPos.x - 1000.0f);
+	int MaxX = Cell(ViewPos.x + 1000.0f);
+	int MinY = Cell(ViewPos.y - 800.0f);
+	int MaxY = Cell(ViewPos.y + 800.0f);
+	for(int y = MinY; y <= MaxY; y++)
+	{
+		for(int x = MinX; x <= MaxX; x++)
+		{
+			int b = Bucket(x, y);
+			if(m_aBucketFirst[b] != -1 && ((m_aBucketMasks[b]>>SnappingClient)&1))
+				aNext[NumLists++] = m_aBucketFirst[b];
+		}
+	}
+
+	// merge the buckets to keep the items in order of creation
+	int Num = 0;
+	while(NumLists)
+	{
+		int Min = 0;
+		for(int l = 1; l < NumLists; l++)
+		{
+			if(aNext[l] < aNext[Min])
+				Min = l;
+		}
+
+		int i = aNext[Min];
+		const CItem *pItem = &m_pItems[i];
+		if(pItem->m_Next == -1)
+			aNext[Min] = aNext[--NumLists];
+		else
+			aNext[Min] = pItem->m_Next;
+
+		if(!((pItem->m_Mask>>SnappingClient)&1) || (pItem->m_Clip && Clipped(ViewPos, pItem->m_ClipPos)))
+			continue;
+		m_pCollected[Num++] = i;
+	}
+	*pNum = Num;
+	return m_pCollected;
+}
@@ -0,0 +1,118 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_SNAPITEMS_H
+#define GAME_SERVER_SNAPITEMS_H
+
+#include <stdint.h>
+
+#include <base/vmath.h>
+
+/*
+	Class: CSharedSnapItems
+		Snapshot items that look the same for every client, built once
+		per snapshot. The items are bucketed by the cell of their clip
+		position, so every client only looks at the items around its view.
+*/
+class CSharedSnapItems
+{
+public:
+	struct CItem
+	{
+		int m_Type;
+		int m_ID;
+		int m_Size;
+		int m_Offset;
+		int64_t m_Mask;
+		vec2 m_ClipPos;
+		bool m_Clip;
+		int m_Next; // next item in the same bucket, in order of creation
+	};
+
+private:
+	enum
+	{
+		// the table holds the items of the whole map, not only the ones
+		// around one client, so it grows far beyond one snapshot
+		MIN_ITEMS = 256,
+		MAX_ITEMS = 64*1024,
+		MAX_DATA = MAX_ITEMS*64,
+
+		CELL_SHIFT = 10,
+		NUM_BUCKETS = 256,
+		BUCKET_UNCLIPPED = NUM_BUCKETS, // items every client gets, wherever it looks
+	};
+
+	CItem *m_pItems;
+	int m_ItemsCapacity;
+	int m_NumItems;
+	char *m_pData;
+	int m_DataCapacity;
+	int m_DataSize;
+	int *m_pCollected;
+	int m_NumDropped;
+
+	int m_aBucketFirst[NUM_BUCKETS+1];
+	int m_aBucketLast[NUM_BUCKETS+1];
+	int64_t m_aBucketMasks[NUM_BUCKETS+1];
+
+	static int Cell(float Pos);
+	static int Bucket(int CellX, int CellY);
+	bool Grow(int NumItems, int DataSize);
+
+public:
+	CSharedSnapItems();
+	~CSharedSnapItems();
+
+	void Clear();
+
+	/*
+		Function: New
+			Adds an item to the snapshot.
+
+		Parameters:
+			Type - Snapshot item type.
+			ID - Snapshot item id.
+			Size - Size of the item data.
+			Mask - Clients that get the item.
+			ClipPos - Position the item is clipped at.
+			Clip - Whether the item is clipped at all.
+
+		Returns:
+			Zeroed memory for the item data, 0 if the table is full.
+			The memory is valid until the next call.
+	*/
+	void *New(int Type, int ID, int Size, int64_t Mask, vec2 ClipPos, bool Clip);
+
+	/*
+		Function: Collect
+			Finds the items a client gets from a view position, through
+			the buckets once there are more than a few items.
+
+		Parameters:
+			SnappingClient - Client the items are for.
+			ViewPos - Where the client looks at.
+			pNum - Receives the number of items found.
+
+		Returns:
+			The indices of the items in order of creation, valid until
+			the next item is added.
+	*/
+	const int *Collect(int SnappingClient, vec2 ViewPos, int *pNum);
+
+	/*
+		Function: CollectLinear
+			Same as <Collect>, but always looks at every item and writes
+			the indices to pIndices, which must hold <NumItems> entries.
+	*/
+	int CollectLinear(int SnappingClient, vec2 ViewPos, int *pIndices) const;
+
+	int NumItems() const { return m_NumItems; }
+	int NumDropped() const { return m_NumDropped; } // items that didn't fit since the last <Clear>
+	const CItem *Item(int Index) const { return &m_pItems[Index]; }
+	const void *ItemData(int Index) const { return m_pData + m_pItems[Index].m_Offset; }
+
+	// the view box of CGameWorld::NetworkClipped
+	static bool Clipped(vec2 ViewPos, vec2 CheckPos);
+};
+
+#endif
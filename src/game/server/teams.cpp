@@ -13,16 +13,21 @@ CGameTeams::CGameTeams(CGameContext *pGameContext) :
 void CGameTeams::Reset()
 {
 	m_Core.Reset();
+	m_TeeFinished = 0;
 	for (int i = 0; i < MAX_CLIENTS; ++i)
 	{
 		m_TeamState[i] = TEAMSTATE_EMPTY;
-		m_TeeFinished[i] = false;
 		m_MembersCount[i] = 0;
 		m_LastChat[i] = 0;
 		m_TeamLocked[i] = false;
 		m_IsSaving[i] = false;
 		m_Invited[i] = 0;
 	}
+
+	// everyone starts in TEAM_FLOCK
+	mem_zero(m_aTeamMembers, sizeof(m_aTeamMembers));
+	m_aTeamMembers[TEAM_FLOCK] = ~0ULL;
+	OnViewChange();
 }
 
 void CGameTeams::OnCharacterStart(int ClientID)
@@ -117,14 +122,16 @@ void CGameTeams::OnCharacterStart(int ClientID)
 
 		if(g_Config.m_SvTeam < 3 && g_Config.m_SvTeamMaxSize != 2 && g_Config.m_SvPauseable)
 		{
+			int64_t Mask = 0;
 			for(int i = 0; i < MAX_CLIENTS; ++i)
 			{
 				CPlayer* pPlayer = GetPlayer(i);
 				if(m_Core.Team(ClientID) == m_Core.Team(i) && pPlayer && (pPlayer->IsPlaying() || TeamLocked(m_Core.Team(ClientID))))
 				{
-					GameServer()->SendChatTarget(i, aBuf);
+					Mask |= CmaskOne(i);
 				}
 			}
+			GameServer()->SendChatMask(Mask, aBuf);
 		}
 	}
 }
@@ -149,7 +156,7 @@ void CGameTeams::OnCharacterFinish(int ClientID)
 	}
 	else
 	{
-		m_TeeFinished[ClientID] = true;
+		SetFinished(ClientID, true);
 
 		CheckTeamFinished(m_Core.Team(ClientID));
 	}
@@ -169,7 +176,7 @@ void CGameTeams::CheckTeamFinished(int Team)
 				CPlayer* pPlayer = GetPlayer(i);
 				if (pPlayer && pPlayer->IsPlaying())
 				{
-					m_TeeFinished[i] = false;
+					SetFinished(i, false);
 
 					TeamPlayers[PlayersCount++] = pPlayer;
 				}
@@ -227,12 +234,15 @@ void CGameTeams::SetForceCharacterTeam(int ClientID, int Team)
 		ForceLeaveTeam(ClientID);
 	else
 	{
-		m_TeeFinished[ClientID] = false;
+		SetFinished(ClientID, false);
 		if (Count(m_Core.Team(ClientID)) > 0)
 			m_MembersCount[m_Core.Team(ClientID)]--;
 	}
 
+	m_aTeamMembers[m_Core.Team(ClientID)] &= ~(1ULL << ClientID);
+	m_aTeamMembers[Team] |= 1ULL << ClientID;
 	m_Core.Team(ClientID, Team);
+	OnViewChange();
 
 	if (m_Core.Team(ClientID) != TEAM_SUPER)
 		m_MembersCount[m_Core.Team(ClientID)]++;
@@ -254,19 +264,13 @@ void CGameTeams::SetForceCharacterTeam(int ClientID, int Team)
 
 void CGameTeams::ForceLeaveTeam(int ClientID)
 {
-	m_TeeFinished[ClientID] = false;
+	SetFinished(ClientID, false);
 
 	if (m_Core.Team(ClientID) != TEAM_FLOCK
 			&& m_Core.Team(ClientID) != TEAM_SUPER
 			&& m_TeamState[m_Core.Team(ClientID)] != TEAMSTATE_EMPTY)
 	{
-		bool NoOneInOldTeam = true;
-		for (int i = 0; i < MAX_CLIENTS; ++i)
-			if (i != ClientID && m_Core.Team(ClientID) == m_Core.Team(i))
-			{
-				NoOneInOldTeam = false; //all good exists someone in old team
-				break;
-			}
+		bool NoOneInOldTeam = (m_aTeamMembers[m_Core.Team(ClientID)] & ~(1ULL << ClientID)) == 0;
 		if (NoOneInOldTeam)
 		{
 			m_TeamState[m_Core.Team(ClientID)] = TEAMSTATE_EMPTY;
@@ -309,69 +313,37 @@ void CGameTeams::onChangeTeamState(int Team, int State, int OldState)
 
 bool CGameTeams::TeamFinished(int Team)
 {
-	for (int i = 0; i < MAX_CLIENTS; ++i)
-		if (m_Core.Team(i) == Team && !m_TeeFinished[i])
-			return false;
-	return true;
+	return (m_aTeamMembers[Team] & ~m_TeeFinished) == 0;
 }
 
-int64_t CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
+void CGameTeams::UpdateViewMasks()
 {
-	int64_t Mask = 0;
-
+	CTeamViewMasks::CViewer aViewers[MAX_CLIENTS];
 	for (int i = 0; i < MAX_CLIENTS; ++i)
 	{
-		if (i == ExceptID)
-			continue; // Explicitly excluded
-		if (!GetPlayer(i))
-			continue; // Player doesn't exist
-
-		if (!(GetPlayer(i)->GetTeam() == -1 || GetPlayer(i)->IsPaused()))
-		{ // Not spectator
-			if (i != Asker)
-			{ // Actions of other players
-				if (!Character(i))
-					continue; // Player is currently dead
-				if (!GetPlayer(i)->m_ShowOthers)
-				{
-					if (m_Core.GetSolo(Asker))
-						continue; // When in solo part don't show others
-					if (m_Core.GetSolo(i))
-						continue; // When in solo part don't show others
-					if (m_Core.Team(i) != Team && m_Core.Team(i) != TEAM_SUPER)
-						continue; // In different teams
-				} // ShowOthers
-			} // See everything of yourself
-		}
-		else if (GetPlayer(i)->GetSpectatorID() != -1)
-		{ // Spectating specific player
-			if (GetPlayer(i)->GetSpectatorID() != Asker)
-			{ // Actions of other players
-				if (!Character(GetPlayer(i)->GetSpectatorID()))
-					continue; // Player is currently dead
-				if (!GetPlayer(i)->m_ShowOthers)
-				{
-					if (m_Core.GetSolo(Asker))
-						continue; // When in solo part don't show others
-					if (m_Core.GetSolo(GetPlayer(i)->GetSpectatorID()))
-						continue; // When in solo part don't show others
-					if (m_Core.Team(GetPlayer(i)->GetSpectatorID()) != Team && m_Core.Team(GetPlayer(i)->GetSpectatorID()) != TEAM_SUPER)
-						continue; // In different teams
-				} // ShowOthers
-			} // See everything of player you're spectating
-		}
-		else
-		{ // Freeview
-			if (GetPlayer(i)->m_SpecTeam)
-			{ // Show only players in own team when spectating
-				if (m_Core.Team(i) != Team && m_Core.Team(i) != TEAM_SUPER)
-					continue; // in different teams
-			}
-		}
-
-		Mask |= 1LL << i;
+		CPlayer *pPlayer = GetPlayer(i);
+		CTeamViewMasks::CViewer *pViewer = &aViewers[i];
+		pViewer->m_Active = pPlayer != 0;
+		pViewer->m_Spectating = !pPlayer || pPlayer->GetTeam() == -1 || pPlayer->IsPaused();
+		pViewer->m_SpectatorID = pPlayer ? pPlayer->GetSpectatorID() : -1;
+		pViewer->m_SpecTeam = pPlayer && pPlayer->m_SpecTeam;
+		pViewer->m_ShowOthers = pPlayer && pPlayer->m_ShowOthers;
+		pViewer->m_Alive = Character(i) != 0;
 	}
-	return Mask;
+	m_ViewMasks.Update(aViewers, &m_Core);
+
+	m_ViewMasksDirty = false;
+	m_ViewMasksTick = Server()->Tick();
+}
+
+int64_t CGameTeams::TeamMask(int Team, int ExceptID, int Asker)
+{
+	// rebuilt at least once per tick, in case a change wasn't reported
+	if (m_ViewMasksDirty || m_ViewMasksTick != Server()->Tick())
+		UpdateViewMasks();
+
+	bool AskerSolo = Asker >= 0 && Asker < MAX_CLIENTS && m_Core.GetSolo(Asker);
+	return m_ViewMasks.Mask(Team, ExceptID, Asker, AskerSolo);
 }
 
 int CGameTeams::GetDDRaceState(CPlayer* Player)
@@ -562,7 +534,7 @@ void CGameTeams::OnFinish(CPlayer* Player, float Time, const char *pTimestamp)
 
 void CGameTeams::OnCharacterSpawn(int ClientID)
 {
-	m_Core.SetSolo(ClientID, false);
+	SetSolo(ClientID, false);
 
 	if (m_Core.Team(ClientID) >= TEAM_SUPER || !m_TeamLocked[m_Core.Team(ClientID)])
 		SetForceCharacterTeam(ClientID, 0);
@@ -572,7 +544,7 @@ void CGameTeams::OnCharacterDeath(int ClientID, int Weapon)
 {
 	GameServer()->m_apPlayers[ClientID]->Respawn(); // queue the spawn as kill tiles don't
 
-	m_Core.SetSolo(ClientID, false);
+	SetSolo(ClientID, false);
 
 	int Team = m_Core.Team(ClientID);
 	bool Locked = TeamLocked(Team) && Weapon != WEAPON_GAME;
@@ -609,6 +581,12 @@ void CGameTeams::OnCharacterDeath(int ClientID, int Weapon)
 	}
 }
 
+void CGameTeams::SetSolo(int ClientID, bool Solo)
+{
+	m_Core.SetSolo(ClientID, Solo);
+	OnViewChange();
+}
+
 void CGameTeams::SetTeamLock(int Team, bool Lock)
 {
 	if(Team > TEAM_FLOCK && Team < TEAM_SUPER)
@@ -642,7 +620,7 @@ void CGameTeams::KillSavedTeam(int Team)
 		{
 			// Set so that no finish is accidentally given to some of the players
 			GameServer()->m_apPlayers[i]->GetCharacter()->m_DDraceState = DDRACE_NONE;
-			m_TeeFinished[i] = false;
+			SetFinished(i, false);
 		}
 	}
 
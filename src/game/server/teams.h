@@ -5,18 +5,27 @@
 #include <game/teamscore.h>
 #include <game/server/gamecontext.h>
 #include <game/server/player.h>
+#include <game/server/teamviewmasks.h>
 
 class CGameTeams
 {
 	int m_TeamState[MAX_CLIENTS];
 	int m_MembersCount[MAX_CLIENTS];
-	bool m_TeeFinished[MAX_CLIENTS];
+	// by m_Core.Team, +1 for TEAM_SUPER
+	uint64_t m_aTeamMembers[MAX_CLIENTS+1];
+	uint64_t m_TeeFinished;
 	bool m_TeamLocked[MAX_CLIENTS];
 	bool m_IsSaving[MAX_CLIENTS];
 	uint64_t m_Invited[MAX_CLIENTS];
 
 	class CGameContext * m_pGameContext;
 
+	// who sees the events of whom, rebuilt by UpdateViewMasks
+	bool m_ViewMasksDirty;
+	int m_ViewMasksTick;
+	CTeamViewMasks m_ViewMasks;
+
+	void UpdateViewMasks();
 	void CheckTeamFinished(int ClientID);
 	bool TeamFinished(int Team);
 	void OnTeamFinish(CPlayer** Players, unsigned int Size, float Time, const char *pTimestamp);
@@ -62,6 +71,10 @@ public:
 	void onChangeTeamState(int Team, int State, int OldState);
 
 	int64_t TeamMask(int Team, int ExceptID = -1, int Asker = -1);
+	// call when something TeamMask depends on changes: teams, solo, a
+	// character spawning or dying, pausing, spectating or show others
+	void OnViewChange() { m_ViewMasksDirty = true; }
+	uint64_t Members(int Team) const { return m_aTeamMembers[Team]; }
 
 	int Count(int Team) const;
 
@@ -71,6 +84,7 @@ public:
 
 	void Reset();
 
+	void SetSolo(int ClientID, bool Solo);
 	void SetTeamLock(int Team, bool Lock);
 	void ResetInvited(int Team);
 	void SetClientInvited(int Team, int ClientID, bool Invited);
@@ -87,7 +101,7 @@ public:
 
 	bool TeeFinished(int ClientID)
 	{
-		return m_TeeFinished[ClientID];
+		return m_TeeFinished & 1ULL << ClientID;
 	}
 
 	int GetTeamState(int Team)
@@ -110,7 +124,10 @@ public:
 
 	void SetFinished(int ClientID, bool finished)
 	{
-		m_TeeFinished[ClientID] = finished;
+		if(finished)
+			m_TeeFinished |= 1ULL << ClientID;
+		else
+			m_TeeFinished &= ~(1ULL << ClientID);
 	}
 
 	void SetSaving(int TeamID, bool Value)
@@ -0,0 +1,72 @@
+/* (c) Shereef Marzouk. See "licence DDRace.txt" and the readme.txt in the root of the distribution for more information. */
+#include <base/system.h>
+
+#include "teamviewmasks.h"
+
+CTeamViewMasks::CTeamViewMasks()
+{
+	m_ViewAll = 0;
+	mem_zero(m_aViewTeam, sizeof(m_aViewTeam));
+	mem_zero(m_aViewTeamSpec, sizeof(m_aViewTeamSpec));
+	mem_zero(m_aViewSubject, sizeof(m_aViewSubject));
+}
+
+void CTeamViewMasks::Update(const CViewer *pViewers, CTeamsCore *pCore)
+{
+	m_ViewAll = 0;
+	mem_zero(m_aViewTeam, sizeof(m_aViewTeam));
+	mem_zero(m_aViewTeamSpec, sizeof(m_aViewTeamSpec));
+	mem_zero(m_aViewSubject, sizeof(m_aViewSubject));
+
+	for(int i = 0; i < MAX_CLIENTS; ++i)
+	{
+		const CViewer *pViewer = &pViewers[i];
+		if(!pViewer->m_Active)
+			continue;
+
+		uint64_t Bit = 1ULL << i;
+		int Subject;
+		if(!pViewer->m_Spectating)
+			Subject = i; // Not spectator
+		else if(pViewer->m_SpectatorID >= 0 && pViewer->m_SpectatorID < MAX_CLIENTS)
+			Subject = pViewer->m_SpectatorID; // Spectating specific player
+		else
+		{ // Freeview
+			if(pViewer->m_SpecTeam)
+			{
+				// only the own team, even if the asker is in a solo part
+				m_aViewTeam[pCore->Team(i)] |= Bit;
+				m_aViewTeamSpec[pCore->Team(i)] |= Bit;
+			}
+			else
+				m_ViewAll |= Bit;
+			continue;
+		}
+
+		// everything of yourself or of the player you're spectating
+		m_aViewSubject[Subject] |= Bit;
+
+		// the others only while the player is alive
+		if(!pViewers[Subject].m_Alive)
+			continue;
+		if(pViewer->m_ShowOthers)
+			m_ViewAll |= Bit;
+		else if(!pCore->GetSolo(Subject))
+			m_aViewTeam[pCore->Team(Subject)] |= Bit;
+	}
+}
+
+uint64_t CTeamViewMasks::Mask(int Team, int ExceptID, int Asker, bool AskerSolo) const
+{
+	// spectators of a team still see it when the asker is in a solo part
+	const uint64_t *pViewTeam = AskerSolo ? m_aViewTeamSpec : m_aViewTeam;
+
+	uint64_t Mask = m_ViewAll | pViewTeam[TEAM_SUPER];
+	if(Team >= 0 && Team < TEAM_SUPER)
+		Mask |= pViewTeam[Team];
+	if(Asker >= 0 && Asker < MAX_CLIENTS)
+		Mask |= m_aViewSubject[Asker];
+	if(ExceptID >= 0 && ExceptID < MAX_CLIENTS)
+		Mask &= ~(1ULL << ExceptID); // Explicitly excluded
+	return Mask;
+}
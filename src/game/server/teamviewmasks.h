@@ -0,0 +1,60 @@
+/* (c) Shereef Marzouk. See "licence DDRace.txt" and the readme.txt in the root of the distribution for more information. */
+#ifndef GAME_SERVER_TEAMVIEWMASKS_H
+#define GAME_SERVER_TEAMVIEWMASKS_H
+
+#include <stdint.h>
+
+#include <game/teamscore.h>
+
+/*
+	Class: CTeamViewMasks
+		Who sees the events of whom, kept in a few bitsets:
+		the viewers that see everything, the viewers of each team and
+		the viewers of each player, meaning the player itself and
+		whoever spectates them.
+*/
+class CTeamViewMasks
+{
+	uint64_t m_ViewAll;
+	uint64_t m_aViewTeam[MAX_CLIENTS+1];
+	uint64_t m_aViewTeamSpec[MAX_CLIENTS+1];
+	uint64_t m_aViewSubject[MAX_CLIENTS];
+
+public:
+	// what the view of a client depends on
+	struct CViewer
+	{
+		bool m_Active; // the player exists
+		bool m_Spectating; // spectator or paused
+		int m_SpectatorID;
+		bool m_SpecTeam;
+		bool m_ShowOthers;
+		bool m_Alive; // has a character
+	};
+
+	CTeamViewMasks();
+
+	/*
+		Function: Update
+			Rebuilds the bitsets with one pass over the clients.
+
+		Parameters:
+			pViewers - MAX_CLIENTS viewers, by client id.
+			pCore - Teams and solo parts of the clients.
+	*/
+	void Update(const CViewer *pViewers, CTeamsCore *pCore);
+
+	/*
+		Function: Mask
+			Clients that see an event of a team.
+
+		Parameters:
+			Team - Team the event happens in.
+			ExceptID - Client to leave out, -1 for none.
+			Asker - Client the event comes from, -1 for none.
+			AskerSolo - Whether the asker is in a solo part.
+	*/
+	uint64_t Mask(int Team, int ExceptID, int Asker, bool AskerSolo) const;
+};
+
+#endif
@@ -611,3 +611,191 @@ void CTeeHistorian::Finish()
 
 	Write(Buffer.Data(), Buffer.Size());
 }
+
+CTeeHistorianReader::CTeeHistorianReader()
+{
+	m_pHeader = "";
+	m_Finished = true;
+	m_Tick = 0;
+	m_InPlayers = false;
+	m_LastClientID = -1;
+}
+
+bool CTeeHistorianReader::Open(const void *pData, int DataSize)
+{
+	const char *pStart = (const char *)pData;
+	if(DataSize < (int)sizeof(TEEHISTORIAN_UUID) || mem_comp(pStart, &TEEHISTORIAN_UUID, sizeof(TEEHISTORIAN_UUID)) != 0)
+		return false;
+
+	// the json header is null terminated
+	const char *pHeader = pStart + sizeof(TEEHISTORIAN_UUID);
+	const char *pEnd = pStart + DataSize;
+	const char *pHeaderEnd = pHeader;
+	while(pHeaderEnd < pEnd && *pHeaderEnd)
+		pHeaderEnd++;
+	if(pHeaderEnd == pEnd)
+		return false;
+
+	m_pHeader = pHeader;
+	m_Unpacker.Reset(pHeaderEnd + 1, pEnd - (pHeaderEnd + 1));
+	m_Finished = false;
+
+	// tick 0 is implicit, the game starts as tick 1
+	m_Tick = 0;
+	m_InPlayers = false;
+	m_LastClientID = -1;
+	mem_zero(m_aPlayers, sizeof(m_aPlayers));
+	return true;
+}
+
+void CTeeHistorianReader::PlayerData(int ClientID)
+{
+	// see EnsureTickWrittenPlayerData, the writer leaves the tick out
+	// as long as the client ids keep it recognizable
+	if(!m_InPlayers || ClientID <= m_LastClientID)
+	{
+		m_Tick++;
+		m_InPlayers = true;
+	}
+	m_LastClientID = ClientID;
+}
+
+int CTeeHistorianReader::Next(CItem *pItem)
+{
+	if(m_Finished)
+		return ITEM_FINISH;
+
+	while(true)
+	{
+		int Chunk = m_Unpacker.GetInt();
+		int ClientID = -1;
+		if(Chunk >= 0)
+		{
+			ClientID = Chunk;
+			Chunk = -TEEHISTORIAN_NONE;
+		}
+		else if(-Chunk != TEEHISTORIAN_FINISH && -Chunk != TEEHISTORIAN_TICK_SKIP && -Chunk != TEEHISTORIAN_EX)
+		{
+			ClientID = m_Unpacker.GetInt();
+		}
+
+		if(m_Unpacker.Error())
+			return ITEM_ERROR;
+		if(-Chunk != TEEHISTORIAN_CONSOLE_COMMAND && -Chunk != TEEHISTORIAN_FINISH && -Chunk != TEEHISTORIAN_TICK_SKIP
+			&& -Chunk != TEEHISTORIAN_EX && (ClientID < 0 || ClientID >= MAX_CLIENTS))
+			return ITEM_ERROR;
+
+		pItem->m_ClientID = ClientID;
+		CPlayer *pPlayer = ClientID >= 0 && ClientID < MAX_CLIENTS ? &m_aPlayers[ClientID] : 0;
+
+		switch(-Chunk)
+		{
+		case TEEHISTORIAN_NONE:
+		{
+			int dx = m_Unpacker.GetInt();
+			int dy = m_Unpacker.GetInt();
+			if(!pPlayer->m_Alive)
+				return ITEM_ERROR;
+			PlayerData(ClientID);
+			pPlayer->m_X += dx;
+			pPlayer->m_Y += dy;
+			pItem->m_Type = ITEM_PLAYER;
+			break;
+		}
+		case TEEHISTORIAN_PLAYER_NEW:
+			PlayerData(ClientID);
+			pPlayer->m_Alive = true;
+			pPlayer->m_X = m_Unpacker.GetInt();
+			pPlayer->m_Y = m_Unpacker.GetInt();
+			pItem->m_Type = ITEM_PLAYER;
+			break;
+		case TEEHISTORIAN_PLAYER_OLD:
+			PlayerData(ClientID);
+			pPlayer->m_Alive = false;
+			pItem->m_Type = ITEM_DEAD_PLAYER;
+			break;
+		case TEEHISTORIAN_TICK_SKIP:
+		{
+			int dt = m_Unpacker.GetInt();
+			if(dt < 0)
+				return ITEM_ERROR;
+			m_Tick += 1 + dt;
+			m_InPlayers = true;
+			m_LastClientID = -1;
+			continue;
+		}
+		case TEEHISTORIAN_INPUT_NEW:
+		case TEEHISTORIAN_INPUT_DIFF:
+		{
+			int *pInput = (int *)&pPlayer->m_Input;
+			for(int i = 0; i < (int)(sizeof(pPlayer->m_Input) / sizeof(int)); i++)
+			{
+				int Value = m_Unpacker.GetInt();
+				pInput[i] = -Chunk == TEEHISTORIAN_INPUT_DIFF ? pInput[i] + Value : Value;
+			}
+			pItem->m_Input = pPlayer->m_Input;
+			pItem->m_Type = ITEM_INPUT;
+			break;
+		}
+		case TEEHISTORIAN_MESSAGE:
+			pItem->m_DataSize = m_Unpacker.GetInt();
+			pItem->m_pData = pItem->m_DataSize >= 0 ? m_Unpacker.GetRaw(pItem->m_DataSize) : 0;
+			pItem->m_Type = ITEM_MESSAGE;
+			break;
+		case TEEHISTORIAN_JOIN:
+			pItem->m_Type = ITEM_JOIN;
+			break;
+		case TEEHISTORIAN_DROP:
+			pItem->m_pReason = m_Unpacker.GetString(0);
+			pItem->m_Type = ITEM_DROP;
+			break;
+		case TEEHISTORIAN_CONSOLE_COMMAND:
+		{
+			pItem->m_FlagMask = m_Unpacker.GetInt();
+			pItem->m_pCommand = m_Unpacker.GetString(0);
+			int NumArgs = m_Unpacker.GetInt();
+			pItem->m_NumArgs = 0;
+			for(int i = 0; i < NumArgs && !m_Unpacker.Error(); i++)
+			{
+				const char *pArg = m_Unpacker.GetString(0);
+				if(i < MAX_ARGS)
+					pItem->m_apArgs[pItem->m_NumArgs++] = pArg;
+			}
+			pItem->m_Type = ITEM_CONSOLE_COMMAND;
+			break;
+		}
+		case TEEHISTORIAN_EX:
+		{
+			const unsigned char *pUuid = m_Unpacker.GetRaw(sizeof(pItem->m_Uuid));
+			if(pUuid)
+				mem_copy(&pItem->m_Uuid, pUuid, sizeof(pItem->m_Uuid));
+			pItem->m_DataSize = m_Unpacker.GetInt();
+			pItem->m_pData = pItem->m_DataSize >= 0 ? m_Unpacker.GetRaw(pItem->m_DataSize) : 0;
+			pItem->m_Type = ITEM_EX;
+			break;
+		}
+		case TEEHISTORIAN_FINISH:
+			m_Finished = true;
+			pItem->m_Type = ITEM_FINISH;
+			break;
+		default:
+			return ITEM_ERROR;
+		}
+
+		if(pItem->m_Type == ITEM_PLAYER)
+		{
+			pItem->m_X = pPlayer->m_X;
+			pItem->m_Y = pPlayer->m_Y;
+		}
+
+		if(m_Unpacker.Error() || ((pItem->m_Type == ITEM_MESSAGE || pItem->m_Type == ITEM_EX) && !pItem->m_pData))
+			return ITEM_ERROR;
+
+		// everything but player data is recorded after the tick ran
+		if(pItem->m_Type != ITEM_PLAYER && pItem->m_Type != ITEM_DEAD_PLAYER)
+			m_InPlayers = false;
+
+		pItem->m_Tick = m_Tick;
+		return pItem->m_Type;
+	}
+}
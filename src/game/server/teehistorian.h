@@ -108,3 +108,91 @@ private:
 	int m_MaxClientID;
 	CPlayer m_aPrevPlayers[MAX_CLIENTS];
 };
+
+/*
+	Class: CTeeHistorianReader
+		Reads back what <CTeeHistorian> wrote. The ticks the writer left
+		implicit are recovered, so every item carries the tick it belongs
+		to. Player positions and inputs come out absolute.
+
+		Player items describe the state after their tick was simulated,
+		all other items arrived between their tick and the next one.
+*/
+class CTeeHistorianReader
+{
+public:
+	enum
+	{
+		ITEM_ERROR=-1,
+		ITEM_FINISH=0,
+		ITEM_PLAYER,
+		ITEM_DEAD_PLAYER,
+		ITEM_INPUT,
+		ITEM_MESSAGE,
+		ITEM_JOIN,
+		ITEM_DROP,
+		ITEM_CONSOLE_COMMAND,
+		ITEM_EX,
+
+		MAX_ARGS=16,
+	};
+
+	struct CItem
+	{
+		int m_Type;
+		int m_Tick;
+		int m_ClientID;
+
+		// ITEM_PLAYER
+		int m_X;
+		int m_Y;
+
+		// ITEM_INPUT
+		CNetObj_PlayerInput m_Input;
+
+		// ITEM_MESSAGE and ITEM_EX
+		CUuid m_Uuid;
+		const void *m_pData;
+		int m_DataSize;
+
+		// ITEM_DROP
+		const char *m_pReason;
+
+		// ITEM_CONSOLE_COMMAND, arguments beyond MAX_ARGS are dropped
+		int m_FlagMask;
+		const char *m_pCommand;
+		int m_NumArgs;
+		const char *m_apArgs[MAX_ARGS];
+	};
+
+	CTeeHistorianReader();
+
+	// the data is not copied and has to stay around while reading
+	bool Open(const void *pData, int DataSize);
+	const char *Header() const { return m_pHeader; }
+
+	// returns the type of the item, ITEM_ERROR on truncated or broken data
+	int Next(CItem *pItem);
+	int Tick() const { return m_Tick; }
+
+private:
+	void PlayerData(int ClientID);
+
+	struct CPlayer
+	{
+		bool m_Alive;
+		int m_X;
+		int m_Y;
+
+		CNetObj_PlayerInput m_Input;
+	};
+
+	CUnpacker m_Unpacker;
+	const char *m_pHeader;
+	bool m_Finished;
+
+	int m_Tick;
+	bool m_InPlayers;
+	int m_LastClientID;
+	CPlayer m_aPlayers[MAX_CLIENTS];
+};
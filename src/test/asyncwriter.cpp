@@ -0,0 +1,159 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <engine/shared/asyncwriter.h>
+
+#include <zlib.h>
+
+static const int s_DataSize = 300000;
+
+static void FillData(unsigned char *pData, int Size)
+{
+	for(int i = 0; i < Size; i++)
+		pData[i] = (i*7 + i/1000)&0xff;
+}
+
+static void WriteRecords(CAsyncWriter *pWriter, const unsigned char *pData, int Size)
+{
+	// uneven record sizes to hit the ring buffer wrap around
+	for(int Offset = 0, i = 0; Offset < Size; i++)
+	{
+		int Chunk = min(1 + (i*37)%900, Size - Offset);
+		pWriter->Write(pData + Offset, Chunk);
+		Offset += Chunk;
+		if(i%16 == 0)
+			pWriter->Flush();
+	}
+}
+
+TEST(AsyncWriter, Plain)
+{
+	CTestInfo Info;
+	static unsigned char s_aData[s_DataSize];
+	FillData(s_aData, s_DataSize);
+
+	CAsyncWriter Writer;
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	ASSERT_TRUE(Writer.Open(File, 4096, 0, 0));
+	WriteRecords(&Writer, s_aData, s_DataSize);
+	Writer.Close();
+	EXPECT_EQ(Writer.Backlog(), 0);
+	EXPECT_LE(Writer.PeakBacklog(), 4096);
+
+	static unsigned char s_aRead[s_DataSize+1];
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_read(File, s_aRead, sizeof(s_aRead)), (unsigned)s_DataSize);
+	io_close(File);
+	EXPECT_EQ(mem_comp(s_aData, s_aRead, s_DataSize), 0);
+
+	fs_remove(Info.m_aFilename);
+}
+
+TEST(AsyncWriter, Compressed)
+{
+	CTestInfo Info;
+	static unsigned char s_aData[s_DataSize];
+	FillData(s_aData, s_DataSize);
+
+	CAsyncWriter Writer;
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	ASSERT_TRUE(Writer.Open(File, 64*1024, 0, CAsyncWriter::FLAG_COMPRESS));
+	WriteRecords(&Writer, s_aData, s_DataSize);
+	Writer.Close();
+
+	gzFile GzFile = gzopen(Info.m_aFilename, "rb");
+	ASSERT_TRUE(GzFile);
+	static unsigned char s_aRead[s_DataSize+1];
+	EXPECT_EQ(gzread(GzFile, s_aRead, sizeof(s_aRead)), s_DataSize);
+	gzclose(GzFile);
+	EXPECT_EQ(mem_comp(s_aData, s_aRead, s_DataSize), 0);
+
+	fs_remove(Info.m_aFilename);
+}
+
+TEST(AsyncWriter, Reopen)
+{
+	CTestInfo Info;
+	unsigned char aData[] = {1, 2, 3, 4};
+
+	CAsyncWriter Writer;
+	for(int i = 0; i < 2; i++)
+	{
+		IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+		ASSERT_TRUE(File);
+		ASSERT_TRUE(Writer.Open(File, 16, 0, 0));
+		EXPECT_FALSE(Writer.Open(File, 16, 0, 0));
+		Writer.Write(aData, sizeof(aData));
+		Writer.Close();
+		EXPECT_FALSE(Writer.IsOpen());
+	}
+
+	fs_remove(Info.m_aFilename);
+}
+
+class CTestConsumer : public CAsyncWriter::IConsumer
+{
+public:
+	int m_NumStarts;
+	int m_NumRecords;
+	int m_NumShutdowns;
+	bool m_Ok;
+
+	CTestConsumer() : m_NumStarts(0), m_NumRecords(0), m_NumShutdowns(0), m_Ok(true) {}
+
+	virtual void OnStart() { m_NumStarts++; }
+	virtual void OnRecord(const void *pData, int Size)
+	{
+		// the header holds the record number, the data its bytes
+		const unsigned char *pRecord = (const unsigned char *)pData;
+		int Number;
+		mem_copy(&Number, pRecord, sizeof(Number));
+		if(m_NumStarts != 1 || m_NumShutdowns || Number != m_NumRecords || Size != (int)sizeof(int) + Number%900)
+			m_Ok = false;
+		for(int i = sizeof(int); i < Size && m_Ok; i++)
+		{
+			if(pRecord[i] != (unsigned char)(Number + i))
+				m_Ok = false;
+		}
+		m_NumRecords++;
+	}
+	virtual void OnDrained(bool Shutdown)
+	{
+		if(Shutdown)
+			m_NumShutdowns++;
+	}
+};
+
+TEST(AsyncWriter, Records)
+{
+	CTestConsumer Consumer;
+	CAsyncWriter Writer;
+	ASSERT_TRUE(Writer.OpenRecords(&Consumer, 4096, 1024));
+
+	// uneven record sizes to hit the ring buffer wrap around
+	unsigned char aData[1024];
+	for(int Number = 0; Number < 2000; Number++)
+	{
+		int Size = Number%900;
+		for(int i = 0; i < Size; i++)
+			aData[i] = (unsigned char)(Number + sizeof(int) + i);
+		Writer.WriteRecord(&Number, sizeof(Number), aData, Size);
+		if(Number%16 == 0)
+			Writer.Flush();
+	}
+	// too large for the consumer
+	Writer.WriteRecord(aData, sizeof(aData), aData, 1);
+	Writer.Close();
+
+	EXPECT_TRUE(Consumer.m_Ok);
+	EXPECT_EQ(Consumer.m_NumStarts, 1);
+	EXPECT_EQ(Consumer.m_NumRecords, 2000);
+	EXPECT_EQ(Consumer.m_NumShutdowns, 1);
+	EXPECT_EQ(Writer.Backlog(), 0);
+	EXPECT_LE(Writer.PeakBacklog(), 4096);
+}
@@ -0,0 +1,432 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/map.h>
+#include <engine/shared/config.h>
+#include <engine/shared/datafile.h>
+#include <engine/storage.h>
+#include <game/collision.h>
+#include <game/layers.h>
+#include <game/mapitems.h>
+
+#include <vector>
+
+// the per pixel samplers the intersection functions used before they walked
+// the grid tile by tile, kept here as the reference
+static int OldIntersectLine(CCollision *pCollision, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision)
+{
+	float Distance = distance(Pos0, Pos1);
+	int End(Distance + 1);
+	vec2 Last = Pos0;
+	for(int i = 0; i <= End; i++)
+	{
+		float a = i / (float)End;
+		vec2 Pos = mix(Pos0, Pos1, a);
+		int ix = round_to_int(Pos.x);
+		int iy = round_to_int(Pos.y);
+		if(pCollision->CheckPoint(ix, iy))
+		{
+			*pOutCollision = Pos;
+			*pOutBeforeCollision = Last;
+			return pCollision->GetCollisionAt(ix, iy);
+		}
+		Last = Pos;
+	}
+	*pOutCollision = Pos1;
+	*pOutBeforeCollision = Pos1;
+	return 0;
+}
+
+static int OldIntersectLineTele(CCollision *pCollision, bool Hook, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision, int *pTeleNr)
+{
+	float Distance = distance(Pos0, Pos1);
+	int End(Distance + 1);
+	vec2 Last = Pos0;
+	int dx = 0, dy = 0;
+	ThroughOffset(Pos0, Pos1, &dx, &dy);
+	for(int i = 0; i <= End; i++)
+	{
+		float a = i / (float)End;
+		vec2 Pos = mix(Pos0, Pos1, a);
+		int ix = round_to_int(Pos.x);
+		int iy = round_to_int(Pos.y);
+
+		int Index = pCollision->GetPureMapIndex(Pos);
+		if(Hook)
+			*pTeleNr = g_Config.m_SvOldTeleportHook ? pCollision->IsTeleport(Index) : pCollision->IsTeleportHook(Index);
+		else
+			*pTeleNr = g_Config.m_SvOldTeleportWeapons ? pCollision->IsTeleport(Index) : pCollision->IsTeleportWeapon(Index);
+		if(*pTeleNr)
+		{
+			*pOutCollision = Pos;
+			*pOutBeforeCollision = Last;
+			return Hook ? TILE_TELEINHOOK : TILE_TELEINWEAPON;
+		}
+
+		int Hit = 0;
+		if(pCollision->CheckPoint(ix, iy))
+		{
+			if(!Hook || !pCollision->IsThrough(ix, iy, dx, dy, Pos0, Pos1))
+				Hit = pCollision->GetCollisionAt(ix, iy);
+		}
+		else if(Hook && pCollision->IsHookBlocker(ix, iy, Pos0, Pos1))
+			Hit = TILE_NOHOOK;
+		if(Hit)
+		{
+			*pOutCollision = Pos;
+			*pOutBeforeCollision = Last;
+			return Hit;
+		}
+		Last = Pos;
+	}
+	*pOutCollision = Pos1;
+	*pOutBeforeCollision = Pos1;
+	return 0;
+}
+
+enum
+{
+	OLD_NOLASER=0,
+	OLD_NOLASER_NW,
+	OLD_AIR,
+};
+
+static int OldIntersectPixels(CCollision *pCollision, int Type, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision)
+{
+	float d = distance(Pos0, Pos1);
+	vec2 Last = Pos0;
+	for(float f = 0; f < d; f++)
+	{
+		float a = f / d;
+		vec2 Pos = mix(Pos0, Pos1, a);
+		int ix = round_to_int(Pos.x);
+		int iy = round_to_int(Pos.y);
+		int Nx = clamp(ix / 32, 0, pCollision->GetWidth() - 1);
+		int Ny = clamp(iy / 32, 0, pCollision->GetHeight() - 1);
+
+		int Hit = -2;
+		if(Type == OLD_NOLASER)
+		{
+			int Index = pCollision->GetIndex(Nx, Ny);
+			if(Index == TILE_SOLID || Index == TILE_NOHOOK || Index == TILE_NOLASER || pCollision->GetFIndex(Nx, Ny) == TILE_NOLASER)
+				Hit = pCollision->GetFIndex(Nx, Ny) == TILE_NOLASER ? pCollision->GetFCollisionAt(Pos.x, Pos.y) : pCollision->GetCollisionAt(Pos.x, Pos.y);
+		}
+		else if(Type == OLD_NOLASER_NW)
+		{
+			if(pCollision->IsNoLaser(ix, iy) || pCollision->IsFNoLaser(ix, iy))
+				Hit = pCollision->IsNoLaser(ix, iy) ? pCollision->GetCollisionAt(Pos.x, Pos.y) : pCollision->GetFCollisionAt(Pos.x, Pos.y);
+		}
+		else
+		{
+			if(pCollision->IsSolid(ix, iy) || (!pCollision->GetTile(ix, iy) && !pCollision->GetFTile(ix, iy)))
+			{
+				if(!pCollision->GetTile(ix, iy) && !pCollision->GetFTile(ix, iy))
+					Hit = -1;
+				else
+					Hit = !pCollision->GetTile(ix, iy) ? pCollision->GetTile(ix, iy) : pCollision->GetFTile(ix, iy);
+			}
+		}
+		if(Hit != -2)
+		{
+			*pOutCollision = Pos;
+			*pOutBeforeCollision = Last;
+			return Hit;
+		}
+		Last = Pos;
+	}
+	*pOutCollision = Pos1;
+	*pOutBeforeCollision = Pos1;
+	return 0;
+}
+
+// the list based version CCharacter used to walk over
+static std::vector<int> OldGetMapIndices(CCollision *pCollision, vec2 PrevPos, vec2 Pos)
+{
+	std::vector<int> Indices;
+	float d = distance(PrevPos, Pos);
+	int End(d + 1);
+	int Width = pCollision->GetWidth();
+	int Height = pCollision->GetHeight();
+	if(!d)
+	{
+		int Index = clamp((int)Pos.y / 32, 0, Height - 1) * Width + clamp((int)Pos.x / 32, 0, Width - 1);
+		if(pCollision->TileExists(Index))
+			Indices.push_back(Index);
+		return Indices;
+	}
+	int LastIndex = 0;
+	for(int i = 0; i < End; i++)
+	{
+		vec2 Tmp = mix(PrevPos, Pos, i / d);
+		int Index = clamp((int)Tmp.y / 32, 0, Height - 1) * Width + clamp((int)Tmp.x / 32, 0, Width - 1);
+		if(pCollision->TileExists(Index) && LastIndex != Index)
+		{
+			Indices.push_back(Index);
+			LastIndex = Index;
+		}
+	}
+	return Indices;
+}
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+static float RandomFloat(unsigned *pSeed, float Min, float Max)
+{
+	return Min + (Max - Min) * (Random(pSeed) % 100000) / 100000.0f;
+}
+
+// writes a small map with a game, front and tele layer full of the tiles the
+// intersection functions care about
+static void WriteTileMap(IStorage *pStorage, const char *pFilename, int Width, int Height)
+{
+	const int aGameTiles[] = {TILE_AIR, TILE_AIR, TILE_AIR, TILE_AIR, TILE_AIR, TILE_SOLID, TILE_NOHOOK, TILE_NOLASER, TILE_DEATH, TILE_THROUGH_ALL, TILE_THROUGH_DIR, TILE_FREEZE};
+	const int aFrontTiles[] = {TILE_AIR, TILE_AIR, TILE_AIR, TILE_AIR, TILE_AIR, TILE_AIR, TILE_NOLASER, TILE_DEATH, TILE_THROUGH, TILE_THROUGH_CUT, TILE_THROUGH_ALL, TILE_THROUGH_DIR};
+	const int aTeleTypes[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, TILE_TELEIN, TILE_TELEINHOOK, TILE_TELEINWEAPON};
+	const int aRotations[] = {ROTATION_0, ROTATION_90, ROTATION_180, ROTATION_270};
+
+	unsigned Seed = 1337;
+	CTile *pGame = new CTile[Width*Height];
+	CTile *pFront = new CTile[Width*Height];
+	CTeleTile *pTele = new CTeleTile[Width*Height];
+	mem_zero(pGame, Width*Height*sizeof(CTile));
+	mem_zero(pFront, Width*Height*sizeof(CTile));
+	mem_zero(pTele, Width*Height*sizeof(CTeleTile));
+	for(int i = 0; i < Width*Height; i++)
+	{
+		pGame[i].m_Index = aGameTiles[Random(&Seed)%(sizeof(aGameTiles)/sizeof(int))];
+		pGame[i].m_Flags = aRotations[Random(&Seed)%4];
+		pFront[i].m_Index = aFrontTiles[Random(&Seed)%(sizeof(aFrontTiles)/sizeof(int))];
+		pFront[i].m_Flags = aRotations[Random(&Seed)%4];
+		pTele[i].m_Type = aTeleTypes[Random(&Seed)%(sizeof(aTeleTypes)/sizeof(int))];
+		pTele[i].m_Number = pTele[i].m_Type ? 1 + Random(&Seed)%10 : 0;
+	}
+
+	CDataFileWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage, pFilename));
+
+	CMapItemVersion Version;
+	Version.m_Version = CMapItemVersion::CURRENT_VERSION;
+	Writer.AddItem(MAPITEMTYPE_VERSION, 0, sizeof(Version), &Version);
+
+	CMapItemGroup Group;
+	mem_zero(&Group, sizeof(Group));
+	Group.m_Version = CMapItemGroup::CURRENT_VERSION;
+	Group.m_ParallaxX = 100;
+	Group.m_ParallaxY = 100;
+	Group.m_StartLayer = 0;
+	Group.m_NumLayers = 3;
+	Writer.AddItem(MAPITEMTYPE_GROUP, 0, sizeof(Group), &Group);
+
+	const int aFlags[] = {TILESLAYERFLAG_GAME, TILESLAYERFLAG_FRONT, TILESLAYERFLAG_TELE};
+	int GameData = Writer.AddData(Width*Height*sizeof(CTile), pGame);
+	int FrontData = Writer.AddData(Width*Height*sizeof(CTile), pFront);
+	int TeleData = Writer.AddData(Width*Height*sizeof(CTeleTile), pTele);
+	for(int l = 0; l < 3; l++)
+	{
+		CMapItemLayerTilemap Layer;
+		mem_zero(&Layer, sizeof(Layer));
+		Layer.m_Layer.m_Type = LAYERTYPE_TILES;
+		// version 3 layers are stored uncompressed
+		Layer.m_Version = 3;
+		Layer.m_Width = Width;
+		Layer.m_Height = Height;
+		Layer.m_Flags = aFlags[l];
+		Layer.m_Image = -1;
+		Layer.m_Data = GameData;
+		Layer.m_Front = FrontData;
+		Layer.m_Tele = TeleData;
+		Layer.m_Speedup = -1;
+		Layer.m_Switch = -1;
+		Layer.m_Tune = -1;
+		Writer.AddItem(MAPITEMTYPE_LAYER, l, sizeof(Layer), &Layer);
+	}
+	Writer.Finish();
+
+	delete[] pGame;
+	delete[] pFront;
+	delete[] pTele;
+}
+
+static void ExpectSame(int Old, vec2 OldCol, vec2 OldBefore, int New, vec2 NewCol, vec2 NewBefore, vec2 Pos0, vec2 Pos1)
+{
+	// positions have to match to the bit
+	EXPECT_EQ(Old, New) << Pos0.x << "," << Pos0.y << " -> " << Pos1.x << "," << Pos1.y;
+	EXPECT_EQ(mem_comp(&OldCol, &NewCol, sizeof(vec2)), 0) << Pos0.x << "," << Pos0.y << " -> " << Pos1.x << "," << Pos1.y;
+	EXPECT_EQ(mem_comp(&OldBefore, &NewBefore, sizeof(vec2)), 0) << Pos0.x << "," << Pos0.y << " -> " << Pos1.x << "," << Pos1.y;
+}
+
+static void CompareIntersections(CCollision *pCollision, int NumSegments)
+{
+	unsigned Seed = 42;
+	float MaxX = pCollision->GetWidth() * 32.0f + 100.0f;
+	float MaxY = pCollision->GetHeight() * 32.0f + 100.0f;
+	for(int n = 0; n < NumSegments; n++)
+	{
+		vec2 Pos0(RandomFloat(&Seed, -100.0f, MaxX), RandomFloat(&Seed, -100.0f, MaxY));
+		vec2 Pos1;
+		switch(n%4)
+		{
+		case 0: Pos1 = Pos0 + vec2(RandomFloat(&Seed, -800.0f, 800.0f), RandomFloat(&Seed, -800.0f, 800.0f)); break;
+		case 1: Pos1 = Pos0 + vec2(RandomFloat(&Seed, -40.0f, 40.0f), RandomFloat(&Seed, -40.0f, 40.0f)); break;
+		// axis aligned and exactly on tile borders
+		case 2: Pos1 = Pos0 + vec2(RandomFloat(&Seed, -800.0f, 800.0f), 0.0f); Pos0.y = Pos1.y = (Random(&Seed)%64)*32 - 0.5f; break;
+		default: Pos1 = Pos0; Pos0.x = Pos1.x = (Random(&Seed)%64)*32 + 31.5f; Pos1.y += RandomFloat(&Seed, -800.0f, 800.0f); break;
+		}
+
+		vec2 OldCol, OldBefore, NewCol, NewBefore;
+		int Old = OldIntersectLine(pCollision, Pos0, Pos1, &OldCol, &OldBefore);
+		int New = pCollision->IntersectLine(Pos0, Pos1, &NewCol, &NewBefore);
+		ExpectSame(Old, OldCol, OldBefore, New, NewCol, NewBefore, Pos0, Pos1);
+
+		for(int Hook = 0; Hook < 2; Hook++)
+		{
+			int OldTele = -1, NewTele = -1;
+			Old = OldIntersectLineTele(pCollision, Hook, Pos0, Pos1, &OldCol, &OldBefore, &OldTele);
+			if(Hook)
+				New = pCollision->IntersectLineTeleHook(Pos0, Pos1, &NewCol, &NewBefore, &NewTele);
+			else
+				New = pCollision->IntersectLineTeleWeapon(Pos0, Pos1, &NewCol, &NewBefore, &NewTele);
+			ExpectSame(Old, OldCol, OldBefore, New, NewCol, NewBefore, Pos0, Pos1);
+			EXPECT_EQ(OldTele, NewTele);
+		}
+
+		Old = OldIntersectPixels(pCollision, OLD_NOLASER, Pos0, Pos1, &OldCol, &OldBefore);
+		New = pCollision->IntersectNoLaser(Pos0, Pos1, &NewCol, &NewBefore);
+		ExpectSame(Old, OldCol, OldBefore, New, NewCol, NewBefore, Pos0, Pos1);
+		Old = OldIntersectPixels(pCollision, OLD_NOLASER_NW, Pos0, Pos1, &OldCol, &OldBefore);
+		New = pCollision->IntersectNoLaserNW(Pos0, Pos1, &NewCol, &NewBefore);
+		ExpectSame(Old, OldCol, OldBefore, New, NewCol, NewBefore, Pos0, Pos1);
+		Old = OldIntersectPixels(pCollision, OLD_AIR, Pos0, Pos1, &OldCol, &OldBefore);
+		New = pCollision->IntersectAir(Pos0, Pos1, &NewCol, &NewBefore);
+		ExpectSame(Old, OldCol, OldBefore, New, NewCol, NewBefore, Pos0, Pos1);
+
+		if(::testing::Test::HasFailure())
+			return;
+	}
+}
+
+TEST(Collision, IntersectMatchesSampler)
+{
+	IStorage *pStorage = CreateTestStorage();
+	IEngineMap *pMap = CreateEngineMap();
+	ASSERT_TRUE(pMap->Load("data/maps/Kobra 4.map", pStorage));
+
+	CLayers Layers;
+	Layers.Init(0, pMap);
+	CCollision Collision;
+	Collision.Init(&Layers);
+	CompareIntersections(&Collision, 20000);
+
+	Collision.Dest();
+	pMap->Unload();
+	delete pMap;
+	delete pStorage;
+}
+
+TEST(Collision, IntersectMatchesSamplerDDRaceTiles)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+	WriteTileMap(pStorage, Info.m_aFilename, 64, 64);
+	IEngineMap *pMap = CreateEngineMap();
+	ASSERT_TRUE(pMap->Load(Info.m_aFilename, pStorage));
+
+	CLayers Layers;
+	Layers.Init(0, pMap);
+	CCollision Collision;
+	Collision.Init(&Layers);
+	for(int Old = 0; Old < 2; Old++)
+	{
+		g_Config.m_SvOldTeleportHook = Old;
+		g_Config.m_SvOldTeleportWeapons = Old;
+		CompareIntersections(&Collision, 20000);
+	}
+	g_Config.m_SvOldTeleportHook = 0;
+	g_Config.m_SvOldTeleportWeapons = 0;
+
+	// same tiles in the same order, consecutive duplicates dropped
+	unsigned Seed = 3;
+	for(int n = 0; n < 5000; n++)
+	{
+		vec2 PrevPos(RandomFloat(&Seed, 0.0f, 64*32.0f), RandomFloat(&Seed, 0.0f, 64*32.0f));
+		vec2 Pos = n%8 ? PrevPos + vec2(RandomFloat(&Seed, -200.0f, 200.0f), RandomFloat(&Seed, -200.0f, 200.0f)) : PrevPos;
+		std::vector<int> Expected = OldGetMapIndices(&Collision, PrevPos, Pos);
+		CMapIndices Indices;
+		Collision.GetMapIndices(PrevPos, Pos, &Indices);
+		ASSERT_EQ(Indices.Num(), (int)Expected.size());
+		for(int i = 0; i < Indices.Num(); i++)
+			EXPECT_EQ(Indices[i], Expected[i]);
+	}
+
+	Collision.Dest();
+	pMap->Unload();
+	delete pMap;
+	delete pStorage;
+	fs_remove(Info.m_aFilename);
+}
+
+TEST(Collision, MapIndicesGrow)
+{
+	// a move that crosses more tiles than fit on the stack keeps all of them
+	CMapIndices Indices;
+	for(int Round = 0; Round < 2; Round++)
+	{
+		Indices.Clear();
+		EXPECT_TRUE(Indices.Empty());
+		int Num = CMapIndices::NUM_INLINE_INDICES*4 + 3;
+		for(int i = 0; i < Num; i++)
+			Indices.Add(i*7);
+		ASSERT_EQ(Indices.Num(), Num);
+		for(int i = 0; i < Num; i++)
+			EXPECT_EQ(Indices[i], i*7);
+	}
+}
+
+TEST(Collision, IntersectBenchmark)
+{
+	IStorage *pStorage = CreateTestStorage();
+	IEngineMap *pMap = CreateEngineMap();
+	ASSERT_TRUE(pMap->Load("data/maps/Kobra 4.map", pStorage));
+
+	CLayers Layers;
+	Layers.Init(0, pMap);
+	CCollision Collision;
+	Collision.Init(&Layers);
+
+	const int Iterations = 200000;
+	vec2 *pSegments = new vec2[Iterations*2];
+	unsigned Seed = 7;
+	for(int i = 0; i < Iterations; i++)
+	{
+		pSegments[i*2] = vec2(RandomFloat(&Seed, 0.0f, Collision.GetWidth()*32.0f), RandomFloat(&Seed, 0.0f, Collision.GetHeight()*32.0f));
+		// laser reach
+		pSegments[i*2+1] = pSegments[i*2] + vec2(RandomFloat(&Seed, -800.0f, 800.0f), RandomFloat(&Seed, -800.0f, 800.0f));
+	}
+
+	vec2 Col, Before;
+	int Sum = 0;
+	int64 Start = time_get();
+	for(int i = 0; i < Iterations; i++)
+		Sum += OldIntersectLine(&Collision, pSegments[i*2], pSegments[i*2+1], &Col, &Before);
+	int64 Sampled = time_get() - Start;
+
+	Start = time_get();
+	for(int i = 0; i < Iterations; i++)
+		Sum -= Collision.IntersectLine(pSegments[i*2], pSegments[i*2+1], &Col, &Before);
+	int64 Walked = time_get() - Start;
+
+	EXPECT_EQ(Sum, 0);
+	dbg_msg("test", "intersect line, %d segments: sampled=%.2fms walked=%.2fms", Iterations,
+		Sampled*1000.0/time_freq(), Walked*1000.0/time_freq());
+
+	delete[] pSegments;
+	Collision.Dest();
+	pMap->Unload();
+	delete pMap;
+	delete pStorage;
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/console.h>
+#include <engine/shared/config.h>
+
+static void DummyCommand(IConsole::IResult *pResult, void *pUserData)
+{
+	(*(int *)pUserData)++;
+}
+
+TEST(Console, FindCommand)
+{
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER);
+	int Calls = 0;
+	pConsole->Register("test_command", "", CFGFLAG_SERVER, DummyCommand, &Calls, "");
+	pConsole->Register("test_client", "", CFGFLAG_CLIENT, DummyCommand, &Calls, "");
+
+	EXPECT_TRUE(pConsole->GetCommandInfo("test_command", CFGFLAG_SERVER, false));
+	EXPECT_TRUE(pConsole->GetCommandInfo("TEST_Command", CFGFLAG_SERVER, false));
+	EXPECT_FALSE(pConsole->GetCommandInfo("test_command", CFGFLAG_CLIENT, false));
+	EXPECT_FALSE(pConsole->GetCommandInfo("test_commandx", CFGFLAG_SERVER, false));
+	EXPECT_FALSE(pConsole->GetCommandInfo("test_client", CFGFLAG_SERVER, false));
+	EXPECT_TRUE(pConsole->GetCommandInfo("sv_name", CFGFLAG_SERVER, false));
+
+	pConsole->ExecuteLine("Test_Command");
+	pConsole->ExecuteLine("test_client");
+	EXPECT_EQ(Calls, 1);
+
+	// temporary commands come and go
+	char aName[32];
+	for(int i = 0; i < 100; i++)
+	{
+		str_format(aName, sizeof(aName), "temp%d", i);
+		pConsole->RegisterTemp(aName, "", CFGFLAG_SERVER, "");
+	}
+	EXPECT_TRUE(pConsole->GetCommandInfo("TEMP42", CFGFLAG_SERVER, true));
+	EXPECT_FALSE(pConsole->GetCommandInfo("temp42", CFGFLAG_SERVER, false));
+	pConsole->DeregisterTemp("temp42");
+	EXPECT_FALSE(pConsole->GetCommandInfo("temp42", CFGFLAG_SERVER, true));
+	EXPECT_TRUE(pConsole->GetCommandInfo("temp43", CFGFLAG_SERVER, true));
+	pConsole->RegisterTemp("temp42", "", CFGFLAG_SERVER, "");
+	EXPECT_TRUE(pConsole->GetCommandInfo("temp42", CFGFLAG_SERVER, true));
+	pConsole->DeregisterTempAll();
+	EXPECT_FALSE(pConsole->GetCommandInfo("temp42", CFGFLAG_SERVER, true));
+	EXPECT_FALSE(pConsole->GetCommandInfo("temp7", CFGFLAG_SERVER, true));
+	EXPECT_TRUE(pConsole->GetCommandInfo("test_command", CFGFLAG_SERVER, false));
+
+	// the listing stays sorted
+	int Num = 0;
+	const IConsole::CCommandInfo *pPrev = 0;
+	for(const IConsole::CCommandInfo *pInfo = pConsole->FirstCommandInfo(IConsole::ACCESS_LEVEL_ADMIN, CFGFLAG_SERVER); pInfo; pInfo = pInfo->NextCommandInfo(IConsole::ACCESS_LEVEL_ADMIN, CFGFLAG_SERVER))
+	{
+		if(pPrev)
+		{
+			EXPECT_LE(str_comp(pPrev->m_pName, pInfo->m_pName), 0);
+		}
+		pPrev = pInfo;
+		Num++;
+	}
+	EXPECT_GT(Num, 100);
+
+	delete pConsole;
+}
@@ -0,0 +1,66 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <engine/shared/datafile.h>
+#include <engine/storage.h>
+
+static void WriteTestFile(IStorage *pStorage, const char *pFilename, int *pData, int DataSize)
+{
+	for(int i = 0; i < DataSize; i++)
+		pData[i] = i*3 + i/100;
+	int aItem[4] = {1, 2, 3, 4};
+
+	CDataFileWriter Writer;
+	ASSERT_TRUE(Writer.Open(pStorage, pFilename));
+	Writer.AddItem(1, 0, sizeof(aItem), aItem);
+	Writer.AddData(DataSize*sizeof(int), pData);
+	Writer.AddData(sizeof(aItem), aItem);
+	Writer.Finish();
+}
+
+static void ExpectContents(IStorage *pStorage, const char *pFilename, int Flags, const int *pData, int DataSize, SHA256_DIGEST *pSha256, unsigned *pCrc)
+{
+	CDataFileReader Reader;
+	ASSERT_TRUE(Reader.Open(pStorage, pFilename, IStorage::TYPE_ALL, Flags));
+	EXPECT_EQ(Reader.NumItems(), 1);
+	EXPECT_EQ(Reader.NumData(), 2);
+
+	int Type, ID;
+	int *pItem = (int *)Reader.GetItem(0, &Type, &ID);
+	ASSERT_TRUE(pItem);
+	EXPECT_EQ(Type, 1);
+	EXPECT_EQ(ID, 0);
+	EXPECT_EQ(pItem[3], 4);
+
+	ASSERT_EQ(Reader.GetDataSize(0), DataSize*(int)sizeof(int));
+	int *pReadData = (int *)Reader.GetData(0);
+	ASSERT_TRUE(pReadData);
+	EXPECT_EQ(mem_comp(pReadData, pData, DataSize*sizeof(int)), 0);
+
+	// replacing data must work for files kept in memory too
+	char *pReplacement = (char *)mem_alloc(16, 1);
+	Reader.ReplaceData(1, pReplacement);
+	EXPECT_EQ(Reader.GetData(1), pReplacement);
+	Reader.UnloadData(0);
+
+	*pSha256 = Reader.Sha256();
+	*pCrc = Reader.Crc();
+}
+
+TEST(Datafile, WholeFileMatchesRead)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+	static int s_aData[10000];
+	WriteTestFile(pStorage, Info.m_aFilename, s_aData, 10000);
+
+	SHA256_DIGEST Sha256Read, Sha256WholeFile;
+	unsigned CrcRead, CrcWholeFile;
+	ExpectContents(pStorage, Info.m_aFilename, 0, s_aData, 10000, &Sha256Read, &CrcRead);
+	ExpectContents(pStorage, Info.m_aFilename, CDataFileReader::OPENFLAG_WHOLE_FILE, s_aData, 10000, &Sha256WholeFile, &CrcWholeFile);
+	EXPECT_EQ(Sha256Read, Sha256WholeFile);
+	EXPECT_EQ(CrcRead, CrcWholeFile);
+
+	fs_remove(Info.m_aFilename);
+	delete pStorage;
+}
@@ -0,0 +1,123 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/console.h>
+#include <engine/shared/config.h>
+#include <engine/shared/demo.h>
+#include <engine/shared/network.h>
+#include <engine/shared/snapshot.h>
+#include <engine/storage.h>
+
+#include <vector>
+
+static const char *s_pNetVersion = "0.6 test";
+
+struct CRecorded
+{
+	std::vector<char> m_Data;
+	bool m_Snapshot;
+};
+
+class CTestListener : public CDemoPlayer::IListner
+{
+public:
+	std::vector<CRecorded> m_lRecords;
+
+	void Add(void *pData, int Size, bool Snapshot)
+	{
+		CRecorded Record;
+		Record.m_Data.assign((char *)pData, (char *)pData + Size);
+		Record.m_Snapshot = Snapshot;
+		// the player repeats the last snapshot on ticks without a new one
+		if(Snapshot && !m_lRecords.empty() && m_lRecords.back().m_Snapshot && m_lRecords.back().m_Data == Record.m_Data)
+			return;
+		m_lRecords.push_back(Record);
+	}
+
+	virtual void OnDemoPlayerSnapshot(void *pData, int Size) { Add(pData, Size, true); }
+	virtual void OnDemoPlayerMessage(void *pData, int Size) { Add(pData, Size, false); }
+};
+
+TEST(Demo, RecordAndPlay)
+{
+	CTestInfo Info;
+	IStorage *pStorage = CreateTestStorage();
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER);
+	// the chunks are huffman compressed
+	CNetBase::Init();
+
+	// the recorder embeds the map, an empty one is enough
+	char aMapName[64];
+	char aMapFilename[128];
+	str_format(aMapName, sizeof(aMapName), "%s", Info.m_aFilename);
+	str_format(aMapFilename, sizeof(aMapFilename), "maps/%s.map", aMapName);
+	fs_makedir("maps");
+	IOHANDLE MapFile = io_open(aMapFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(MapFile);
+	io_close(MapFile);
+
+	CSnapshotDelta SnapshotDelta;
+	CDemoRecorder Recorder(&SnapshotDelta);
+	SHA256_DIGEST Sha256 = {{0}};
+	ASSERT_EQ(Recorder.Start(pStorage, pConsole, Info.m_aFilename, s_pNetVersion, aMapName, Sha256, 0, "server"), 0);
+
+	// snapshots that change a little each tick, a message every few
+	// ticks, long enough for more than one keyframe
+	CTestListener Expected;
+	static CSnapshotBuilder s_Builder;
+	for(int Tick = 1; Tick <= 600; Tick++)
+	{
+		s_Builder.Init();
+		for(int i = 0; i < 8; i++)
+		{
+			int *pItem = (int *)s_Builder.NewItem(1 + i%3, i, 4*sizeof(int));
+			pItem[0] = Tick/(i+1);
+			pItem[1] = i;
+			pItem[2] = Tick%7 == 0 ? Tick : 0;
+			pItem[3] = -i;
+		}
+		static char s_aSnap[CSnapshot::MAX_SIZE];
+		int SnapSize = s_Builder.Finish(s_aSnap);
+		Recorder.RecordSnapshot(Tick, s_aSnap, SnapSize);
+		Expected.Add(s_aSnap, SnapSize, true);
+
+		if(Tick%3 == 0)
+		{
+			int aMsg[5] = {Tick, Tick*2, Tick*3, Tick*4, Tick*5};
+			Recorder.RecordMessage(aMsg, sizeof(int)*(1 + Tick%5));
+			Expected.Add(aMsg, sizeof(int)*(1 + Tick%5), false);
+		}
+	}
+	EXPECT_EQ(Recorder.Length(), 599/SERVER_TICK_SPEED);
+	ASSERT_EQ(Recorder.Stop(), 0);
+	EXPECT_EQ(Recorder.Backlog(), 0);
+	EXPECT_GT(Recorder.PeakBacklog(), 0);
+
+	CDemoPlayer Player(&SnapshotDelta);
+	CTestListener Played;
+	Player.SetListner(&Played);
+	ASSERT_FALSE(Player.Load(pStorage, pConsole, Info.m_aFilename, IStorage::TYPE_ALL, s_pNetVersion));
+	// play it back fast, the player pauses at the end of the file
+	Player.SetSpeed(1000.0f);
+	Player.Play();
+	while(Player.IsPlaying() && !Player.BaseInfo()->m_Paused)
+	{
+		thread_sleep(1);
+		Player.Update();
+	}
+	Player.Stop();
+
+	ASSERT_EQ(Played.m_lRecords.size(), Expected.m_lRecords.size());
+	for(unsigned i = 0; i < Expected.m_lRecords.size(); i++)
+	{
+		EXPECT_EQ(Played.m_lRecords[i].m_Snapshot, Expected.m_lRecords[i].m_Snapshot);
+		EXPECT_TRUE(Played.m_lRecords[i].m_Data == Expected.m_lRecords[i].m_Data);
+	}
+
+	fs_remove(Info.m_aFilename);
+	fs_remove(aMapFilename);
+	fs_remove("maps");
+	delete pConsole;
+	delete pStorage;
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <game/server/entitygrid.h>
+
+enum
+{
+	NUM_TYPES=3,
+	NUM_ENTITIES=800,
+	MAP_SIZE=200*32,
+};
+
+struct CTestEntity
+{
+	CEntityGrid::CNode m_Node;
+	vec2 m_Pos;
+	int m_Type;
+	unsigned m_Serial;
+	bool m_Alive;
+};
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+static vec2 RandomPos(unsigned *pSeed)
+{
+	// a bit outside of the map as well
+	return vec2((int)(Random(pSeed)%(MAP_SIZE+800)) - 400.0f, (int)(Random(pSeed)%(MAP_SIZE+800)) - 400.0f);
+}
+
+// everything of the type within the box, newest first, the way the world
+// walks its type lists
+static int LinearQuery(CTestEntity *pEntities, int Type, vec2 Min, vec2 Max, CTestEntity **ppOut)
+{
+	int Num = 0;
+	for(int i = NUM_ENTITIES-1; i >= 0; i--)
+	{
+		CTestEntity *pEnt = &pEntities[i];
+		if(pEnt->m_Alive && pEnt->m_Type == Type && pEnt->m_Pos.x >= Min.x && pEnt->m_Pos.x <= Max.x && pEnt->m_Pos.y >= Min.y && pEnt->m_Pos.y <= Max.y)
+			ppOut[Num++] = pEnt;
+	}
+	return Num;
+}
+
+static void ExpectQuery(CEntityGrid *pGrid, CTestEntity *pEntities, int Type, vec2 Min, vec2 Max)
+{
+	static CTestEntity *s_apExpected[NUM_ENTITIES];
+	static CEntityGrid::CNode *s_apNodes[NUM_ENTITIES];
+	int NumExpected = LinearQuery(pEntities, Type, Min, Max, s_apExpected);
+	int NumNodes = pGrid->Query(Type, Min, Max, s_apNodes, NUM_ENTITIES);
+	ASSERT_GE(NumNodes, NumExpected);
+
+	// the grid may return more from the border cells, never less and
+	// always in the same order
+	int Found = 0;
+	for(int i = 0; i < NumNodes; i++)
+	{
+		CTestEntity *pEnt = (CTestEntity *)s_apNodes[i]->Owner();
+		EXPECT_EQ(pEnt->m_Type, Type);
+		if(i > 0)
+		{
+			EXPECT_GT(((CTestEntity *)s_apNodes[i-1]->Owner())->m_Serial, pEnt->m_Serial);
+		}
+		if(Found < NumExpected && pEnt == s_apExpected[Found])
+			Found++;
+	}
+	EXPECT_EQ(Found, NumExpected);
+
+	// the same nodes unsorted
+	static CEntityGrid::CNode *s_apCollected[NUM_ENTITIES];
+	static bool s_aSeen[NUM_ENTITIES];
+	ASSERT_EQ(pGrid->Collect(Type, Min, Max, s_apCollected, NUM_ENTITIES), NumNodes);
+	mem_zero(s_aSeen, sizeof(s_aSeen));
+	for(int i = 0; i < NumNodes; i++)
+		s_aSeen[(CTestEntity *)s_apCollected[i]->Owner() - pEntities] = true;
+	for(int i = 0; i < NumNodes; i++)
+		EXPECT_TRUE(s_aSeen[(CTestEntity *)s_apNodes[i]->Owner() - pEntities]);
+}
+
+TEST(EntityGrid, MatchesLinearScan)
+{
+	static CTestEntity s_aEntities[NUM_ENTITIES];
+	CEntityGrid Grid;
+	Grid.Init(NUM_TYPES, MAP_SIZE, MAP_SIZE);
+
+	unsigned Seed = 1;
+	for(int i = 0; i < NUM_ENTITIES; i++)
+	{
+		s_aEntities[i].m_Pos = RandomPos(&Seed);
+		s_aEntities[i].m_Type = i%NUM_TYPES;
+		s_aEntities[i].m_Serial = i;
+		s_aEntities[i].m_Alive = true;
+		s_aEntities[i].m_Node = CEntityGrid::CNode();
+		Grid.Insert(&s_aEntities[i].m_Node, &s_aEntities[i], s_aEntities[i].m_Type, i, s_aEntities[i].m_Pos);
+	}
+	EXPECT_EQ(Grid.Num(0) + Grid.Num(1) + Grid.Num(2), NUM_ENTITIES);
+
+	for(int Round = 0; Round < 50; Round++)
+	{
+		// move a few, some only a little so they keep their cell
+		for(int i = 0; i < NUM_ENTITIES; i += 1 + Random(&Seed)%5)
+		{
+			if(!s_aEntities[i].m_Alive)
+				continue;
+			s_aEntities[i].m_Pos = Random(&Seed)%2 ? RandomPos(&Seed) : s_aEntities[i].m_Pos + vec2(3.0f, -2.0f);
+			Grid.Move(&s_aEntities[i].m_Node, s_aEntities[i].m_Pos);
+			EXPECT_TRUE(Grid.InCell(&s_aEntities[i].m_Node, s_aEntities[i].m_Pos));
+		}
+
+		// and remove some
+		int Victim = Random(&Seed)%NUM_ENTITIES;
+		if(s_aEntities[Victim].m_Alive)
+		{
+			Grid.Remove(&s_aEntities[Victim].m_Node);
+			EXPECT_FALSE(s_aEntities[Victim].m_Node.InGrid());
+			s_aEntities[Victim].m_Alive = false;
+		}
+
+		for(int q = 0; q < 20; q++)
+		{
+			vec2 Center = RandomPos(&Seed);
+			float Range = 10.0f + Random(&Seed)%1000;
+			ExpectQuery(&Grid, s_aEntities, q%NUM_TYPES, Center - vec2(Range, Range), Center + vec2(Range, Range));
+		}
+	}
+
+	// too many results for the buffer
+	static CEntityGrid::CNode *s_apNodes[NUM_ENTITIES];
+	EXPECT_EQ(Grid.Query(0, vec2(-1000, -1000), vec2(MAP_SIZE+1000, MAP_SIZE+1000), s_apNodes, 10), -1);
+	EXPECT_EQ(Grid.Collect(0, vec2(-1000, -1000), vec2(MAP_SIZE+1000, MAP_SIZE+1000), s_apNodes, 10), -1);
+}
+
+TEST(EntityGrid, Benchmark)
+{
+	// a map with lots of projectiles and pickups, every character looks
+	// for them around itself each tick
+	static CTestEntity s_aEntities[NUM_ENTITIES];
+	static CTestEntity *s_apTypeList[NUM_TYPES][NUM_ENTITIES];
+	int aTypeNum[NUM_TYPES] = {0};
+	CEntityGrid Grid;
+	Grid.Init(NUM_TYPES, MAP_SIZE, MAP_SIZE);
+	unsigned Seed = 5;
+	for(int i = 0; i < NUM_ENTITIES; i++)
+	{
+		CTestEntity *pEnt = &s_aEntities[i];
+		pEnt->m_Pos = RandomPos(&Seed);
+		pEnt->m_Type = i < 64 ? 0 : 1 + i%2;
+		pEnt->m_Serial = i;
+		pEnt->m_Alive = true;
+		pEnt->m_Node = CEntityGrid::CNode();
+		s_apTypeList[pEnt->m_Type][aTypeNum[pEnt->m_Type]++] = pEnt;
+		Grid.Insert(&pEnt->m_Node, pEnt, pEnt->m_Type, i, pEnt->m_Pos);
+	}
+
+	const int Ticks = 2000;
+	const float Radius = 28.0f + 14.0f;
+	static CEntityGrid::CNode *s_apNodes[NUM_ENTITIES];
+	int Sum = 0;
+
+	int64 Start = time_get();
+	for(int t = 0; t < Ticks; t++)
+		for(int c = 0; c < 64; c++)
+			for(int Type = 1; Type < NUM_TYPES; Type++)
+				for(int i = 0; i < aTypeNum[Type]; i++)
+					if(distance(s_apTypeList[Type][i]->m_Pos, s_aEntities[c].m_Pos) < Radius)
+						Sum++;
+	int64 Linear = time_get() - Start;
+
+	Start = time_get();
+	for(int t = 0; t < Ticks; t++)
+		for(int c = 0; c < 64; c++)
+			for(int Type = 1; Type < NUM_TYPES; Type++)
+			{
+				vec2 Pos = s_aEntities[c].m_Pos;
+				int Num = Grid.Query(Type, Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), s_apNodes, NUM_ENTITIES);
+				for(int i = 0; i < Num; i++)
+					if(distance(((CTestEntity *)s_apNodes[i]->Owner())->m_Pos, Pos) < Radius)
+						Sum--;
+			}
+	int64 Gridded = time_get() - Start;
+
+	EXPECT_EQ(Sum, 0);
+	dbg_msg("test", "entity queries, %d ticks: linear=%.2fms grid=%.2fms", Ticks,
+		Linear*1000.0/time_freq(), Gridded*1000.0/time_freq());
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/protocol.h>
+#include <generated/protocol.h>
+#include <game/server/eventhandler.h>
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+static int RandomCoord(unsigned *pSeed)
+{
+	// wide enough for the buckets to wrap around, negative as well
+	return (int)(Random(pSeed)%40000) - 20000;
+}
+
+static void CreateEvents(CEventHandler *pEvents, int Num, unsigned *pSeed)
+{
+	for(int i = 0; i < Num; i++)
+	{
+		int64_t Mask = -1LL;
+		if(Random(pSeed)%2)
+		{
+			Mask = 0;
+			for(int c = 0; c < MAX_CLIENTS; c++)
+			{
+				if(Random(pSeed)%4 == 0)
+					Mask |= 1LL<<c;
+			}
+		}
+		CNetEvent_Explosion *pEvent = (CNetEvent_Explosion *)pEvents->Create(NETEVENTTYPE_EXPLOSION, sizeof(CNetEvent_Explosion), Mask);
+		ASSERT_TRUE(pEvent);
+		// a lot of them close together or on the cell borders, the rest anywhere
+		int Where = Random(pSeed)%3;
+		if(Where == 0)
+		{
+			pEvent->m_X = (int)(Random(pSeed)%4096) - 2048;
+			pEvent->m_Y = (int)(Random(pSeed)%4096) - 2048;
+		}
+		else if(Where == 1)
+		{
+			pEvent->m_X = ((int)(Random(pSeed)%8) - 4)*1024 + (int)(Random(pSeed)%3) - 1;
+			pEvent->m_Y = ((int)(Random(pSeed)%8) - 4)*1024 + (int)(Random(pSeed)%3) - 1;
+		}
+		else
+		{
+			pEvent->m_X = RandomCoord(pSeed);
+			pEvent->m_Y = RandomCoord(pSeed);
+		}
+	}
+}
+
+static void ExpectSameEvents(CEventHandler *pEvents, vec2 ViewPos)
+{
+	int *pLinear = new int[pEvents->NumEvents()];
+	int *pBucketed = new int[pEvents->NumEvents()];
+	for(int c = 0; c < MAX_CLIENTS; c++)
+	{
+		int NumLinear = pEvents->CollectLinear(c, ViewPos, pLinear);
+		int NumBucketed = pEvents->Collect(c, ViewPos, pBucketed);
+		ASSERT_EQ(NumLinear, NumBucketed) << "client=" << c << " view=" << ViewPos.x << "," << ViewPos.y;
+		for(int i = 0; i < NumLinear; i++)
+		{
+			ASSERT_EQ(pLinear[i], pBucketed[i]) << "client=" << c << " view=" << ViewPos.x << "," << ViewPos.y;
+		}
+	}
+	delete[] pLinear;
+	delete[] pBucketed;
+}
+
+static void ExpectSameEventsAround(CEventHandler *pEvents, unsigned *pSeed)
+{
+	for(int i = 0; i < 50; i++)
+		ExpectSameEvents(pEvents, vec2(RandomCoord(pSeed), RandomCoord(pSeed)));
+
+	// the view or its edges right at the cell borders
+	const float aOffsets[] = {0.0f, -0.5f, 0.5f, 1500.0f, 1499.5f, 1500.5f, 1300.0f, -1500.0f, -1499.5f, -1500.5f, -1300.0f};
+	const int NumOffsets = sizeof(aOffsets)/sizeof(aOffsets[0]);
+	for(int k = -3; k <= 3; k++)
+	{
+		for(int i = 0; i < NumOffsets; i++)
+		{
+			ExpectSameEvents(pEvents, vec2(k*1024.0f + aOffsets[i], -k*1024.0f + aOffsets[(i+k+NumOffsets)%NumOffsets]));
+			ExpectSameEvents(pEvents, vec2(k*1024.0f + aOffsets[i], k*1024.0f + aOffsets[i]));
+		}
+	}
+}
+
+TEST(EventHandler, BucketedMatchesLinear)
+{
+	CEventHandler Events;
+	unsigned Seed = 1;
+	const int aNumEvents[] = {17, 64, 300, 1000};
+	for(unsigned t = 0; t < sizeof(aNumEvents)/sizeof(aNumEvents[0]); t++)
+	{
+		CreateEvents(&Events, aNumEvents[t], &Seed);
+		ExpectSameEventsAround(&Events, &Seed);
+
+		// the events created after the first snapshot get indexed as well
+		CreateEvents(&Events, 20, &Seed);
+		ExpectSameEventsAround(&Events, &Seed);
+
+		Events.Clear();
+	}
+}
+
+TEST(EventHandler, FewEvents)
+{
+	CEventHandler Events;
+	unsigned Seed = 2;
+	CreateEvents(&Events, 16, &Seed);
+	ExpectSameEventsAround(&Events, &Seed);
+	Events.Clear();
+}
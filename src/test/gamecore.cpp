@@ -0,0 +1,321 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <base/tl/threading.h>
+#include <engine/map.h>
+#include <engine/shared/jobs.h>
+#include <engine/storage.h>
+#include <game/collision.h>
+#include <game/gamecore.h>
+#include <game/layers.h>
+
+#include <vector>
+
+enum
+{
+	NUM_CORES=32,
+	NUM_TICKS=1500,
+	NUM_THREADS=4,
+};
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+struct CPrepareJob
+{
+	CJob m_Job;
+	CCharacterCore **m_ppCores;
+	CCharacterCore *m_pBases;
+	CCharacterCore *m_pPrepared;
+	CCharacterCore::CTickState *m_pStates;
+	const bool *m_pUseInput;
+	int m_First;
+	int m_Num;
+};
+
+static int PrepareJob(void *pUser)
+{
+	CPrepareJob *pJob = (CPrepareJob *)pUser;
+	// on a copy, the way CCharacter::PrepareCore does it
+	for(int i = pJob->m_First; i < pJob->m_First + pJob->m_Num; i++)
+	{
+		mem_copy(&pJob->m_pBases[i], pJob->m_ppCores[i], sizeof(CCharacterCore));
+		mem_copy(&pJob->m_pPrepared[i], pJob->m_ppCores[i], sizeof(CCharacterCore));
+		pJob->m_pPrepared[i].TickPrepare(pJob->m_pUseInput[i], &pJob->m_pStates[i]);
+	}
+	return 0;
+}
+
+class GameCore : public ::testing::Test
+{
+protected:
+	IStorage *m_pStorage;
+	IEngineMap *m_pMap;
+	CLayers m_Layers;
+	CCollision m_Collision;
+	CTeamsCore m_Teams;
+
+	CWorldCore m_World;
+	CCharacterCore m_aCores[NUM_CORES];
+	vec2 m_aSpawns[NUM_CORES];
+
+	// the recorded inputs, one per core and tick
+	std::vector<CNetObj_PlayerInput> m_lInputs;
+	std::vector<bool> m_lUseInput;
+
+	GameCore()
+	{
+		m_pStorage = CreateTestStorage();
+		m_pMap = CreateEngineMap();
+	}
+
+	~GameCore()
+	{
+		m_Collision.Dest();
+		m_pMap->Unload();
+		delete m_pMap;
+		delete m_pStorage;
+	}
+
+	void SetUp()
+	{
+		ASSERT_TRUE(m_pMap->Load("data/maps/Kobra 4.map", m_pStorage));
+		m_Layers.Init(0, m_pMap);
+		m_Collision.Init(&m_Layers);
+
+		// a crowd in the most open spot, so they hook and push each other
+		unsigned Seed = 7;
+		float Width = m_Collision.GetWidth()*32.0f;
+		float Height = m_Collision.GetHeight()*32.0f;
+		vec2 Center(0, 0);
+		int BestFree = -1;
+		for(int n = 0; n < 400; n++)
+		{
+			vec2 Pos(Random(&Seed)%(int)Width, Random(&Seed)%(int)Height);
+			int Free = 0;
+			for(int y = -3; y <= 3; y++)
+				for(int x = -5; x <= 5; x++)
+					if(!m_Collision.TestBox(Pos + vec2(x*32.0f, y*32.0f), vec2(28.0f, 28.0f)))
+						Free++;
+			if(Free > BestFree)
+			{
+				BestFree = Free;
+				Center = Pos;
+			}
+		}
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			do
+				m_aSpawns[i] = Center + vec2((int)(Random(&Seed)%320) - 160.0f, (int)(Random(&Seed)%192) - 96.0f);
+			while(m_Collision.TestBox(m_aSpawns[i], vec2(28.0f, 28.0f)));
+		}
+
+		// held for a while like real players do
+		m_lInputs.resize(NUM_TICKS*NUM_CORES);
+		m_lUseInput.resize(NUM_TICKS*NUM_CORES);
+		CNetObj_PlayerInput aCurrent[NUM_CORES];
+		mem_zero(aCurrent, sizeof(aCurrent));
+		for(int t = 0; t < NUM_TICKS; t++)
+			for(int i = 0; i < NUM_CORES; i++)
+			{
+				CNetObj_PlayerInput *pInput = &aCurrent[i];
+				if(Random(&Seed)%10 == 0)
+					pInput->m_Direction = (int)(Random(&Seed)%3) - 1;
+				if(Random(&Seed)%6 == 0)
+					pInput->m_Jump ^= 1;
+				if(Random(&Seed)%25 == 0)
+					pInput->m_Hook ^= 1;
+				if(Random(&Seed)%8 == 0)
+				{
+					pInput->m_TargetX = (int)(Random(&Seed)%600) - 300;
+					pInput->m_TargetY = (int)(Random(&Seed)%600) - 300;
+				}
+				m_lInputs[t*NUM_CORES + i] = *pInput;
+				// cores without a new input keep going, like in the prediction
+				m_lUseInput[t*NUM_CORES + i] = Random(&Seed)%9 != 0;
+			}
+	}
+
+	void Spawn()
+	{
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			// Reset doesn't touch the direction and a few more
+			mem_zero(&m_aCores[i], sizeof(m_aCores[i]));
+			m_aCores[i].Init(&m_World, &m_Collision, &m_Teams);
+			m_aCores[i].Reset();
+			m_aCores[i].m_Id = i;
+			m_aCores[i].m_Pos = m_aSpawns[i];
+			m_World.m_apCharacters[i] = &m_aCores[i];
+		}
+	}
+
+	void SetInputs(int Tick, bool *pUseInput)
+	{
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			m_aCores[i].m_Input = m_lInputs[Tick*NUM_CORES + i];
+			pUseInput[i] = m_lUseInput[Tick*NUM_CORES + i];
+		}
+	}
+
+	void Move()
+	{
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			m_aCores[i].Move();
+			m_aCores[i].Quantize();
+		}
+	}
+};
+
+struct CCoreResult
+{
+	vec2 m_Pos;
+	vec2 m_Vel;
+	vec2 m_HookPos;
+	int m_HookState;
+	int m_HookedPlayer;
+	int m_TriggeredEvents;
+	int m_Jumped;
+};
+
+static void Store(const CCharacterCore *pCore, CCoreResult *pResult)
+{
+	mem_zero(pResult, sizeof(*pResult));
+	pResult->m_Pos = pCore->m_Pos;
+	pResult->m_Vel = pCore->m_Vel;
+	pResult->m_HookPos = pCore->m_HookPos;
+	pResult->m_HookState = pCore->m_HookState;
+	pResult->m_HookedPlayer = pCore->m_HookedPlayer;
+	pResult->m_TriggeredEvents = pCore->m_TriggeredEvents;
+	pResult->m_Jumped = pCore->m_Jumped;
+}
+
+TEST_F(GameCore, PreparedTickMatchesSerial)
+{
+	static CCoreResult s_aSerial[NUM_TICKS][NUM_CORES];
+	bool aUseInput[NUM_CORES];
+
+	// replay the inputs the way the cores were ticked so far
+	Spawn();
+	int PlayerHooks = 0;
+	int Contacts = 0;
+	for(int t = 0; t < NUM_TICKS; t++)
+	{
+		SetInputs(t, aUseInput);
+		for(int i = 0; i < NUM_CORES; i++)
+			m_aCores[i].Tick(aUseInput[i]);
+		Move();
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			Store(&m_aCores[i], &s_aSerial[t][i]);
+			if(m_aCores[i].m_HookedPlayer != -1)
+				PlayerHooks++;
+			for(int j = i + 1; j < NUM_CORES; j++)
+				if(distance(m_aCores[i].m_Pos, m_aCores[j].m_Pos) < 28.0f*1.25f)
+					Contacts++;
+		}
+	}
+	// make sure the interesting parts were exercised
+	EXPECT_GT(PlayerHooks, 100);
+	EXPECT_GT(Contacts, 100);
+
+	// and again with all cores prepared on a job pool first
+	CJobPool Pool;
+	Pool.Init(NUM_THREADS);
+	static CCharacterCore::CTickState s_aStates[NUM_CORES];
+	static CCharacterCore s_aBases[NUM_CORES];
+	static CCharacterCore s_aPrepared[NUM_CORES];
+	CCharacterCore *apCores[NUM_CORES];
+	CPrepareJob aJobs[NUM_THREADS];
+	for(int i = 0; i < NUM_CORES; i++)
+		apCores[i] = &m_aCores[i];
+
+	Spawn();
+	int Mismatches = 0;
+	int Applied = 0;
+	for(int t = 0; t < NUM_TICKS && !Mismatches; t++)
+	{
+		SetInputs(t, aUseInput);
+		for(int j = 0; j < NUM_THREADS; j++)
+		{
+			aJobs[j].m_ppCores = apCores;
+			aJobs[j].m_pBases = s_aBases;
+			aJobs[j].m_pPrepared = s_aPrepared;
+			aJobs[j].m_pStates = s_aStates;
+			aJobs[j].m_pUseInput = aUseInput;
+			aJobs[j].m_First = j*NUM_CORES/NUM_THREADS;
+			aJobs[j].m_Num = (j+1)*NUM_CORES/NUM_THREADS - aJobs[j].m_First;
+			Pool.Add(&aJobs[j].m_Job, PrepareJob, &aJobs[j]);
+		}
+		for(int j = 0; j < NUM_THREADS; j++)
+			while(aJobs[j].m_Job.Status() != CJob::STATE_DONE)
+				thread_yield();
+		sync_barrier();
+
+		// a core an earlier one changed, for example by dragging it with
+		// the hook, is ticked again like CCharacter::Tick does
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			if(mem_comp(&m_aCores[i], &s_aBases[i], sizeof(m_aCores[i])) == 0)
+			{
+				mem_copy(&m_aCores[i], &s_aPrepared[i], sizeof(m_aCores[i]));
+				m_aCores[i].TickApply(aUseInput[i], &s_aStates[i]);
+				Applied++;
+			}
+			else
+				m_aCores[i].Tick(aUseInput[i]);
+		}
+		Move();
+
+		for(int i = 0; i < NUM_CORES; i++)
+		{
+			CCoreResult Result;
+			Store(&m_aCores[i], &Result);
+			if(mem_comp(&Result, &s_aSerial[t][i], sizeof(Result)) != 0)
+			{
+				ADD_FAILURE() << "core " << i << " differs in tick " << t;
+				Mismatches++;
+			}
+		}
+	}
+	EXPECT_EQ(Mismatches, 0);
+	EXPECT_GT(Applied, NUM_TICKS*NUM_CORES/2);
+}
+
+TEST_F(GameCore, PreparedCopyDoesNotHookItself)
+{
+	// a flying hook that passes its owner, like after a tele hook or when
+	// the player is faster than the hook
+	Spawn();
+	for(int i = 1; i < NUM_CORES; i++)
+		m_World.m_apCharacters[i] = 0;
+	CCharacterCore *pCore = &m_aCores[0];
+	mem_zero(&pCore->m_Input, sizeof(pCore->m_Input));
+	pCore->m_Input.m_Hook = 1;
+	pCore->m_Input.m_TargetX = 1;
+	pCore->m_HookState = HOOK_FLYING;
+	pCore->m_HookPos = pCore->m_Pos - vec2(40.0f, 0.0f);
+	pCore->m_HookDir = vec2(1.0f, 0.0f);
+	pCore->m_HookedPlayer = -1;
+
+	CCharacterCore Serial;
+	mem_copy(&Serial, pCore, sizeof(Serial));
+	Serial.Tick(true);
+
+	CCharacterCore Prepared;
+	mem_copy(&Prepared, pCore, sizeof(Prepared));
+	CCharacterCore::CTickState State;
+	Prepared.TickPrepare(true, &State);
+	mem_copy(pCore, &Prepared, sizeof(Prepared));
+	pCore->TickApply(true, &State);
+
+	EXPECT_EQ(Serial.m_HookedPlayer, -1);
+	EXPECT_EQ(pCore->m_HookedPlayer, Serial.m_HookedPlayer);
+	EXPECT_EQ(pCore->m_HookState, Serial.m_HookState);
+}
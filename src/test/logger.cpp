@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+
+// the loggers can't be removed again, so one logger collects for all tests
+static const int s_MaxLines = 4096;
+static char s_aaLines[s_MaxLines][600];
+static int s_NumLines = 0;
+
+static void TestLogger(const char *pLine)
+{
+	// skip the time stamp, everything after it is deterministic
+	const char *pSys = str_find(pLine, "][");
+	if(!pSys || !str_startswith(pSys + 2, "test/") || s_NumLines == s_MaxLines)
+		return;
+	str_copy(s_aaLines[s_NumLines++], pSys + 2, sizeof(s_aaLines[0]));
+}
+
+static void ResetLines()
+{
+	static bool s_Registered = false;
+	if(!s_Registered)
+	{
+		dbg_logger(TestLogger);
+		s_Registered = true;
+	}
+	s_NumLines = 0;
+}
+
+static const int s_NumThreads = 4;
+static const int s_LinesPerThread = 200;
+
+static void LogThread(void *pUser)
+{
+	int Thread = *(int *)pUser;
+	char aLong[500];
+	for(int i = 0; i < (int)sizeof(aLong) - 1; i++)
+		aLong[i] = 'a' + (Thread*7 + i)%26;
+	aLong[sizeof(aLong) - 1] = 0;
+
+	for(int i = 0; i < s_LinesPerThread; i++)
+	{
+		// every third line spans several slots of the queue
+		if(i%3 == 0)
+			dbg_msg("test/async", "%d %d %s", Thread, i, aLong);
+		else
+			dbg_msg("test/async", "%d %d", Thread, i);
+		// stay well below the size of the queue
+		if(i%50 == 49)
+			dbg_logger_flush();
+	}
+}
+
+TEST(Logger, Async)
+{
+	ResetLines();
+	dbg_logger_async_start();
+
+	void *apThreads[s_NumThreads];
+	int aIndices[s_NumThreads];
+	for(int i = 0; i < s_NumThreads; i++)
+	{
+		aIndices[i] = i;
+		apThreads[i] = thread_init(LogThread, &aIndices[i]);
+	}
+	for(int i = 0; i < s_NumThreads; i++)
+		thread_wait(apThreads[i]);
+	dbg_logger_flush();
+
+	// no lines lost and the order of every thread kept
+	EXPECT_EQ(s_NumLines, s_NumThreads*s_LinesPerThread);
+	int aNext[s_NumThreads] = {0};
+	for(int i = 0; i < s_NumLines; i++)
+	{
+		int Thread, Line, Length = str_length(s_aaLines[i]);
+		ASSERT_EQ(sscanf(s_aaLines[i], "test/async]: %d %d", &Thread, &Line), 2);
+		ASSERT_TRUE(Thread >= 0 && Thread < s_NumThreads);
+		EXPECT_EQ(Line, aNext[Thread]++);
+		if(Line%3 == 0)
+		{
+			EXPECT_GT(Length, 499);
+			EXPECT_EQ(s_aaLines[i][Length - 1], 'a' + (Thread*7 + 498)%26);
+		}
+	}
+
+	// lines logged before stopping are written out
+	dbg_msg("test/async", "last");
+	dbg_logger_async_stop();
+	ASSERT_EQ(s_NumLines, s_NumThreads*s_LinesPerThread + 1);
+	EXPECT_STREQ(s_aaLines[s_NumLines - 1], "test/async]: last");
+}
+
+TEST(Logger, Level)
+{
+	ResetLines();
+	dbg_msg_level(LOG_LEVEL_DEBUG, "test/level", "hidden");
+	dbg_logger_level("test/level", LOG_LEVEL_DEBUG);
+	dbg_msg_level(LOG_LEVEL_DEBUG, "test/level", "debug");
+	dbg_logger_level("test/level", LOG_LEVEL_WARN);
+	dbg_msg("test/level", "hidden");
+	dbg_msg_level(LOG_LEVEL_ERROR, "test/level", "error");
+	dbg_logger_level("test/level", -1);
+	dbg_msg("test/level", "info");
+
+	ASSERT_EQ(s_NumLines, 3);
+	EXPECT_STREQ(s_aaLines[0], "test/level]: debug");
+	EXPECT_STREQ(s_aaLines[1], "test/level]: error");
+	EXPECT_STREQ(s_aaLines[2], "test/level]: info");
+}
+
+TEST(Logger, RateLimit)
+{
+	ResetLines();
+	dbg_logger_rate_limit(5);
+	// start right after a second began
+	int64 Second = time_get()/time_freq();
+	while(time_get()/time_freq() == Second)
+		thread_sleep(1);
+
+	for(int i = 0; i < 20; i++)
+		dbg_msg("test/rate", "%d", i);
+	dbg_msg_level(LOG_LEVEL_ERROR, "test/rate", "error");
+	ASSERT_EQ(s_NumLines, 6);
+	EXPECT_STREQ(s_aaLines[4], "test/rate]: 4");
+	EXPECT_STREQ(s_aaLines[5], "test/rate]: error");
+
+	// the next second tells how many were dropped
+	thread_sleep(1000);
+	dbg_msg("test/rate", "again");
+	dbg_logger_rate_limit(0);
+	ASSERT_EQ(s_NumLines, 8);
+	EXPECT_STREQ(s_aaLines[6], "test/rate]: suppressed 15 messages");
+	EXPECT_STREQ(s_aaLines[7], "test/rate]: again");
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/network.h>
+
+static NETADDR MakeAddr(int i, bool Ipv6)
+{
+	NETADDR Addr;
+	mem_zero(&Addr, sizeof(Addr));
+	Addr.type = Ipv6 ? NETTYPE_IPV6 : NETTYPE_IPV4;
+	Addr.ip[0] = Ipv6 ? 0x20 : 10;
+	Addr.ip[2] = i>>8;
+	Addr.ip[3] = i&0xff;
+	if(Ipv6)
+		Addr.ip[15] = i*7;
+	Addr.port = 8303 + (i&3);
+	return Addr;
+}
+
+TEST(NetAddrIndex, Empty)
+{
+	CNetAddrIndex Index;
+	NETADDR Addr = MakeAddr(1, false);
+	EXPECT_EQ(Index.Find(&Addr), -1);
+	Index.Remove(&Addr);
+	EXPECT_EQ(Index.Find(&Addr), -1);
+}
+
+TEST(NetAddrIndex, InsertFindRemove)
+{
+	CNetAddrIndex Index;
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		NETADDR Addr = MakeAddr(i, i&1);
+		EXPECT_TRUE(Index.Insert(&Addr, i));
+	}
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		NETADDR Addr = MakeAddr(i, i&1);
+		EXPECT_EQ(Index.Find(&Addr), i);
+	}
+
+	// same ip, different port or family must not match
+	NETADDR Other = MakeAddr(2, false);
+	Other.port++;
+	EXPECT_EQ(Index.Find(&Other), -1);
+	Other = MakeAddr(2, true);
+	EXPECT_EQ(Index.Find(&Other), -1);
+
+	// remove every other entry, the rest must stay reachable
+	for(int i = 0; i < NET_MAX_CLIENTS; i += 2)
+	{
+		NETADDR Addr = MakeAddr(i, i&1);
+		Index.Remove(&Addr);
+	}
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		NETADDR Addr = MakeAddr(i, i&1);
+		EXPECT_EQ(Index.Find(&Addr), i&1 ? i : -1);
+	}
+
+	// reinserting reuses the freed buckets
+	for(int i = 0; i < NET_MAX_CLIENTS; i += 2)
+	{
+		NETADDR Addr = MakeAddr(i+1000, false);
+		EXPECT_TRUE(Index.Insert(&Addr, i));
+		EXPECT_EQ(Index.Find(&Addr), i);
+	}
+}
+
+TEST(NetAddrIndex, Benchmark)
+{
+	NETADDR aAddrs[NET_MAX_CLIENTS];
+	CNetAddrIndex Index;
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		aAddrs[i] = MakeAddr(i, i&1);
+		Index.Insert(&aAddrs[i], i);
+	}
+
+	const int Iterations = 200000;
+	int Sum = 0;
+
+	int64 Start = time_get();
+	for(int n = 0; n < Iterations; n++)
+	{
+		const NETADDR *pAddr = &aAddrs[(n*37)%NET_MAX_CLIENTS];
+		for(int i = 0; i < NET_MAX_CLIENTS; i++)
+		{
+			if(net_addr_comp(&aAddrs[i], pAddr) == 0)
+			{
+				Sum += i;
+				break;
+			}
+		}
+	}
+	int64 Linear = time_get() - Start;
+
+	Start = time_get();
+	for(int n = 0; n < Iterations; n++)
+		Sum -= Index.Find(&aAddrs[(n*37)%NET_MAX_CLIENTS]);
+	int64 Hashed = time_get() - Start;
+
+	EXPECT_EQ(Sum, 0);
+	dbg_msg("test", "peer lookup, %d iterations: linear=%.2fms hashed=%.2fms", Iterations,
+		Linear*1000.0/time_freq(), Hashed*1000.0/time_freq());
+}
+
+// drives CNetServer::Recv with packets from a full server of peers, the
+// path the index is used on
+TEST(NetAddrIndex, RecvFlood)
+{
+	// for the connect tokens and the packet compression
+	ASSERT_EQ(secure_random_init(), 0);
+	CNetBase::Init();
+
+	NETADDR BindAddr;
+	mem_zero(&BindAddr, sizeof(BindAddr));
+	BindAddr.type = NETTYPE_IPV4;
+	BindAddr.ip[0] = 127;
+	BindAddr.ip[3] = 1;
+
+	CNetServer *pServer = new CNetServer();
+	bool Opened = false;
+	for(int Port = 38700; Port < 38800 && !Opened; Port++)
+	{
+		BindAddr.port = Port;
+		Opened = pServer->Open(BindAddr, 0, NET_MAX_CLIENTS, NET_MAX_CLIENTS, 0);
+	}
+	ASSERT_TRUE(Opened);
+	NETADDR ServerAddr = BindAddr;
+
+	CNetClient *pClients = new CNetClient[NET_MAX_CLIENTS];
+	BindAddr.port = 0;
+	for(int i = 0; i < NET_MAX_CLIENTS; i++)
+	{
+		ASSERT_TRUE(pClients[i].Open(BindAddr, NETCREATE_FLAG_RANDOMPORT));
+		pClients[i].Connect(&ServerAddr);
+	}
+
+	CNetChunk Chunk;
+	int NumOnline = 0;
+	int64 Timeout = time_get() + 5*time_freq();
+	while(NumOnline < NET_MAX_CLIENTS && time_get() < Timeout)
+	{
+		pServer->Update();
+		while(pServer->Recv(&Chunk))
+			;
+		NumOnline = 0;
+		for(int i = 0; i < NET_MAX_CLIENTS; i++)
+		{
+			pClients[i].Update();
+			while(pClients[i].Recv(&Chunk))
+				;
+			if(pClients[i].State() == NETSTATE_ONLINE)
+				NumOnline++;
+		}
+	}
+	ASSERT_EQ(NumOnline, NET_MAX_CLIENTS);
+
+	// one packet per peer and round, few enough for the socket buffer
+	const int Rounds = 200;
+	unsigned char aData[16];
+	for(unsigned i = 0; i < sizeof(aData); i++)
+		aData[i] = i*37;
+	int Received = 0;
+	int64 Total = 0;
+	for(int r = 0; r < Rounds; r++)
+	{
+		for(int i = 0; i < NET_MAX_CLIENTS; i++)
+		{
+			CNetChunk Send;
+			Send.m_ClientID = 0;
+			Send.m_Flags = NETSENDFLAG_FLUSH;
+			Send.m_DataSize = sizeof(aData);
+			Send.m_pData = aData;
+			pClients[i].Send(&Send);
+		}
+
+		int64 Start = time_get();
+		while(pServer->Recv(&Chunk))
+			Received++;
+		Total += time_get() - Start;
+	}
+
+	EXPECT_EQ(Received, Rounds*NET_MAX_CLIENTS);
+	dbg_msg("test", "recv flood, %d peers, %d packets: %.2fms, %.2fus per packet", NET_MAX_CLIENTS, Received,
+		Total*1000.0/time_freq(), Received ? Total*1000000.0/time_freq()/Received : 0.0);
+
+	delete[] pClients;
+	net_udp_close(pServer->Socket());
+	delete pServer;
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <game/server/score/score_index.h>
+
+#include <algorithm>
+#include <vector>
+
+struct CReference
+{
+	char m_aName[MAX_NAME_LENGTH];
+	float m_Time;
+	unsigned m_Order;
+
+	bool operator<(const CReference &Other) const
+	{
+		if(m_Time != Other.m_Time)
+			return m_Time < Other.m_Time;
+		return m_Order < Other.m_Order;
+	}
+};
+
+static void ExpectRanking(const CScoreIndex &Index, std::vector<CReference> Reference)
+{
+	std::sort(Reference.begin(), Reference.end());
+	ASSERT_EQ(Index.Num(), (int)Reference.size());
+	for(int i = 0; i < (int)Reference.size(); i++)
+	{
+		int ID = Index.Nth(i+1);
+		ASSERT_GE(ID, 0);
+		EXPECT_STREQ(Index.Name(ID), Reference[i].m_aName);
+		EXPECT_EQ(Index.Time(ID), Reference[i].m_Time);
+		EXPECT_EQ(Index.Rank(ID), i+1);
+		EXPECT_EQ(Index.Find(Reference[i].m_aName), ID);
+	}
+	EXPECT_EQ(Index.Nth(0), -1);
+	EXPECT_EQ(Index.Nth(Index.Num()+1), -1);
+}
+
+TEST(ScoreIndex, Empty)
+{
+	CScoreIndex Index;
+	EXPECT_EQ(Index.Num(), 0);
+	EXPECT_EQ(Index.Find("nameless tee"), -1);
+	EXPECT_EQ(Index.Nth(1), -1);
+}
+
+TEST(ScoreIndex, MatchesSortedList)
+{
+	CScoreIndex Index;
+	std::vector<CReference> Reference;
+	unsigned Order = 0;
+	unsigned Seed = 7;
+
+	for(int i = 0; i < 3000; i++)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		// few distinct times to get lots of ties
+		float Time = 30.0f + (Seed>>16)%200 * 0.02f;
+		char aName[MAX_NAME_LENGTH];
+		str_format(aName, sizeof(aName), "tee%d", (Seed>>8)%1500);
+
+		int ID = Index.Find(aName);
+		if(ID >= 0)
+		{
+			Index.Update(ID, Time);
+			for(unsigned k = 0; k < Reference.size(); k++)
+				if(str_comp(Reference[k].m_aName, aName) == 0)
+				{
+					Reference[k].m_Time = Time;
+					Reference[k].m_Order = Order++;
+				}
+		}
+		else
+		{
+			ID = Index.Add(aName, Time);
+			EXPECT_EQ(ID, (int)Reference.size());
+			CReference Entry;
+			str_copy(Entry.m_aName, aName, sizeof(Entry.m_aName));
+			Entry.m_Time = Time;
+			Entry.m_Order = Order++;
+			Reference.push_back(Entry);
+		}
+
+		if(i%500 == 0)
+			ExpectRanking(Index, Reference);
+	}
+	ExpectRanking(Index, Reference);
+
+	Index.Clear();
+	EXPECT_EQ(Index.Num(), 0);
+	EXPECT_EQ(Index.Find("tee1"), -1);
+}
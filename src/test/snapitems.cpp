@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/protocol.h>
+#include <game/server/snapitems.h>
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+static float RandomCoord(unsigned *pSeed)
+{
+	// wide enough for the buckets to wrap around, negative as well
+	return (int)(Random(pSeed)%40000) - 20000 + (Random(pSeed)%4)*0.25f;
+}
+
+static void CreateItems(CSharedSnapItems *pItems, int Num, unsigned *pSeed)
+{
+	for(int i = 0; i < Num; i++)
+	{
+		int64_t Mask = -1LL;
+		if(Random(pSeed)%2)
+		{
+			Mask = 0;
+			for(int c = 0; c < MAX_CLIENTS; c++)
+			{
+				if(Random(pSeed)%4 == 0)
+					Mask |= 1LL<<c;
+			}
+		}
+		// a lot of them close together or on the cell borders, the rest anywhere
+		vec2 Pos;
+		int Where = Random(pSeed)%3;
+		if(Where == 0)
+			Pos = vec2((int)(Random(pSeed)%4096) - 2048, (int)(Random(pSeed)%4096) - 2048);
+		else if(Where == 1)
+			Pos = vec2(((int)(Random(pSeed)%8) - 4)*1024 + ((int)(Random(pSeed)%5) - 2)*0.5f,
+				((int)(Random(pSeed)%8) - 4)*1024 + ((int)(Random(pSeed)%5) - 2)*0.5f);
+		else
+			Pos = vec2(RandomCoord(pSeed), RandomCoord(pSeed));
+		bool Clip = Random(pSeed)%8 != 0;
+		int *pData = (int *)pItems->New(i%4, i, sizeof(int), Mask, Pos, Clip);
+		ASSERT_TRUE(pData);
+		*pData = i;
+	}
+}
+
+static void ExpectSameItems(CSharedSnapItems *pItems, vec2 ViewPos)
+{
+	int *pLinear = new int[pItems->NumItems()];
+	for(int c = 0; c < MAX_CLIENTS; c++)
+	{
+		int NumLinear = pItems->CollectLinear(c, ViewPos, pLinear);
+		int NumBucketed;
+		const int *pBucketed = pItems->Collect(c, ViewPos, &NumBucketed);
+		ASSERT_EQ(NumLinear, NumBucketed) << "client=" << c << " view=" << ViewPos.x << "," << ViewPos.y;
+		for(int i = 0; i < NumLinear; i++)
+		{
+			ASSERT_EQ(pLinear[i], pBucketed[i]) << "client=" << c << " view=" << ViewPos.x << "," << ViewPos.y;
+		}
+	}
+	delete[] pLinear;
+}
+
+static void ExpectSameItemsAround(CSharedSnapItems *pItems, unsigned *pSeed)
+{
+	for(int i = 0; i < 50; i++)
+		ExpectSameItems(pItems, vec2(RandomCoord(pSeed), RandomCoord(pSeed)));
+
+	// the view box edges right at the cell borders
+	const float aOffsets[] = {0.0f, -0.5f, 0.5f, 1000.0f, 999.5f, 1000.5f, 800.0f, 799.5f, 800.5f, -1000.0f, -1000.5f, -800.0f, -800.5f};
+	const int NumOffsets = sizeof(aOffsets)/sizeof(aOffsets[0]);
+	for(int k = -3; k <= 3; k++)
+	{
+		for(int i = 0; i < NumOffsets; i++)
+		{
+			ExpectSameItems(pItems, vec2(k*1024.0f + aOffsets[i], -k*1024.0f + aOffsets[(i+k+NumOffsets)%NumOffsets]));
+			ExpectSameItems(pItems, vec2(k*1024.0f + aOffsets[i], k*1024.0f + aOffsets[i]));
+		}
+	}
+}
+
+TEST(SharedSnapItems, BucketedMatchesLinear)
+{
+	CSharedSnapItems Items;
+	unsigned Seed = 1;
+	const int aNumItems[] = {21, 64, 300, 1000};
+	for(unsigned t = 0; t < sizeof(aNumItems)/sizeof(aNumItems[0]); t++)
+	{
+		CreateItems(&Items, aNumItems[t], &Seed);
+		ExpectSameItemsAround(&Items, &Seed);
+		Items.Clear();
+	}
+}
+
+TEST(SharedSnapItems, Grow)
+{
+	CSharedSnapItems Items;
+	unsigned Seed = 2;
+	CreateItems(&Items, 5000, &Seed);
+	ASSERT_EQ(Items.NumItems(), 5000);
+	EXPECT_EQ(Items.NumDropped(), 0);
+	for(int i = 0; i < Items.NumItems(); i++)
+	{
+		ASSERT_EQ(*(const int *)Items.ItemData(i), i);
+	}
+	ExpectSameItemsAround(&Items, &Seed);
+}
+
+TEST(SharedSnapItems, FewItems)
+{
+	CSharedSnapItems Items;
+	unsigned Seed = 3;
+	CreateItems(&Items, 20, &Seed);
+	ExpectSameItemsAround(&Items, &Seed);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/snapshot.h>
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+// a snapshot of some players and projectiles that come and go
+static int BuildSnapshot(CSnapshot *pSnap, unsigned Seed, int Step)
+{
+	static CSnapshotBuilder s_Builder;
+	s_Builder.Init();
+	for(int i = 0; i < 300; i++)
+	{
+		unsigned ItemSeed = Seed + i*7919;
+		if((Random(&ItemSeed) + Step*(i%3)) % 5 == 0)
+			continue;
+		int Size = 4 * (1 + i%6);
+		int *pData = (int *)s_Builder.NewItem(1 + i%20, i, Size);
+		for(int k = 0; k < Size/4; k++)
+			pData[k] = (i%4 == 0 ? Step : 0) + (int)(Random(&ItemSeed) % 100);
+	}
+	return s_Builder.Finish(pSnap);
+}
+
+static void ExpectSameSnapshot(const CSnapshot *pA, const CSnapshot *pB)
+{
+	ASSERT_EQ(pA->NumItems(), pB->NumItems());
+	for(int i = 0; i < pA->NumItems(); i++)
+	{
+		ASSERT_EQ(pA->GetItem(i)->Key(), pB->GetItem(i)->Key());
+		ASSERT_EQ(pA->GetItemSize(i), pB->GetItemSize(i));
+		EXPECT_EQ(mem_comp(pA->GetItem(i)->Data(), pB->GetItem(i)->Data(), pA->GetItemSize(i)), 0);
+	}
+}
+
+TEST(Snapshot, HashFindsAllItems)
+{
+	static char s_aSnap[CSnapshot::MAX_SIZE];
+	static int s_aHash[CSnapshot::MAX_SIZE/sizeof(int)];
+	CSnapshot *pSnap = (CSnapshot *)s_aSnap;
+	CSnapshotHash *pHash = (CSnapshotHash *)s_aHash;
+
+	BuildSnapshot(pSnap, 3, 0);
+	ASSERT_LE(CSnapshotHash::Size(pSnap->NumItems()), (int)sizeof(s_aHash));
+	pHash->Build(pSnap);
+	for(int i = 0; i < pSnap->NumItems(); i++)
+		EXPECT_EQ(pHash->GetItemIndex(pSnap->GetItem(i)->Key()), i);
+	EXPECT_EQ(pHash->GetItemIndex((25<<16)|1), -1);
+}
+
+TEST(Snapshot, DeltaRoundTrip)
+{
+	static char s_aFrom[CSnapshot::MAX_SIZE];
+	static char s_aTo[CSnapshot::MAX_SIZE];
+	static char s_aUnpacked[CSnapshot::MAX_SIZE];
+	static char s_aDelta[CSnapshot::MAX_SIZE];
+	static char s_aDeltaHashed[CSnapshot::MAX_SIZE];
+	static CSnapshotDelta s_Delta;
+	CSnapshot *pFrom = (CSnapshot *)s_aFrom;
+	CSnapshot *pTo = (CSnapshot *)s_aTo;
+
+	CSnapshotStorage Storage;
+	Storage.Init();
+
+	for(int Step = 1; Step < 200; Step++)
+	{
+		BuildSnapshot(pFrom, 11, Step-1);
+		int ToSize = BuildSnapshot(pTo, 11, Step);
+
+		// the storage keeps a second of them, like the server does
+		Storage.PurgeUntil(Step-50);
+		Storage.Add(Step, 0, ToSize, pTo, 0, true);
+		CSnapshotStorage::CHolder *pHolder = Storage.Find(Step);
+		ASSERT_TRUE(pHolder);
+		ASSERT_TRUE(pHolder->m_pHash);
+		CSnapshotStorage::CHolder *pPrev = Storage.Find(Step-1);
+
+		int DeltaSize = s_Delta.CreateDelta(pFrom, pTo, s_aDelta);
+		if(pPrev)
+		{
+			int HashedSize = s_Delta.CreateDelta(pPrev->m_pSnap, pPrev->m_pHash, pHolder->m_pSnap, pHolder->m_pHash, s_aDeltaHashed);
+			ASSERT_EQ(HashedSize, DeltaSize);
+			EXPECT_EQ(mem_comp(s_aDelta, s_aDeltaHashed, DeltaSize), 0);
+		}
+
+		if(DeltaSize)
+		{
+			ASSERT_GT(s_Delta.UnpackDelta(pFrom, (CSnapshot *)s_aUnpacked, s_aDelta, DeltaSize), 0);
+			ExpectSameSnapshot((CSnapshot *)s_aUnpacked, pTo);
+		}
+	}
+
+	EXPECT_FALSE(Storage.Find(10));
+	EXPECT_TRUE(Storage.Find(150));
+	EXPECT_EQ(Storage.m_pLast->m_Tick, 199);
+	Storage.PurgeAll();
+	EXPECT_FALSE(Storage.m_pFirst);
+	EXPECT_FALSE(Storage.m_pFree);
+}
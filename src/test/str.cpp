@@ -41,6 +41,28 @@ TEST(Str, Endswith)
 		str_length(ABCDEFG) - str_length(DEFG));
 }
 
+TEST(Str, Utf8Skeleton)
+{
+	int aSkel1[32];
+	int aSkel2[32];
+
+	EXPECT_EQ(str_utf8_comp_confusable("rn", "m"), 0);
+	EXPECT_EQ(str_utf8_comp_confusable("I", "l"), 0);
+	EXPECT_EQ(str_utf8_comp_confusable("\xd0\xb0", "a"), 0); // cyrillic a
+	EXPECT_NE(str_utf8_comp_confusable("abc", "abd"), 0);
+	EXPECT_NE(str_utf8_comp_confusable("abc", "ab"), 0);
+
+	int Length1 = str_utf8_to_skeleton("cl0mn", aSkel1, 32);
+	int Length2 = str_utf8_to_skeleton("cIOrnn", aSkel2, 32);
+	ASSERT_EQ(Length1, Length2);
+	EXPECT_EQ(mem_comp(aSkel1, aSkel2, Length1*sizeof(int)), 0);
+
+	// the longest decomposition, 15 code points from 3 bytes
+	EXPECT_EQ(str_utf8_to_skeleton("\xef\xb7\xba", aSkel1, 32), 15);
+	EXPECT_EQ(str_utf8_to_skeleton("\xef\xb7\xba", aSkel1, 4), 4);
+	EXPECT_EQ(str_utf8_to_skeleton("", aSkel1, 32), 0);
+}
+
 TEST(StrFormat, Positional)
 {
 	char aBuf[256];
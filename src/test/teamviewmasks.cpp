@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <game/server/teamviewmasks.h>
+
+typedef CTeamViewMasks::CViewer CViewer;
+
+static unsigned Random(unsigned *pSeed)
+{
+	*pSeed = *pSeed * 1103515245 + 12345;
+	return *pSeed >> 8;
+}
+
+// the loop over all clients CGameTeams::TeamMask used to run, except
+// that an asker of -1 counts as not solo
+static uint64_t LoopMask(const CViewer *pViewers, CTeamsCore *pCore, int Team, int ExceptID, int Asker)
+{
+	bool AskerSolo = Asker >= 0 && pCore->GetSolo(Asker);
+	uint64_t Mask = 0;
+
+	for(int i = 0; i < MAX_CLIENTS; ++i)
+	{
+		if(i == ExceptID)
+			continue; // Explicitly excluded
+		if(!pViewers[i].m_Active)
+			continue; // Player doesn't exist
+
+		if(!pViewers[i].m_Spectating)
+		{ // Not spectator
+			if(i != Asker)
+			{ // Actions of other players
+				if(!pViewers[i].m_Alive)
+					continue; // Player is currently dead
+				if(!pViewers[i].m_ShowOthers)
+				{
+					if(AskerSolo)
+						continue; // When in solo part don't show others
+					if(pCore->GetSolo(i))
+						continue; // When in solo part don't show others
+					if(pCore->Team(i) != Team && pCore->Team(i) != TEAM_SUPER)
+						continue; // In different teams
+				} // ShowOthers
+			} // See everything of yourself
+		}
+		else if(pViewers[i].m_SpectatorID != -1)
+		{ // Spectating specific player
+			int SpectatorID = pViewers[i].m_SpectatorID;
+			if(SpectatorID != Asker)
+			{ // Actions of other players
+				if(!pViewers[SpectatorID].m_Alive)
+					continue; // Player is currently dead
+				if(!pViewers[i].m_ShowOthers)
+				{
+					if(AskerSolo)
+						continue; // When in solo part don't show others
+					if(pCore->GetSolo(SpectatorID))
+						continue; // When in solo part don't show others
+					if(pCore->Team(SpectatorID) != Team && pCore->Team(SpectatorID) != TEAM_SUPER)
+						continue; // In different teams
+				} // ShowOthers
+			} // See everything of player you're spectating
+		}
+		else
+		{ // Freeview
+			if(pViewers[i].m_SpecTeam)
+			{ // Show only players in own team when spectating
+				if(pCore->Team(i) != Team && pCore->Team(i) != TEAM_SUPER)
+					continue; // in different teams
+			}
+		}
+
+		Mask |= 1ULL << i;
+	}
+	return Mask;
+}
+
+static void RandomChange(CViewer *pViewers, CTeamsCore *pCore, unsigned *pSeed)
+{
+	int ClientID = Random(pSeed)%MAX_CLIENTS;
+	CViewer *pViewer = &pViewers[ClientID];
+	switch(Random(pSeed)%8)
+	{
+	case 0:
+		// joins or drops
+		pViewer->m_Active = !pViewer->m_Active;
+		pViewer->m_Spectating = false;
+		pViewer->m_SpectatorID = -1;
+		pViewer->m_Alive = false;
+		break;
+	case 1: pViewer->m_Spectating = !pViewer->m_Spectating; break;
+	case 2: pViewer->m_SpectatorID = (int)(Random(pSeed)%(MAX_CLIENTS+1)) - 1; break;
+	case 3: pViewer->m_SpecTeam = !pViewer->m_SpecTeam; break;
+	case 4: pViewer->m_ShowOthers = !pViewer->m_ShowOthers; break;
+	case 5: pViewer->m_Alive = pViewer->m_Active && !pViewer->m_Alive; break;
+	case 6: pCore->SetSolo(ClientID, !pCore->GetSolo(ClientID)); break;
+	case 7:
+		// a few teams, so they overlap
+		{
+			int Team = Random(pSeed)%5;
+			pCore->Team(ClientID, Team == 4 ? (int)TEAM_SUPER : Team);
+		}
+		break;
+	}
+}
+
+TEST(TeamViewMasks, MatchesLoop)
+{
+	CViewer aViewers[MAX_CLIENTS];
+	mem_zero(aViewers, sizeof(aViewers));
+	for(int i = 0; i < MAX_CLIENTS; i++)
+		aViewers[i].m_SpectatorID = -1;
+	CTeamsCore Core;
+	CTeamViewMasks Masks;
+	unsigned Seed = 1;
+
+	for(int Round = 0; Round < 500; Round++)
+	{
+		int NumChanges = 1 + Random(&Seed)%20;
+		for(int i = 0; i < NumChanges; i++)
+			RandomChange(aViewers, &Core, &Seed);
+		Masks.Update(aViewers, &Core);
+
+		for(int Asker = -1; Asker < MAX_CLIENTS; Asker++)
+		{
+			bool AskerSolo = Asker >= 0 && Core.GetSolo(Asker);
+			int ExceptID = Random(&Seed)%4 ? -1 : (int)(Random(&Seed)%MAX_CLIENTS);
+			int aTeams[] = {-1, 0, 1, 2, 3, TEAM_SUPER, Asker >= 0 ? Core.Team(Asker) : 0};
+			for(unsigned t = 0; t < sizeof(aTeams)/sizeof(aTeams[0]); t++)
+			{
+				int Team = aTeams[t];
+				ASSERT_EQ(LoopMask(aViewers, &Core, Team, ExceptID, Asker), Masks.Mask(Team, ExceptID, Asker, AskerSolo))
+					<< "round=" << Round << " team=" << Team << " except=" << ExceptID << " asker=" << Asker;
+			}
+		}
+	}
+}
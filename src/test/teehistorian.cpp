@@ -358,3 +358,79 @@ TEST_F(TeeHistorian, Auth)
 	Finish();
 	Expect(EXPECTED, sizeof(EXPECTED));
 }
+
+TEST_F(TeeHistorian, ReadBack)
+{
+	CNetObj_PlayerInput Input;
+	mem_zero(&Input, sizeof(Input));
+
+	Tick(1); Player(0, 1, 2); Player(1, 3, 4);
+	Tick(2); Player(1, 3, 5);
+	Inputs(); m_TH.RecordPlayerJoin(2); Input.m_Direction = 1; m_TH.RecordPlayerInput(2, &Input);
+	Tick(3); Player(0, 1, 3);
+	Tick(7); Player(2, 10, 10);
+	Inputs(); Input.m_Jump = 1; m_TH.RecordPlayerInput(2, &Input); m_TH.RecordPlayerMessage(2, "\x01\x02", 2); m_TH.RecordPlayerDrop(1, "bye");
+	Tick(8); DeadPlayer(0);
+	Finish();
+
+	CTeeHistorianReader Reader;
+	ASSERT_FALSE(Reader.Open(m_Buffer.Data(), 10));
+	ASSERT_TRUE(Reader.Open(m_Buffer.Data(), m_Buffer.Size()));
+	EXPECT_TRUE(str_find(Reader.Header(), "\"map_name\":\"Kobra 3 Solo\""));
+
+	CTeeHistorianReader::CItem Item;
+	struct
+	{
+		int m_Type;
+		int m_Tick;
+		int m_ClientID;
+		int m_X;
+		int m_Y;
+	} aExpected[] = {
+		{CTeeHistorianReader::ITEM_PLAYER, 1, 0, 1, 2},
+		{CTeeHistorianReader::ITEM_PLAYER, 1, 1, 3, 4},
+		{CTeeHistorianReader::ITEM_PLAYER, 2, 1, 3, 5},
+		{CTeeHistorianReader::ITEM_JOIN, 2, 2},
+		{CTeeHistorianReader::ITEM_INPUT, 2, 2},
+		{CTeeHistorianReader::ITEM_PLAYER, 3, 0, 1, 3},
+		{CTeeHistorianReader::ITEM_PLAYER, 7, 2, 10, 10},
+		{CTeeHistorianReader::ITEM_INPUT, 7, 2},
+		{CTeeHistorianReader::ITEM_MESSAGE, 7, 2},
+		{CTeeHistorianReader::ITEM_DROP, 7, 1},
+		{CTeeHistorianReader::ITEM_DEAD_PLAYER, 8, 0},
+	};
+	for(unsigned i = 0; i < sizeof(aExpected) / sizeof(aExpected[0]); i++)
+	{
+		ASSERT_EQ(Reader.Next(&Item), aExpected[i].m_Type) << "item " << i;
+		EXPECT_EQ(Item.m_Tick, aExpected[i].m_Tick) << "item " << i;
+		EXPECT_EQ(Item.m_ClientID, aExpected[i].m_ClientID) << "item " << i;
+		if(Item.m_Type == CTeeHistorianReader::ITEM_PLAYER)
+		{
+			EXPECT_EQ(Item.m_X, aExpected[i].m_X) << "item " << i;
+			EXPECT_EQ(Item.m_Y, aExpected[i].m_Y) << "item " << i;
+		}
+		else if(Item.m_Type == CTeeHistorianReader::ITEM_INPUT)
+		{
+			EXPECT_EQ(Item.m_Input.m_Direction, 1);
+			EXPECT_EQ(Item.m_Input.m_Jump, Item.m_Tick == 7 ? 1 : 0);
+		}
+		else if(Item.m_Type == CTeeHistorianReader::ITEM_MESSAGE)
+		{
+			ASSERT_EQ(Item.m_DataSize, 2);
+			EXPECT_EQ(mem_comp(Item.m_pData, "\x01\x02", 2), 0);
+		}
+		else if(Item.m_Type == CTeeHistorianReader::ITEM_DROP)
+		{
+			EXPECT_STREQ(Item.m_pReason, "bye");
+		}
+	}
+	EXPECT_EQ(Reader.Next(&Item), CTeeHistorianReader::ITEM_FINISH);
+	EXPECT_EQ(Reader.Next(&Item), CTeeHistorianReader::ITEM_FINISH);
+
+	// a file cut short is noticed
+	ASSERT_TRUE(Reader.Open(m_Buffer.Data(), m_Buffer.Size() - 3));
+	int Type;
+	while((Type = Reader.Next(&Item)) > CTeeHistorianReader::ITEM_FINISH)
+		;
+	EXPECT_EQ(Type, CTeeHistorianReader::ITEM_ERROR);
+}
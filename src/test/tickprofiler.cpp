@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/tickprofiler.h>
+
+static int64 Us(int64 Microseconds)
+{
+	return Microseconds*time_freq()/1000000;
+}
+
+TEST(TickProfiler, Histogram)
+{
+	CTickProfiler Profiler;
+	EXPECT_EQ(Profiler.NumFrames(), 0);
+	EXPECT_EQ(Profiler.Percentile(CTickProfiler::PHASE_TICK, 50), 0);
+
+	// 99 quick ticks and one slow one
+	for(int i = 0; i < 100; i++)
+	{
+		Profiler.Add(CTickProfiler::PHASE_TICK, Us(i == 42 ? 5000 : 100));
+		Profiler.Add(CTickProfiler::PHASE_SNAP, Us(10));
+		Profiler.Add(CTickProfiler::PHASE_SNAP, Us(20));
+		Profiler.EndFrame(1000 + i);
+	}
+
+	EXPECT_EQ(Profiler.NumFrames(), 100);
+	EXPECT_EQ(Profiler.Mean(CTickProfiler::PHASE_TICK), (99*100 + 5000)/100);
+	EXPECT_EQ(Profiler.Max(CTickProfiler::PHASE_TICK), 5000);
+	EXPECT_EQ(Profiler.Percentile(CTickProfiler::PHASE_TICK, 50), 127);
+	EXPECT_EQ(Profiler.Percentile(CTickProfiler::PHASE_TICK, 99), 5000);
+	EXPECT_EQ(Profiler.Mean(CTickProfiler::PHASE_SNAP), 30);
+	EXPECT_EQ(Profiler.CallRate(CTickProfiler::PHASE_SNAP), 200);
+	EXPECT_EQ(Profiler.Mean(CTickProfiler::PHASE_DELTA), 0);
+
+	EXPECT_EQ(Profiler.WorstTick(), 1042);
+	EXPECT_EQ(Profiler.WorstTotal(), 5030);
+	EXPECT_EQ(Profiler.WorstPhase(CTickProfiler::PHASE_TICK), 5000);
+
+	Profiler.Reset();
+	EXPECT_EQ(Profiler.NumFrames(), 0);
+	EXPECT_EQ(Profiler.WorstTick(), -1);
+	EXPECT_EQ(Profiler.Max(CTickProfiler::PHASE_TICK), 0);
+}
+
+TEST(TickProfiler, Nesting)
+{
+	CTickProfiler Profiler;
+	Profiler.Begin(CTickProfiler::PHASE_SNAP);
+	Profiler.Begin(CTickProfiler::PHASE_RECORD);
+	thread_sleep(20);
+	Profiler.End(CTickProfiler::PHASE_RECORD);
+	Profiler.End(CTickProfiler::PHASE_SNAP);
+	Profiler.EndFrame(1);
+
+	// the inner phase is not counted twice
+	EXPECT_GE(Profiler.Mean(CTickProfiler::PHASE_RECORD), 15000);
+	EXPECT_LT(Profiler.Mean(CTickProfiler::PHASE_SNAP), 5000);
+	EXPECT_EQ(Profiler.CallRate(CTickProfiler::PHASE_SNAP), 100);
+
+	// nothing is measured while disabled
+	Profiler.SetEnabled(false);
+	Profiler.Begin(CTickProfiler::PHASE_TICK);
+	Profiler.Add(CTickProfiler::PHASE_TICK, Us(1000));
+	Profiler.End(CTickProfiler::PHASE_TICK);
+	Profiler.EndFrame(2);
+	EXPECT_EQ(Profiler.NumFrames(), 1);
+	EXPECT_EQ(Profiler.Max(CTickProfiler::PHASE_TICK), 0);
+}
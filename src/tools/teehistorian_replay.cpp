@@ -0,0 +1,747 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/math.h>
+#include <base/system.h>
+
+#include <engine/config.h>
+#include <engine/console.h>
+#include <engine/kernel.h>
+#include <engine/map.h>
+#include <engine/server.h>
+#include <engine/storage.h>
+#include <engine/external/json-parser/json.h>
+#include <engine/shared/config.h>
+#include <engine/shared/packer.h>
+#include <engine/shared/protocol.h>
+#include <engine/shared/protocol_ex.h>
+#include <engine/shared/snapshot.h>
+#include <engine/shared/tickprofiler.h>
+#include <engine/shared/uuid_manager.h>
+#include <game/version.h>
+#include <game/server/entities/character.h>
+#include <game/server/gamecontext.h>
+
+#include <vector>
+#include <zlib.h>
+
+/*
+	Runs the game server on a recorded game, without networking and as
+	fast as it goes. Joins, drops, messages, inputs and console commands
+	of the teehistorian file are fed back at the ticks they were recorded
+	at.
+
+	Reports the ticks per second, the time per phase and a checksum over
+	all characters, with -c also the checksum of every tick. The same
+	file has to give the same checksums on every run, which makes it a
+	determinism check for changes to the tick. The recorded positions
+	are compared too, they only match as long as the inputs reach the
+	game at the same ticks as they did on the real server.
+*/
+
+static CUuid s_UuidAuthInit = CalculateUuid("teehistorian-auth-init@ddnet.tw");
+static CUuid s_UuidAuthLogin = CalculateUuid("teehistorian-auth-login@ddnet.tw");
+static CUuid s_UuidAuthLogout = CalculateUuid("teehistorian-auth-logout@ddnet.tw");
+
+class CReplayServer : public IServer
+{
+public:
+	enum
+	{
+		STATE_EMPTY=0,
+		STATE_READY,
+		STATE_INGAME,
+
+		MAX_IDS=16*1024,
+	};
+
+	struct CClient
+	{
+		int m_State;
+		char m_aName[MAX_NAME_LENGTH];
+		char m_aClan[MAX_CLAN_LENGTH];
+		int m_Country;
+		int m_AuthLevel;
+		char m_aAuthName[64];
+
+		bool m_HasInput;
+		CNetObj_PlayerInput m_Input;
+	};
+
+	CClient m_aClients[MAX_CLIENTS];
+	CSnapshotBuilder m_SnapshotBuilder;
+	CTickProfiler m_TickProfiler;
+
+	// ids are handed out again right away, nobody holds old snapshots
+	int m_aFreeIDs[MAX_IDS];
+	int m_NumFreeIDs;
+
+	char m_aMapName[128];
+	int m_MapSize;
+	SHA256_DIGEST m_MapSha256;
+	int m_MapCrc;
+
+	int64 m_NumMessages;
+	int64 m_MessageBytes;
+
+	CReplayServer()
+	{
+		m_CurrentGameTick = 0;
+		m_TickSpeed = SERVER_TICK_SPEED;
+		mem_zero(m_aClients, sizeof(m_aClients));
+		for(int i = 0; i < MAX_IDS; i++)
+			m_aFreeIDs[i] = MAX_IDS-1-i;
+		m_NumFreeIDs = MAX_IDS;
+		m_aMapName[0] = 0;
+		m_MapSize = 0;
+		mem_zero(&m_MapSha256, sizeof(m_MapSha256));
+		m_MapCrc = 0;
+		m_NumMessages = 0;
+		m_MessageBytes = 0;
+	}
+
+	void SetTick(int Tick) { m_CurrentGameTick = Tick; }
+
+	virtual int MaxClients() const { return MAX_CLIENTS; }
+	virtual const char *ClientName(int ClientID) const
+	{
+		if(ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State == STATE_EMPTY)
+			return "(invalid)";
+		return m_aClients[ClientID].m_aName;
+	}
+	virtual const char *ClientClan(int ClientID) const
+	{
+		if(ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State == STATE_EMPTY)
+			return "";
+		return m_aClients[ClientID].m_aClan;
+	}
+	virtual int ClientCountry(int ClientID) const
+	{
+		if(ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State == STATE_EMPTY)
+			return -1;
+		return m_aClients[ClientID].m_Country;
+	}
+	virtual bool ClientIngame(int ClientID) const
+	{
+		return ClientID >= 0 && ClientID < MAX_CLIENTS && m_aClients[ClientID].m_State == STATE_INGAME;
+	}
+	virtual int GetClientInfo(int ClientID, CClientInfo *pInfo) const
+	{
+		if(!ClientIngame(ClientID))
+			return 0;
+		pInfo->m_pName = m_aClients[ClientID].m_aName;
+		pInfo->m_Latency = 0;
+		return 1;
+	}
+	virtual void GetClientAddr(int ClientID, char *pAddrStr, int Size) const
+	{
+		str_format(pAddrStr, Size, "10.0.0.%d", ClientID+1);
+	}
+	virtual int GetClientVersion(int ClientID) const
+	{
+		return ClientIngame(ClientID) ? CLIENT_VERSION : 0;
+	}
+	virtual void RestrictRconOutput(int ClientID) {}
+
+	virtual void GetClientAddr(int ClientID, NETADDR *pAddr)
+	{
+		mem_zero(pAddr, sizeof(*pAddr));
+		pAddr->type = NETTYPE_IPV4;
+		pAddr->ip[0] = 10;
+		pAddr->ip[3] = ClientID+1;
+		pAddr->port = 8303;
+	}
+
+	virtual int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID)
+	{
+		m_NumMessages++;
+		m_MessageBytes += pMsg->Size();
+		return 0;
+	}
+	virtual int SendMsgMask(CMsgPacker *pMsg, int Flags, int64 Mask)
+	{
+		m_NumMessages++;
+		m_MessageBytes += pMsg->Size();
+		return 0;
+	}
+
+	virtual void GetMapInfo(char *pMapName, int MapNameSize, int *pMapSize, SHA256_DIGEST *pSha256, int *pMapCrc)
+	{
+		str_copy(pMapName, m_aMapName, MapNameSize);
+		*pMapSize = m_MapSize;
+		*pSha256 = m_MapSha256;
+		*pMapCrc = m_MapCrc;
+	}
+
+	virtual void SetClientName(int ClientID, char const *pName)
+	{
+		str_copy(m_aClients[ClientID].m_aName, pName, sizeof(m_aClients[ClientID].m_aName));
+	}
+	virtual void SetClientClan(int ClientID, char const *pClan)
+	{
+		str_copy(m_aClients[ClientID].m_aClan, pClan, sizeof(m_aClients[ClientID].m_aClan));
+	}
+	virtual void SetClientCountry(int ClientID, int Country) { m_aClients[ClientID].m_Country = Country; }
+	virtual void SetClientScore(int ClientID, int Score) {}
+
+	virtual void ExpireServerInfo() {}
+
+	virtual int SnapNewID()
+	{
+		dbg_assert(m_NumFreeIDs > 0, "no snap ids left");
+		return m_aFreeIDs[--m_NumFreeIDs];
+	}
+	virtual void SnapFreeID(int ID)
+	{
+		dbg_assert(m_NumFreeIDs < MAX_IDS, "snap id freed twice");
+		m_aFreeIDs[m_NumFreeIDs++] = ID;
+	}
+	virtual void *SnapNewItem(int Type, int ID, int Size)
+	{
+		dbg_assert(ID >= 0 && ID <= 0xffff, "incorrect id");
+		return m_SnapshotBuilder.NewItem(Type, ID, Size);
+	}
+	virtual void SnapSetStaticsize(int ItemType, int Size) {}
+
+	virtual void SetRconCID(int ClientID) {}
+	virtual int IsAuthed(int ClientID) const
+	{
+		return ClientID >= 0 && ClientID < MAX_CLIENTS ? m_aClients[ClientID].m_AuthLevel : 0;
+	}
+	virtual const char *AuthName(int ClientID) const
+	{
+		return ClientID >= 0 && ClientID < MAX_CLIENTS ? m_aClients[ClientID].m_aAuthName : "";
+	}
+	virtual bool IsBanned(int ClientID) { return false; }
+	// the recording has the drop that follows
+	virtual void Kick(int ClientID, const char *pReason) {}
+
+	virtual void DemoRecorder_HandleAutoStart() {}
+	virtual bool DemoRecorder_IsRecording() { return false; }
+
+	virtual CTickProfiler *TickProfiler() { return &m_TickProfiler; }
+};
+
+class CReplay
+{
+public:
+	enum
+	{
+		MAX_OWN_COMMANDS=64,
+	};
+
+	IConsole *m_pConsole;
+	CGameContext *m_pGameServer;
+	CReplayServer *m_pServer;
+
+	bool m_Snapshots;
+	bool m_PrintChecksums;
+
+	int m_NumTicks;
+	unsigned m_Checksum;
+	int64 m_NumCompared;
+	int64 m_NumDiverged;
+	int m_FirstDivergedTick;
+	int64 m_NumSkippedCommands;
+
+	// commands the game ran on its own since the last tick, votes and
+	// chat commands, their recorded copies must not run a second time
+	struct COwnCommand
+	{
+		int m_ClientID;
+		char m_aLine[256];
+	};
+	COwnCommand m_aOwnCommands[MAX_OWN_COMMANDS];
+	int m_NumOwnCommands;
+	bool m_RunningRecorded;
+
+	CReplay()
+	{
+		m_Snapshots = true;
+		m_PrintChecksums = false;
+		m_NumTicks = 0;
+		m_Checksum = crc32(0, 0, 0);
+		m_NumCompared = 0;
+		m_NumDiverged = 0;
+		m_FirstDivergedTick = -1;
+		m_NumSkippedCommands = 0;
+		m_NumOwnCommands = 0;
+		m_RunningRecorded = false;
+	}
+
+	static void FormatCommand(char *pBuf, int BufSize, const char *pCommand, int NumArgs, const char * const *ppArgs)
+	{
+		str_copy(pBuf, pCommand, BufSize);
+		for(int i = 0; i < NumArgs; i++)
+		{
+			str_append(pBuf, " \"", BufSize);
+			int Length = str_length(pBuf);
+			for(const char *pArg = ppArgs[i]; *pArg && Length < BufSize - 3; pArg++)
+			{
+				if(*pArg == '"' || *pArg == '\\')
+					pBuf[Length++] = '\\';
+				pBuf[Length++] = *pArg;
+			}
+			pBuf[Length] = 0;
+			str_append(pBuf, "\"", BufSize);
+		}
+	}
+
+	static void OwnCommandCallback(int ClientID, int FlagMask, const char *pCmd, IConsole::IResult *pResult, void *pUser)
+	{
+		CReplay *pSelf = (CReplay *)pUser;
+		if(pSelf->m_RunningRecorded || pSelf->m_NumOwnCommands == MAX_OWN_COMMANDS)
+			return;
+
+		const char *apArgs[CTeeHistorianReader::MAX_ARGS];
+		int NumArgs = min(pResult->NumArguments(), (int)CTeeHistorianReader::MAX_ARGS);
+		for(int i = 0; i < NumArgs; i++)
+			apArgs[i] = pResult->GetString(i);
+
+		COwnCommand *pCommand = &pSelf->m_aOwnCommands[pSelf->m_NumOwnCommands++];
+		pCommand->m_ClientID = ClientID;
+		FormatCommand(pCommand->m_aLine, sizeof(pCommand->m_aLine), pCmd, NumArgs, apArgs);
+	}
+
+	void DoSnapshot()
+	{
+		m_pGameServer->OnPreSnap();
+		for(int i = 0; i < MAX_CLIENTS; i++)
+		{
+			if(!m_pServer->ClientIngame(i))
+				continue;
+
+			char aData[CSnapshot::MAX_SIZE];
+			m_pServer->m_SnapshotBuilder.Init();
+			m_pGameServer->OnSnap(i);
+			m_pServer->m_SnapshotBuilder.Finish(aData);
+		}
+		m_pGameServer->OnPostSnap();
+	}
+
+	void RunTick()
+	{
+		CTickProfiler *pProfiler = &m_pServer->m_TickProfiler;
+		m_pServer->SetTick(m_pServer->Tick() + 1);
+		m_NumOwnCommands = 0;
+
+		// every client sends an input per tick, the last one is repeated
+		pProfiler->Begin(CTickProfiler::PHASE_INPUT);
+		for(int i = 0; i < MAX_CLIENTS; i++)
+		{
+			CReplayServer::CClient *pClient = &m_pServer->m_aClients[i];
+			if(pClient->m_State != CReplayServer::STATE_INGAME || !pClient->m_HasInput)
+				continue;
+			CNetObj_PlayerInput Input = pClient->m_Input;
+			m_pGameServer->OnClientPredictedInput(i, &Input);
+		}
+		pProfiler->End(CTickProfiler::PHASE_INPUT);
+
+		pProfiler->Begin(CTickProfiler::PHASE_TICK);
+		m_pGameServer->OnTick();
+		pProfiler->End(CTickProfiler::PHASE_TICK);
+
+		if(m_Snapshots && (m_pServer->Tick()%2) == 0)
+		{
+			pProfiler->Begin(CTickProfiler::PHASE_SNAP);
+			DoSnapshot();
+			pProfiler->End(CTickProfiler::PHASE_SNAP);
+		}
+
+		pProfiler->EndFrame(m_pServer->Tick());
+
+		unsigned Checksum = crc32(0, 0, 0);
+		for(int i = 0; i < MAX_CLIENTS; i++)
+		{
+			CCharacter *pChr = m_pGameServer->GetPlayerChar(i);
+			if(!pChr)
+				continue;
+			CNetObj_CharacterCore Core;
+			mem_zero(&Core, sizeof(Core));
+			pChr->GetCore().Write(&Core);
+			Checksum = crc32(Checksum, (const Bytef *)&i, sizeof(i));
+			Checksum = crc32(Checksum, (const Bytef *)&Core, sizeof(Core));
+		}
+		m_Checksum = crc32(m_Checksum, (const Bytef *)&Checksum, sizeof(Checksum));
+		m_NumTicks++;
+
+		if(m_PrintChecksums)
+			dbg_msg("replay", "tick=%d checksum=%08x", m_pServer->Tick(), Checksum);
+	}
+
+	void ComparePlayer(const CTeeHistorianReader::CItem *pItem)
+	{
+		CCharacter *pChr = m_pGameServer->GetPlayerChar(pItem->m_ClientID);
+		bool Match;
+		if(pItem->m_Type == CTeeHistorianReader::ITEM_DEAD_PLAYER)
+			Match = !pChr;
+		else if(!pChr)
+			Match = false;
+		else
+		{
+			CNetObj_CharacterCore Core;
+			pChr->GetCore().Write(&Core);
+			Match = Core.m_X == pItem->m_X && Core.m_Y == pItem->m_Y;
+		}
+
+		m_NumCompared++;
+		if(!Match)
+		{
+			m_NumDiverged++;
+			if(m_FirstDivergedTick < 0)
+				m_FirstDivergedTick = pItem->m_Tick;
+		}
+	}
+
+	void Message(const CTeeHistorianReader::CItem *pItem)
+	{
+		int ClientID = pItem->m_ClientID;
+		if(m_pServer->m_aClients[ClientID].m_State == CReplayServer::STATE_EMPTY)
+			return;
+
+		CUnpacker Unpacker;
+		Unpacker.Reset(pItem->m_pData, pItem->m_DataSize);
+		CMsgPacker Packer(NETMSG_EX);
+		int Msg;
+		bool Sys;
+		CUuid Uuid;
+		if(UnpackMessageID(&Msg, &Sys, &Uuid, &Unpacker, &Packer) == UNPACKMESSAGE_ERROR || Sys)
+			return;
+		m_pGameServer->OnMessage(Msg, &Unpacker, ClientID);
+
+		// the client enters as soon as the game lets it
+		if(m_pServer->m_aClients[ClientID].m_State == CReplayServer::STATE_READY && m_pGameServer->IsClientReady(ClientID))
+		{
+			m_pServer->m_aClients[ClientID].m_State = CReplayServer::STATE_INGAME;
+			m_pGameServer->OnClientEnter(ClientID);
+		}
+	}
+
+	void ConsoleCommand(const CTeeHistorianReader::CItem *pItem)
+	{
+		char aLine[256];
+		FormatCommand(aLine, sizeof(aLine), pItem->m_pCommand, pItem->m_NumArgs, pItem->m_apArgs);
+		for(int i = 0; i < m_NumOwnCommands; i++)
+		{
+			if(m_aOwnCommands[i].m_ClientID == pItem->m_ClientID && str_comp(m_aOwnCommands[i].m_aLine, aLine) == 0)
+			{
+				m_aOwnCommands[i] = m_aOwnCommands[--m_NumOwnCommands];
+				m_NumSkippedCommands++;
+				return;
+			}
+		}
+
+		m_RunningRecorded = true;
+		m_pConsole->ExecuteLineFlag(aLine, pItem->m_FlagMask, pItem->m_ClientID, false);
+		m_RunningRecorded = false;
+	}
+
+	void Auth(const CTeeHistorianReader::CItem *pItem)
+	{
+		CUnpacker Unpacker;
+		Unpacker.Reset(pItem->m_pData, pItem->m_DataSize);
+		int ClientID = Unpacker.GetInt();
+		if(Unpacker.Error() || ClientID < 0 || ClientID >= MAX_CLIENTS)
+			return;
+
+		CReplayServer::CClient *pClient = &m_pServer->m_aClients[ClientID];
+		if(s_UuidAuthLogout == pItem->m_Uuid)
+		{
+			pClient->m_AuthLevel = 0;
+			pClient->m_aAuthName[0] = 0;
+			return;
+		}
+		int Level = Unpacker.GetInt();
+		const char *pName = Unpacker.GetString(0);
+		if(Unpacker.Error())
+			return;
+		pClient->m_AuthLevel = Level;
+		str_copy(pClient->m_aAuthName, pName, sizeof(pClient->m_aAuthName));
+	}
+
+	void Handle(const CTeeHistorianReader::CItem *pItem)
+	{
+		int ClientID = pItem->m_ClientID;
+		CReplayServer::CClient *pClient = ClientID >= 0 && ClientID < MAX_CLIENTS ? &m_pServer->m_aClients[ClientID] : 0;
+
+		switch(pItem->m_Type)
+		{
+		case CTeeHistorianReader::ITEM_PLAYER:
+		case CTeeHistorianReader::ITEM_DEAD_PLAYER:
+			ComparePlayer(pItem);
+			break;
+		case CTeeHistorianReader::ITEM_INPUT:
+			if(pClient->m_State == CReplayServer::STATE_INGAME)
+			{
+				pClient->m_Input = pItem->m_Input;
+				pClient->m_HasInput = true;
+				CNetObj_PlayerInput Input = pItem->m_Input;
+				m_pGameServer->OnClientDirectInput(ClientID, &Input);
+			}
+			break;
+		case CTeeHistorianReader::ITEM_MESSAGE:
+			Message(pItem);
+			break;
+		case CTeeHistorianReader::ITEM_JOIN:
+			if(pClient->m_State == CReplayServer::STATE_EMPTY)
+			{
+				mem_zero(pClient, sizeof(*pClient));
+				pClient->m_State = CReplayServer::STATE_READY;
+				pClient->m_Country = -1;
+				m_pGameServer->OnClientEngineJoin(ClientID);
+				m_pGameServer->OnClientConnected(ClientID, false);
+			}
+			break;
+		case CTeeHistorianReader::ITEM_DROP:
+			if(pClient->m_State != CReplayServer::STATE_EMPTY)
+			{
+				m_pGameServer->OnClientDrop(ClientID, pItem->m_pReason);
+				m_pGameServer->OnClientEngineDrop(ClientID, pItem->m_pReason);
+				pClient->m_State = CReplayServer::STATE_EMPTY;
+			}
+			break;
+		case CTeeHistorianReader::ITEM_CONSOLE_COMMAND:
+			ConsoleCommand(pItem);
+			break;
+		case CTeeHistorianReader::ITEM_EX:
+			if(s_UuidAuthInit == pItem->m_Uuid || s_UuidAuthLogin == pItem->m_Uuid || s_UuidAuthLogout == pItem->m_Uuid)
+				Auth(pItem);
+			break;
+		}
+	}
+};
+
+static bool ReadFile(const char *pFilename, std::vector<char> *pData)
+{
+	IOHANDLE File = io_open(pFilename, IOFLAG_READ);
+	if(!File)
+		return false;
+	unsigned Size = io_length(File);
+	std::vector<char> Raw(Size);
+	bool Success = io_read(File, Raw.data(), Size) == Size;
+	io_close(File);
+	if(!Success)
+		return false;
+
+	// sv_tee_historian_compress writes gzip
+	if(Size < 2 || (unsigned char)Raw[0] != 0x1f || (unsigned char)Raw[1] != 0x8b)
+	{
+		pData->swap(Raw);
+		return true;
+	}
+
+	z_stream Stream;
+	mem_zero(&Stream, sizeof(Stream));
+	if(inflateInit2(&Stream, 15+32) != Z_OK)
+		return false;
+	Stream.next_in = (Bytef *)Raw.data();
+	Stream.avail_in = Size;
+	pData->resize(Size*4);
+	int Result = Z_OK;
+	while(Result == Z_OK)
+	{
+		if(Stream.total_out == pData->size())
+			pData->resize(pData->size()*2);
+		Stream.next_out = (Bytef *)pData->data() + Stream.total_out;
+		Stream.avail_out = pData->size() - Stream.total_out;
+		Result = inflate(&Stream, Z_NO_FLUSH);
+	}
+	pData->resize(Stream.total_out);
+	inflateEnd(&Stream);
+	return Result == Z_STREAM_END;
+}
+
+static void ExecuteSetting(IConsole *pConsole, const char *pCommand, const char *pValue)
+{
+	char aLine[512];
+	CReplay::FormatCommand(aLine, sizeof(aLine), pCommand, 1, &pValue);
+	pConsole->ExecuteLine(aLine, -1, false);
+}
+
+int main(int argc, const char **argv) // ignore_convention
+{
+	dbg_logger_stdout();
+
+	CReplay Replay;
+	int Arg = 1;
+	for(; Arg < argc && argv[Arg][0] == '-'; Arg++) // ignore_convention
+	{
+		if(str_comp(argv[Arg], "-c") == 0) // ignore_convention
+			Replay.m_PrintChecksums = true;
+		else if(str_comp(argv[Arg], "-n") == 0) // ignore_convention
+			Replay.m_Snapshots = false;
+		else
+			break;
+	}
+	if(Arg >= argc)
+	{
+		dbg_msg("usage", "%s [-c] [-n] <teehistorian file> [commands]", argv[0]); // ignore_convention
+		dbg_msg("usage", "  -c  print the checksum of every tick");
+		dbg_msg("usage", "  -n  don't build snapshots");
+		return -1;
+	}
+	const char *pFilename = argv[Arg++]; // ignore_convention
+
+	if(secure_random_init() != 0)
+	{
+		dbg_msg("secure", "could not initialize secure RNG");
+		return -1;
+	}
+
+	std::vector<char> Data;
+	CTeeHistorianReader Reader;
+	if(!ReadFile(pFilename, &Data))
+	{
+		dbg_msg("replay", "failed to read '%s'", pFilename);
+		return -1;
+	}
+	if(!Reader.Open(Data.data(), Data.size()))
+	{
+		dbg_msg("replay", "'%s' is not a teehistorian file", pFilename);
+		return -1;
+	}
+
+	json_settings JsonSettings;
+	mem_zero(&JsonSettings, sizeof(JsonSettings));
+	char aError[256];
+	json_value *pHeader = json_parse_ex(&JsonSettings, Reader.Header(), str_length(Reader.Header()), aError);
+	if(!pHeader || pHeader->type != json_object)
+	{
+		dbg_msg("replay", "invalid header: %s", aError);
+		return -1;
+	}
+
+	IKernel *pKernel = IKernel::Create();
+	IStorage *pStorage = CreateStorage("Teeworlds", IStorage::STORAGETYPE_SERVER, argc, argv); // ignore_convention
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER);
+	IConfig *pConfig = CreateConfig();
+	IEngineMap *pEngineMap = CreateEngineMap();
+	CReplayServer *pServer = new CReplayServer();
+	CGameContext *pGameServer = (CGameContext *)CreateGameServer();
+
+	{
+		bool RegisterFail = false;
+
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IServer*>(pServer));
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IEngineMap*>(pEngineMap)); // register as both
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IMap*>(pEngineMap));
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(static_cast<IGameServer*>(pGameServer));
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pConsole);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pStorage);
+		RegisterFail = RegisterFail || !pKernel->RegisterInterface(pConfig);
+
+		if(RegisterFail)
+			return -1;
+	}
+
+	pConfig->Init(CFGFLAG_SERVER);
+	pGameServer->OnConsoleInit();
+
+	// the settings the game was recorded with, then the overrides
+	const json_value &rConfig = (*pHeader)["config"];
+	for(unsigned i = 0; rConfig.type == json_object && i < rConfig.u.object.length; i++)
+	{
+		const json_value *pValue = rConfig.u.object.values[i].value;
+		if(pValue->type == json_string)
+			ExecuteSetting(pConsole, rConfig.u.object.values[i].name, pValue->u.string.ptr);
+	}
+	const json_value &rMapName = (*pHeader)["map_name"];
+	if(rMapName.type == json_string)
+		str_copy(g_Config.m_SvMap, rMapName.u.string.ptr, sizeof(g_Config.m_SvMap));
+	if(Arg < argc)
+		pConsole->ParseArguments(argc-Arg, &argv[Arg]); // ignore_convention
+	pConfig->RestoreStrings();
+
+	// never record the replay
+	g_Config.m_SvTeeHistorian = 0;
+
+	char aMapFilename[512];
+	str_format(aMapFilename, sizeof(aMapFilename), "maps/%s.map", g_Config.m_SvMap);
+	pGameServer->OnMapChange(aMapFilename, sizeof(aMapFilename));
+	if(!pEngineMap->Load(aMapFilename))
+	{
+		dbg_msg("replay", "failed to load map '%s'", aMapFilename);
+		return -1;
+	}
+	str_copy(pServer->m_aMapName, g_Config.m_SvMap, sizeof(pServer->m_aMapName));
+	pServer->m_MapSha256 = pEngineMap->Sha256();
+	pServer->m_MapCrc = pEngineMap->Crc();
+	IOHANDLE MapFile = pStorage->OpenFile(aMapFilename, IOFLAG_READ, IStorage::TYPE_ALL);
+	if(MapFile)
+	{
+		pServer->m_MapSize = io_length(MapFile);
+		io_close(MapFile);
+	}
+
+	char aSha256[SHA256_MAXSTRSIZE];
+	sha256_str(pServer->m_MapSha256, aSha256, sizeof(aSha256));
+	const json_value &rMapSha256 = (*pHeader)["map_sha256"];
+	if(rMapSha256.type == json_string && str_comp(rMapSha256.u.string.ptr, aSha256) != 0)
+		dbg_msg("replay", "warning: '%s' is not the map the game was recorded on", aMapFilename);
+
+	pGameServer->OnInit();
+
+	// the tuning after the map settings, as the header has it
+	const json_value &rTuning = (*pHeader)["tuning"];
+	for(unsigned i = 0; rTuning.type == json_object && i < rTuning.u.object.length; i++)
+	{
+		const json_value *pValue = rTuning.u.object.values[i].value;
+		if(pValue->type != json_string)
+			continue;
+		char aValue[32];
+		str_format(aValue, sizeof(aValue), "%.2f", str_toint(pValue->u.string.ptr)/100.0f);
+		char aLine[128];
+		str_format(aLine, sizeof(aLine), "tune %s %s", rTuning.u.object.values[i].name, aValue);
+		pConsole->ExecuteLine(aLine, -1, false);
+	}
+	json_value_free(pHeader);
+
+	Replay.m_pConsole = pConsole;
+	Replay.m_pGameServer = pGameServer;
+	Replay.m_pServer = pServer;
+	pConsole->SetTeeHistorianCommandCallback(CReplay::OwnCommandCallback, &Replay);
+
+	dbg_msg("replay", "replaying '%s' on '%s'", pFilename, g_Config.m_SvMap);
+
+	int64 StartTime = time_get();
+	CTeeHistorianReader::CItem Item;
+	int Type;
+	while((Type = Reader.Next(&Item)) > CTeeHistorianReader::ITEM_FINISH)
+	{
+		while(pServer->Tick() < Item.m_Tick)
+			Replay.RunTick();
+		Replay.Handle(&Item);
+	}
+	int64 Duration = time_get() - StartTime;
+
+	if(Type == CTeeHistorianReader::ITEM_ERROR)
+		dbg_msg("replay", "the file is truncated or broken after tick %d", Reader.Tick());
+
+	pGameServer->OnShutdown();
+
+	double Seconds = Duration / (double)time_freq();
+	dbg_msg("replay", "ticks=%d time=%.3fs ticks/s=%.1f checksum=%08x",
+		Replay.m_NumTicks, Seconds, Seconds > 0 ? Replay.m_NumTicks/Seconds : 0.0, Replay.m_Checksum);
+	dbg_msg("replay", "positions compared=%lld diverged=%lld first_diverged_tick=%d",
+		Replay.m_NumCompared, Replay.m_NumDiverged, Replay.m_FirstDivergedTick);
+	dbg_msg("replay", "messages=%lld bytes=%lld skipped_own_commands=%lld",
+		pServer->m_NumMessages, pServer->m_MessageBytes, Replay.m_NumSkippedCommands);
+
+	char aBuf[256];
+	for(int p = 0; p < CTickProfiler::NUM_PHASES; p++)
+	{
+		pServer->m_TickProfiler.Format(p, aBuf, sizeof(aBuf));
+		dbg_msg("replay", "%s", aBuf);
+	}
+	pServer->m_TickProfiler.FormatWorst(aBuf, sizeof(aBuf));
+	dbg_msg("replay", "%s", aBuf);
+
+	delete pGameServer;
+	delete pServer;
+	delete pEngineMap;
+	delete pConfig;
+	delete pConsole;
+	delete pStorage;
+	delete pKernel;
+
+	return Type == CTeeHistorianReader::ITEM_ERROR ? 1 : 0;
+}